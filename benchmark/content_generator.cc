@@ -0,0 +1,195 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include <cstdlib>
+
+#include "harness/generator.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/log.h"
+#include "ozz/options/options.h"
+
+// Generates synthetic skeleton, animation and track archives of configurable
+// size and noise. Content is deterministic for a given set of options,
+// including the seed. Raw archives are output by default, so they can be used
+// to benchmark offline builders and optimizers. Runtime archives can be
+// output instead, for loaders and runtime jobs.
+
+OZZ_OPTIONS_DECLARE_INT(seed, "Seed of the pseudo random generator", 1, false)
+
+static bool ValidatePositive(const ozz::options::Option& _option,
+                             int /*_argc*/) {
+  const ozz::options::IntOption& option =
+      static_cast<const ozz::options::IntOption&>(_option);
+  return option >= 1;
+}
+
+OZZ_OPTIONS_DECLARE_INT_FN(joints, "Number of skeleton joints", 500, false,
+                           &ValidatePositive)
+
+static bool ValidateDuration(const ozz::options::Option& _option,
+                             int /*_argc*/) {
+  const ozz::options::FloatOption& option =
+      static_cast<const ozz::options::FloatOption&>(_option);
+  return option > 0.f;
+}
+
+OZZ_OPTIONS_DECLARE_FLOAT_FN(duration, "Animation duration, in seconds", 60.f,
+                             false, &ValidateDuration)
+
+OZZ_OPTIONS_DECLARE_FLOAT_FN(frequency,
+                             "Animation keyframe frequency, in hertz", 30.f,
+                             false, &ValidateDuration)
+
+static bool ValidateNoise(const ozz::options::Option& _option,
+                          int /*_argc*/) {
+  const ozz::options::FloatOption& option =
+      static_cast<const ozz::options::FloatOption&>(_option);
+  return option >= 0.f && option <= 1.f;
+}
+
+OZZ_OPTIONS_DECLARE_FLOAT_FN(noise,
+                             "Amplitude of the random noise added to keys, in "
+                             "range [0,1]. Noise prevents keys from being "
+                             "optimized away",
+                             .01f, false, &ValidateNoise)
+
+OZZ_OPTIONS_DECLARE_INT_FN(track_keys, "Number of float track keys", 18000,
+                           false, &ValidatePositive)
+
+OZZ_OPTIONS_DECLARE_STRING(skeleton,
+                           "Skeleton output file, skipped if empty",
+                           "skeleton.ozz", false)
+
+OZZ_OPTIONS_DECLARE_STRING(animation,
+                           "Animation output file, skipped if empty",
+                           "animation.ozz", false)
+
+OZZ_OPTIONS_DECLARE_STRING(track, "Float track output file, skipped if empty",
+                           "", false)
+
+OZZ_OPTIONS_DECLARE_BOOL(raw,
+                         "Outputs raw (offline) archives. Otherwise, builds "
+                         "and outputs runtime archives",
+                         true, false)
+
+namespace {
+
+// Outputs _object to file _filename.
+template <typename _Type>
+bool Write(const char* _filename, const _Type& _object) {
+  ozz::log::LogV() << "Opens output file: " << _filename << std::endl;
+  ozz::io::File file(_filename, "wb");
+  if (!file.opened()) {
+    ozz::log::Err() << "Failed to open output file: \"" << _filename << "\"."
+                    << std::endl;
+    return false;
+  }
+  ozz::io::OArchive archive(&file);
+  archive << _object;
+  return true;
+}
+
+// Outputs _raw object, or the runtime object built from it with _Builder.
+template <typename _Builder, typename _Raw>
+bool Output(const char* _filename, const _Raw& _raw) {
+  if (OPTIONS_raw) {
+    return Write(_filename, _raw);
+  }
+  const _Builder builder;
+  const auto object = builder(_raw);
+  if (!object) {
+    ozz::log::Err() << "Failed to build runtime object for \"" << _filename
+                    << "\"." << std::endl;
+    return false;
+  }
+  return Write(_filename, *object);
+}
+}  // namespace
+
+int main(int _argc, const char** _argv) {
+  const ozz::options::ParseResult parse_result = ozz::options::ParseCommandLine(
+      _argc, _argv, "1.0",
+      "Generates deterministic synthetic skeleton, animation and track "
+      "archives, for stress tests and benchmarks.");
+  if (parse_result != ozz::options::kSuccess) {
+    return parse_result == ozz::options::kExitSuccess ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+  }
+
+  const uint32_t seed = static_cast<uint32_t>(OPTIONS_seed.value());
+
+  if (OPTIONS_skeleton.value()[0] != 0) {
+    ozz::log::Log() << "Generates skeleton with " << OPTIONS_joints.value()
+                    << " joints." << std::endl;
+    ozz::animation::offline::RawSkeleton raw_skeleton;
+    ozz::benchmark::GenerateRawSkeleton(OPTIONS_joints, seed, &raw_skeleton);
+    if (!Output<ozz::animation::offline::SkeletonBuilder>(OPTIONS_skeleton,
+                                                          raw_skeleton)) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (OPTIONS_animation.value()[0] != 0) {
+    ozz::log::Log() << "Generates " << OPTIONS_duration.value()
+                    << "s animation at " << OPTIONS_frequency.value()
+                    << "hz, for " << OPTIONS_joints.value() << " joints."
+                    << std::endl;
+    ozz::animation::offline::RawAnimation raw_animation;
+    ozz::benchmark::GenerateRawAnimation(OPTIONS_joints, OPTIONS_duration,
+                                         OPTIONS_frequency, OPTIONS_noise, seed,
+                                         &raw_animation);
+    if (!Output<ozz::animation::offline::AnimationBuilder>(OPTIONS_animation,
+                                                           raw_animation)) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (OPTIONS_track.value()[0] != 0) {
+    ozz::log::Log() << "Generates float track with "
+                    << OPTIONS_track_keys.value() << " keys." << std::endl;
+    ozz::animation::offline::RawFloatTrack raw_track;
+    ozz::benchmark::GenerateRawFloatTrack(OPTIONS_track_keys, OPTIONS_noise,
+                                          seed, &raw_track);
+    if (!Output<ozz::animation::offline::TrackBuilder>(OPTIONS_track,
+                                                       raw_track)) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,665 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+#include "framework/mesh.h"
+#include "harness/assets.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/blending_job.h"
+#include "ozz/animation/runtime/ik_aim_job.h"
+#include "ozz/animation/runtime/ik_correction_job.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/log.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+#include "ozz/options/options.h"
+
+// Headless crowd benchmark. Updates a crowd of characters, each one sampling
+// and blending two of the bundled pab animations, converting to model-space,
+// applying a look-at IK on the head and skinning arnaud mesh. Frames are
+// updated for an increasing number of threads, so that scaling issues (false
+// sharing, allocator contention...) that micro-benchmarks can't reveal are
+// exposed.
+// For every thread count, the benchmark reports frame time percentiles, along
+// with per stage percentiles. Stage times are cpu times summed over all
+// threads, while frame time is the wall clock time.
+
+static bool ValidateCharacters(const ozz::options::Option& _option,
+                               int /*_argc*/) {
+  const ozz::options::IntOption& option =
+      static_cast<const ozz::options::IntOption&>(_option);
+  return option >= 1 && option <= 20000;
+}
+
+OZZ_OPTIONS_DECLARE_INT_FN(characters,
+                           "Number of characters in the crowd, in range "
+                           "[1,20000]",
+                           256, false, &ValidateCharacters)
+
+static bool ValidatePositive(const ozz::options::Option& _option,
+                             int /*_argc*/) {
+  const ozz::options::IntOption& option =
+      static_cast<const ozz::options::IntOption&>(_option);
+  return option >= 1;
+}
+
+OZZ_OPTIONS_DECLARE_INT_FN(frames, "Number of measured frames per thread count",
+                           120, false, &ValidatePositive)
+
+static bool ValidateThreads(const ozz::options::Option& _option,
+                            int /*_argc*/) {
+  const ozz::options::IntOption& option =
+      static_cast<const ozz::options::IntOption&>(_option);
+  return option >= 0;
+}
+
+OZZ_OPTIONS_DECLARE_INT_FN(threads,
+                           "Maximum number of threads. Crowd is updated with "
+                           "1, 2, 4... up to this number of threads. 0 selects "
+                           "hardware concurrency",
+                           0, false, &ValidateThreads)
+
+OZZ_OPTIONS_DECLARE_BOOL(ik, "Enables head look-at IK stage", true, false)
+
+OZZ_OPTIONS_DECLARE_BOOL(skinning, "Enables skinning stage", true, false)
+
+OZZ_OPTIONS_DECLARE_STRING(json, "Outputs results to a json file", "", false)
+
+namespace {
+
+// Animations blended by characters.
+const char* kAnimations[] = {"pab_walk.ozz", "pab_jog.ozz", "pab_run.ozz",
+                             "pab_crossarms.ozz"};
+const int kNumAnimations = OZZ_ARRAY_SIZE(kAnimations);
+
+// Number of blended layers per character.
+const int kNumLayers = 2;
+
+// Number of frames run before measuring, for each thread count.
+const int kWarmupFrames = 4;
+
+// Frame delta time, in seconds.
+const float kDeltaTime = 1.f / 60.f;
+
+// Number of characters processed by a thread each time it fetches work.
+const int kBatchSize = 8;
+
+// Update stages.
+enum Stage {
+  kSampling,
+  kBlending,
+  kLocalToModel,
+  kIK,
+  kSkinning,
+  kNumStages,
+};
+const char* kStageNames[kNumStages] = {"sampling", "blending",
+                                       "local_to_model", "ik", "skinning"};
+
+// Resources shared by all characters.
+struct Resources {
+  ozz::unique_ptr<ozz::animation::Skeleton> skeleton;
+  ozz::unique_ptr<ozz::animation::Animation> animations[kNumAnimations];
+  ozz::sample::Mesh mesh;
+  int head;
+};
+
+// Per character data. Allocated once, so no allocation happens while updating.
+struct Character {
+  int animations[kNumLayers];
+  float times[kNumLayers];
+  float phase;
+  ozz::animation::SamplingCache caches[kNumLayers];
+  ozz::vector<ozz::math::SoaTransform> layers_locals[kNumLayers];
+  ozz::vector<ozz::math::SoaTransform> locals;
+  ozz::vector<ozz::math::Float4x4> models;
+};
+
+// Per thread data. Aligned to avoid false sharing of timings, as they're
+// written for every character.
+struct alignas(64) Worker {
+  // Per stage accumulated time, in seconds.
+  double timings[kNumStages];
+  // Skinning buffers. Skinned vertices are consumed right away (by a renderer),
+  // so they can be shared by all characters updated by a thread.
+  ozz::vector<ozz::math::Float4x4> skinning_matrices;
+  ozz::vector<float> out_positions;
+  ozz::vector<float> out_normals;
+  ozz::vector<float> out_tangents;
+};
+
+// Deterministic character setup, from its index.
+void SetupCharacter(const Resources& _resources, int _index,
+                    Character* _character) {
+  const int num_soa_joints = _resources.skeleton->num_soa_joints();
+  const int num_joints = _resources.skeleton->num_joints();
+  uint32_t seed = static_cast<uint32_t>(_index) * 2654435761u + 1;
+  for (int i = 0; i < kNumLayers; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    _character->animations[i] = (_index + i * (1 + (seed >> 24) % 3)) %
+                                kNumAnimations;
+    _character->times[i] = (seed >> 8) * (1.f / 16777216.f);
+    _character->caches[i].Resize(num_joints);
+    _character->layers_locals[i].resize(num_soa_joints);
+  }
+  _character->phase = _index * .1f;
+  _character->locals.resize(num_soa_joints);
+  _character->models.resize(num_joints);
+}
+
+typedef std::chrono::steady_clock Clock;
+
+double Elapsed(Clock::time_point* _since) {
+  const Clock::time_point now = Clock::now();
+  const double elapsed = std::chrono::duration<double>(now - *_since).count();
+  *_since = now;
+  return elapsed;
+}
+
+// Updates a character for the frame _time, accumulating stage timings to
+// _worker.
+bool UpdateCharacter(const Resources& _resources, float _time,
+                     Character* _character, Worker* _worker) {
+  const ozz::animation::Skeleton& skeleton = *_resources.skeleton;
+  Clock::time_point time = Clock::now();
+
+  // Samples all layers.
+  for (int i = 0; i < kNumLayers; ++i) {
+    const ozz::animation::Animation& animation =
+        *_resources.animations[_character->animations[i]];
+    float& layer_time = _character->times[i];
+    layer_time = std::fmod(layer_time + kDeltaTime / animation.duration(), 1.f);
+
+    ozz::animation::SamplingJob sampling_job;
+    sampling_job.animation = &animation;
+    sampling_job.cache = &_character->caches[i];
+    sampling_job.ratio = layer_time;
+    sampling_job.output = make_span(_character->layers_locals[i]);
+    if (!sampling_job.Run()) {
+      return false;
+    }
+  }
+  _worker->timings[kSampling] += Elapsed(&time);
+
+  // Blends layers, with a weight that varies over time.
+  ozz::animation::BlendingJob::Layer layers[kNumLayers];
+  for (int i = 0; i < kNumLayers; ++i) {
+    layers[i].transform = make_span(_character->layers_locals[i]);
+    layers[i].weight =
+        .5f + std::sin(_time + _character->phase + i * 3.14159f) * .5f;
+  }
+  ozz::animation::BlendingJob blending_job;
+  blending_job.layers = layers;
+  blending_job.bind_pose = skeleton.joint_bind_poses();
+  blending_job.output = make_span(_character->locals);
+  if (!blending_job.Run()) {
+    return false;
+  }
+  _worker->timings[kBlending] += Elapsed(&time);
+
+  ozz::animation::LocalToModelJob ltm_job;
+  ltm_job.skeleton = &skeleton;
+  ltm_job.input = make_span(_character->locals);
+  ltm_job.output = make_span(_character->models);
+  if (!ltm_job.Run()) {
+    return false;
+  }
+  _worker->timings[kLocalToModel] += Elapsed(&time);
+
+  // Head looks at a moving target, then model-space matrices of the head and
+  // its children are updated.
+  if (OPTIONS_ik && _resources.head != -1) {
+    const float angle = _time + _character->phase;
+    const ozz::math::SimdFloat4 target = ozz::math::simd_float4::Load(
+        std::sin(angle), 1.5f, std::cos(angle) + 1.f, 0.f);
+    ozz::math::SimdQuaternion correction;
+    ozz::animation::IKAimJob ik_job;
+    ik_job.pole_vector = ozz::math::simd_float4::y_axis();
+    ik_job.forward = ozz::math::simd_float4::y_axis();
+    ik_job.up = ozz::math::simd_float4::x_axis();
+    ik_job.target = target;
+    ik_job.joint = &_character->models[_resources.head];
+    ik_job.joint_correction = &correction;
+    if (!ik_job.Run()) {
+      return false;
+    }
+    const ozz::animation::IKCorrectionJob::Correction corrections[] = {
+        {_resources.head, correction}};
+    ozz::animation::IKCorrectionJob correction_job;
+    correction_job.skeleton = &skeleton;
+    correction_job.corrections = corrections;
+    correction_job.models = make_span(_character->models);
+    correction_job.locals = make_span(_character->locals);
+    if (!correction_job.Run()) {
+      return false;
+    }
+    _worker->timings[kIK] += Elapsed(&time);
+  }
+
+  if (OPTIONS_skinning) {
+    const ozz::sample::Mesh& mesh = _resources.mesh;
+    for (int i = 0; i < mesh.num_joints(); ++i) {
+      _worker->skinning_matrices[i] =
+          _character->models[mesh.joint_remaps[i]] *
+          mesh.inverse_bind_poses[i];
+    }
+
+    size_t processed = 0;
+    for (size_t i = 0; i < mesh.parts.size(); ++i) {
+      const ozz::sample::Mesh::Part& part = mesh.parts[i];
+      const int part_vertex_count = part.vertex_count();
+      const int influences = part.influences_count();
+      if (part_vertex_count == 0) {
+        continue;
+      }
+      const size_t part_count = static_cast<size_t>(part_vertex_count) * 3;
+
+      ozz::geometry::SkinningJob skinning_job;
+      skinning_job.vertex_count = part_vertex_count;
+      skinning_job.influences_count = influences;
+      skinning_job.joint_matrices = make_span(_worker->skinning_matrices);
+      skinning_job.joint_indices = make_span(part.joint_indices);
+      skinning_job.joint_indices_stride = sizeof(uint16_t) * influences;
+      if (influences > 1) {
+        skinning_job.joint_weights = make_span(part.joint_weights);
+        skinning_job.joint_weights_stride = sizeof(float) * (influences - 1);
+      }
+      skinning_job.in_positions = make_span(part.positions);
+      skinning_job.in_positions_stride = sizeof(float) * 3;
+      skinning_job.out_positions = {_worker->out_positions.data() + processed,
+                                    part_count};
+      skinning_job.out_positions_stride = sizeof(float) * 3;
+      if (part.normals.size() == part.positions.size()) {
+        skinning_job.in_normals = make_span(part.normals);
+        skinning_job.in_normals_stride = sizeof(float) * 3;
+        skinning_job.out_normals = {_worker->out_normals.data() + processed,
+                                    part_count};
+        skinning_job.out_normals_stride = sizeof(float) * 3;
+        if (part.tangents.size() / 4 == part.positions.size() / 3) {
+          skinning_job.in_tangents = make_span(part.tangents);
+          skinning_job.in_tangents_stride = sizeof(float) * 4;
+          skinning_job.out_tangents = {
+              _worker->out_tangents.data() + processed, part_count};
+          skinning_job.out_tangents_stride = sizeof(float) * 3;
+        }
+      }
+      if (!skinning_job.Run()) {
+        return false;
+      }
+      processed += part_count;
+    }
+    _worker->timings[kSkinning] += Elapsed(&time);
+  }
+
+  return true;
+}
+
+// Minimal thread pool. Run() executes a task on all workers (including the
+// calling thread) and waits for all of them to complete.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int _num_threads)
+      : generation_(0), pending_(0), exit_(false) {
+    for (int i = 1; i < _num_threads; ++i) {
+      threads_.push_back(std::thread(&ThreadPool::Loop, this, i));
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      exit_ = true;
+    }
+    start_.notify_all();
+    for (size_t i = 0; i < threads_.size(); ++i) {
+      threads_[i].join();
+    }
+  }
+
+  void Run(const std::function<void(int)>& _task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_ = _task;
+      pending_ = static_cast<int>(threads_.size());
+      ++generation_;
+    }
+    start_.notify_all();
+
+    _task(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+  }
+
+ private:
+  void Loop(int _index) {
+    int generation = 0;
+    for (;;) {
+      std::function<void(int)> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock,
+                    [&] { return exit_ || generation_ != generation; });
+        if (exit_) {
+          return;
+        }
+        generation = generation_;
+        task = task_;
+      }
+      task(_index);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --pending_;
+      }
+      done_.notify_one();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  std::function<void(int)> task_;
+  int generation_;
+  int pending_;
+  bool exit_;
+  ozz::vector<std::thread> threads_;
+};
+
+// Percentiles of a set of timings, in milliseconds.
+struct Percentiles {
+  double p50;
+  double p90;
+  double p99;
+  double max;
+};
+
+Percentiles ComputePercentiles(ozz::vector<double> _samples) {
+  std::sort(_samples.begin(), _samples.end());
+  const size_t last = _samples.size() - 1;
+  Percentiles result;
+  result.p50 = _samples[last * 50 / 100] * 1e3;
+  result.p90 = _samples[last * 90 / 100] * 1e3;
+  result.p99 = _samples[last * 99 / 100] * 1e3;
+  result.max = _samples[last] * 1e3;
+  return result;
+}
+
+// Results for a given thread count.
+struct Result {
+  int threads;
+  Percentiles frame;
+  Percentiles stages[kNumStages];
+};
+
+void OutputPercentiles(const Percentiles& _percentiles,
+                       std::ostream& _stream) {
+  _stream << "{\"p50_ms\": " << _percentiles.p50
+          << ", \"p90_ms\": " << _percentiles.p90
+          << ", \"p99_ms\": " << _percentiles.p99
+          << ", \"max_ms\": " << _percentiles.max << "}";
+}
+
+void OutputJson(const ozz::vector<Result>& _results, std::ostream& _stream) {
+  char date[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  _stream << std::setprecision(6);
+  _stream << "{\n  \"context\": {\n";
+  _stream << "    \"date\": \"" << date << "\",\n";
+  _stream << "    \"simd\": \"" << ozz::math::SimdImplementationName()
+          << "\",\n";
+  _stream << "    \"build\": \""
+          << OZZ_IF_DEBUG("debug") OZZ_IF_NDEBUG("release") << "\",\n";
+  _stream << "    \"hardware_threads\": "
+          << std::thread::hardware_concurrency() << ",\n";
+  _stream << "    \"characters\": " << OPTIONS_characters.value() << ",\n";
+  _stream << "    \"frames\": " << OPTIONS_frames.value() << ",\n";
+  _stream << "    \"ik\": " << (OPTIONS_ik ? "true" : "false") << ",\n";
+  _stream << "    \"skinning\": " << (OPTIONS_skinning ? "true" : "false")
+          << "\n";
+  _stream << "  },\n  \"results\": [";
+  for (size_t i = 0; i < _results.size(); ++i) {
+    const Result& result = _results[i];
+    _stream << (i == 0 ? "\n" : ",\n") << "    {\n";
+    _stream << "      \"threads\": " << result.threads << ",\n";
+    _stream << "      \"speedup\": "
+            << _results[0].frame.p50 / result.frame.p50 << ",\n";
+    _stream << "      \"frame\": ";
+    OutputPercentiles(result.frame, _stream);
+    for (int s = 0; s < kNumStages; ++s) {
+      _stream << ",\n      \"" << kStageNames[s] << "\": ";
+      OutputPercentiles(result.stages[s], _stream);
+    }
+    _stream << "\n    }";
+  }
+  _stream << "\n  ]\n}\n";
+}
+
+bool LoadResources(Resources* _resources) {
+  _resources->skeleton =
+      ozz::benchmark::LoadMedia<ozz::animation::Skeleton>("pab_skeleton.ozz");
+  if (!_resources->skeleton) {
+    ozz::log::Err() << "Failed to load skeleton." << std::endl;
+    return false;
+  }
+  for (int i = 0; i < kNumAnimations; ++i) {
+    _resources->animations[i] =
+        ozz::benchmark::LoadMedia<ozz::animation::Animation>(kAnimations[i]);
+    if (!_resources->animations[i] ||
+        _resources->animations[i]->num_tracks() !=
+            _resources->skeleton->num_joints()) {
+      ozz::log::Err() << "Failed to load animation " << kAnimations[i] << "."
+                      << std::endl;
+      return false;
+    }
+  }
+  if (!ozz::benchmark::LoadArchive(
+          ozz::benchmark::MediaPath("arnaud_mesh.ozz").c_str(),
+          &_resources->mesh) ||
+      _resources->mesh.highest_joint_index() >=
+          _resources->skeleton->num_joints()) {
+    ozz::log::Err() << "Failed to load mesh." << std::endl;
+    return false;
+  }
+
+  _resources->head = -1;
+  const ozz::span<const char* const> names =
+      _resources->skeleton->joint_names();
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (std::strcmp(names[i], "Head") == 0) {
+      _resources->head = static_cast<int>(i);
+    }
+  }
+  return true;
+}
+}  // namespace
+
+int main(int _argc, const char** _argv) {
+  const char* usage =
+      "Measures frame times of a headless crowd update, for an increasing "
+      "number of threads.";
+  const ozz::options::ParseResult parse_result =
+      ozz::options::ParseCommandLine(_argc, _argv, "1.0", usage);
+  if (parse_result != ozz::options::kSuccess) {
+    return parse_result == ozz::options::kExitSuccess ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+  }
+
+  Resources resources;
+  if (!LoadResources(&resources)) {
+    return EXIT_FAILURE;
+  }
+
+  const int num_characters = OPTIONS_characters;
+  ozz::vector<Character> characters(num_characters);
+  for (int i = 0; i < num_characters; ++i) {
+    SetupCharacter(resources, i, &characters[i]);
+  }
+
+  // Lists thread counts: powers of 2 up to max_threads, plus max_threads.
+  const int max_threads =
+      OPTIONS_threads != 0
+          ? OPTIONS_threads.value()
+          : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  ozz::vector<int> thread_counts;
+  for (int count = 1; count < max_threads; count *= 2) {
+    thread_counts.push_back(count);
+  }
+  thread_counts.push_back(max_threads);
+
+  ozz::log::Out() << "Updating " << num_characters << " characters, "
+                  << OPTIONS_frames.value() << " frames." << std::endl;
+  ozz::log::Out() << std::setw(8) << "Threads" << std::setw(10) << "p50 (ms)"
+                  << std::setw(10) << "p90 (ms)" << std::setw(10) << "p99 (ms)"
+                  << std::setw(10) << "max (ms)" << std::setw(10) << "Speedup";
+  for (int s = 0; s < kNumStages; ++s) {
+    ozz::log::Out() << std::setw(16) << kStageNames[s];
+  }
+  ozz::log::Out() << std::endl;
+
+  bool success = true;
+  ozz::vector<Result> results;
+  for (size_t t = 0; t < thread_counts.size() && success; ++t) {
+    const int num_threads = thread_counts[t];
+    ozz::vector<Worker> workers(num_threads);
+    for (int w = 0; w < num_threads; ++w) {
+      Worker& worker = workers[w];
+      worker.skinning_matrices.resize(resources.mesh.num_joints());
+      worker.out_positions.resize(resources.mesh.vertex_count() * 3);
+      worker.out_normals.resize(resources.mesh.vertex_count() * 3);
+      worker.out_tangents.resize(resources.mesh.vertex_count() * 3);
+    }
+
+    ThreadPool pool(num_threads);
+    std::atomic<int> next(0);
+    std::atomic<bool> failed(false);
+    float time = 0.f;
+
+    const int num_frames = kWarmupFrames + OPTIONS_frames;
+    ozz::vector<double> frame_samples;
+    ozz::vector<double> stage_samples[kNumStages];
+    for (int f = 0; f < num_frames; ++f) {
+      for (int w = 0; w < num_threads; ++w) {
+        std::fill(workers[w].timings, workers[w].timings + kNumStages, 0.);
+      }
+      next = 0;
+      time += kDeltaTime;
+
+      Clock::time_point frame_start = Clock::now();
+      pool.Run([&](int _worker) {
+        Worker* worker = &workers[_worker];
+        for (;;) {
+          const int begin = next.fetch_add(kBatchSize);
+          if (begin >= num_characters) {
+            break;
+          }
+          const int end = std::min(begin + kBatchSize, num_characters);
+          for (int c = begin; c < end; ++c) {
+            if (!UpdateCharacter(resources, time, &characters[c], worker)) {
+              failed = true;
+            }
+          }
+        }
+      });
+      const double frame_time = Elapsed(&frame_start);
+
+      if (f < kWarmupFrames) {
+        continue;
+      }
+      frame_samples.push_back(frame_time);
+      for (int s = 0; s < kNumStages; ++s) {
+        double stage_time = 0.;
+        for (int w = 0; w < num_threads; ++w) {
+          stage_time += workers[w].timings[s];
+        }
+        stage_samples[s].push_back(stage_time);
+      }
+    }
+
+    if (failed) {
+      ozz::log::Err() << "Failed to update crowd." << std::endl;
+      success = false;
+      break;
+    }
+
+    Result result;
+    result.threads = num_threads;
+    result.frame = ComputePercentiles(frame_samples);
+    for (int s = 0; s < kNumStages; ++s) {
+      result.stages[s] = ComputePercentiles(stage_samples[s]);
+    }
+    results.push_back(result);
+
+    ozz::log::Out() << std::fixed << std::setprecision(3) << std::setw(8)
+                    << num_threads << std::setw(10) << result.frame.p50
+                    << std::setw(10) << result.frame.p90 << std::setw(10)
+                    << result.frame.p99 << std::setw(10) << result.frame.max
+                    << std::setw(10) << results[0].frame.p50 / result.frame.p50;
+    for (int s = 0; s < kNumStages; ++s) {
+      ozz::log::Out() << std::setw(16) << result.stages[s].p50;
+    }
+    ozz::log::Out() << std::defaultfloat << std::endl;
+  }
+
+  if (!success) {
+    return EXIT_FAILURE;
+  }
+
+  if (OPTIONS_json.value()[0] != 0) {
+    std::ofstream file(OPTIONS_json.value());
+    if (!file.is_open()) {
+      ozz::log::Err() << "Failed to open json output file \""
+                      << OPTIONS_json.value() << "\"." << std::endl;
+      return EXIT_FAILURE;
+    }
+    OutputJson(results, file);
+    ozz::log::Out() << "Results written to \"" << OPTIONS_json.value()
+                    << "\"." << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
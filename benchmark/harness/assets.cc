@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "harness/assets.h"
+
+#include "framework/mesh.h"
+#include "harness/generator.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/options/options.h"
+
+OZZ_OPTIONS_DECLARE_STRING(media, "Path to bundled media directory", "media",
+                           false)
+
+namespace ozz {
+namespace benchmark {
+
+ozz::string MediaPath(const char* _filename) {
+  ozz::string path = OPTIONS_media.value();
+  if (!path.empty() && path.back() != '/' && path.back() != '\\') {
+    path += '/';
+  }
+  return path + _filename;
+}
+
+ozz::unique_ptr<animation::Skeleton> BuildSyntheticSkeleton(int _num_joints) {
+  animation::offline::RawSkeleton raw_skeleton;
+  GenerateRawSkeleton(_num_joints, _num_joints, &raw_skeleton);
+
+  const animation::offline::SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+
+ozz::unique_ptr<animation::Animation> BuildSyntheticAnimation(
+    const animation::Skeleton& _skeleton, float _duration, float _frequency) {
+  animation::offline::RawAnimation raw_animation;
+  GenerateRawAnimation(_skeleton.num_joints(), _duration, _frequency, .01f,
+                       _skeleton.num_joints(), &raw_animation);
+
+  const animation::offline::AnimationBuilder builder;
+  return builder(raw_animation);
+}
+
+ozz::unique_ptr<animation::FloatTrack> BuildSyntheticFloatTrack(int _num_keys) {
+  animation::offline::RawFloatTrack raw_track;
+  GenerateRawFloatTrack(_num_keys, 1.f, _num_keys, &raw_track);
+
+  const animation::offline::TrackBuilder builder;
+  return builder(raw_track);
+}
+
+void BuildSyntheticMesh(int _num_vertices, int _influences, int _num_joints,
+                        sample::Mesh* _mesh) {
+  Random random(_num_vertices * _influences);
+
+  *_mesh = sample::Mesh();
+  _mesh->parts.resize(1);
+  sample::Mesh::Part& part = _mesh->parts[0];
+
+  for (int i = 0; i < _num_vertices; ++i) {
+    part.positions.push_back(random.NextFloat(-1.f, 1.f));
+    part.positions.push_back(random.NextFloat(0.f, 2.f));
+    part.positions.push_back(random.NextFloat(-1.f, 1.f));
+
+    const math::Float3 normal = Normalize(math::Float3(
+        random.NextFloat(-1.f, 1.f), random.NextFloat(-1.f, 1.f), 1.f));
+    part.normals.push_back(normal.x);
+    part.normals.push_back(normal.y);
+    part.normals.push_back(normal.z);
+
+    const math::Float3 tangent =
+        Normalize(Cross(normal, math::Float3::x_axis()));
+    part.tangents.push_back(tangent.x);
+    part.tangents.push_back(tangent.y);
+    part.tangents.push_back(tangent.z);
+    part.tangents.push_back(1.f);
+
+    // Weights are normalized, last one is restored by skinning job.
+    float remaining_weight = 1.f;
+    for (int j = 0; j < _influences; ++j) {
+      part.joint_indices.push_back(
+          static_cast<uint16_t>(random.NextInt() % _num_joints));
+      if (j != _influences - 1) {
+        const float weight = remaining_weight * random.NextFloat(.3f, .7f);
+        part.joint_weights.push_back(weight);
+        remaining_weight -= weight;
+      }
+    }
+  }
+
+  for (int i = 0; i < _num_joints; ++i) {
+    _mesh->joint_remaps.push_back(static_cast<uint16_t>(i));
+    _mesh->inverse_bind_poses.push_back(math::Float4x4::identity());
+  }
+}
+}  // namespace benchmark
+}  // namespace ozz
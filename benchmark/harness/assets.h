@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_BENCHMARK_HARNESS_ASSETS_H_
+#define OZZ_BENCHMARK_HARNESS_ASSETS_H_
+
+#include "ozz/base/containers/string.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+namespace ozz {
+namespace animation {
+class Animation;
+class Skeleton;
+class FloatTrack;
+}  // namespace animation
+namespace sample {
+struct Mesh;
+}
+namespace benchmark {
+
+// Builds the path of a bundled media file, located in the directory specified
+// by --media command line option.
+ozz::string MediaPath(const char* _filename);
+
+// Loads an object from an ozz archive file named _filename. Returns false if
+// the file cannot be opened or doesn't contain the expected object type.
+template <typename _Type>
+bool LoadArchive(const char* _filename, _Type* _object) {
+  ozz::io::File file(_filename, "rb");
+  if (!file.opened()) {
+    return false;
+  }
+  ozz::io::IArchive archive(&file);
+  if (!archive.TestTag<_Type>()) {
+    return false;
+  }
+  archive >> *_object;
+  return true;
+}
+
+// Loads a bundled media object, from --media directory. Returns an empty
+// pointer on failure.
+template <typename _Type>
+ozz::unique_ptr<_Type> LoadMedia(const char* _filename) {
+  ozz::unique_ptr<_Type> object = ozz::make_unique<_Type>();
+  if (!LoadArchive(MediaPath(_filename).c_str(), object.get())) {
+    object.reset();
+  }
+  return object;
+}
+
+// Synthetic assets builders, see generator.h. All of them are deterministic, as
+// they are built from a fixed seed.
+
+// Builds a skeleton of _num_joints joints. The hierarchy is made of a spine
+// from which chains of limbs branch, so that it's both deep and wide like
+// production rigs.
+ozz::unique_ptr<animation::Skeleton> BuildSyntheticSkeleton(int _num_joints);
+
+// Builds an animation for _skeleton, with keys sampled at _frequency during
+// _duration. Keys are noisy, so that no key is optimized away.
+ozz::unique_ptr<animation::Animation> BuildSyntheticAnimation(
+    const animation::Skeleton& _skeleton, float _duration, float _frequency);
+
+// Builds a float track with _num_keys noisy linear keys.
+ozz::unique_ptr<animation::FloatTrack> BuildSyntheticFloatTrack(int _num_keys);
+
+// Builds a single part mesh of _num_vertices vertices, each influenced by
+// _influences joints (in range [0,_num_joints[). Mesh has normals and tangents.
+void BuildSyntheticMesh(int _num_vertices, int _influences, int _num_joints,
+                        sample::Mesh* _mesh);
+}  // namespace benchmark
+}  // namespace ozz
+#endif  // OZZ_BENCHMARK_HARNESS_ASSETS_H_
@@ -0,0 +1,323 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "harness/benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+#include "ozz/base/containers/string.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/log.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/options/options.h"
+
+OZZ_OPTIONS_DECLARE_STRING(filter,
+                           "Runs only benchmarks whose name matches this "
+                           "pattern (supports * and ? wildcards)",
+                           "*", false)
+
+OZZ_OPTIONS_DECLARE_FLOAT(min_time,
+                          "Minimum measurement time (in seconds) of each "
+                          "repetition",
+                          .1f, false)
+
+static bool ValidateRepetitions(const ozz::options::Option& _option,
+                                int /*_argc*/) {
+  const ozz::options::IntOption& option =
+      static_cast<const ozz::options::IntOption&>(_option);
+  return option >= 1;
+}
+
+OZZ_OPTIONS_DECLARE_INT_FN(repetitions,
+                           "Number of measurement repetitions, used to "
+                           "compute statistics",
+                           5, false, &ValidateRepetitions)
+
+OZZ_OPTIONS_DECLARE_BOOL(warmup,
+                         "Runs every benchmark once before measuring it", true,
+                         false)
+
+OZZ_OPTIONS_DECLARE_STRING(json, "Outputs results to a json file", "", false)
+
+OZZ_OPTIONS_DECLARE_BOOL(list, "Lists benchmarks and exits", false, false)
+
+namespace ozz {
+namespace benchmark {
+
+State::State(int _arg, double _min_time)
+    : arg_(_arg),
+      min_time_(_min_time),
+      remaining_(0),
+      batch_(0),
+      iterations_(0),
+      items_per_iteration_(0),
+      running_(false),
+      paused_(0.),
+      elapsed_(0.),
+      skipped_(nullptr) {}
+
+bool State::NextBatch() {
+  const Clock::time_point now = Clock::now();
+  if (!running_) {
+    // First call, starts measuring with a single iteration batch.
+    assert(iterations_ == 0 && "KeepRunning can't be called once it failed.");
+    running_ = true;
+    paused_ = 0.;
+    batch_ = 1;
+    remaining_ = batch_ - 1;
+    start_ = Clock::now();  // Reads the clock again, after setup.
+    return true;
+  }
+
+  iterations_ += batch_;
+  elapsed_ = std::chrono::duration<double>(now - start_).count() - paused_;
+  if (elapsed_ >= min_time_) {
+    running_ = false;
+    return false;
+  }
+
+  // Grows batch size, so that clock is rarely queried. The estimation of the
+  // remaining iteration count prevents from overshooting min_time too much.
+  const double per_iteration = elapsed_ / iterations_;
+  const double estimated =
+      per_iteration > 0. ? (min_time_ - elapsed_) / per_iteration : batch_;
+  batch_ = std::max<int64_t>(
+      1, std::min<int64_t>(batch_ * 2, static_cast<int64_t>(estimated) + 1));
+  remaining_ = batch_ - 1;
+  return true;
+}
+
+void State::PauseTiming() { pause_start_ = Clock::now(); }
+
+void State::ResumeTiming() {
+  paused_ +=
+      std::chrono::duration<double>(Clock::now() - pause_start_).count();
+}
+
+void State::Skip(const char* _reason) { skipped_ = _reason; }
+
+namespace {
+// Head of the intrusive list of registered benchmarks.
+Registrar*& RegistrarHead() {
+  static Registrar* head = nullptr;
+  return head;
+}
+
+// Per benchmark statistics, computed from all repetitions.
+struct Result {
+  ozz::string name;
+  const char* skipped;
+  int64_t iterations;
+  int64_t items_per_iteration;
+  double min;     // Nanoseconds per iteration.
+  double median;  // Nanoseconds per iteration.
+  double mean;    // Nanoseconds per iteration.
+  double max;     // Nanoseconds per iteration.
+  double stddev;  // Nanoseconds per iteration.
+};
+
+Result ComputeResult(const char* _name, ozz::vector<double>* _samples,
+                     int64_t _iterations, int64_t _items) {
+  Result result;
+  result.name = _name;
+  result.skipped = nullptr;
+  result.iterations = _iterations;
+  result.items_per_iteration = _items;
+
+  ozz::vector<double>& samples = *_samples;
+  std::sort(samples.begin(), samples.end());
+  const size_t count = samples.size();
+  result.min = samples.front();
+  result.max = samples.back();
+  result.median = (count & 1) ? samples[count / 2]
+                              : (samples[count / 2 - 1] + samples[count / 2]) *
+                                    .5;
+  double sum = 0.;
+  for (size_t i = 0; i < count; ++i) {
+    sum += samples[i];
+  }
+  result.mean = sum / count;
+  double variance = 0.;
+  for (size_t i = 0; i < count; ++i) {
+    variance += (samples[i] - result.mean) * (samples[i] - result.mean);
+  }
+  result.stddev = std::sqrt(variance / count);
+  return result;
+}
+
+void OutputJson(const ozz::vector<Result>& _results, std::ostream& _stream) {
+  char date[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  _stream << std::setprecision(9);
+  _stream << "{\n  \"context\": {\n";
+  _stream << "    \"date\": \"" << date << "\",\n";
+  _stream << "    \"executable\": \"" << ozz::options::ParsedExecutableName()
+          << "\",\n";
+  _stream << "    \"simd\": \"" << math::SimdImplementationName() << "\",\n";
+  _stream << "    \"build\": \""
+          << OZZ_IF_DEBUG("debug") OZZ_IF_NDEBUG("release") << "\",\n";
+  _stream << "    \"hardware_threads\": "
+          << std::thread::hardware_concurrency() << ",\n";
+  _stream << "    \"min_time\": " << OPTIONS_min_time.value() << ",\n";
+  _stream << "    \"repetitions\": " << OPTIONS_repetitions.value() << "\n";
+  _stream << "  },\n  \"benchmarks\": [";
+  for (size_t i = 0; i < _results.size(); ++i) {
+    const Result& result = _results[i];
+    _stream << (i == 0 ? "\n" : ",\n") << "    {\n";
+    _stream << "      \"name\": \"" << result.name << "\",\n";
+    if (result.skipped) {
+      _stream << "      \"skipped\": \"" << result.skipped << "\"\n    }";
+      continue;
+    }
+    _stream << "      \"iterations\": " << result.iterations << ",\n";
+    _stream << "      \"min_ns\": " << result.min << ",\n";
+    _stream << "      \"median_ns\": " << result.median << ",\n";
+    _stream << "      \"mean_ns\": " << result.mean << ",\n";
+    _stream << "      \"max_ns\": " << result.max << ",\n";
+    _stream << "      \"stddev_ns\": " << result.stddev;
+    if (result.items_per_iteration) {
+      _stream << ",\n      \"items_per_iteration\": "
+              << result.items_per_iteration << ",\n";
+      _stream << "      \"items_per_second\": "
+              << result.items_per_iteration * 1e9 / result.median;
+    }
+    _stream << "\n    }";
+  }
+  _stream << "\n  ]\n}\n";
+}
+}  // namespace
+
+Registrar::Registrar(const char* _name, Function _function, int _arg)
+    : name_(_name), function_(_function), arg_(_arg), next_(nullptr) {
+  // Appends to the list, so benchmarks are run in registration order.
+  Registrar** last = &RegistrarHead();
+  while (*last) {
+    last = &(*last)->next_;
+  }
+  *last = this;
+}
+
+int RunBenchmarks(int _argc, const char* const* _argv, const char* _usage) {
+  // Parses arguments.
+  ozz::options::ParseResult parse_result =
+      ozz::options::ParseCommandLine(_argc, _argv, "1.0", _usage);
+  if (parse_result != ozz::options::kSuccess) {
+    return parse_result == ozz::options::kExitSuccess ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+  }
+
+  if (OPTIONS_list) {
+    for (const Registrar* it = RegistrarHead(); it; it = it->next_) {
+      ozz::log::Out() << it->name_ << std::endl;
+    }
+    return EXIT_SUCCESS;
+  }
+
+  ozz::log::Out() << std::left << std::setw(48) << "Benchmark" << std::right
+                  << std::setw(14) << "Median (ns)" << std::setw(14)
+                  << "Min (ns)" << std::setw(12) << "Stddev" << std::setw(14)
+                  << "Items/s" << std::endl;
+
+  ozz::vector<Result> results;
+  for (const Registrar* it = RegistrarHead(); it; it = it->next_) {
+    if (!strmatch(it->name_, OPTIONS_filter)) {
+      continue;
+    }
+
+    // Warms up caches, lazy initialized assets...
+    if (OPTIONS_warmup) {
+      State state(it->arg_, OPTIONS_min_time * .1);
+      it->function_(state);
+    }
+
+    ozz::vector<double> samples;
+    int64_t iterations = 0;
+    int64_t items = 0;
+    const char* skipped = nullptr;
+    for (int i = 0; i < OPTIONS_repetitions && !skipped; ++i) {
+      State state(it->arg_, OPTIONS_min_time);
+      it->function_(state);
+      skipped = state.skipped();
+      if (!skipped) {
+        assert(state.iterations() > 0);
+        samples.push_back(state.elapsed() * 1e9 / state.iterations());
+        iterations += state.iterations();
+        items = state.items_per_iteration();
+      }
+    }
+
+    if (skipped) {
+      Result result;
+      result.name = it->name_;
+      result.skipped = skipped;
+      results.push_back(result);
+      ozz::log::Out() << std::left << std::setw(48) << it->name_
+                      << "skipped: " << skipped << std::endl;
+      continue;
+    }
+
+    const Result result = ComputeResult(it->name_, &samples, iterations, items);
+    results.push_back(result);
+
+    ozz::log::Out() << std::left << std::setw(48) << result.name << std::right
+                    << std::fixed << std::setprecision(1) << std::setw(14)
+                    << result.median << std::setw(14) << result.min
+                    << std::setw(12) << result.stddev << std::setw(14);
+    if (items) {
+      ozz::log::Out() << std::scientific << std::setprecision(3)
+                      << items * 1e9 / result.median;
+    } else {
+      ozz::log::Out() << "-";
+    }
+    ozz::log::Out() << std::defaultfloat << std::endl;
+  }
+
+  // Outputs json file.
+  if (OPTIONS_json.value()[0] != 0) {
+    std::ofstream file(OPTIONS_json.value());
+    if (!file.is_open()) {
+      ozz::log::Err() << "Failed to open json output file \""
+                      << OPTIONS_json.value() << "\"." << std::endl;
+      return EXIT_FAILURE;
+    }
+    OutputJson(results, file);
+    ozz::log::Out() << "Results written to \"" << OPTIONS_json.value()
+                    << "\"." << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
+}  // namespace benchmark
+}  // namespace ozz
@@ -0,0 +1,174 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_BENCHMARK_HARNESS_BENCHMARK_H_
+#define OZZ_BENCHMARK_HARNESS_BENCHMARK_H_
+
+#include <chrono>
+
+#include "ozz/base/platform.h"
+
+namespace ozz {
+namespace benchmark {
+
+// Benchmark execution state, given to every benchmark function. The function
+// prepares its data first, then loops while KeepRunning() returns true,
+// executing the code to measure once per iteration. Setup code executed before
+// the first call to KeepRunning() is not measured.
+// Iterations are executed in batches whose size grows until the requested
+// measurement time is reached. This way the clock is queried rarely, and its
+// cost doesn't pollute measurements of very short functions.
+class State {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  // Constructs a state that will run for at least _min_time seconds.
+  State(int _arg, double _min_time);
+
+  // Returns true while more iterations must be executed.
+  OZZ_INLINE bool KeepRunning() {
+    if (remaining_ != 0) {
+      --remaining_;
+      return true;
+    }
+    return NextBatch();
+  }
+
+  // Benchmark argument, as specified at registration time.
+  int arg() const { return arg_; }
+
+  // Pauses/resumes time measurement, to exclude per iteration setup code from
+  // the measure. Note that the cost of querying the clock remains.
+  void PauseTiming();
+  void ResumeTiming();
+
+  // Sets the number of items (joints, vertices, keys...) processed per
+  // iteration. Allows to report a throughput along with timings.
+  void set_items_per_iteration(int64_t _items) {
+    items_per_iteration_ = _items;
+  }
+  int64_t items_per_iteration() const { return items_per_iteration_; }
+
+  // Flags the benchmark as skipped, usually because an asset is missing. The
+  // benchmark function shall return without calling KeepRunning().
+  void Skip(const char* _reason);
+  const char* skipped() const { return skipped_; }
+
+  // Returns measured results, once KeepRunning() returned false.
+  int64_t iterations() const { return iterations_; }
+  double elapsed() const { return elapsed_; }  // In seconds.
+
+ private:
+  // Disables copy and assignation.
+  State(const State&);
+  void operator=(const State&);
+
+  // Slow path of KeepRunning, called at the end of every batch.
+  bool NextBatch();
+
+  // Benchmark argument.
+  int arg_;
+
+  // Minimum measurement duration, in seconds.
+  double min_time_;
+
+  // Number of iterations remaining in the current batch.
+  int64_t remaining_;
+
+  // Current batch size.
+  int64_t batch_;
+
+  // Number of iterations executed (and measured) so far.
+  int64_t iterations_;
+
+  // Items processed per iteration.
+  int64_t items_per_iteration_;
+
+  // Timing states.
+  bool running_;
+  Clock::time_point start_;
+  Clock::time_point pause_start_;
+  double paused_;
+  double elapsed_;
+
+  // Skipping reason, nullptr if benchmark isn't skipped.
+  const char* skipped_;
+};
+
+// Prototype of a benchmark function.
+typedef void (*Function)(State& _state);
+
+// Registers a benchmark function. Registrar objects are expected to be
+// statically allocated, see OZZ_BENCHMARK* macros below.
+class Registrar {
+ public:
+  Registrar(const char* _name, Function _function, int _arg = 0);
+
+ private:
+  friend int RunBenchmarks(int _argc, const char* const* _argv,
+                           const char* _usage);
+
+  const char* name_;
+  Function function_;
+  int arg_;
+
+  // Intrusive list of registered benchmarks.
+  Registrar* next_;
+};
+
+// Runs all registered benchmarks that match the command line filter, and
+// outputs results to the console and to a json file if requested.
+// Returns EXIT_SUCCESS if all benchmarks could run, EXIT_FAILURE otherwise.
+int RunBenchmarks(int _argc, const char* const* _argv, const char* _usage);
+
+// Prevents the compiler from optimizing away _value computation.
+template <typename _Ty>
+OZZ_INLINE void DoNotOptimize(const _Ty& _value) {
+#if defined(_MSC_VER)
+  const volatile char* sink = reinterpret_cast<const volatile char*>(&_value);
+  (void)*sink;
+#else
+  asm volatile("" : : "r,m"(_value) : "memory");
+#endif
+}
+
+#define OZZ_BENCHMARK_CONCAT_IMPL(_a, _b) _a##_b
+#define OZZ_BENCHMARK_CONCAT(_a, _b) OZZ_BENCHMARK_CONCAT_IMPL(_a, _b)
+
+// Registers _function benchmark, named after the function.
+#define OZZ_BENCHMARK(_function)                          \
+  static ozz::benchmark::Registrar OZZ_BENCHMARK_CONCAT( \
+      g_registrar_, __LINE__)(#_function, _function)
+
+// Registers _function benchmark with argument _arg. Benchmark is named
+// "function/arg".
+#define OZZ_BENCHMARK_ARG(_function, _arg)                \
+  static ozz::benchmark::Registrar OZZ_BENCHMARK_CONCAT( \
+      g_registrar_, __LINE__)(#_function "/" #_arg, _function, _arg)
+}  // namespace benchmark
+}  // namespace ozz
+#endif  // OZZ_BENCHMARK_HARNESS_BENCHMARK_H_
@@ -0,0 +1,157 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "harness/generator.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/base/maths/math_constant.h"
+#include "ozz/base/maths/math_ex.h"
+
+namespace ozz {
+namespace benchmark {
+
+namespace {
+// Appends a chain of _length joints to _parent.
+void AddChain(animation::offline::RawSkeleton::Joint* _parent, int _length,
+              int* _remaining, Random* _random) {
+  animation::offline::RawSkeleton::Joint* parent = _parent;
+  for (int i = 0; i < _length && *_remaining > 0; ++i, --*_remaining) {
+    parent->children.resize(parent->children.size() + 1);
+    animation::offline::RawSkeleton::Joint& joint = parent->children.back();
+    char name[16];
+    std::sprintf(name, "joint%d", *_remaining);
+    joint.name = name;
+    joint.transform = math::Transform::identity();
+    joint.transform.translation =
+        math::Float3(_random->NextFloat(-.02f, .02f), .1f,
+                     _random->NextFloat(-.02f, .02f));
+    parent = &joint;
+  }
+}
+}  // namespace
+
+void GenerateRawSkeleton(int _num_joints, uint32_t _seed,
+                         animation::offline::RawSkeleton* _skeleton) {
+  Random random(_seed);
+
+  *_skeleton = animation::offline::RawSkeleton();
+  int remaining = _num_joints;
+  if (remaining <= 0) {
+    return;
+  }
+
+  // Root joint is the first joint of the spine.
+  _skeleton->roots.resize(1);
+  animation::offline::RawSkeleton::Joint* spine = &_skeleton->roots[0];
+  spine->name = "root";
+  spine->transform = math::Transform::identity();
+  --remaining;
+
+  // Every spine joint has two limbs of 4 joints, before the next spine joint.
+  while (remaining > 0) {
+    AddChain(spine, 4, &remaining, &random);
+    AddChain(spine, 4, &remaining, &random);
+    const size_t next = spine->children.size();
+    AddChain(spine, 1, &remaining, &random);
+    if (spine->children.size() == next) {
+      break;
+    }
+    spine = &spine->children[next];
+  }
+}
+
+void GenerateRawAnimation(int _num_tracks, float _duration, float _frequency,
+                          float _noise, uint32_t _seed,
+                          animation::offline::RawAnimation* _animation) {
+  Random random(_seed);
+
+  *_animation = animation::offline::RawAnimation();
+  _animation->duration = _duration;
+  _animation->tracks.resize(_num_tracks);
+
+  const int num_keys = static_cast<int>(_duration * _frequency) + 1;
+  for (int i = 0; i < _num_tracks; ++i) {
+    animation::offline::RawAnimation::JointTrack& track =
+        _animation->tracks[i];
+    track.translations.reserve(num_keys);
+    track.rotations.reserve(num_keys);
+
+    // Every joint oscillates with its own phase and frequency.
+    const float phase = random.NextFloat(0.f, math::k2Pi);
+    const float pulsation = random.NextFloat(1.f, 6.f);
+    const math::Float3 axis =
+        Normalize(math::Float3(random.NextFloat(-1.f, 1.f),
+                               random.NextFloat(-1.f, 1.f), 1.f));
+    for (int k = 0; k < num_keys; ++k) {
+      const float time = math::Min(k / _frequency, _duration);
+      const float wave = std::sin(phase + pulsation * time);
+
+      const float height = .1f + wave * .01f;
+      const animation::offline::RawAnimation::TranslationKey tkey = {
+          time, math::Float3(random.NextFloat(-_noise, _noise),
+                             height + random.NextFloat(-_noise, _noise),
+                             random.NextFloat(-_noise, _noise))};
+      track.translations.push_back(tkey);
+
+      const float angle = wave * .5f + random.NextFloat(-_noise, _noise);
+      const animation::offline::RawAnimation::RotationKey rkey = {
+          time, math::Quaternion::FromAxisAngle(axis, angle)};
+      track.rotations.push_back(rkey);
+    }
+
+    // Scales are usually constant.
+    const animation::offline::RawAnimation::ScaleKey skey = {
+        0.f, math::Float3::one()};
+    track.scales.push_back(skey);
+  }
+}
+
+void GenerateRawFloatTrack(int _num_keys, float _noise, uint32_t _seed,
+                           animation::offline::RawFloatTrack* _track) {
+  Random random(_seed);
+
+  *_track = animation::offline::RawFloatTrack();
+  _track->keyframes.reserve(_num_keys);
+  for (int i = 0; i < _num_keys; ++i) {
+    const float ratio =
+        _num_keys > 1 ? static_cast<float>(i) / (_num_keys - 1) : 0.f;
+    const float value = std::sin(ratio * math::k2Pi * 4.f) *
+                            math::Max(0.f, 1.f - _noise) +
+                        random.NextFloat(-_noise, _noise);
+    const animation::offline::RawFloatTrack::Keyframe key = {
+        animation::offline::RawTrackInterpolation::kLinear, ratio, value};
+    _track->keyframes.push_back(key);
+  }
+}
+}  // namespace benchmark
+}  // namespace ozz
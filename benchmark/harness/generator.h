@@ -0,0 +1,93 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_BENCHMARK_HARNESS_GENERATOR_H_
+#define OZZ_BENCHMARK_HARNESS_GENERATOR_H_
+
+#include <cstdint>
+
+namespace ozz {
+namespace animation {
+namespace offline {
+struct RawSkeleton;
+struct RawAnimation;
+struct RawFloatTrack;
+}  // namespace offline
+}  // namespace animation
+namespace benchmark {
+
+// Deterministic synthetic content generators. Generated content only depends on
+// the arguments, including the _seed, so it's the same on every platform and
+// run. This allows to produce production scale content (hundreds of joints,
+// minutes long animations) that bundled media can't provide.
+
+// Deterministic pseudo random number generator (xorshift32).
+class Random {
+ public:
+  explicit Random(uint32_t _seed) : state_(_seed ? _seed : 0x9e3779b9) {}
+
+  uint32_t NextInt() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+  // Returns a float in range [_min,_max[.
+  float NextFloat(float _min = 0.f, float _max = 1.f) {
+    const float unit = (NextInt() >> 8) * (1.f / 16777216.f);
+    return _min + unit * (_max - _min);
+  }
+
+ private:
+  uint32_t state_;
+};
+
+// Generates a skeleton of _num_joints joints. The hierarchy is made of a spine
+// from which chains of limbs branch, so that it's both deep and wide like
+// production rigs.
+void GenerateRawSkeleton(int _num_joints, uint32_t _seed,
+                         animation::offline::RawSkeleton* _skeleton);
+
+// Generates an animation of _num_tracks tracks, with keys sampled at
+// _frequency during _duration. Joints oscillate smoothly, with an additional
+// random noise of amplitude _noise. Noise prevents keys from being optimized
+// away, a _noise of 0 produces smooth curves that optimize well.
+// Scales are constant.
+void GenerateRawAnimation(int _num_tracks, float _duration, float _frequency,
+                          float _noise, uint32_t _seed,
+                          animation::offline::RawAnimation* _animation);
+
+// Generates a linear float track with _num_keys keys, uniformly distributed
+// in [0,1] ratio range. Values are in range [-1,1], made of a sine wave and a
+// random noise of amplitude _noise (in range [0,1]).
+void GenerateRawFloatTrack(int _num_keys, float _noise, uint32_t _seed,
+                           animation::offline::RawFloatTrack* _track);
+}  // namespace benchmark
+}  // namespace ozz
+#endif  // OZZ_BENCHMARK_HARNESS_GENERATOR_H_
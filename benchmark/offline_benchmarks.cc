@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "harness/benchmark.h"
+#include "harness/generator.h"
+#include "ozz/animation/offline/animation_optimizer.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/offline/task_runner.h"
+#include "ozz/animation/offline/track_optimizer.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+// Benchmarks of ozz offline utilities, on synthetic assets. They are executed
+// by ozz_benchmarks along with runtime jobs benchmarks.
+
+using ozz::benchmark::State;
+using ozz::benchmark::DoNotOptimize;
+
+namespace {
+
+// Synthetic skeleton and raw animation used by offline benchmarks.
+struct RawRig {
+  RawRig() {
+    ozz::animation::offline::RawSkeleton raw_skeleton;
+    ozz::benchmark::GenerateRawSkeleton(64, 64, &raw_skeleton);
+    const ozz::animation::offline::SkeletonBuilder builder;
+    skeleton = builder(raw_skeleton);
+    ozz::benchmark::GenerateRawAnimation(64, 4.f, 60.f, .001f, 64,
+                                         &raw_animation);
+  }
+  ozz::unique_ptr<ozz::animation::Skeleton> skeleton;
+  ozz::animation::offline::RawAnimation raw_animation;
+};
+
+const RawRig& GetRawRig() {
+  static RawRig rig;
+  return rig;
+}
+
+// Optimizes a raw animation. Argument is the number of threads, 0 optimizes on
+// the calling thread without any task runner.
+void AnimationOptimizer(State& _state) {
+  const RawRig& rig = GetRawRig();
+  ozz::animation::offline::ThreadedTaskRunner runner(_state.arg());
+  ozz::animation::offline::AnimationOptimizer optimizer;
+  optimizer.task_runner = _state.arg() != 0 ? &runner : nullptr;
+
+  ozz::animation::offline::RawAnimation output;
+  _state.set_items_per_iteration(rig.raw_animation.num_tracks());
+  while (_state.KeepRunning()) {
+    optimizer(rig.raw_animation, *rig.skeleton, &output);
+    DoNotOptimize(output.tracks[0]);
+  }
+}
+OZZ_BENCHMARK_ARG(AnimationOptimizer, 0);
+OZZ_BENCHMARK_ARG(AnimationOptimizer, 1);
+OZZ_BENCHMARK_ARG(AnimationOptimizer, 4);
+
+// Benchmark argument selecting the decimation algorithm.
+ozz::animation::offline::DecimationAlgorithm Algorithm(int _arg) {
+  return _arg == 0 ? ozz::animation::offline::kRamerDouglasPeucker
+                   : ozz::animation::offline::kRamerDouglasPeuckerSimd;
+}
+
+// Optimizes a raw animation on the calling thread, with the decimation
+// algorithm selected by argument (0 for reference Ramer-Douglas-Peucker, 1 for
+// its SIMD implementation).
+void AnimationOptimizerAlgorithm(State& _state) {
+  const RawRig& rig = GetRawRig();
+  ozz::animation::offline::AnimationOptimizer optimizer;
+  optimizer.algorithm = Algorithm(_state.arg());
+
+  ozz::animation::offline::RawAnimation output;
+  _state.set_items_per_iteration(rig.raw_animation.num_tracks());
+  while (_state.KeepRunning()) {
+    optimizer(rig.raw_animation, *rig.skeleton, &output);
+    DoNotOptimize(output.tracks[0]);
+  }
+}
+OZZ_BENCHMARK_ARG(AnimationOptimizerAlgorithm, 0);
+OZZ_BENCHMARK_ARG(AnimationOptimizerAlgorithm, 1);
+
+// Optimizes a long dense float track (10 minutes at 60hz), with the
+// decimation algorithm selected by argument.
+void TrackOptimizer(State& _state) {
+  static ozz::animation::offline::RawFloatTrack input;
+  if (input.keyframes.empty()) {
+    ozz::benchmark::GenerateRawFloatTrack(36000, 1e-4f, 36000, &input);
+  }
+  ozz::animation::offline::TrackOptimizer optimizer;
+  optimizer.algorithm = Algorithm(_state.arg());
+
+  ozz::animation::offline::RawFloatTrack output;
+  _state.set_items_per_iteration(static_cast<int64_t>(input.keyframes.size()));
+  while (_state.KeepRunning()) {
+    optimizer(input, &output);
+    DoNotOptimize(output.keyframes[0]);
+  }
+}
+OZZ_BENCHMARK_ARG(TrackOptimizer, 0);
+OZZ_BENCHMARK_ARG(TrackOptimizer, 1);
+}  // namespace
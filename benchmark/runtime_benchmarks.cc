@@ -0,0 +1,1048 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include <cstdlib>
+#include <utility>
+
+#include "framework/mesh.h"
+#include "harness/assets.h"
+#include "harness/benchmark.h"
+#include "harness/generator.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/blending_job.h"
+#include "ozz/animation/runtime/event_track.h"
+#include "ozz/animation/runtime/event_track_query_job.h"
+#include "ozz/animation/runtime/ik_aim_job.h"
+#include "ozz/animation/runtime/ik_aim_soa_job.h"
+#include "ozz/animation/runtime/ik_chain_job.h"
+#include "ozz/animation/runtime/ik_correction_job.h"
+#include "ozz/animation/runtime/ik_two_bone_job.h"
+#include "ozz/animation/runtime/ik_two_bone_soa_job.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/model_space_query_job.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/offline/raw_event_track.h"
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/offline/track_edges_builder.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_bundle.h"
+#include "ozz/animation/runtime/track_edges.h"
+#include "ozz/animation/runtime/track_sampling_job.h"
+#include "ozz/animation/runtime/track_triggering_job.h"
+#include "ozz/base/containers/map.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/geometry/runtime/skinning_job.h"
+
+// Micro-benchmarks of ozz runtime jobs. Each benchmark measures a single job
+// execution per iteration, on bundled media assets (pab skeleton and
+// animations, arnaud mesh, robot track) and on synthetic assets of
+// configurable size.
+
+using ozz::benchmark::State;
+using ozz::benchmark::DoNotOptimize;
+
+namespace {
+
+// Benchmark argument selecting bundled media assets instead of synthetic ones.
+// Any other argument value is the number of joints of a synthetic rig.
+enum { kMedia = 0 };
+
+// Defines a skeleton and a set of animations to benchmark.
+struct Rig {
+  ozz::unique_ptr<ozz::animation::Skeleton> skeleton;
+  ozz::vector<ozz::unique_ptr<ozz::animation::Animation>> animations;
+};
+
+// Gets (lazily loads or builds) the rig matching _arg. Returns nullptr if
+// assets couldn't be loaded.
+const Rig* GetRig(int _arg) {
+  static ozz::map<int, Rig> rigs;
+  ozz::map<int, Rig>::iterator it = rigs.find(_arg);
+  if (it != rigs.end()) {
+    return it->second.skeleton ? &it->second : nullptr;
+  }
+
+  Rig& rig = rigs[_arg];
+  if (_arg == kMedia) {
+    rig.skeleton = ozz::benchmark::LoadMedia<ozz::animation::Skeleton>(
+        "pab_skeleton.ozz");
+    const char* animations[] = {"pab_walk.ozz", "pab_jog.ozz", "pab_run.ozz",
+                                "pab_crossarms.ozz"};
+    for (size_t i = 0; i < OZZ_ARRAY_SIZE(animations); ++i) {
+      ozz::unique_ptr<ozz::animation::Animation> animation =
+          ozz::benchmark::LoadMedia<ozz::animation::Animation>(animations[i]);
+      if (!animation || !rig.skeleton ||
+          animation->num_tracks() != rig.skeleton->num_joints()) {
+        rig.skeleton.reset();
+        return nullptr;
+      }
+      rig.animations.push_back(std::move(animation));
+    }
+  } else {
+    rig.skeleton = ozz::benchmark::BuildSyntheticSkeleton(_arg);
+    if (!rig.skeleton) {
+      return nullptr;
+    }
+    rig.animations.push_back(ozz::benchmark::BuildSyntheticAnimation(
+        *rig.skeleton, 4.f, 30.f));
+    rig.animations.push_back(ozz::benchmark::BuildSyntheticAnimation(
+        *rig.skeleton, 2.f, 30.f));
+  }
+  return rig.skeleton ? &rig : nullptr;
+}
+
+const char* kMissingMedia = "media assets not found, see --media option";
+
+// Builds a deterministic table of pseudo random ratios.
+ozz::vector<float> RandomRatios(size_t _count) {
+  ozz::vector<float> ratios(_count);
+  uint32_t seed = 0x2545f491;
+  for (size_t i = 0; i < _count; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    ratios[i] = (seed >> 8) * (1.f / 16777216.f);
+  }
+  return ratios;
+}
+
+// Samples an animation forward at 60fps, looping.
+void SamplingForward(State& _state) {
+  const Rig* rig = GetRig(_state.arg());
+  if (!rig) {
+    return _state.Skip(kMissingMedia);
+  }
+  const ozz::animation::Animation& animation = *rig->animations[0];
+  ozz::animation::SamplingCache cache(animation.num_tracks());
+  ozz::vector<ozz::math::SoaTransform> locals(animation.num_soa_tracks());
+
+  ozz::animation::SamplingJob job;
+  job.animation = &animation;
+  job.cache = &cache;
+  job.output = make_span(locals);
+
+  const float step = 1.f / (60.f * animation.duration());
+  float ratio = 0.f;
+  _state.set_items_per_iteration(animation.num_tracks());
+  while (_state.KeepRunning()) {
+    ratio += step;
+    ratio -= ratio > 1.f ? 1.f : 0.f;
+    job.ratio = ratio;
+    job.Run();
+    DoNotOptimize(locals[0]);
+  }
+}
+OZZ_BENCHMARK_ARG(SamplingForward, kMedia);
+OZZ_BENCHMARK_ARG(SamplingForward, 64);
+OZZ_BENCHMARK_ARG(SamplingForward, 256);
+OZZ_BENCHMARK_ARG(SamplingForward, 1024);
+
+// Samples an animation at random ratios, which defeats cache forward
+// optimization.
+void SamplingRandomSeek(State& _state) {
+  const Rig* rig = GetRig(_state.arg());
+  if (!rig) {
+    return _state.Skip(kMissingMedia);
+  }
+  const ozz::animation::Animation& animation = *rig->animations[0];
+  ozz::animation::SamplingCache cache(animation.num_tracks());
+  ozz::vector<ozz::math::SoaTransform> locals(animation.num_soa_tracks());
+  const ozz::vector<float> ratios = RandomRatios(1024);
+
+  ozz::animation::SamplingJob job;
+  job.animation = &animation;
+  job.cache = &cache;
+  job.output = make_span(locals);
+
+  size_t i = 0;
+  _state.set_items_per_iteration(animation.num_tracks());
+  while (_state.KeepRunning()) {
+    job.ratio = ratios[i++ & 1023];
+    job.Run();
+    DoNotOptimize(locals[0]);
+  }
+}
+OZZ_BENCHMARK_ARG(SamplingRandomSeek, kMedia);
+OZZ_BENCHMARK_ARG(SamplingRandomSeek, 1024);
+
+// Alternates sampling at the end and at the beginning of the animation, which
+// is what happens every time a looping animation wraps around. Every second
+// sampling invalidates the cache.
+void SamplingLoop(State& _state) {
+  const Rig* rig = GetRig(_state.arg());
+  if (!rig) {
+    return _state.Skip(kMissingMedia);
+  }
+  const ozz::animation::Animation& animation = *rig->animations[0];
+  ozz::animation::SamplingCache cache(animation.num_tracks());
+  ozz::vector<ozz::math::SoaTransform> locals(animation.num_soa_tracks());
+
+  ozz::animation::SamplingJob job;
+  job.animation = &animation;
+  job.cache = &cache;
+  job.output = make_span(locals);
+
+  const float ratios[2] = {.99f, .01f};
+  size_t i = 0;
+  _state.set_items_per_iteration(animation.num_tracks());
+  while (_state.KeepRunning()) {
+    job.ratio = ratios[i++ & 1];
+    job.Run();
+    DoNotOptimize(locals[0]);
+  }
+}
+OZZ_BENCHMARK_ARG(SamplingLoop, kMedia);
+OZZ_BENCHMARK_ARG(SamplingLoop, 1024);
+
+// Prepares blending layers inputs, sampling rig animations at different
+// ratios.
+struct BlendingSetup {
+  BlendingSetup(const Rig& _rig, int _num_layers, bool _masked) {
+    const int num_soa_joints = _rig.skeleton->num_soa_joints();
+    ozz::animation::SamplingCache cache(_rig.skeleton->num_joints());
+    locals.resize(_num_layers);
+    weights.resize(_num_layers);
+    layers.resize(_num_layers);
+    for (int i = 0; i < _num_layers; ++i) {
+      locals[i].resize(num_soa_joints);
+
+      ozz::animation::SamplingJob sampling;
+      sampling.animation = _rig.animations[i % _rig.animations.size()].get();
+      sampling.cache = &cache;
+      sampling.ratio = static_cast<float>(i) / _num_layers;
+      sampling.output = make_span(locals[i]);
+      sampling.Run();
+
+      layers[i].transform = make_span(locals[i]);
+      layers[i].weight = 1.f / (i + 1);
+      if (_masked) {
+        // Half of the joints are masked out.
+        weights[i].resize(num_soa_joints);
+        for (int j = 0; j < num_soa_joints; ++j) {
+          weights[i][j] = ozz::math::simd_float4::Load1(
+              ((i + j) & 1) ? 0.f : .5f + .5f / (i + 1));
+        }
+        layers[i].joint_weights = make_span(weights[i]);
+      }
+    }
+    output.resize(num_soa_joints);
+  }
+
+  ozz::vector<ozz::vector<ozz::math::SoaTransform>> locals;
+  ozz::vector<ozz::vector<ozz::math::SimdFloat4>> weights;
+  ozz::vector<ozz::animation::BlendingJob::Layer> layers;
+  ozz::vector<ozz::math::SoaTransform> output;
+};
+
+void Blending(State& _state, bool _masked) {
+  const Rig* rig = GetRig(kMedia);
+  if (!rig) {
+    return _state.Skip(kMissingMedia);
+  }
+  BlendingSetup setup(*rig, _state.arg(), _masked);
+
+  ozz::animation::BlendingJob job;
+  job.layers = make_span(setup.layers);
+  job.bind_pose = rig->skeleton->joint_bind_poses();
+  job.output = make_span(setup.output);
+
+  _state.set_items_per_iteration(rig->skeleton->num_joints());
+  while (_state.KeepRunning()) {
+    job.Run();
+    DoNotOptimize(setup.output[0]);
+  }
+}
+
+// Blends _state.arg() layers, without joint masks.
+void BlendingLayers(State& _state) { Blending(_state, false); }
+OZZ_BENCHMARK_ARG(BlendingLayers, 1);
+OZZ_BENCHMARK_ARG(BlendingLayers, 2);
+OZZ_BENCHMARK_ARG(BlendingLayers, 4);
+OZZ_BENCHMARK_ARG(BlendingLayers, 8);
+
+// Blends _state.arg() layers, with per-joint weights.
+void BlendingMasked(State& _state) { Blending(_state, true); }
+OZZ_BENCHMARK_ARG(BlendingMasked, 2);
+OZZ_BENCHMARK_ARG(BlendingMasked, 4);
+OZZ_BENCHMARK_ARG(BlendingMasked, 8);
+
+// Converts a full skeleton from local to model-space.
+void LocalToModel(State& _state) {
+  const Rig* rig = GetRig(_state.arg());
+  if (!rig) {
+    return _state.Skip(kMissingMedia);
+  }
+  const ozz::animation::Skeleton& skeleton = *rig->skeleton;
+  ozz::vector<ozz::math::Float4x4> models(skeleton.num_joints());
+
+  ozz::animation::LocalToModelJob job;
+  job.skeleton = &skeleton;
+  job.input = skeleton.joint_bind_poses();
+  job.output = make_span(models);
+
+  _state.set_items_per_iteration(skeleton.num_joints());
+  while (_state.KeepRunning()) {
+    job.Run();
+    DoNotOptimize(models[0]);
+  }
+}
+OZZ_BENCHMARK_ARG(LocalToModel, kMedia);
+OZZ_BENCHMARK_ARG(LocalToModel, 64);
+OZZ_BENCHMARK_ARG(LocalToModel, 256);
+OZZ_BENCHMARK_ARG(LocalToModel, 1024);
+
+// Converts 3 joints of a skeleton (like both hands and head after IK) and
+// their ancestors from local to model-space, using LocalToModelJob mask.
+void LocalToModelMasked(State& _state) {
+  const Rig* rig = GetRig(_state.arg());
+  if (!rig) {
+    return _state.Skip(kMissingMedia);
+  }
+  const ozz::animation::Skeleton& skeleton = *rig->skeleton;
+  const int num_joints = skeleton.num_joints();
+  ozz::vector<ozz::math::Float4x4> models(num_joints);
+  ozz::vector<uint8_t> mask((num_joints + 7) / 8, 0);
+  const int joints[] = {num_joints / 3, num_joints * 2 / 3, num_joints - 1};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(joints); ++i) {
+    mask[joints[i] / 8] |= 1 << (joints[i] & 7);
+  }
+
+  ozz::animation::LocalToModelJob job;
+  job.skeleton = &skeleton;
+  job.input = skeleton.joint_bind_poses();
+  job.output = make_span(models);
+  job.mask = make_span(mask);
+
+  while (_state.KeepRunning()) {
+    job.Run();
+    DoNotOptimize(models[num_joints - 1]);
+  }
+}
+OZZ_BENCHMARK_ARG(LocalToModelMasked, kMedia);
+OZZ_BENCHMARK_ARG(LocalToModelMasked, 1024);
+
+// Updates incrementally a pose whose last 8 joints (like facial joints) local
+// transforms changed, using LocalToModelJob dirty flags.
+void LocalToModelDirty(State& _state) {
+  const Rig* rig = GetRig(_state.arg());
+  if (!rig) {
+    return _state.Skip(kMissingMedia);
+  }
+  const ozz::animation::Skeleton& skeleton = *rig->skeleton;
+  const int num_joints = skeleton.num_joints();
+  ozz::vector<ozz::math::Float4x4> models(num_joints);
+  ozz::vector<uint8_t> dirty((num_joints + 7) / 8, 0);
+  for (int i = ozz::math::Max(num_joints - 8, 0); i < num_joints; ++i) {
+    dirty[i / 8] |= 1 << (i & 7);
+  }
+
+  ozz::animation::LocalToModelJob job;
+  job.skeleton = &skeleton;
+  job.input = skeleton.joint_bind_poses();
+  job.output = make_span(models);
+  job.Run();  // Computes the whole pose once.
+  job.dirty = make_span(dirty);
+
+  while (_state.KeepRunning()) {
+    job.Run();
+    DoNotOptimize(models[num_joints - 1]);
+  }
+}
+OZZ_BENCHMARK_ARG(LocalToModelDirty, kMedia);
+OZZ_BENCHMARK_ARG(LocalToModelDirty, 1024);
+
+// Computes the model-space matrix of a single joint of an animated skeleton,
+// like an attachment point, either sampling the whole pose and converting it
+// with LocalToModelJob, or with ModelSpaceQueryJob. The queried joint is the
+// first one 8 levels deep (about a hand), or the deepest one. Animation is
+// sampled forward at 60fps.
+void JointQuery(State& _state, bool _query_job) {
+  const Rig* rig = GetRig(_state.arg());
+  if (!rig) {
+    return _state.Skip(kMissingMedia);
+  }
+  const ozz::animation::Skeleton& skeleton = *rig->skeleton;
+  const ozz::animation::Animation& animation = *rig->animations[0];
+  ozz::animation::SamplingCache cache(animation.num_tracks());
+  ozz::vector<ozz::math::SoaTransform> locals(animation.num_soa_tracks());
+  ozz::vector<ozz::math::Float4x4> models(skeleton.num_joints());
+
+  // Finds the queried joint.
+  const ozz::span<const int32_t>& parents = skeleton.joint_parents();
+  ozz::vector<int> depths(skeleton.num_joints());
+  int joint = 0;
+  for (int i = 0; i < skeleton.num_joints() && depths[joint] < 8; ++i) {
+    depths[i] = parents[i] == ozz::animation::Skeleton::kNoParent
+                    ? 0
+                    : depths[parents[i]] + 1;
+    joint = depths[i] > depths[joint] ? i : joint;
+  }
+
+  ozz::animation::SamplingJob sampling;
+  sampling.animation = &animation;
+  sampling.cache = &cache;
+  sampling.output = make_span(locals);
+
+  ozz::animation::LocalToModelJob ltm;
+  ltm.skeleton = &skeleton;
+  ltm.input = make_span(locals);
+  ltm.output = make_span(models);
+
+  ozz::animation::ModelSpaceQueryJob query;
+  query.animation = &animation;
+  query.cache = &cache;
+  query.skeleton = &skeleton;
+  query.joint = joint;
+  query.locals = make_span(locals);
+  query.output = &models[joint];
+
+  const float step = 1.f / (60.f * animation.duration());
+  float ratio = 0.f;
+  while (_state.KeepRunning()) {
+    ratio += step;
+    ratio -= ratio > 1.f ? 1.f : 0.f;
+    if (_query_job) {
+      query.ratio = ratio;
+      query.Run();
+    } else {
+      sampling.ratio = ratio;
+      sampling.Run();
+      ltm.Run();
+    }
+    DoNotOptimize(models[joint]);
+  }
+}
+
+void JointQuerySamplingLocalToModel(State& _state) {
+  JointQuery(_state, false);
+}
+OZZ_BENCHMARK_ARG(JointQuerySamplingLocalToModel, kMedia);
+OZZ_BENCHMARK_ARG(JointQuerySamplingLocalToModel, 1024);
+
+void JointQueryJob(State& _state) { JointQuery(_state, true); }
+OZZ_BENCHMARK_ARG(JointQueryJob, kMedia);
+OZZ_BENCHMARK_ARG(JointQueryJob, 1024);
+
+// Applies IK corrections to a chain of 4 joints, like a look-at from spine to
+// head, either multiplying local-space rotations and running LocalToModelJob
+// from the parent-iest corrected joint, or with IKCorrectionJob. The chain
+// starts from a root child and follows the children with the largest
+// hierarchy.
+void IKCorrections(State& _state, bool _correction_job) {
+  const Rig* rig = GetRig(_state.arg());
+  if (!rig) {
+    return _state.Skip(kMissingMedia);
+  }
+  const ozz::animation::Skeleton& skeleton = *rig->skeleton;
+  const int num_joints = skeleton.num_joints();
+  const ozz::span<const int32_t> parents = skeleton.joint_parents();
+  const ozz::span<const ozz::math::SoaTransform> bind_pose =
+      skeleton.joint_bind_poses();
+  ozz::vector<ozz::math::SoaTransform> locals(bind_pose.begin(),
+                                              bind_pose.end());
+  ozz::vector<ozz::math::Float4x4> models(num_joints);
+
+  ozz::animation::LocalToModelJob ltm_job;
+  ltm_job.skeleton = &skeleton;
+  ltm_job.input = make_span(locals);
+  ltm_job.output = make_span(models);
+  ltm_job.Run();
+
+  // Computes hierarchy sizes, and selects the chain.
+  ozz::vector<int> sizes(num_joints, 1);
+  for (int i = num_joints - 1; i > 0; --i) {
+    if (parents[i] != ozz::animation::Skeleton::kNoParent) {
+      sizes[parents[i]] += sizes[i];
+    }
+  }
+  ozz::animation::IKCorrectionJob::Correction corrections[4];
+  int num_corrections = 0;
+  for (int parent = 0; num_corrections < 4; ++num_corrections) {
+    int largest = -1;
+    for (int i = parent + 1; i < num_joints && parents[i] >= parent; ++i) {
+      if (parents[i] == parent &&
+          (largest == -1 || sizes[i] > sizes[largest])) {
+        largest = i;
+      }
+    }
+    if (largest == -1) {
+      break;
+    }
+    corrections[num_corrections].joint = parent = largest;
+    corrections[num_corrections].rotation =
+        ozz::math::SimdQuaternion::FromAxisAngle(
+            ozz::math::simd_float4::y_axis(),
+            ozz::math::simd_float4::Load1(1e-3f));
+  }
+  const ozz::span<const ozz::animation::IKCorrectionJob::Correction> applied =
+      {corrections, corrections + num_corrections};
+
+  ozz::animation::IKCorrectionJob job;
+  job.skeleton = &skeleton;
+  job.corrections = applied;
+  job.models = make_span(models);
+
+  _state.set_items_per_iteration(sizes[applied[0].joint]);
+  while (_state.KeepRunning()) {
+    if (_correction_job) {
+      job.Run();
+    } else {
+      for (const ozz::animation::IKCorrectionJob::Correction& correction :
+           applied) {
+        ozz::math::SoaTransform& soa_transform = locals[correction.joint / 4];
+        ozz::math::SimdQuaternion aos_quats[4];
+        ozz::math::Transpose4x4(&soa_transform.rotation.x, &aos_quats->xyzw);
+        aos_quats[correction.joint & 3] =
+            aos_quats[correction.joint & 3] * correction.rotation;
+        ozz::math::Transpose4x4(&aos_quats->xyzw, &soa_transform.rotation.x);
+      }
+      ltm_job.from = applied[0].joint;
+      ltm_job.Run();
+    }
+    DoNotOptimize(models[applied[0].joint]);
+  }
+}
+
+void IKCorrectionLocalToModel(State& _state) { IKCorrections(_state, false); }
+OZZ_BENCHMARK_ARG(IKCorrectionLocalToModel, kMedia);
+OZZ_BENCHMARK_ARG(IKCorrectionLocalToModel, 1024);
+
+void IKCorrection(State& _state) { IKCorrections(_state, true); }
+OZZ_BENCHMARK_ARG(IKCorrection, kMedia);
+OZZ_BENCHMARK_ARG(IKCorrection, 1024);
+
+// Solves CCD IK on a curled chain of _state.arg() joints, with default
+// iterations count and tolerance. Target is reachable, at half the chain
+// length.
+void IKChain(State& _state) {
+  const int num_joints = _state.arg();
+  ozz::vector<ozz::math::Float4x4> models(num_joints);
+  ozz::vector<int> joints(num_joints);
+  ozz::math::Float4x4 model = ozz::math::Float4x4::identity();
+  const ozz::math::Float4x4 local =
+      ozz::math::Float4x4::Translation(ozz::math::simd_float4::y_axis()) *
+      ozz::math::Float4x4::FromAxisAngle(ozz::math::simd_float4::z_axis(),
+                                         ozz::math::simd_float4::Load1(.1f));
+  for (int i = 0; i < num_joints; ++i) {
+    models[i] = model;
+    joints[i] = i;
+    model = model * local;
+  }
+  ozz::vector<ozz::animation::IKCorrectionJob::Correction> corrections(
+      num_joints - 1);
+
+  ozz::animation::IKChainJob job;
+  job.target = ozz::math::simd_float4::Load(num_joints * .3f,
+                                            num_joints * .4f, 0.f, 0.f);
+  job.joints = make_span(joints);
+  job.models = make_span(models);
+  job.corrections = make_span(corrections);
+
+  _state.set_items_per_iteration(num_joints);
+  while (_state.KeepRunning()) {
+    job.Run();
+    DoNotOptimize(corrections[0]);
+  }
+}
+OZZ_BENCHMARK_ARG(IKChain, 8);
+OZZ_BENCHMARK_ARG(IKChain, 32);
+OZZ_BENCHMARK_ARG(IKChain, 64);
+
+// Skinning vertex attributes.
+enum SkinningAttributes { kPositions, kNormals, kTangents };
+
+// Skins all parts of _mesh, returns the number of vertices processed.
+struct SkinningSetup {
+  SkinningSetup(const ozz::sample::Mesh& _mesh, SkinningAttributes _attributes)
+      : mesh(_mesh) {
+    matrices.resize(_mesh.num_joints(), ozz::math::Float4x4::identity());
+    for (size_t i = 0; i < matrices.size(); ++i) {
+      matrices[i].cols[3] = ozz::math::simd_float4::Load(
+          i * .01f, i * -.01f, i * .02f, 1.f);
+    }
+    vertex_count = _mesh.vertex_count();
+    out_positions.resize(vertex_count * 3);
+    out_normals.resize(vertex_count * 3);
+    out_tangents.resize(vertex_count * 3);
+
+    int processed = 0;
+    for (size_t i = 0; i < _mesh.parts.size(); ++i) {
+      const ozz::sample::Mesh::Part& part = _mesh.parts[i];
+      const int part_vertex_count = part.vertex_count();
+      const int influences = part.influences_count();
+      if (part_vertex_count == 0) {
+        continue;
+      }
+
+      ozz::geometry::SkinningJob job;
+      job.vertex_count = part_vertex_count;
+      job.influences_count = influences;
+      job.joint_matrices = make_span(matrices);
+      job.joint_indices = make_span(part.joint_indices);
+      job.joint_indices_stride = sizeof(uint16_t) * influences;
+      if (influences > 1) {
+        job.joint_weights = make_span(part.joint_weights);
+        job.joint_weights_stride = sizeof(float) * (influences - 1);
+      }
+      job.in_positions = make_span(part.positions);
+      job.in_positions_stride = sizeof(float) * 3;
+      job.out_positions = {out_positions.data() + processed * 3,
+                           static_cast<size_t>(part_vertex_count * 3)};
+      job.out_positions_stride = sizeof(float) * 3;
+      if (_attributes >= kNormals &&
+          part.normals.size() == part.positions.size()) {
+        job.in_normals = make_span(part.normals);
+        job.in_normals_stride = sizeof(float) * 3;
+        job.out_normals = {out_normals.data() + processed * 3,
+                           static_cast<size_t>(part_vertex_count * 3)};
+        job.out_normals_stride = sizeof(float) * 3;
+        if (_attributes >= kTangents &&
+            part.tangents.size() / 4 == part.positions.size() / 3) {
+          job.in_tangents = make_span(part.tangents);
+          job.in_tangents_stride = sizeof(float) * 4;
+          job.out_tangents = {out_tangents.data() + processed * 3,
+                              static_cast<size_t>(part_vertex_count * 3)};
+          job.out_tangents_stride = sizeof(float) * 3;
+        }
+      }
+      jobs.push_back(job);
+      processed += part_vertex_count;
+    }
+  }
+
+  void Run() const {
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      jobs[i].Run();
+    }
+  }
+
+  const ozz::sample::Mesh& mesh;
+  int vertex_count;
+  ozz::vector<ozz::math::Float4x4> matrices;
+  ozz::vector<float> out_positions;
+  ozz::vector<float> out_normals;
+  ozz::vector<float> out_tangents;
+  ozz::vector<ozz::geometry::SkinningJob> jobs;
+};
+
+void Skinning(State& _state, SkinningAttributes _attributes) {
+  ozz::sample::Mesh mesh;
+  ozz::benchmark::BuildSyntheticMesh(10000, _state.arg(), 64, &mesh);
+  const SkinningSetup setup(mesh, _attributes);
+
+  _state.set_items_per_iteration(setup.vertex_count);
+  while (_state.KeepRunning()) {
+    setup.Run();
+    DoNotOptimize(setup.out_positions[0]);
+  }
+}
+
+// Skins 10000 synthetic vertices with _state.arg() influences.
+void SkinningPositions(State& _state) { Skinning(_state, kPositions); }
+OZZ_BENCHMARK_ARG(SkinningPositions, 1);
+OZZ_BENCHMARK_ARG(SkinningPositions, 2);
+OZZ_BENCHMARK_ARG(SkinningPositions, 3);
+OZZ_BENCHMARK_ARG(SkinningPositions, 4);
+OZZ_BENCHMARK_ARG(SkinningPositions, 8);
+
+void SkinningNormals(State& _state) { Skinning(_state, kNormals); }
+OZZ_BENCHMARK_ARG(SkinningNormals, 1);
+OZZ_BENCHMARK_ARG(SkinningNormals, 4);
+OZZ_BENCHMARK_ARG(SkinningNormals, 8);
+
+void SkinningTangents(State& _state) { Skinning(_state, kTangents); }
+OZZ_BENCHMARK_ARG(SkinningTangents, 1);
+OZZ_BENCHMARK_ARG(SkinningTangents, 4);
+OZZ_BENCHMARK_ARG(SkinningTangents, 8);
+
+// Skins bundled arnaud mesh, with all its attributes.
+void SkinningMedia(State& _state) {
+  ozz::sample::Mesh mesh;
+  if (!ozz::benchmark::LoadArchive(
+          ozz::benchmark::MediaPath("arnaud_mesh.ozz").c_str(), &mesh)) {
+    return _state.Skip(kMissingMedia);
+  }
+  const SkinningSetup setup(mesh, kTangents);
+
+  _state.set_items_per_iteration(setup.vertex_count);
+  while (_state.KeepRunning()) {
+    setup.Run();
+    DoNotOptimize(setup.out_positions[0]);
+  }
+}
+OZZ_BENCHMARK(SkinningMedia);
+
+// Samples a float track forward, _state.arg() being the number of keys of a
+// synthetic track, or kMedia for the bundled robot track.
+void TrackSamplingForward(State& _state) {
+  ozz::unique_ptr<ozz::animation::FloatTrack> track =
+      _state.arg() == kMedia
+          ? ozz::benchmark::LoadMedia<ozz::animation::FloatTrack>(
+                "robot_track_grasp.ozz")
+          : ozz::benchmark::BuildSyntheticFloatTrack(_state.arg());
+  if (!track) {
+    return _state.Skip(kMissingMedia);
+  }
+
+  float result;
+  ozz::animation::FloatTrackSamplingJob job;
+  job.track = track.get();
+  job.result = &result;
+
+  float ratio = 0.f;
+  while (_state.KeepRunning()) {
+    ratio += 1.f / 600.f;
+    ratio -= ratio > 1.f ? 1.f : 0.f;
+    job.ratio = ratio;
+    job.Run();
+    DoNotOptimize(result);
+  }
+}
+OZZ_BENCHMARK_ARG(TrackSamplingForward, kMedia);
+OZZ_BENCHMARK_ARG(TrackSamplingForward, 16);
+OZZ_BENCHMARK_ARG(TrackSamplingForward, 1024);
+OZZ_BENCHMARK_ARG(TrackSamplingForward, 65536);
+
+// Samples a float track forward, using a cache. _state.arg() is the number of
+// keys of a synthetic track, or kMedia for the bundled robot track.
+void TrackSamplingForwardCached(State& _state) {
+  ozz::unique_ptr<ozz::animation::FloatTrack> track =
+      _state.arg() == kMedia
+          ? ozz::benchmark::LoadMedia<ozz::animation::FloatTrack>(
+                "robot_track_grasp.ozz")
+          : ozz::benchmark::BuildSyntheticFloatTrack(_state.arg());
+  if (!track) {
+    return _state.Skip(kMissingMedia);
+  }
+
+  float result;
+  ozz::animation::TrackSamplingCache cache;
+  ozz::animation::FloatTrackSamplingJob job;
+  job.track = track.get();
+  job.cache = &cache;
+  job.result = &result;
+
+  float ratio = 0.f;
+  while (_state.KeepRunning()) {
+    ratio += 1.f / 600.f;
+    ratio -= ratio > 1.f ? 1.f : 0.f;
+    job.ratio = ratio;
+    job.Run();
+    DoNotOptimize(result);
+  }
+}
+OZZ_BENCHMARK_ARG(TrackSamplingForwardCached, kMedia);
+OZZ_BENCHMARK_ARG(TrackSamplingForwardCached, 16);
+OZZ_BENCHMARK_ARG(TrackSamplingForwardCached, 1024);
+OZZ_BENCHMARK_ARG(TrackSamplingForwardCached, 65536);
+
+// Number of float tracks sampled by TrackSamplingTracks and
+// TrackSamplingBundle benchmarks, _state.arg() being the number of keys.
+const int kBundleTracks = 40;
+
+void BuildSyntheticRawFloatTracks(
+    int _num_keys, ozz::vector<ozz::animation::offline::RawFloatTrack>* _raws) {
+  _raws->resize(kBundleTracks);
+  for (int i = 0; i < kBundleTracks; ++i) {
+    ozz::benchmark::GenerateRawFloatTrack(_num_keys, 1.f, i, &(*_raws)[i]);
+  }
+}
+
+// Samples kBundleTracks float tracks, one job per track.
+void TrackSamplingTracks(State& _state) {
+  ozz::vector<ozz::animation::offline::RawFloatTrack> raws;
+  BuildSyntheticRawFloatTracks(_state.arg(), &raws);
+  const ozz::animation::offline::TrackBuilder builder;
+  ozz::vector<ozz::unique_ptr<ozz::animation::FloatTrack>> tracks;
+  for (const ozz::animation::offline::RawFloatTrack& raw : raws) {
+    tracks.push_back(builder(raw));
+  }
+
+  float results[kBundleTracks];
+  ozz::animation::FloatTrackSamplingJob job;
+
+  float ratio = 0.f;
+  _state.set_items_per_iteration(kBundleTracks);
+  while (_state.KeepRunning()) {
+    ratio += 1.f / 600.f;
+    ratio -= ratio > 1.f ? 1.f : 0.f;
+    job.ratio = ratio;
+    for (int i = 0; i < kBundleTracks; ++i) {
+      job.track = tracks[i].get();
+      job.result = &results[i];
+      job.Run();
+    }
+    DoNotOptimize(results);
+  }
+}
+OZZ_BENCHMARK_ARG(TrackSamplingTracks, 16);
+OZZ_BENCHMARK_ARG(TrackSamplingTracks, 1024);
+
+// Samples kBundleTracks float tracks, built as a single bundle.
+void TrackSamplingBundle(State& _state) {
+  ozz::vector<ozz::animation::offline::RawFloatTrack> raws;
+  BuildSyntheticRawFloatTracks(_state.arg(), &raws);
+  const ozz::animation::offline::TrackBuilder builder;
+  ozz::unique_ptr<ozz::animation::FloatTrackBundle> bundle =
+      builder(ozz::make_span(raws));
+
+  float results[kBundleTracks];
+  ozz::animation::FloatTrackBundleSamplingJob job;
+  job.bundle = bundle.get();
+  job.output = ozz::make_span(results);
+
+  float ratio = 0.f;
+  _state.set_items_per_iteration(kBundleTracks);
+  while (_state.KeepRunning()) {
+    ratio += 1.f / 600.f;
+    ratio -= ratio > 1.f ? 1.f : 0.f;
+    job.ratio = ratio;
+    job.Run();
+    DoNotOptimize(results);
+  }
+}
+OZZ_BENCHMARK_ARG(TrackSamplingBundle, 16);
+OZZ_BENCHMARK_ARG(TrackSamplingBundle, 1024);
+
+// Queries edges of a synthetic float track with _state.arg() keys, for
+// consecutive 60fps frame ranges. Edges are optionally precomputed.
+void Triggering(State& _state, bool _precomputed) {
+  ozz::unique_ptr<ozz::animation::FloatTrack> track =
+      ozz::benchmark::BuildSyntheticFloatTrack(_state.arg());
+  const ozz::animation::offline::TrackEdgesBuilder edges_builder;
+  ozz::unique_ptr<ozz::animation::TrackEdges> edges =
+      edges_builder(*track, 0.f);
+
+  ozz::animation::TrackTriggeringJob::Iterator iterator;
+  ozz::animation::TrackTriggeringJob job;
+  job.track = track.get();
+  job.edges = _precomputed ? edges.get() : nullptr;
+  job.threshold = 0.f;
+  job.iterator = &iterator;
+
+  float ratio = 0.f;
+  while (_state.KeepRunning()) {
+    job.from = ratio;
+    ratio += 1.f / 600.f;
+    ratio -= ratio > 1.f ? 1.f : 0.f;
+    job.to = ratio;
+    job.Run();
+    for (const ozz::animation::TrackTriggeringJob::Iterator end = job.end();
+         iterator != end; ++iterator) {
+      DoNotOptimize(*iterator);
+    }
+  }
+}
+
+void TrackTriggering(State& _state) { Triggering(_state, false); }
+OZZ_BENCHMARK_ARG(TrackTriggering, 16);
+OZZ_BENCHMARK_ARG(TrackTriggering, 1024);
+
+void TrackTriggeringEdges(State& _state) { Triggering(_state, true); }
+OZZ_BENCHMARK_ARG(TrackTriggeringEdges, 16);
+OZZ_BENCHMARK_ARG(TrackTriggeringEdges, 1024);
+
+// Queries events of an event track with _state.arg() evenly spread events, for
+// consecutive 60fps frame ranges.
+void EventTrackQuery(State& _state) {
+  ozz::animation::offline::RawEventTrack raw_track;
+  for (int i = 0; i < _state.arg(); ++i) {
+    const ozz::animation::offline::RawEventTrack::Event event = {
+        static_cast<float>(i) / _state.arg(), static_cast<uint16_t>(i)};
+    raw_track.events.push_back(event);
+  }
+  const ozz::animation::offline::TrackBuilder builder;
+  ozz::unique_ptr<ozz::animation::EventTrack> track = builder(raw_track);
+
+  ozz::animation::EventTrackQueryJob::Iterator iterator;
+  ozz::animation::EventTrackQueryJob job;
+  job.track = track.get();
+  job.iterator = &iterator;
+
+  float ratio = 0.f;
+  while (_state.KeepRunning()) {
+    job.from = ratio;
+    ratio += 1.f / 600.f;
+    job.to = ratio;
+    job.Run();
+    for (const ozz::animation::EventTrackQueryJob::Iterator end = job.end();
+         iterator != end; ++iterator) {
+      DoNotOptimize(*iterator);
+    }
+    ratio -= ratio > 1.f ? 1.f : 0.f;
+  }
+}
+OZZ_BENCHMARK_ARG(EventTrackQuery, 16);
+OZZ_BENCHMARK_ARG(EventTrackQuery, 1024);
+
+// Solves a two-bone IK chain, for a set of targets.
+void IKTwoBone(State& _state) {
+  const ozz::math::Float4x4 start = ozz::math::Float4x4::identity();
+  const ozz::math::Float4x4 mid = ozz::math::Float4x4::Translation(
+      ozz::math::simd_float4::Load(0.f, 1.f, 0.f, 0.f));
+  const ozz::math::Float4x4 end = ozz::math::Float4x4::Translation(
+      ozz::math::simd_float4::Load(1.f, 1.f, 0.f, 0.f));
+  const ozz::vector<float> randoms = RandomRatios(3 * 64);
+
+  ozz::math::SimdQuaternion start_correction;
+  ozz::math::SimdQuaternion mid_correction;
+  bool reached;
+  ozz::animation::IKTwoBoneJob job;
+  job.start_joint = &start;
+  job.mid_joint = &mid;
+  job.end_joint = &end;
+  job.mid_axis = ozz::math::simd_float4::z_axis();
+  job.pole_vector = ozz::math::simd_float4::y_axis();
+  job.start_joint_correction = &start_correction;
+  job.mid_joint_correction = &mid_correction;
+  job.reached = &reached;
+
+  _state.set_items_per_iteration(1);
+  size_t i = 0;
+  while (_state.KeepRunning()) {
+    const float* target = &randoms[(i++ & 63) * 3];
+    job.target = ozz::math::simd_float4::Load(target[0] * 2.f, target[1] * 2.f,
+                                              target[2] * 2.f, 0.f);
+    job.Run();
+    DoNotOptimize(start_correction);
+    DoNotOptimize(mid_correction);
+  }
+}
+OZZ_BENCHMARK(IKTwoBone);
+
+// Loads 4 random targets, from 12 consecutive randoms, as a SoaFloat3.
+ozz::math::SoaFloat3 LoadSoaTargets(const float* _randoms, float _scale,
+                                    float _x, float _y) {
+  const ozz::math::SimdFloat4 scale = ozz::math::simd_float4::Load1(_scale);
+  const ozz::math::SoaFloat3 targets = {
+      ozz::math::simd_float4::Load(_randoms[0], _randoms[3], _randoms[6],
+                                   _randoms[9]) *
+              scale +
+          ozz::math::simd_float4::Load1(_x),
+      ozz::math::simd_float4::Load(_randoms[1], _randoms[4], _randoms[7],
+                                   _randoms[10]) *
+              scale +
+          ozz::math::simd_float4::Load1(_y),
+      ozz::math::simd_float4::Load(_randoms[2], _randoms[5], _randoms[8],
+                                   _randoms[11])};
+  return targets;
+}
+
+// Solves 4 two-bone IK chains at once (per iteration), for a set of targets.
+void IKTwoBoneSoa(State& _state) {
+  const ozz::math::SoaFloat4x4 start = ozz::math::SoaFloat4x4::identity();
+  ozz::math::SoaFloat4x4 mid = start;
+  mid.cols[3].y = ozz::math::simd_float4::one();
+  ozz::math::SoaFloat4x4 end = mid;
+  end.cols[3].x = ozz::math::simd_float4::one();
+  const ozz::vector<float> randoms = RandomRatios(12 * 64);
+
+  ozz::math::SoaQuaternion start_correction;
+  ozz::math::SoaQuaternion mid_correction;
+  ozz::math::SimdInt4 reached;
+  ozz::animation::IKTwoBoneSoaJob job;
+  job.start_joint = &start;
+  job.mid_joint = &mid;
+  job.end_joint = &end;
+  job.start_joint_correction = &start_correction;
+  job.mid_joint_correction = &mid_correction;
+  job.reached = &reached;
+
+  _state.set_items_per_iteration(4);
+  size_t i = 0;
+  while (_state.KeepRunning()) {
+    job.target = LoadSoaTargets(&randoms[(i++ & 63) * 12], 2.f, 0.f, 0.f);
+    job.Run();
+    DoNotOptimize(start_correction);
+    DoNotOptimize(mid_correction);
+  }
+}
+OZZ_BENCHMARK(IKTwoBoneSoa);
+
+// Solves an aim IK for a set of targets.
+void IKAim(State& _state) {
+  const ozz::math::Float4x4 joint = ozz::math::Float4x4::identity();
+  const ozz::vector<float> randoms = RandomRatios(3 * 64);
+
+  ozz::math::SimdQuaternion correction;
+  bool reached;
+  ozz::animation::IKAimJob job;
+  job.joint = &joint;
+  job.forward = ozz::math::simd_float4::x_axis();
+  job.up = ozz::math::simd_float4::y_axis();
+  job.offset = ozz::math::simd_float4::Load(0.f, .1f, 0.f, 0.f);
+  job.pole_vector = ozz::math::simd_float4::y_axis();
+  job.joint_correction = &correction;
+  job.reached = &reached;
+
+  _state.set_items_per_iteration(1);
+  size_t i = 0;
+  while (_state.KeepRunning()) {
+    const float* target = &randoms[(i++ & 63) * 3];
+    job.target = ozz::math::simd_float4::Load(
+        target[0] * 2.f + .5f, target[1] * 2.f - 1.f, target[2], 0.f);
+    job.Run();
+    DoNotOptimize(correction);
+  }
+}
+OZZ_BENCHMARK(IKAim);
+
+// Solves 4 aim IK at once (per iteration), for a set of targets.
+void IKAimSoa(State& _state) {
+  const ozz::math::SoaFloat4x4 joint = ozz::math::SoaFloat4x4::identity();
+  const ozz::vector<float> randoms = RandomRatios(12 * 64);
+
+  ozz::math::SoaQuaternion correction;
+  ozz::math::SimdInt4 reached;
+  ozz::animation::IKAimSoaJob job;
+  job.joint = &joint;
+  job.offset.y = ozz::math::simd_float4::Load1(.1f);
+  job.joint_correction = &correction;
+  job.reached = &reached;
+
+  _state.set_items_per_iteration(4);
+  size_t i = 0;
+  while (_state.KeepRunning()) {
+    job.target = LoadSoaTargets(&randoms[(i++ & 63) * 12], 2.f, .5f, -1.f);
+    job.Run();
+    DoNotOptimize(correction);
+  }
+}
+OZZ_BENCHMARK(IKAimSoa);
+}  // namespace
+
+int main(int _argc, const char** _argv) {
+  return ozz::benchmark::RunBenchmarks(
+      _argc, _argv,
+      "Micro-benchmarks of ozz runtime jobs, on bundled media and synthetic "
+      "assets.");
+}
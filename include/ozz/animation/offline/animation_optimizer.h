@@ -28,6 +28,7 @@
 #ifndef OZZ_OZZ_ANIMATION_OFFLINE_ANIMATION_OPTIMIZER_H_
 #define OZZ_OZZ_ANIMATION_OFFLINE_ANIMATION_OPTIMIZER_H_
 
+#include "ozz/animation/offline/decimation.h"
 #include "ozz/base/containers/map.h"
 
 namespace ozz {
@@ -40,6 +41,9 @@ namespace offline {
 // Forward declare offline animation type.
 struct RawAnimation;
 
+// Forward declare task runner type.
+class TaskRunner;
+
 // Defines the class responsible of optimizing an offline raw animation
 // instance. Optimization is performed using a key frame reduction technique. It
 // deciamtes redundant / interpolable key frames, within error tolerances given
@@ -96,6 +100,46 @@ class AnimationOptimizer {
   // Per joint override of optimization settings.
   typedef ozz::map<int, Setting> JointsSetting;
   JointsSetting joints_setting_override;
+
+  // Optimization modes.
+  enum Mode {
+    // Decimates every joint translation, rotation and scale track
+    // independently, with a tolerance and distance estimated from the joint
+    // hierarchy (see class description). This is the fastest mode.
+    kHierarchical,
+
+    // Greedily removes keyframes across all tracks, as long as the actual
+    // model-space error of all affected joints remains within their tolerance.
+    // Error is measured at setting distance from each joint, comparing
+    // optimized and original animations sampled at all original keyframe
+    // times. Interpolation is the same as the runtime one. Keyframes that
+    // generate the smallest error are removed first, and error of a keyframe
+    // is re-evaluated before its removal as it depends on previous removals.
+    // This mode removes more keyframes than kHierarchical, as it doesn't
+    // rely on conservative estimations, but it's much slower. Setting
+    // tolerance and distance are applied per joint, including overrides, and
+    // algorithm is ignored.
+    // Memory usage is also much higher, as reference and optimized model-space
+    // matrices of all joints are kept for all times, aka 128 bytes per joint
+    // per distinct keyframe time. A 10 minutes, 30Hz, 500 joints animation
+    // hence requires about 1.1GB, long animations might need to be split.
+    kModelSpace,
+  };
+
+  // Optimization mode, default is kHierarchical.
+  Mode mode;
+
+  // Keyframe reduction algorithm, see DecimationAlgorithm. Default is
+  // kRamerDouglasPeucker.
+  DecimationAlgorithm algorithm;
+
+  // Optional task runner used to optimize tracks concurrently. Once hierarchy
+  // specifications are computed, every joint translation, rotation and scale
+  // track is optimized independently. In kModelSpace mode, it's used to
+  // evaluate initial keyframes errors. Output is the same whatever the runner
+  // and its number of threads.
+  // Optimization is done on the calling thread if runner is nullptr (default).
+  TaskRunner* task_runner;
 };
 }  // namespace offline
 }  // namespace animation
@@ -0,0 +1,52 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_OFFLINE_DECIMATION_H_
+#define OZZ_OZZ_ANIMATION_OFFLINE_DECIMATION_H_
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+// Keyframe reduction algorithms, as used by AnimationOptimizer and
+// TrackOptimizer. Both are based on Ramer–Douglas–Peucker, which recursively
+// splits tracks at the keyframe that is the furthest from the interpolated
+// segment. They select the same keyframes.
+enum DecimationAlgorithm {
+  // Reference implementation, evaluating keyframes distance one at a time.
+  kRamerDouglasPeucker,
+
+  // Evaluates the distance of 4 keyframes at a time using SIMD instructions,
+  // which speeds up scanning long dense tracks, mostly multi-component ones
+  // (translations, rotations, scales). Distance computations are performed in
+  // the same order as the reference implementation, so output is the same.
+  kRamerDouglasPeuckerSimd,
+};
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_OFFLINE_DECIMATION_H_
@@ -0,0 +1,97 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_OFFLINE_JOINTS_SETTING_BUILDER_H_
+#define OZZ_OZZ_ANIMATION_OFFLINE_JOINTS_SETTING_BUILDER_H_
+
+#include "ozz/animation/offline/animation_optimizer.h"
+#include "ozz/base/maths/vec_float.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declare runtime skeleton type.
+class Skeleton;
+namespace offline {
+
+// Defines the class responsible of deriving AnimationOptimizer per joint
+// settings from skinned meshes. AnimationOptimizer::Setting::distance emulates
+// the effect of animation error on skinning. JointsSettingBuilder sets it, for
+// every joint, to the distance of the farthest vertex the joint influences,
+// weighted by influence. This way joints that only move small (or lightly
+// weighted) geometry, like fingers or facial joints, are optimized more
+// aggressively than joints that move big ones, without visible artifacts.
+// Error on descendants is still accounted for by the optimizer hierarchical
+// error propagation.
+class JointsSettingBuilder {
+ public:
+  // Initializes the builder with default settings.
+  JointsSettingBuilder();
+
+  // Skinned mesh description. Vertices are expected in skeleton bind pose
+  // model-space.
+  struct Mesh {
+    Mesh() : influences(0) {}
+
+    // Vertex positions.
+    span<const math::Float3> positions;
+
+    // Number of joints influencing each vertex.
+    int influences;
+
+    // Skeleton joint indices, "influences" per vertex.
+    span<const uint16_t> joint_indices;
+
+    // Joint weights, "influences" per vertex. An influence whose weight is
+    // zero or negative is ignored.
+    span<const float> joint_weights;
+  };
+
+  // Computes a setting for every joint of _skeleton, from _meshes skinned
+  // vertices.
+  // Returns true on success and fills _settings with an entry per joint, that
+  // can be assigned to AnimationOptimizer::joints_setting_override.
+  // Returns false and clears _settings if a mesh isn't valid: mismatching
+  // buffer sizes or joint indices out of skeleton range.
+  bool operator()(const Skeleton& _skeleton, const span<const Mesh>& _meshes,
+                  AnimationOptimizer::JointsSetting* _settings) const;
+
+  // Tolerance of the joints influencing at least a vertex, directly or through
+  // a descendant. Default is 1mm.
+  float tolerance;
+
+  // Setting of the joints that don't influence any vertex, nor any of their
+  // descendants. Their error isn't visible on skinned meshes, so a high
+  // tolerance can be used, unless they're used for attachments or IK. Default
+  // is AnimationOptimizer::Setting default (favoring quality).
+  AnimationOptimizer::Setting unskinned;
+};
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_OFFLINE_JOINTS_SETTING_BUILDER_H_
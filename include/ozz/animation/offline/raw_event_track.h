@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_OFFLINE_RAW_EVENT_TRACK_H_
+#define OZZ_OZZ_ANIMATION_OFFLINE_RAW_EVENT_TRACK_H_
+
+#include "ozz/base/containers/string.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/archive_traits.h"
+#include "ozz/base/platform.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+// Offline event track data structure. An event track is a sorted sequence of
+// discrete events (footsteps, sounds, visual effects...), each one being
+// defined by a ratio and a payload id:
+// - Ratio: As for other tracks, events are dated with a ratio between 0 (the
+// beginning of the track) and 1 (the end), instead of times.
+// - Id: A small user defined identifier, that can be used to index the
+// payload of the event (a sound, an effect...) in a user table.
+// As all other Raw data types, RawEventTrack isn't intended to be used at run
+// time. It is converted to the runtime EventTrack using the
+// ozz::animation::offline::TrackBuilder.
+// RawEventTrack structure exposes a Validate() function to check that all the
+// following rules are respected:
+// 1. Events' ratios are sorted in ascending order. Multiple events can share
+// the same ratio.
+// 2. Events' ratios are all within [0,1] range.
+// RawEventTrack that would fail this validation will fail to be converted by
+// the TrackBuilder.
+struct RawEventTrack {
+  // Event data structure.
+  struct Event {
+    float ratio;
+    uint16_t id;
+  };
+
+  // Validates that all the following rules are respected:
+  //  1. Events' ratios are sorted in ascending order.
+  //  2. Events' ratios are all within [0,1] range.
+  bool Validate() const;
+
+  // Serialization functions.
+  // Should not be called directly but through io::Archive << and >> operators.
+  void Save(io::OArchive& _archive) const;
+  void Load(io::IArchive& _archive, uint32_t _version);
+
+  // Sequence of events, expected to be sorted.
+  typedef ozz::vector<Event> Events;
+  Events events;
+
+  // Name of the track.
+  string name;
+};
+}  // namespace offline
+}  // namespace animation
+
+namespace io {
+OZZ_IO_TYPE_VERSION(1, animation::offline::RawEventTrack)
+OZZ_IO_TYPE_TAG("ozz-raw_event_track", animation::offline::RawEventTrack)
+}  // namespace io
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_OFFLINE_RAW_EVENT_TRACK_H_
@@ -46,16 +46,27 @@ struct RawTrackInterpolation {
     kStep,    // All values following this key, up to the next key, are equal.
     kLinear,  // All value between this key and the next are linearly
               // interpolated.
+    kCubic,   // All value between this key and the next are interpolated
+              // with a cubic Hermite curve, using this key out tangent and
+              // the next key in tangent.
   };
 };
 
 // Keyframe data structure.
+// Tangents are only used by kCubic interpolation: out_tangent is used by the
+// curve starting at this key, in_tangent by the curve ending at this key.
+// They're derivatives of the value relatively to the ratio, aka the same
+// definition as glTF cubic spline tangents, expressed in ratio rather than
+// time. Bezier control points convert to tangents as out_tangent = 3 * (p1 -
+// p0) / (r1 - r0) and in_tangent = 3 * (p3 - p2) / (r1 - r0).
 template <typename _ValueType>
 struct RawTrackKeyframe {
   typedef _ValueType ValueType;
   RawTrackInterpolation::Value interpolation;
   float ratio;
   ValueType value;
+  ValueType in_tangent;
+  ValueType out_tangent;
 };
 
 namespace internal {
@@ -77,7 +88,8 @@ namespace internal {
 // with.
 // - Value: The animated value (float, ... float4, quaternion).
 // - Interpolation mode (`ozz::animation::offline::RawTrackInterpolation`):
-// Defines how value is interpolated with the next key. Track structure is then
+// Defines how value is interpolated with the next key. kCubic interpolation
+// also uses keys tangents. Track structure is then
 // a sorted vector of keyframes. RawTrack structure exposes a Validate()
 // function to check that all the following rules are respected:
 // 1. Keyframes' ratios are sorted in a strict ascending order.
@@ -0,0 +1,103 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_OFFLINE_SKELETON_MERGER_H_
+#define OZZ_OZZ_ANIMATION_OFFLINE_SKELETON_MERGER_H_
+
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/memory/unique_ptr.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declares the runtime skeleton type.
+class Skeleton;
+
+namespace offline {
+
+// Forward declares the offline animation type.
+struct RawAnimation;
+
+// Defines the class responsible of merging skeletons, for example the body,
+// head and gears of a modular character, into a single skeleton. Each part's
+// root joints are attached as children of a joint of another part (or become
+// roots of the merged skeleton). Part animations can then be merged too, so
+// that the whole character is processed by a single SamplingJob and a single
+// LocalToModelJob, instead of one per part and manual attachments composition.
+// Part roots local transforms (bind pose and animation) are expressed in their
+// attachment joint space, hence defining attachments offset.
+class SkeletonMerger {
+ public:
+  // Defines a skeleton to merge.
+  struct Part {
+    Part();
+
+    // The skeleton of the part. Can't be nullptr.
+    const Skeleton* skeleton;
+
+    // Index of the part this part is attached to, in the parts range. It must
+    // be lower than this part's index, hence the first part can't be
+    // attached. Skeleton::kNoParent means that part's roots are merged
+    // skeleton roots.
+    int parent;
+
+    // Index of the joint of the parent part skeleton this part's roots are
+    // attached to. Unused if part isn't attached.
+    int joint;
+  };
+
+  // Joint indices remapping table of a part, from the part skeleton joint
+  // index to the merged skeleton joint index.
+  typedef ozz::vector<int> JointRemap;
+
+  // Merges _parts skeletons into a single skeleton.
+  // Returns the merged skeleton on success and fills _remaps with a joint
+  // remapping table per part. Joints are sorted depth-first, attached parts
+  // being added after the attachment joint's own children.
+  // Returns an empty unique_ptr and clears _remaps on failure, which happens
+  // if _parts is empty, a skeleton is nullptr, an attachment is invalid or the
+  // total number of joints exceeds Skeleton::kMaxJoints.
+  ozz::unique_ptr<Skeleton> operator()(const span<const Part>& _parts,
+                                       ozz::vector<JointRemap>* _remaps) const;
+
+  // Merges _animations, one per part (in the same order as _parts), into a
+  // single animation matching the merged skeleton.
+  // An animation can be nullptr, in which case its part joints tracks are set
+  // to their bind pose. Animations must all have the same duration, and a
+  // track per joint of their part skeleton.
+  // Returns true on success and fills _output. Returns false and resets
+  // _output to an empty animation on failure.
+  bool operator()(const span<const Part>& _parts,
+                  const span<const JointRemap>& _remaps,
+                  const span<const RawAnimation* const>& _animations,
+                  RawAnimation* _output) const;
+};
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_OFFLINE_SKELETON_MERGER_H_
@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_OFFLINE_TASK_RUNNER_H_
+#define OZZ_OZZ_ANIMATION_OFFLINE_TASK_RUNNER_H_
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+// Defines a unit of work that can be executed concurrently by a TaskRunner.
+// Execute function is called once for every index in range [0, count[, in any
+// order and from any thread. Executing an index must hence not depend on the
+// execution of any other index.
+class Task {
+ public:
+  virtual ~Task() {}
+  virtual void Execute(int _index) const = 0;
+};
+
+// Defines the interface used by offline utilities (like AnimationOptimizer) to
+// distribute independent units of work. This interface allows users to plug
+// their own job system. Run function shall execute _task for all indices in
+// range [0, _count[ and return only once they are all completed.
+class TaskRunner {
+ public:
+  virtual ~TaskRunner() {}
+  virtual void Run(int _count, const Task& _task) = 0;
+};
+
+// Default TaskRunner implementation, executing tasks on a set of threads that
+// live for the duration of a Run call. Indices are distributed dynamically to
+// threads, so that work is balanced even if task durations vary.
+class ThreadedTaskRunner : public TaskRunner {
+ public:
+  // Initializes runner with _num_threads threads, including the calling one.
+  // 0 means as many threads as hardware concurrency.
+  explicit ThreadedTaskRunner(int _num_threads = 0);
+
+  virtual void Run(int _count, const Task& _task);
+
+  // Returns the number of threads used, including the calling one.
+  int num_threads() const { return num_threads_; }
+
+ private:
+  int num_threads_;
+};
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_OFFLINE_TASK_RUNNER_H_
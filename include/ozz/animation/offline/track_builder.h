@@ -29,6 +29,7 @@
 #define OZZ_OZZ_ANIMATION_OFFLINE_TRACK_BUILDER_H_
 
 #include "ozz/base/memory/unique_ptr.h"
+#include "ozz/base/span.h"
 
 namespace ozz {
 namespace animation {
@@ -39,6 +40,13 @@ class Float2Track;
 class Float3Track;
 class Float4Track;
 class QuaternionTrack;
+class FloatTrackBundle;
+class EventTrack;
+class CompressedFloatTrack;
+class CompressedFloat2Track;
+class CompressedFloat3Track;
+class CompressedFloat4Track;
+class CompressedQuaternionTrack;
 
 namespace offline {
 
@@ -48,6 +56,7 @@ struct RawFloat2Track;
 struct RawFloat3Track;
 struct RawFloat4Track;
 struct RawQuaternionTrack;
+struct RawEventTrack;
 
 // Defines the class responsible of building runtime track instances from
 // offline tracks.The input raw track is first validated. Runtime conversion of
@@ -67,9 +76,47 @@ class TrackBuilder {
   ozz::unique_ptr<QuaternionTrack> operator()(
       const RawQuaternionTrack& _input) const;
 
+  // Creates a compressed track based on _input. Keyframe ratios are quantized
+  // on 16 bits, values on 8 or 16 bits per component: 8 bits are used if the
+  // maximum error, sampling the compressed track at all _input keyframe
+  // ratios, is below _tolerance, 16 bits otherwise. Error is measured the same
+  // way as TrackOptimizer does, a distance for float values and
+  // 1 - cos(angle / 2) for quaternions. Keyframes whose quantized ratios are
+  // the same are merged to the last of them, which is the only one sampled.
+  // Returns a track instance on success, an empty unique_ptr on failure. See
+  // Raw*Track::Validate() for more details about failure reasons. Compression
+  // also fails if _input has cubic keys, which aren't supported.
+  ozz::unique_ptr<CompressedFloatTrack> operator()(const RawFloatTrack& _input,
+                                                   float _tolerance) const;
+  ozz::unique_ptr<CompressedFloat2Track> operator()(
+      const RawFloat2Track& _input, float _tolerance) const;
+  ozz::unique_ptr<CompressedFloat3Track> operator()(
+      const RawFloat3Track& _input, float _tolerance) const;
+  ozz::unique_ptr<CompressedFloat4Track> operator()(
+      const RawFloat4Track& _input, float _tolerance) const;
+  ozz::unique_ptr<CompressedQuaternionTrack> operator()(
+      const RawQuaternionTrack& _input, float _tolerance) const;
+
+  // Creates a FloatTrackBundle from all _inputs tracks, in order. Bundle
+  // keyframe ratios are the union of all inputs ratios, every input track
+  // being sampled at each of them.
+  // Returns a bundle instance on success, an empty unique_ptr on failure if any
+  // of the input tracks isn't valid or has cubic keys. See
+  // RawFloatTrack::Validate() for more details about failure reasons.
+  ozz::unique_ptr<FloatTrackBundle> operator()(
+      const span<const RawFloatTrack>& _inputs) const;
+
+  // Creates an EventTrack based on _input events.
+  // Returns a track instance on success, an empty unique_ptr on failure. See
+  // RawEventTrack::Validate() for more details about failure reasons.
+  ozz::unique_ptr<EventTrack> operator()(const RawEventTrack& _input) const;
+
  private:
   template <typename _RawTrack, typename _Track>
   ozz::unique_ptr<_Track> Build(const _RawTrack& _input) const;
+  template <typename _RawTrack, typename _Track>
+  ozz::unique_ptr<_Track> Compress(const _RawTrack& _input,
+                                   float _tolerance) const;
 };
 }  // namespace offline
 }  // namespace animation
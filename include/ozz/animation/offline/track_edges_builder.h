@@ -0,0 +1,59 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_OFFLINE_TRACK_EDGES_BUILDER_H_
+#define OZZ_OZZ_ANIMATION_OFFLINE_TRACK_EDGES_BUILDER_H_
+
+#include "ozz/base/memory/unique_ptr.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declares the runtime types.
+class FloatTrack;
+class TrackEdges;
+
+namespace offline {
+
+// Defines the class responsible of building runtime TrackEdges instances, the
+// precomputed edges of a FloatTrack for a given threshold. Edges are detected
+// by the TrackTriggeringJob over a single loop of the track, so TrackEdges
+// yield exactly the same edges as processing the track itself.
+class TrackEdgesBuilder {
+ public:
+  // Creates TrackEdges from _track edges crossing _threshold value.
+  // Returns a TrackEdges instance on success, an empty unique_ptr on failure.
+  // Building can only fail if _track is invalid (empty track).
+  // The instance is returned as an unique_ptr as ownership is given back to the
+  // caller.
+  ozz::unique_ptr<TrackEdges> operator()(const FloatTrack& _track,
+                                         float _threshold) const;
+};
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_OFFLINE_TRACK_EDGES_BUILDER_H_
@@ -28,6 +28,8 @@
 #ifndef OZZ_OZZ_ANIMATION_OFFLINE_TRACK_OPTIMIZER_H_
 #define OZZ_OZZ_ANIMATION_OFFLINE_TRACK_OPTIMIZER_H_
 
+#include "ozz/animation/offline/decimation.h"
+
 namespace ozz {
 namespace animation {
 namespace offline {
@@ -44,6 +46,9 @@ struct RawQuaternionTrack;
 // keyframes (within a tolerance value) are removed from the track. Default
 // optimization tolerances are set in order to favor quality over runtime
 // performances and memory footprint.
+// Optionally, float tracks can be fitted with cubic Hermite curves, which
+// represents smooth (usually densely sampled) tracks with far less keys than
+// linear interpolation.
 class TrackOptimizer {
  public:
   // Initializes the optimizer with default tolerances (favoring quality).
@@ -64,6 +69,16 @@ class TrackOptimizer {
 
   // Optimization tolerance.
   float tolerance;
+
+  // Keyframe reduction algorithm, see DecimationAlgorithm. Default is
+  // kRamerDouglasPeucker.
+  DecimationAlgorithm algorithm;
+
+  // Fits float tracks with cubic (RawTrackInterpolation::kCubic) keys instead
+  // of removing linear keys. Curves tangents are estimated from input keys,
+  // and every curve is extended over as many input keys as tolerance allows.
+  // Step keys are preserved. Ignored for quaternion tracks. Default is false.
+  bool fit_curves;
 };
 }  // namespace offline
 }  // namespace animation
@@ -130,7 +130,7 @@ class Animation {
 }  // namespace animation
 
 namespace io {
-OZZ_IO_TYPE_VERSION(6, animation::Animation)
+OZZ_IO_TYPE_VERSION(7, animation::Animation)
 OZZ_IO_TYPE_TAG("ozz-animation", animation::Animation)
 }  // namespace io
 }  // namespace ozz
@@ -0,0 +1,194 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_COMPRESSED_TRACK_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_COMPRESSED_TRACK_H_
+
+#include "ozz/base/io/archive_traits.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+#include "ozz/base/maths/quaternion.h"
+#include "ozz/base/maths/vec_float.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declares the TrackBuilder, used to instantiate a CompressedTrack.
+namespace offline {
+class TrackBuilder;
+}
+
+namespace internal {
+
+// Number of quantized components per value type. Quaternions only store their
+// 3 smallest components, the largest one being restored from quaternion
+// normalization property.
+template <typename _ValueType>
+struct CompressedTrackComponents;
+template <>
+struct CompressedTrackComponents<float> {
+  enum { kCount = 1 };
+};
+template <>
+struct CompressedTrackComponents<math::Float2> {
+  enum { kCount = 2 };
+};
+template <>
+struct CompressedTrackComponents<math::Float3> {
+  enum { kCount = 3 };
+};
+template <>
+struct CompressedTrackComponents<math::Float4> {
+  enum { kCount = 4 };
+};
+template <>
+struct CompressedTrackComponents<math::Quaternion> {
+  enum { kCount = 3 };
+};
+
+// Runtime compressed user-channel track internal implementation.
+// It's the compressed counterpart of Track, built by the TrackBuilder when a
+// tolerance is specified, and sampled by the same TrackSamplingJob interface.
+// - Keyframe ratios are quantized on 16 bits integers, aka a precision of
+// 1/65535 of the track duration.
+// - Float values are range-reduced: every component is quantized on 8 or 16
+// bits integers, relatively to the range of values of the track.
+// - Quaternions are stored with the same "smallest three" scheme as animation
+// QuaternionKey, where the 3 smallest components are quantized and the largest
+// one is restored from normalization. The index and sign of the largest
+// component are stored in the upper bit of each quantized component.
+// The number of bits per component (8 or 16) is selected by the TrackBuilder
+// according to the tolerance. Memory footprint of a QuaternionTrack key drops
+// from 20 to 8 or 5 bytes.
+template <typename _ValueType>
+class CompressedTrack {
+ public:
+  typedef _ValueType ValueType;
+  typedef uint16_t RatioType;
+
+  // Number of quantized components per keyframe value.
+  enum { kComponents = CompressedTrackComponents<_ValueType>::kCount };
+
+  // Quantization factor of keyframe ratios.
+  enum { kMaxRatio = 65535 };
+
+  CompressedTrack();
+  ~CompressedTrack();
+
+  // Keyframe ratios, quantized in range [0,kMaxRatio].
+  span<const uint16_t> ratios() const { return ratios_; }
+
+  // Quantized keyframe values, kComponents per keyframe, each stored on
+  // value_bits() bits.
+  span<const uint8_t> values() const { return values_; }
+
+  // Keyframe modes (1 bit per key): 1 for step, 0 for linear.
+  span<const uint8_t> steps() const { return steps_; }
+
+  // Number of bits per value component, 8 or 16.
+  int value_bits() const { return value_bits_; }
+
+  // Decompresses the value of keyframe _key.
+  _ValueType value(size_t _key) const;
+
+  // Get the estimated track's size in bytes.
+  size_t size() const;
+
+  // Get track name.
+  const char* name() const { return name_ ? name_ : ""; }
+
+  // Serialization functions.
+  // Should not be called directly but through io::Archive << and >> operators.
+  void Save(ozz::io::OArchive& _archive) const;
+  void Load(ozz::io::IArchive& _archive, uint32_t _version);
+
+ private:
+  // Disables copy and assignation.
+  CompressedTrack(CompressedTrack const&);
+  void operator=(CompressedTrack const&);
+
+  // TrackBuilder class is allowed to allocate a CompressedTrack.
+  friend class offline::TrackBuilder;
+
+  // Internal allocation/destruction functions.
+  void Allocate(size_t _keys_count, int _value_bits, size_t _name_len);
+  void Deallocate();
+
+  // Keyframe quantized ratios.
+  span<uint16_t> ratios_;
+
+  // Keyframe quantized values. Buffer is 2 bytes aligned, so it can be read as
+  // 16 bits integers.
+  span<uint8_t> values_;
+
+  // Keyframe modes (1 bit per key): 1 for step, 0 for linear.
+  span<uint8_t> steps_;
+
+  // Dequantization offset and scale of each component, such that value =
+  // offset + quantized * scale. Unused for quaternions.
+  float offsets_[4];
+  float scales_[4];
+
+  // Number of bits per value component.
+  int value_bits_;
+
+  // Track name.
+  char* name_;
+};
+}  // namespace internal
+
+// Runtime compressed track data structure instantiation.
+class CompressedFloatTrack : public internal::CompressedTrack<float> {};
+class CompressedFloat2Track
+    : public internal::CompressedTrack<math::Float2> {};
+class CompressedFloat3Track
+    : public internal::CompressedTrack<math::Float3> {};
+class CompressedFloat4Track
+    : public internal::CompressedTrack<math::Float4> {};
+class CompressedQuaternionTrack
+    : public internal::CompressedTrack<math::Quaternion> {};
+
+}  // namespace animation
+namespace io {
+OZZ_IO_TYPE_VERSION(1, animation::CompressedFloatTrack)
+OZZ_IO_TYPE_TAG("ozz-compressed_float_track", animation::CompressedFloatTrack)
+OZZ_IO_TYPE_VERSION(1, animation::CompressedFloat2Track)
+OZZ_IO_TYPE_TAG("ozz-compressed_float2_track",
+                animation::CompressedFloat2Track)
+OZZ_IO_TYPE_VERSION(1, animation::CompressedFloat3Track)
+OZZ_IO_TYPE_TAG("ozz-compressed_float3_track",
+                animation::CompressedFloat3Track)
+OZZ_IO_TYPE_VERSION(1, animation::CompressedFloat4Track)
+OZZ_IO_TYPE_TAG("ozz-compressed_float4_track",
+                animation::CompressedFloat4Track)
+OZZ_IO_TYPE_VERSION(1, animation::CompressedQuaternionTrack)
+OZZ_IO_TYPE_TAG("ozz-compressed_quat_track",
+                animation::CompressedQuaternionTrack)
+}  // namespace io
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_COMPRESSED_TRACK_H_
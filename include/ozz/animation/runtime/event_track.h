@@ -0,0 +1,99 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_EVENT_TRACK_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_EVENT_TRACK_H_
+
+#include "ozz/base/io/archive_traits.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declares the TrackBuilder, used to instantiate an EventTrack.
+namespace offline {
+class TrackBuilder;
+}
+
+// Runtime event track, a sorted sequence of discrete events, each one being
+// made of a ratio and a payload id. See RawEventTrack for more details on
+// track content. Ratios and ids are stored as separate buffers, as ratios are
+// searched alone by the EventTrackQueryJob.
+class EventTrack {
+ public:
+  EventTrack();
+  ~EventTrack();
+
+  // Number of events in the track.
+  size_t num_events() const { return ratios_.size(); }
+
+  // Events ratios, sorted in ascending order, within [0,1] range.
+  span<const float> ratios() const { return ratios_; }
+
+  // Events payload ids.
+  span<const uint16_t> ids() const { return ids_; }
+
+  // Get the estimated track's size in bytes.
+  size_t size() const;
+
+  // Get track name.
+  const char* name() const { return name_ ? name_ : ""; }
+
+  // Serialization functions.
+  // Should not be called directly but through io::Archive << and >> operators.
+  void Save(ozz::io::OArchive& _archive) const;
+  void Load(ozz::io::IArchive& _archive, uint32_t _version);
+
+ private:
+  // Disables copy and assignation.
+  EventTrack(EventTrack const&);
+  void operator=(EventTrack const&);
+
+  // TrackBuilder class is allowed to allocate an EventTrack.
+  friend class offline::TrackBuilder;
+
+  // Internal allocation/destruction functions.
+  void Allocate(size_t _events_count, size_t _name_len);
+  void Deallocate();
+
+  // Events ratios (0 is the beginning of the track, 1 is the end).
+  span<float> ratios_;
+
+  // Events payload ids.
+  span<uint16_t> ids_;
+
+  // Track name.
+  char* name_;
+};
+}  // namespace animation
+namespace io {
+OZZ_IO_TYPE_VERSION(1, animation::EventTrack)
+OZZ_IO_TYPE_TAG("ozz-event_track", animation::EventTrack)
+}  // namespace io
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_EVENT_TRACK_H_
@@ -0,0 +1,153 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_EVENT_TRACK_QUERY_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_EVENT_TRACK_QUERY_JOB_H_
+
+#include "ozz/base/platform.h"
+
+namespace ozz {
+namespace animation {
+
+class EventTrack;
+
+// Event track query job implementation. Yields all the events of an EventTrack
+// within a range of ratios, excluding the "from" bound and including the "to"
+// one: (from, to] when processed forward, [to, from) backward. Successive
+// queries of contiguous ranges hence yield every event once. Events at ratio 0
+// are triggered when track loops, or if the range starts before ratio 0.
+// The first event of the range is binary searched, so the job cost is
+// O(log n + k), where n is the number of events of the track and k the number
+// of yielded events.
+// As TrackTriggeringJob, execution is lazy: the job builds an iterator that
+// will find the next event on each call to ++ operator.
+struct EventTrackQueryJob {
+  EventTrackQueryJob();
+
+  // Validates job parameters.
+  bool Validate() const;
+
+  // Validates and executes job. Execution is lazy. Iterator operator ++ is
+  // actually doing the processing work.
+  bool Run() const;
+
+  // Input range. 0 is the beginning of the track, 1 is the end.
+  // from and to can be of any sign, any order, and any range. The job will
+  // perform accordingly:
+  // - if difference between from and to is greater than 1, the iterator will
+  // loop multiple times on the track.
+  // - if from is greater than to, then the track is processed backward, and
+  // events are yielded in reverse order.
+  float from;
+  float to;
+
+  // Track to query.
+  const EventTrack* track;
+
+  // Job output iterator.
+  class Iterator;
+  Iterator* iterator;
+
+  // Returns an iterator referring to the past-the-end element. It should only
+  // be used to test if iterator loop reached the end (using operator !=), and
+  // shall not be dereferenced.
+  Iterator end() const;
+
+  // Structure of an event as yielded by the job.
+  struct Event {
+    float ratio;  // Event ratio, in the same loop space as from and to.
+    uint16_t id;  // Event payload id.
+  };
+};
+
+// Iterator implementation. Calls to ++ operator will find the next event. It
+// should be compared (using operator !=) to job's end iterator to test if the
+// last event has been reached.
+class EventTrackQueryJob::Iterator {
+ public:
+  Iterator() : job_(nullptr), outer_(0.f), inner_(0) {}
+
+  // Finds next event.
+  // Calling this function on an end iterator results in an assertion in debug,
+  // an undefined behavior otherwise.
+  const Iterator& operator++();
+  Iterator operator++(int) {
+    Iterator prev = *this;
+    ++*this;
+    return prev;
+  }
+
+  // Compare with other iterators.
+  bool operator!=(const Iterator& _it) const {
+    return inner_ != _it.inner_ || outer_ != _it.outer_ || job_ != _it.job_;
+  }
+  bool operator==(const Iterator& _it) const {
+    return job_ == _it.job_ && outer_ == _it.outer_ && inner_ == _it.inner_;
+  }
+
+  // Dereferencing operators.
+  const Event& operator*() const {
+    assert(*this != job_->end() && "Can't dereference end iterator.");
+    return event_;
+  }
+  const Event* operator->() const {
+    assert(*this != job_->end() && "Can't dereference end iterator.");
+    return &event_;
+  }
+
+ private:
+  friend struct EventTrackQueryJob;
+
+  // Constructors used by the job.
+  explicit Iterator(const EventTrackQueryJob* _job);
+  struct End {};
+  Iterator(const EventTrackQueryJob* _job, End)
+      : job_(_job),
+        outer_(0.f),
+        inner_(-2) {  // Can never be reached while looping.
+  }
+
+  // Job this iterator works on.
+  const EventTrackQueryJob* job_;
+
+  // Current value of the outer loop, aka the track loop being processed.
+  float outer_;
+
+  // Current value of the inner loop, aka an event index.
+  ptrdiff_t inner_;
+
+  // Latest found event.
+  Event event_;
+};
+
+// end() job function inline implementation.
+inline EventTrackQueryJob::Iterator EventTrackQueryJob::end() const {
+  return Iterator(this, Iterator::End());
+}
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_EVENT_TRACK_QUERY_JOB_H_
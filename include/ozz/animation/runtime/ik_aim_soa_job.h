@@ -0,0 +1,107 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_IK_AIM_SOA_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_IK_AIM_SOA_JOB_H_
+
+#include "ozz/base/platform.h"
+
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_float.h"
+
+namespace ozz {
+// Forward declaration of math structures.
+namespace math {
+struct SoaFloat4x4;
+struct SoaQuaternion;
+}  // namespace math
+
+namespace animation {
+
+// ozz::animation::IKAimSoaJob rotates 4 independent joints at once so they aim
+// at their respective targets. It's the SoA counterpart of IKAimJob, see
+// IKAimJob for more details about the algorithm and its parameters. Every SoA
+// lane processes a joint, with the same semantic as IKAimJob.
+// Joints model-space matrices are expected as SoaFloat4x4, which can be
+// built from 4 Float4x4 by transposing each of their columns with
+// ozz::math::Transpose4x4. Output corrections are SoaQuaternion, which can be
+// converted back to 4 SimdQuaternion with ozz::math::Transpose4x4 as well.
+struct IKAimSoaJob {
+  // Default constructor, initializes default values.
+  IKAimSoaJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if joint or output quaternion pointer is nullptr
+  // -if any forward vector isn't normalized.
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Job input.
+
+  // Target positions to aim at, in model-space.
+  math::SoaFloat3 target;
+
+  // Joints forward axis, in joint local-space, to be aimed at target position.
+  // These vectors shall be normalized. Default is x axis.
+  math::SoaFloat3 forward;
+
+  // Offset positions from the joint in local-space, that will aim at target.
+  math::SoaFloat3 offset;
+
+  // Joints up axis, in joint local-space. Default is y axis.
+  math::SoaFloat3 up;
+
+  // Pole vectors, in model-space. Default is y axis.
+  math::SoaFloat3 pole_vector;
+
+  // Twist angles, rotating joints around target vectors. Default is 0.
+  math::SimdFloat4 twist_angle;
+
+  // Weights given to the IK corrections, clamped in range [0,1]. Default is 1.
+  math::SimdFloat4 weight;
+
+  // Joints model-space matrices.
+  const math::SoaFloat4x4* joint;
+
+  // Job output.
+
+  // Output local-space joints correction quaternions. They need to be
+  // multiplied with joints local-space quaternions.
+  math::SoaQuaternion* joint_correction;
+
+  // Optional output mask, each lane being set to true (all bits set) if its
+  // target can be reached, see IKAimJob::reached.
+  math::SimdInt4* reached;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_IK_AIM_SOA_JOB_H_
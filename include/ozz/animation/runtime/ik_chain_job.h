@@ -0,0 +1,115 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_IK_CHAIN_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_IK_CHAIN_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+#include "ozz/animation/runtime/ik_correction_job.h"
+#include "ozz/base/maths/simd_math.h"
+
+namespace ozz {
+namespace animation {
+
+// ozz::animation::IKChainJob performs inverse kinematic on a chain of an
+// arbitrary number of joints (tails, spines, tentacles...), using Cyclic
+// Coordinate Descent (CCD) algorithm.
+// Each iteration rotates every joint of the chain, from the end to the start,
+// so that the vector from the joint to the end of the chain aims at the
+// target. Iterations stop as soon as the end of the chain reaches the target
+// (within tolerance), when it doesn't move anymore (unreachable target), or
+// when max_iterations is reached.
+// Chain joints positions and accumulated rotations are stored and updated as
+// SoA, so each joint rotation updates 4 descendant joints at once.
+// The job outputs local-space corrections for all chain joints but the end
+// one, ready to be applied with IKCorrectionJob (or multiplied to local-space
+// rotations). Like other IK jobs, it assumes joints scale is uniform.
+struct IKChainJob {
+  // Default constructor, initializes default values.
+  IKChainJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if joints count is less than 2 or greater than kMaxJoints.
+  // -if joints indices aren't valid models indices, sorted in strictly
+  // ascending order.
+  // -if corrections size is smaller than joints count minus 1.
+  // -if max_iterations or tolerance are negative.
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Maximum number of joints of a chain.
+  enum { kMaxJoints = 64 };
+
+  // Job input.
+
+  // Target IK position, in model-space. This is the position the end of the
+  // joint chain will try to reach.
+  math::SimdFloat4 target;
+
+  // Indices of the chain joints, from the start to the end of the chain. Each
+  // joint must be an ancestor of the next one. They don't need to be direct
+  // ancestors though (joints in-between will simply remain fixed).
+  span<const int> joints;
+
+  // Model-space matrices of the skeleton joints, as output by LocalToModelJob.
+  span<const math::Float4x4> models;
+
+  // Maximum number of CCD iterations. Default is 16.
+  int max_iterations;
+
+  // Distance from the end of the chain to the target under which target is
+  // considered reached, stopping iterations. Default is 1e-3.
+  float tolerance;
+
+  // Weight given to the IK correction clamped in range [0,1]. This allows to
+  // blend / interpolate from no IK applied (0 weight) to full IK (1).
+  float weight;
+
+  // Job output.
+
+  // Local-space corrections of the chain joints, but the end one. Corrections
+  // are sorted by joint index, as expected by IKCorrectionJob.
+  // Its size must be at least joints count minus 1.
+  span<IKCorrectionJob::Correction> corrections;
+
+  // Optional boolean output value, set to true if the end of the chain reached
+  // the target. Target is considered unreached if weight is less than 1.
+  bool* reached;
+
+  // Optional output value, set to the number of iterations performed.
+  int* iterations;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_IK_CHAIN_JOB_H_
@@ -0,0 +1,116 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_IK_CORRECTION_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_IK_CORRECTION_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+#include "ozz/base/maths/simd_quaternion.h"
+
+namespace ozz {
+
+// Forward declaration math structures.
+namespace math {
+struct SoaTransform;
+struct Float4x4;
+}  // namespace math
+
+namespace animation {
+
+// Forward declares the Skeleton object used to describe joint hierarchy.
+class Skeleton;
+
+// ozz::animation::IKCorrectionJob applies a sequence of local-space joint
+// corrections, as output by IK jobs, directly to model-space matrices. It
+// replaces the sequence of multiplying local-space SoaTransform rotations and
+// running LocalToModelJob again (limited by "from") after each IK job.
+// Every corrected joint matrix is post-multiplied by its correction, and its
+// descendants are updated incrementally with a single matrix multiplication
+// (by the model-space delta of their closest corrected ancestor). Only the
+// hierarchies of corrected joints are updated, in a single pass whatever the
+// number of corrections, and without any SoA to matrix conversion.
+// This is equivalent to applying corrections to local-space rotations and
+// running LocalToModelJob, as long as corrected joints local scale is uniform,
+// which is also the assumption made by IK jobs.
+struct IKCorrectionJob {
+  // Default constructor, initializes default values.
+  IKCorrectionJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if skeleton is nullptr.
+  // -if the size of models is smaller than the skeleton's number of joints.
+  // -if locals is specified and its size is smaller than the skeleton's number
+  // of soa joints.
+  // -if there are more than kMaxCorrections corrections.
+  // -if corrections joints aren't valid joint indices, sorted in strictly
+  // ascending order (which means that parents are corrected before their
+  // children).
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Maximum number of corrections applied by a single job.
+  enum { kMaxCorrections = 64 };
+
+  // Defines a local-space joint correction.
+  struct Correction {
+    // Index of the corrected joint.
+    int joint;
+
+    // Local-space correction quaternion, as output by IK jobs. It's
+    // multiplied with joint local-space rotation.
+    math::SimdQuaternion rotation;
+  };
+
+  // Job input.
+
+  // The Skeleton object describing the joint hierarchy.
+  const Skeleton* skeleton;
+
+  // Corrections to apply, sorted by joint index.
+  span<const Correction> corrections;
+
+  // Job input and output.
+
+  // Model-space matrices of all skeleton joints, as output by LocalToModelJob.
+  // Matrices of corrected joints and their descendants are updated.
+  span<math::Float4x4> models;
+
+  // Optional local-space transforms, whose corrected joints rotations are
+  // multiplied by their correction. This allows to keep local-space
+  // transforms in sync with model-space matrices, for further usage.
+  span<math::SoaTransform> locals;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_IK_CORRECTION_JOB_H_
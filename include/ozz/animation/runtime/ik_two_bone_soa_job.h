@@ -0,0 +1,112 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_IK_TWO_BONE_SOA_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_IK_TWO_BONE_SOA_JOB_H_
+
+#include "ozz/base/platform.h"
+
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_float.h"
+
+namespace ozz {
+// Forward declaration of math structures.
+namespace math {
+struct SoaFloat4x4;
+struct SoaQuaternion;
+}  // namespace math
+
+namespace animation {
+
+// ozz::animation::IKTwoBoneSoaJob performs inverse kinematic on 4 independent
+// three joints chains (two bones) at once. It's the SoA counterpart of
+// IKTwoBoneJob, see IKTwoBoneJob for more details about the algorithm and its
+// parameters. Every SoA lane processes a chain, with the same semantic as
+// IKTwoBoneJob, so SIMD vectors are fully used. This allows to efficiently
+// solve IK of many characters (feet, arms...) at once.
+// Chains model-space matrices are expected as SoaFloat4x4, which can be
+// built from 4 Float4x4 by transposing each of their columns with
+// ozz::math::Transpose4x4. Output corrections are SoaQuaternion, which can be
+// converted back to 4 SimdQuaternion with ozz::math::Transpose4x4 as well.
+// If less than 4 chains need to be solved, unused lanes can be set to identity
+// matrices and a weight of 0, which outputs identity corrections.
+struct IKTwoBoneSoaJob {
+  // Constructor, initializes default values.
+  IKTwoBoneSoaJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any input pointer is nullptr
+  // -if any mid_axis isn't normalized.
+  bool Validate() const;
+
+  // Runs job's execution task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if *this job is not valid.
+  bool Run() const;
+
+  // Job input.
+
+  // Target IK positions, in model-space.
+  math::SoaFloat3 target;
+
+  // Normalized middle joints rotation axis, in middle joint local-space.
+  // Default value is z axis.
+  math::SoaFloat3 mid_axis;
+
+  // Pole vectors, in model-space. Default value is y axis.
+  math::SoaFloat3 pole_vector;
+
+  // Twist angles, rotating IK chains around start-to-target vectors. Default
+  // is 0.
+  math::SimdFloat4 twist_angle;
+
+  // Soften ratios. Default is 1.
+  math::SimdFloat4 soften;
+
+  // Weights given to the IK corrections, clamped in range [0,1]. Default is 1.
+  math::SimdFloat4 weight;
+
+  // Model-space matrices of the start, middle and end joints of the chains.
+  const math::SoaFloat4x4* start_joint;
+  const math::SoaFloat4x4* mid_joint;
+  const math::SoaFloat4x4* end_joint;
+
+  // Job output.
+
+  // Local-space corrections to apply to start and middle joints in order for
+  // end joints to reach target positions.
+  math::SoaQuaternion* start_joint_correction;
+  math::SoaQuaternion* mid_joint_correction;
+
+  // Optional output mask, each lane being set to true (all bits set) if its
+  // target can be reached, see IKTwoBoneJob::reached.
+  math::SimdInt4* reached;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_IK_TWO_BONE_SOA_JOB_H_
@@ -107,6 +107,27 @@ struct LocalToModelJob {
   // Default value is false.
   bool from_excluded;
 
+  // Optional joints mask, one bit per joint (bit i & 7 of byte i / 8), that
+  // limits the update to the selected joints, along with all their ancestors
+  // which are required to compute them. Mask is hence automatically closed
+  // over ancestors, so disjoint subsets of the hierarchy (like both hands and
+  // the head) are updated in a single job execution. Joints beyond mask range
+  // aren't selected. Mask is combined with "from" and "to" parameters, which
+  // still limit the updated range.
+  // Default is an empty mask, meaning all joints are updated.
+  span<const uint8_t> mask;
+
+  // Optional dirty flags, one bit per joint (same layout as mask), used to
+  // update incrementally a pose whose output matrices were computed by a
+  // previous job execution. Only dirty joints and their descendants are
+  // updated, other output matrices are left unchanged. Flags propagate to
+  // descendants within the updated range, so only joints whose local
+  // transform changed need to be flagged (roots if root matrix changed).
+  // Joints beyond dirty range are considered unchanged. Dirty flags are
+  // combined with mask, from and to parameters.
+  // Default is empty, meaning all joints are updated.
+  span<const uint8_t> dirty;
+
   // The input range that store local transforms.
   span<const ozz::math::SoaTransform> input;
 
@@ -0,0 +1,111 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_MODEL_SPACE_QUERY_JOB_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_MODEL_SPACE_QUERY_JOB_H_
+
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+
+// Forward declaration math structures.
+namespace math {
+struct SoaTransform;
+struct Float4x4;
+}  // namespace math
+
+namespace animation {
+
+// Forward declares the types used by the job.
+class Animation;
+class SamplingCache;
+class Skeleton;
+
+// Computes the model-space matrix of a single joint of an animated skeleton,
+// without sampling and converting the whole pose. The job walks up joint's
+// ancestors chain, samples only the soa tracks of those joints (using
+// SamplingJob mask), and concatenates only their local transforms. This suits
+// attachments, hit tests or camera targets of characters whose full pose isn't
+// otherwise needed (dormant or off-screen characters...).
+// Output matrix is identical to the one LocalToModelJob would compute from the
+// pose sampled by SamplingJob.
+struct ModelSpaceQueryJob {
+  // Default constructor, initializes default values.
+  ModelSpaceQueryJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any input pointer is nullptr.
+  // -if joint isn't a valid skeleton joint, or isn't a track of the
+  // animation.
+  // -if locals range is smaller than animation soa tracks.
+  // -if cache is too small for the animation.
+  bool Validate() const;
+
+  // Runs job's query task.
+  // The job is validated before any operation is performed, see Validate() for
+  // more details.
+  // Returns false if job is not valid. See Validate() function.
+  bool Run() const;
+
+  // Job input.
+
+  // Time ratio in the unit interval [0,1] used to sample animation, see
+  // SamplingJob::ratio.
+  float ratio;
+
+  // The animation to sample.
+  const Animation* animation;
+
+  // Sampling cache, that must be big enough to sample the animation. It can be
+  // shared with SamplingJob, as the cache remains coherent whatever the
+  // sampled joints.
+  SamplingCache* cache;
+
+  // The Skeleton object describing the joint hierarchy.
+  const Skeleton* skeleton;
+
+  // Index of the joint to query.
+  int joint;
+
+  // The root matrix will multiply the output matrix, default nullptr means an
+  // identity matrix. See LocalToModelJob::root.
+  const ozz::math::Float4x4* root;
+
+  // Local-space transforms buffer, sized for the animation soa tracks. Only
+  // soa transforms of joint's ancestors chain are sampled, others are left
+  // unchanged.
+  span<ozz::math::SoaTransform> locals;
+
+  // Job output.
+
+  // Joint model-space matrix.
+  ozz::math::Float4x4* output;
+};
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_MODEL_SPACE_QUERY_JOB_H_
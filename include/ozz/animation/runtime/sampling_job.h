@@ -90,6 +90,14 @@ struct SamplingJob {
   // If there are more joints in the animation, then the last joints are not
   // sampled.
   span<ozz::math::SoaTransform> output;
+
+  // Optional joints mask, one bit per track (bit i & 7 of byte i / 8). When
+  // not empty, only soa tracks (4 joints) with at least one bit set are
+  // decompressed and interpolated to the output, others are left unchanged.
+  // Tracks beyond mask range aren't sampled. The cache remains coherent, so
+  // masked and complete samplings can be mixed with the same cache.
+  // Default is an empty mask, meaning all tracks are sampled.
+  span<const uint8_t> mask;
 };
 
 namespace internal {
@@ -133,6 +141,43 @@ class SamplingCache {
   int max_tracks() const { return max_soa_tracks_ * 4; }
   int max_soa_tracks() const { return max_soa_tracks_; }
 
+  // Get the estimated cache's size in bytes.
+  size_t size() const;
+
+  // Sampling statistics, accumulated by every SamplingJob using this cache
+  // until ResetStatistics() is called. They allow to evaluate sampling cost,
+  // like detecting cache thrashing due to frequent animation changes, seeks or
+  // loops. Statistics are typically aggregated and reset every frame.
+  struct Statistics {
+    // Number of SamplingJob executions.
+    size_t samplings;
+
+    // Number of animation keyframes (translations, rotations and scales)
+    // consumed by the cache cursors.
+    size_t keys;
+
+    // Number of soa keyframes (4 tracks) decompressed to the cache.
+    size_t decompressions;
+
+    // Number of cache invalidations, sorted by cause. Only invalidations of a
+    // cache in use are counted, so an already invalid cache doesn't count
+    // twice.
+    // Animation sampled by the cache has changed.
+    size_t animation_invalidations;
+    // Animation sampled backward, which includes looping.
+    size_t backward_invalidations;
+    // Cache resized with Resize().
+    size_t resize_invalidations;
+    // Cache explicitly invalidated with Invalidate().
+    size_t explicit_invalidations;
+  };
+
+  // Gets statistics accumulated since the last reset.
+  const Statistics& statistics() const { return statistics_; }
+
+  // Resets all statistics to 0.
+  void ResetStatistics();
+
  private:
   // Disables copy and assignation.
   SamplingCache(SamplingCache const&);
@@ -140,6 +185,9 @@ class SamplingCache {
 
   friend struct SamplingJob;
 
+  // Invalidates the cache, without counting it in statistics.
+  void Reset();
+
   // Steps the cache in order to use it for a potentially new animation and
   // ratio. If the _animation is different from the animation currently cached,
   // or if the _ratio shows that the animation is played backward, then the
@@ -175,6 +223,9 @@ class SamplingCache {
   uint8_t* outdated_translations_;
   uint8_t* outdated_rotations_;
   uint8_t* outdated_scales_;
+
+  // Sampling statistics.
+  Statistics statistics_;
 };
 }  // namespace animation
 }  // namespace ozz
@@ -53,7 +53,7 @@ class SkeletonBuilder;
 // Joint names, bind-poses and hierarchy information are all stored in separate
 // arrays of data (as opposed to joint structures for the RawSkeleton), in order
 // to closely match with the way runtime algorithms use them. Joint hierarchy is
-// packed as an array of parent jont indices (16 bits), stored in depth-first
+// packed as an array of parent jont indices (32 bits), stored in depth-first
 // order. This is enough to traverse the whole joint hierarchy. See
 // IterateJointsDF() from skeleton_utils.h that implements a depth-first
 // traversal utility.
@@ -64,10 +64,10 @@ class Skeleton {
 
     // Defines the maximum number of joints.
     // This is limited in order to control the number of bits required to store
-    // a joint index. Limiting the number of joints also helps handling worst
-    // size cases, like when it is required to allocate an array of joints on
-    // the stack.
-    kMaxJoints = 1024,
+    // a joint index, aka 16 bits in animation key frames. Limiting the number
+    // of joints also helps handling worst size cases, like when it is required
+    // to allocate per-joint bit arrays on the stack.
+    kMaxJoints = 65535,
 
     // Defines the maximum number of SoA elements required to store the maximum
     // number of joints.
@@ -84,6 +84,9 @@ class Skeleton {
   // Declares the public non-virtual destructor.
   ~Skeleton();
 
+  // Get the estimated skeleton's size in bytes.
+  size_t size() const;
+
   // Returns the number of joints of *this skeleton.
   int num_joints() const { return static_cast<int>(joint_parents_.size()); }
 
@@ -97,7 +100,7 @@ class Skeleton {
   }
 
   // Returns joint's parent indices range.
-  span<const int16_t> joint_parents() const { return joint_parents_; }
+  span<const int32_t> joint_parents() const { return joint_parents_; }
 
   // Returns joint's name collection.
   span<const char* const> joint_names() const {
@@ -129,7 +132,7 @@ class Skeleton {
   span<math::SoaTransform> joint_bind_poses_;
 
   // Array of joint parent indexes.
-  span<int16_t> joint_parents_;
+  span<int32_t> joint_parents_;
 
   // Stores the name of every joint in an array of c-strings.
   span<char*> joint_names_;
@@ -137,7 +140,7 @@ class Skeleton {
 }  // namespace animation
 
 namespace io {
-OZZ_IO_TYPE_VERSION(2, animation::Skeleton)
+OZZ_IO_TYPE_VERSION(3, animation::Skeleton)
 OZZ_IO_TYPE_TAG("ozz-skeleton", animation::Skeleton)
 }  // namespace io
 }  // namespace ozz
@@ -46,7 +46,7 @@ ozz::math::Transform GetJointLocalBindPose(const Skeleton& _skeleton,
 inline bool IsLeaf(const Skeleton& _skeleton, int _joint) {
   const int num_joints = _skeleton.num_joints();
   assert(_joint >= 0 && _joint < num_joints && "_joint index out of range");
-  const span<const int16_t>& parents = _skeleton.joint_parents();
+  const span<const int32_t>& parents = _skeleton.joint_parents();
   const int next = _joint + 1;
   return next == num_joints || parents[next] != _joint;
 }
@@ -60,7 +60,7 @@ inline bool IsLeaf(const Skeleton& _skeleton, int _joint) {
 template <typename _Fct>
 inline _Fct IterateJointsDF(const Skeleton& _skeleton, _Fct _fct,
                             int _from = Skeleton::kNoParent) {
-  const span<const int16_t>& parents = _skeleton.joint_parents();
+  const span<const int32_t>& parents = _skeleton.joint_parents();
   const int num_joints = _skeleton.num_joints();
   //
   // parents[i] >= _from is true as long as "i" is a child of "_from".
@@ -79,7 +79,7 @@ inline _Fct IterateJointsDF(const Skeleton& _skeleton, _Fct _fct,
 // the _current joint is a root.
 template <typename _Fct>
 inline _Fct IterateJointsDFReverse(const Skeleton& _skeleton, _Fct _fct) {
-  const span<const int16_t>& parents = _skeleton.joint_parents();
+  const span<const int32_t>& parents = _skeleton.joint_parents();
   for (int i = _skeleton.num_joints() - 1; i >= 0; --i) {
     _fct(i, parents[i]);
   }
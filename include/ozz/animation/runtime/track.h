@@ -53,10 +53,14 @@ namespace internal {
 // mode are all store as separate buffers in order to access the cache
 // coherently. Ratios are usually accessed/read alone from the jobs that all
 // start by looking up the keyframes to interpolate indeed.
+// Cubic (Hermite) keyframes are flagged in a separate bit buffer, and their
+// tangents stored in a separate buffer too. Both are empty if the track has no
+// cubic keyframe, so linear tracks don't pay for curves.
 template <typename _ValueType>
 class Track {
  public:
   typedef _ValueType ValueType;
+  typedef float RatioType;
 
   Track();
   ~Track();
@@ -66,6 +70,16 @@ class Track {
   span<const _ValueType> values() const { return values_; }
   span<const uint8_t> steps() const { return steps_; }
 
+  // Keyframe cubic modes (1 bit per key): 1 if the key is a cubic Hermite
+  // curve up to the next key. Empty if the track has no cubic key.
+  span<const uint8_t> cubics() const { return cubics_; }
+
+  // Tangents of cubic keys, 2 per keyframe: the out tangent of the key, and
+  // the in tangent of the next key. They're premultiplied by the ratio
+  // difference between the 2 keys, so interpolation doesn't need to scale
+  // them. Empty if the track has no cubic key.
+  span<const _ValueType> tangents() const { return tangents_; }
+
   // Get the estimated track's size in bytes.
   size_t size() const;
 
@@ -86,7 +100,7 @@ class Track {
   friend class offline::TrackBuilder;
 
   // Internal destruction function.
-  void Allocate(size_t _keys_count, size_t _name_len);
+  void Allocate(size_t _keys_count, size_t _name_len, bool _cubic);
   void Deallocate();
 
   // Keyframe ratios (0 is the beginning of the track, 1 is the end).
@@ -98,6 +112,12 @@ class Track {
   // Keyframe modes (1 bit per key): 1 for step, 0 for linear.
   span<uint8_t> steps_;
 
+  // Keyframe cubic modes (1 bit per key), empty if there's no cubic key.
+  span<uint8_t> cubics_;
+
+  // Cubic keyframe tangents (2 per key), empty if there's no cubic key.
+  span<_ValueType> tangents_;
+
   // Track name.
   char* name_;
 };
@@ -109,6 +129,16 @@ struct TrackPolicy {
                                 float _alpha) {
     return math::Lerp(_a, _b, _alpha);
   }
+  // Cubic Hermite interpolation. Tangents _t0 and _t1 are premultiplied by
+  // the ratio difference of the 2 keys.
+  inline static _ValueType Hermite(const _ValueType& _v0, const _ValueType& _t0,
+                                   const _ValueType& _v1, const _ValueType& _t1,
+                                   float _alpha) {
+    const float a2 = _alpha * _alpha;
+    const float a3 = a2 * _alpha;
+    return _v0 * (2.f * a3 - 3.f * a2 + 1.f) + _t0 * (a3 - 2.f * a2 + _alpha) +
+           _v1 * (3.f * a2 - 2.f * a3) + _t1 * (a3 - a2);
+  }
   inline static float Distance(const _ValueType& _a, const _ValueType& _b) {
     return math::Length(_a - _b);
   }
@@ -130,6 +160,18 @@ inline math::Quaternion TrackPolicy<math::Quaternion>::Lerp(
   // approximated with a lower tolerance value if it matters.
   return math::NLerp(_a, _b, _alpha);
 }
+// Quaternions are interpolated component-wise, and then normalized (as glTF
+// does for cubic spline rotations).
+template <>
+inline math::Quaternion TrackPolicy<math::Quaternion>::Hermite(
+    const math::Quaternion& _v0, const math::Quaternion& _t0,
+    const math::Quaternion& _v1, const math::Quaternion& _t1, float _alpha) {
+  const float a2 = _alpha * _alpha;
+  const float a3 = a2 * _alpha;
+  return math::Normalize(
+      _v0 * (2.f * a3 - 3.f * a2 + 1.f) + _t0 * (a3 - 2.f * a2 + _alpha) +
+      _v1 * (3.f * a2 - 2.f * a3) + _t1 * (a3 - a2));
+}
 template <>
 inline float TrackPolicy<math::Quaternion>::Distance(
     const math::Quaternion& _a, const math::Quaternion& _b) {
@@ -154,15 +196,15 @@ class QuaternionTrack : public internal::Track<math::Quaternion> {};
 
 }  // namespace animation
 namespace io {
-OZZ_IO_TYPE_VERSION(1, animation::FloatTrack)
+OZZ_IO_TYPE_VERSION(2, animation::FloatTrack)
 OZZ_IO_TYPE_TAG("ozz-float_track", animation::FloatTrack)
-OZZ_IO_TYPE_VERSION(1, animation::Float2Track)
+OZZ_IO_TYPE_VERSION(2, animation::Float2Track)
 OZZ_IO_TYPE_TAG("ozz-float2_track", animation::Float2Track)
-OZZ_IO_TYPE_VERSION(1, animation::Float3Track)
+OZZ_IO_TYPE_VERSION(2, animation::Float3Track)
 OZZ_IO_TYPE_TAG("ozz-float3_track", animation::Float3Track)
-OZZ_IO_TYPE_VERSION(1, animation::Float4Track)
+OZZ_IO_TYPE_VERSION(2, animation::Float4Track)
 OZZ_IO_TYPE_TAG("ozz-float4_track", animation::Float4Track)
-OZZ_IO_TYPE_VERSION(1, animation::QuaternionTrack)
+OZZ_IO_TYPE_VERSION(2, animation::QuaternionTrack)
 OZZ_IO_TYPE_TAG("ozz-quat_track", animation::QuaternionTrack)
 }  // namespace io
 }  // namespace ozz
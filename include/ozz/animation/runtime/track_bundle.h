@@ -0,0 +1,107 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_TRACK_BUNDLE_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_TRACK_BUNDLE_H_
+
+#include "ozz/base/io/archive_traits.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declares the TrackBuilder, used to instantiate a FloatTrackBundle.
+namespace offline {
+class TrackBuilder;
+}
+
+// Runtime bundle of float tracks, sharing the same keyframe ratios. It's built
+// from a set of RawFloatTrack by the TrackBuilder, and sampled by the
+// FloatTrackBundleSamplingJob. Every track value is stored in SoA format, 4
+// tracks per SIMD vector, so that a single keyframe search is required to
+// sample all tracks, and interpolation processes 4 tracks at a time.
+// Keyframe ratios are the union of all input tracks ratios, so the bundle is
+// most efficient (in memory) for tracks that share the same time base, like
+// curves sampled at the same rate. Step interpolation is supported by
+// duplicating the ratio of the keyframe following a step. The first one stores
+// the value before the discontinuity, the second one the value after.
+class FloatTrackBundle {
+ public:
+  FloatTrackBundle();
+  ~FloatTrackBundle();
+
+  // Number of tracks in the bundle.
+  int num_tracks() const { return num_tracks_; }
+
+  // Number of SoA tracks, aka groups of 4 tracks.
+  int num_soa_tracks() const { return (num_tracks_ + 3) / 4; }
+
+  // Keyframe ratios, shared by all tracks.
+  span<const float> ratios() const { return ratios_; }
+
+  // Keyframe values, stored as num_soa_tracks() SoA (4 floats) values per
+  // keyframe. Buffer is 16 bytes aligned, so it can be loaded as SIMD vectors.
+  // Padding values (after num_tracks()) are set to 0.
+  span<const float> values() const { return values_; }
+
+  // Get the estimated bundle's size in bytes.
+  size_t size() const;
+
+  // Serialization functions.
+  // Should not be called directly but through io::Archive << and >> operators.
+  void Save(ozz::io::OArchive& _archive) const;
+  void Load(ozz::io::IArchive& _archive, uint32_t _version);
+
+ private:
+  // Disables copy and assignation.
+  FloatTrackBundle(FloatTrackBundle const&);
+  void operator=(FloatTrackBundle const&);
+
+  // TrackBuilder class is allowed to allocate a FloatTrackBundle.
+  friend class offline::TrackBuilder;
+
+  // Internal allocation/destruction functions.
+  void Allocate(size_t _keys_count, int _num_tracks);
+  void Deallocate();
+
+  // Number of tracks.
+  int num_tracks_;
+
+  // Keyframe ratios (0 is the beginning of the track, 1 is the end).
+  span<float> ratios_;
+
+  // Keyframe SoA values.
+  span<float> values_;
+};
+}  // namespace animation
+namespace io {
+OZZ_IO_TYPE_VERSION(1, animation::FloatTrackBundle)
+OZZ_IO_TYPE_TAG("ozz-float_track_bundle", animation::FloatTrackBundle)
+}  // namespace io
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_TRACK_BUNDLE_H_
@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_OZZ_ANIMATION_RUNTIME_TRACK_EDGES_H_
+#define OZZ_OZZ_ANIMATION_RUNTIME_TRACK_EDGES_H_
+
+#include "ozz/base/io/archive_traits.h"
+#include "ozz/base/platform.h"
+#include "ozz/base/span.h"
+
+namespace ozz {
+namespace animation {
+
+// Forward declares the TrackEdgesBuilder, used to instantiate TrackEdges.
+namespace offline {
+class TrackEdgesBuilder;
+}
+
+// Runtime table of the edges of a FloatTrack for a given threshold, as
+// detected by the TrackTriggeringJob. Edges of a track are precomputed by the
+// TrackEdgesBuilder, so that TrackTriggeringJob doesn't need to evaluate every
+// keyframe of the queried range: it only binary searches the first edge and
+// iterates the actual edges. Edges ratios are sorted, they're stored for a
+// single loop of the track, in forward direction.
+class TrackEdges {
+ public:
+  TrackEdges();
+  ~TrackEdges();
+
+  // Threshold value used to detect edges.
+  float threshold() const { return threshold_; }
+
+  // Number of edges in the table.
+  size_t num_edges() const { return ratios_.size(); }
+
+  // Edges ratios, sorted in ascending order, within [0,1] range.
+  span<const float> ratios() const { return ratios_; }
+
+  // Bit array of edges direction, 1 bit per edge, set when edge is rising
+  // (when processing the track forward).
+  span<const uint8_t> risings() const { return risings_; }
+
+  // Get the estimated table's size in bytes.
+  size_t size() const;
+
+  // Serialization functions.
+  // Should not be called directly but through io::Archive << and >> operators.
+  void Save(ozz::io::OArchive& _archive) const;
+  void Load(ozz::io::IArchive& _archive, uint32_t _version);
+
+ private:
+  // Disables copy and assignation.
+  TrackEdges(TrackEdges const&);
+  void operator=(TrackEdges const&);
+
+  // TrackEdgesBuilder class is allowed to allocate TrackEdges.
+  friend class offline::TrackEdgesBuilder;
+
+  // Internal allocation/destruction functions.
+  void Allocate(size_t _edges_count);
+  void Deallocate();
+
+  // Edge detection threshold.
+  float threshold_;
+
+  // Edges ratios.
+  span<float> ratios_;
+
+  // Edges direction bit array.
+  span<uint8_t> risings_;
+};
+}  // namespace animation
+namespace io {
+OZZ_IO_TYPE_VERSION(1, animation::TrackEdges)
+OZZ_IO_TYPE_TAG("ozz-track_edges", animation::TrackEdges)
+}  // namespace io
+}  // namespace ozz
+#endif  // OZZ_OZZ_ANIMATION_RUNTIME_TRACK_EDGES_H_
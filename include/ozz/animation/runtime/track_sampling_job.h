@@ -28,11 +28,19 @@
 #ifndef OZZ_OZZ_ANIMATION_RUNTIME_TRACK_SAMPLING_JOB_H_
 #define OZZ_OZZ_ANIMATION_RUNTIME_TRACK_SAMPLING_JOB_H_
 
+#include "ozz/animation/runtime/compressed_track.h"
 #include "ozz/animation/runtime/track.h"
+#include "ozz/base/span.h"
 
 namespace ozz {
 namespace animation {
 
+// Forward declares the cache object used by TrackSamplingJob.
+class TrackSamplingCache;
+
+// Forward declares float tracks bundle.
+class FloatTrackBundle;
+
 namespace internal {
 
 // TrackSamplingJob internal implementation. See *TrackSamplingJob for more
@@ -40,6 +48,7 @@ namespace internal {
 template <typename _Track>
 struct TrackSamplingJob {
   typedef typename _Track::ValueType ValueType;
+  typedef typename _Track::RatioType RatioType;
 
   TrackSamplingJob();
 
@@ -57,11 +66,57 @@ struct TrackSamplingJob {
   // Track to sample.
   const _Track* track;
 
+  // Optional cache, that allows to take advantage of sampling coherency. Note
+  // that a cache can be used with any track, but it's only efficient if it's
+  // always used with the same one. Sampling is the same without a cache
+  // (nullptr, default).
+  TrackSamplingCache* cache;
+
   // Job output.
   typename _Track::ValueType* result;
 };
 }  // namespace internal
 
+// Declares the cache object used by TrackSamplingJob to take advantage of the
+// frame coherency of track sampling. It stores the keyframe found by the
+// previous sampling, so that sampling forward only needs to move the cursor
+// forward by a few keyframes, rather than searching the whole track. Sampling
+// backward (or looping) works, but searches keyframes before the cursor.
+class TrackSamplingCache {
+ public:
+  TrackSamplingCache() : track_(nullptr), cursor_(0) {}
+
+  // Invalidate the cache.
+  // TrackSamplingJob automatically invalidates a cache when it's used with
+  // another track. This automatic mechanism is based on the track address,
+  // which means it's recommended to manually invalidate a cache when the
+  // address of a track is reused for another track (like after successive
+  // calls to delete / new).
+  void Invalidate() {
+    track_ = nullptr;
+    cursor_ = 0;
+  }
+
+ private:
+  template <typename _Track>
+  friend struct internal::TrackSamplingJob;
+  friend struct FloatTrackBundleSamplingJob;
+
+  // Searches for the first keyframe of _ratios that is greater than _ratio,
+  // starting from the cursor if it was set by the same _track. Updates the
+  // cursor with the result. _Ratio is float, or uint16_t for compressed tracks.
+  template <typename _Ratio>
+  const _Ratio* Search(const void* _track, const span<const _Ratio>& _ratios,
+                       float _ratio);
+
+  // Track the cursor refers to, nullptr if cache is invalid.
+  const void* track_;
+
+  // Index of the first keyframe whose ratio is greater than the last sampled
+  // ratio. It's the size of the track if there's none.
+  size_t cursor_;
+};
+
 // Track sampling job implementation. Track sampling allows to query a track
 // value for a specified ratio. This is a ratio rather than a time because
 // tracks have no duration.
@@ -75,6 +130,48 @@ struct Float4TrackSamplingJob : public internal::TrackSamplingJob<Float4Track> {
 struct QuaternionTrackSamplingJob
     : public internal::TrackSamplingJob<QuaternionTrack> {};
 
+// Compressed tracks sampling job implementation. Sampling is the same as for
+// uncompressed tracks, keyframes being decompressed on the fly.
+struct CompressedFloatTrackSamplingJob
+    : public internal::TrackSamplingJob<CompressedFloatTrack> {};
+struct CompressedFloat2TrackSamplingJob
+    : public internal::TrackSamplingJob<CompressedFloat2Track> {};
+struct CompressedFloat3TrackSamplingJob
+    : public internal::TrackSamplingJob<CompressedFloat3Track> {};
+struct CompressedFloat4TrackSamplingJob
+    : public internal::TrackSamplingJob<CompressedFloat4Track> {};
+struct CompressedQuaternionTrackSamplingJob
+    : public internal::TrackSamplingJob<CompressedQuaternionTrack> {};
+
+// Samples all the tracks of a FloatTrackBundle at the same ratio. Keyframes are
+// searched once for the whole bundle, and values are interpolated 4 tracks at
+// a time using SIMD instructions.
+struct FloatTrackBundleSamplingJob {
+  FloatTrackBundleSamplingJob();
+
+  // Validates job parameters. Returns true for a valid job, or false otherwise:
+  // -if any input pointer is nullptr
+  // -if output range is smaller than the number of tracks of the bundle.
+  bool Validate() const;
+
+  // Validates and executes sampling.
+  bool Run() const;
+
+  // Ratio used to sample tracks, clamped in range [0,1] before job execution.
+  float ratio;
+
+  // Bundle to sample.
+  const FloatTrackBundle* bundle;
+
+  // Optional cache, that allows to take advantage of sampling coherency. See
+  // TrackSamplingJob::cache.
+  TrackSamplingCache* cache;
+
+  // Job output, receiving every track value. It must be at least as big as the
+  // number of tracks of the bundle. Remaining values are left unchanged.
+  span<float> output;
+};
+
 }  // namespace animation
 }  // namespace ozz
 #endif  // OZZ_OZZ_ANIMATION_RUNTIME_TRACK_SAMPLING_JOB_H_
@@ -34,6 +34,7 @@ namespace ozz {
 namespace animation {
 
 class FloatTrack;
+class TrackEdges;
 
 // Track edge triggering job implementation. Edge triggering wording refers to
 // signal processing, where a signal edge is a transition from low to high or
@@ -44,8 +45,14 @@ class FloatTrack;
 // triggering dated events that can be processed as state changes.
 // Only FloatTrack is supported, because comparing to a threshold for other
 // track types isn't possible.
+// Cubic keys are processed as linear ones: edges are detected when consecutive
+// key values cross the threshold, and dated by linear interpolation.
 // The job execution actually performs a lazy evaluation of edges. It builds an
 // iterator that will process the next edge on each call to ++ operator.
+// Edges can alternatively be processed from precomputed TrackEdges (see
+// TrackEdgesBuilder), in which case the job binary searches the first edge of
+// the range and only iterates actual edges, instead of evaluating all keyframes
+// of the range.
 struct TrackTriggeringJob {
   TrackTriggeringJob();
 
@@ -76,6 +83,11 @@ struct TrackTriggeringJob {
   // Track to sample.
   const FloatTrack* track;
 
+  // Optional precomputed edges of a track. If edges are set, they are used
+  // instead of track and threshold, which are then ignored. Yielded edges are
+  // the same as processing the track that edges were built from.
+  const TrackEdges* edges;
+
   // Job output iterator.
   class Iterator;
   Iterator* iterator;
@@ -139,6 +151,9 @@ class TrackTriggeringJob::Iterator {
         inner_(-2) {  // Can never be reached while looping.
   }
 
+  // Evaluates next edge from job's precomputed edges.
+  const Iterator& IncrementEdges();
+
   // Job this iterator works on.
   const TrackTriggeringJob* job_;
 
@@ -1006,6 +1006,22 @@ OZZ_INLINE SimdFloat4 ATanX(_SimdFloat4 _v) {
   return ret;
 }
 
+OZZ_INLINE SimdFloat4 ATan2(_SimdFloat4 _y, _SimdFloat4 _x) {
+  const SimdFloat4 ret = {std::atan2(_y.x, _x.x), std::atan2(_y.y, _x.y),
+                          std::atan2(_y.z, _x.z), std::atan2(_y.w, _x.w)};
+  return ret;
+}
+
+OZZ_INLINE SimdFloat4 ATan2X(_SimdFloat4 _y, _SimdFloat4 _x) {
+  const SimdFloat4 ret = {std::atan2(_y.x, _x.x), _y.y, _y.z, _y.w};
+  return ret;
+}
+
+OZZ_INLINE void SinCos(_SimdFloat4 _v, SimdFloat4* _sin, SimdFloat4* _cos) {
+  *_sin = Sin(_v);
+  *_cos = Cos(_v);
+}
+
 namespace simd_int4 {
 
 OZZ_INLINE SimdInt4 zero() {
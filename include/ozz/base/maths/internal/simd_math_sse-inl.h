@@ -889,15 +889,6 @@ OZZ_INLINE SimdFloat4 CosX(_SimdFloat4 _v) {
   return _mm_move_ss(_v, _mm_set_ps1(std::cos(GetX(_v))));
 }
 
-OZZ_INLINE SimdFloat4 ACos(_SimdFloat4 _v) {
-  return _mm_set_ps(std::acos(GetW(_v)), std::acos(GetZ(_v)),
-                    std::acos(GetY(_v)), std::acos(GetX(_v)));
-}
-
-OZZ_INLINE SimdFloat4 ACosX(_SimdFloat4 _v) {
-  return _mm_move_ss(_v, _mm_set_ps1(std::acos(GetX(_v))));
-}
-
 OZZ_INLINE SimdFloat4 Sin(_SimdFloat4 _v) {
   return _mm_set_ps(std::sin(GetW(_v)), std::sin(GetZ(_v)), std::sin(GetY(_v)),
                     std::sin(GetX(_v)));
@@ -907,15 +898,6 @@ OZZ_INLINE SimdFloat4 SinX(_SimdFloat4 _v) {
   return _mm_move_ss(_v, _mm_set_ps1(std::sin(GetX(_v))));
 }
 
-OZZ_INLINE SimdFloat4 ASin(_SimdFloat4 _v) {
-  return _mm_set_ps(std::asin(GetW(_v)), std::asin(GetZ(_v)),
-                    std::asin(GetY(_v)), std::asin(GetX(_v)));
-}
-
-OZZ_INLINE SimdFloat4 ASinX(_SimdFloat4 _v) {
-  return _mm_move_ss(_v, _mm_set_ps1(std::asin(GetX(_v))));
-}
-
 OZZ_INLINE SimdFloat4 Tan(_SimdFloat4 _v) {
   return _mm_set_ps(std::tan(GetW(_v)), std::tan(GetZ(_v)), std::tan(GetY(_v)),
                     std::tan(GetX(_v)));
@@ -925,13 +907,188 @@ OZZ_INLINE SimdFloat4 TanX(_SimdFloat4 _v) {
   return _mm_move_ss(_v, _mm_set_ps1(std::tan(GetX(_v))));
 }
 
+// Trigonometric functions below are vectorized polynomial approximations,
+// derived from Cephes library single precision implementation.
+namespace internal {
+// Computes arcsine of _v components, for a _v in range [0,.5], and _v2 its
+// square.
+OZZ_INLINE __m128 ASinPoly(__m128 _v, __m128 _v2) {
+  __m128 p = OZZ_MADD(_mm_set_ps1(4.2163199048e-2f), _v2,
+                      _mm_set_ps1(2.4181311049e-2f));
+  p = OZZ_MADD(p, _v2, _mm_set_ps1(4.5470025998e-2f));
+  p = OZZ_MADD(p, _v2, _mm_set_ps1(7.4953002686e-2f));
+  p = OZZ_MADD(p, _v2, _mm_set_ps1(1.6666752422e-1f));
+  return OZZ_MADD(_mm_mul_ps(p, _v2), _v, _v);
+}
+
+// Computes arcsine of |_v| components, outputting _big mask for components
+// that were reduced (|_v| > .5) and whose result must be reconstructed as
+// pi/2 - 2 * result.
+OZZ_INLINE __m128 ASinReduced(__m128 _v, __m128i* _big) {
+  const __m128 half = _mm_set_ps1(.5f);
+  const __m128 abs =
+      _mm_and_ps(_v, _mm_castsi128_ps(simd_int4::mask_not_sign()));
+  *_big = _mm_castps_si128(_mm_cmpgt_ps(abs, half));
+  // Big values are reduced using asin(x) = pi/2 - 2 * asin(sqrt((1 - x) / 2)).
+  const __m128 big_v2 = _mm_mul_ps(_mm_sub_ps(simd_float4::one(), abs), half);
+  const __m128 v2 = OZZ_SSE_SELECT_F(*_big, big_v2, _mm_mul_ps(abs, abs));
+  const __m128 v = OZZ_SSE_SELECT_F(*_big, _mm_sqrt_ps(big_v2), abs);
+  return ASinPoly(v, v2);
+}
+
+// Computes arctangent of _v components, for a _v in range [-1,1].
+OZZ_INLINE __m128 ATanPoly(__m128 _v) {
+  const __m128 v2 = _mm_mul_ps(_v, _v);
+  __m128 p = OZZ_MADD(_mm_set_ps1(8.05374449538e-2f), v2,
+                      _mm_set_ps1(-1.38776856032e-1f));
+  p = OZZ_MADD(p, v2, _mm_set_ps1(1.99777106478e-1f));
+  p = OZZ_MADD(p, v2, _mm_set_ps1(-3.33329491539e-1f));
+  return OZZ_MADD(_mm_mul_ps(p, v2), _v, _v);
+}
+}  // namespace internal
+
+OZZ_INLINE SimdFloat4 ACos(_SimdFloat4 _v) {
+  __m128i big;
+  const __m128 asin = internal::ASinReduced(_v, &big);
+  const __m128 sign = _mm_and_ps(_v, _mm_castsi128_ps(simd_int4::mask_sign()));
+  const __m128 signed_asin = _mm_or_ps(asin, sign);
+  // acos(x) = pi/2 - asin(x) for small values. Reduced big values are
+  // 2 * asin(sqrt((1 - x) / 2)) for positive x, pi - ... for negative x.
+  const __m128 pi = _mm_set_ps1(3.14159265358979323846f);
+  const __m128 big_acos =
+      _mm_add_ps(_mm_and_ps(pi, _mm_castsi128_ps(_mm_srai_epi32(
+                                    _mm_castps_si128(_v), 31))),
+                 _mm_add_ps(signed_asin, signed_asin));
+  const __m128 small_acos =
+      _mm_sub_ps(_mm_set_ps1(1.57079632679489661923f), signed_asin);
+  return OZZ_SSE_SELECT_F(big, big_acos, small_acos);
+}
+
+OZZ_INLINE SimdFloat4 ACosX(_SimdFloat4 _v) {
+  return _mm_move_ss(_v, ACos(_v));
+}
+
+OZZ_INLINE SimdFloat4 ASin(_SimdFloat4 _v) {
+  __m128i big;
+  const __m128 asin = internal::ASinReduced(_v, &big);
+  const __m128 big_asin = OZZ_NMADD(_mm_set_ps1(2.f), asin,
+                                    _mm_set_ps1(1.57079632679489661923f));
+  const __m128 sign = _mm_and_ps(_v, _mm_castsi128_ps(simd_int4::mask_sign()));
+  return _mm_or_ps(OZZ_SSE_SELECT_F(big, big_asin, asin), sign);
+}
+
+OZZ_INLINE SimdFloat4 ASinX(_SimdFloat4 _v) {
+  return _mm_move_ss(_v, ASin(_v));
+}
+
 OZZ_INLINE SimdFloat4 ATan(_SimdFloat4 _v) {
-  return _mm_set_ps(std::atan(GetW(_v)), std::atan(GetZ(_v)),
-                    std::atan(GetY(_v)), std::atan(GetX(_v)));
+  const __m128 one = simd_float4::one();
+  const __m128 sign = _mm_and_ps(_v, _mm_castsi128_ps(simd_int4::mask_sign()));
+  const __m128 abs = _mm_xor_ps(_v, sign);
+  // Reduces range to [-tan(pi/8), tan(pi/8)]:
+  // atan(x) = pi/2 + atan(-1 / x) if x > tan(3pi/8),
+  // atan(x) = pi/4 + atan((x - 1) / (x + 1)) if x > tan(pi/8).
+  const __m128i big =
+      _mm_castps_si128(_mm_cmpgt_ps(abs, _mm_set_ps1(2.414213562373095f)));
+  const __m128i mid =
+      _mm_castps_si128(_mm_cmpgt_ps(abs, _mm_set_ps1(.4142135623730950f)));
+  const __m128 num = OZZ_SSE_SELECT_F(
+      big, _mm_set_ps1(-1.f), OZZ_SSE_SELECT_F(mid, _mm_sub_ps(abs, one), abs));
+  const __m128 den = OZZ_SSE_SELECT_F(
+      big, abs, OZZ_SSE_SELECT_F(mid, _mm_add_ps(abs, one), one));
+  const __m128 offset = OZZ_SSE_SELECT_F(
+      big, _mm_set_ps1(1.57079632679489661923f),
+      _mm_and_ps(_mm_castsi128_ps(mid), _mm_set_ps1(.78539816339744830962f)));
+  const __m128 atan =
+      _mm_add_ps(offset, internal::ATanPoly(_mm_div_ps(num, den)));
+  return _mm_xor_ps(atan, sign);
 }
 
 OZZ_INLINE SimdFloat4 ATanX(_SimdFloat4 _v) {
-  return _mm_move_ss(_v, _mm_set_ps1(std::atan(GetX(_v))));
+  return _mm_move_ss(_v, ATan(_v));
+}
+
+OZZ_INLINE SimdFloat4 ATan2(_SimdFloat4 _y, _SimdFloat4 _x) {
+  const __m128 mask_sign = _mm_castsi128_ps(simd_int4::mask_sign());
+  const __m128 y_sign = _mm_and_ps(_y, mask_sign);
+  const __m128 x_sign = _mm_and_ps(_x, mask_sign);
+  const __m128 abs_y = _mm_xor_ps(_y, y_sign);
+  const __m128 abs_x = _mm_xor_ps(_x, x_sign);
+
+  // Computes atan in range [0,pi/4], of the smallest over the biggest
+  // component. Both components being 0 returns 0.
+  const __m128 min = _mm_min_ps(abs_x, abs_y);
+  const __m128 max = _mm_max_ps(abs_x, abs_y);
+  const __m128 ratio =
+      _mm_andnot_ps(_mm_cmpeq_ps(max, _mm_setzero_ps()), _mm_div_ps(min, max));
+  // Further reduces range to [0,pi/8], atan(x) = pi/4 + atan((x-1)/(x+1)).
+  const __m128 one = simd_float4::one();
+  const __m128i mid =
+      _mm_castps_si128(_mm_cmpgt_ps(ratio, _mm_set_ps1(.4142135623730950f)));
+  const __m128 reduced = OZZ_SSE_SELECT_F(
+      mid, _mm_div_ps(_mm_sub_ps(ratio, one), _mm_add_ps(ratio, one)), ratio);
+  __m128 atan =
+      _mm_add_ps(_mm_and_ps(_mm_castsi128_ps(mid),
+                            _mm_set_ps1(.78539816339744830962f)),
+                 internal::ATanPoly(reduced));
+
+  // Rebuilds the full circle angle, from octant to quadrant, and from
+  // quadrant to half circle. Sign of y is finally restored.
+  atan = OZZ_SSE_SELECT_F(
+      _mm_castps_si128(_mm_cmpgt_ps(abs_y, abs_x)),
+      _mm_sub_ps(_mm_set_ps1(1.57079632679489661923f), atan), atan);
+  atan = OZZ_SSE_SELECT_F(
+      _mm_srai_epi32(_mm_castps_si128(_x), 31),
+      _mm_sub_ps(_mm_set_ps1(3.14159265358979323846f), atan), atan);
+  return _mm_or_ps(atan, y_sign);
+}
+
+OZZ_INLINE SimdFloat4 ATan2X(_SimdFloat4 _y, _SimdFloat4 _x) {
+  return _mm_move_ss(_y, ATan2(_y, _x));
+}
+
+OZZ_INLINE void SinCos(_SimdFloat4 _v, SimdFloat4* _sin, SimdFloat4* _cos) {
+  const __m128i mask_sign = simd_int4::mask_sign();
+  const __m128 sign = _mm_and_ps(_v, _mm_castsi128_ps(mask_sign));
+  const __m128 abs = _mm_xor_ps(_v, sign);
+
+  // Reduces range to [-pi/4, pi/4], computing octant index (rounded up to an
+  // even value) and reduced angle. pi/4 is split in 3 parts to extend
+  // reduction precision.
+  const __m128i octant = _mm_and_si128(
+      _mm_cvttps_epi32(OZZ_MADD(abs, _mm_set_ps1(1.27323954473516f),
+                                simd_float4::one())),
+      _mm_set1_epi32(~1));
+  const __m128 y = _mm_cvtepi32_ps(octant);
+  __m128 x = OZZ_NMADD(y, _mm_set_ps1(.78515625f), abs);
+  x = OZZ_NMADD(y, _mm_set_ps1(2.4187564849853515625e-4f), x);
+  x = OZZ_NMADD(y, _mm_set_ps1(3.77489497744594108e-8f), x);
+
+  // Evaluates both polynomials.
+  const __m128 x2 = _mm_mul_ps(x, x);
+  __m128 ps = OZZ_MADD(_mm_set_ps1(-1.9515295891e-4f), x2,
+                       _mm_set_ps1(8.3321608736e-3f));
+  ps = OZZ_MADD(ps, x2, _mm_set_ps1(-1.6666654611e-1f));
+  ps = OZZ_MADD(_mm_mul_ps(ps, x2), x, x);
+  __m128 pc = OZZ_MADD(_mm_set_ps1(2.443315711809948e-5f), x2,
+                       _mm_set_ps1(-1.388731625493765e-3f));
+  pc = OZZ_MADD(pc, x2, _mm_set_ps1(4.166664568298827e-2f));
+  pc = OZZ_MADD(_mm_mul_ps(pc, x2), x2,
+                OZZ_NMADD(_mm_set_ps1(.5f), x2, simd_float4::one()));
+
+  // Selects polynomials and signs according to the octant.
+  const __m128i swap = _mm_cmpeq_epi32(
+      _mm_and_si128(octant, _mm_set1_epi32(2)), _mm_set1_epi32(2));
+  const __m128i octant_4 = _mm_and_si128(octant, _mm_set1_epi32(4));
+  const __m128 sin_sign = _mm_xor_ps(
+      sign, _mm_castsi128_ps(_mm_slli_epi32(octant_4, 29)));
+  const __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(
+      _mm_xor_si128(octant_4,
+                    _mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)),
+                                   1)),
+      29));
+  *_sin = _mm_xor_ps(OZZ_SSE_SELECT_F(swap, pc, ps), sin_sign);
+  *_cos = _mm_xor_ps(OZZ_SSE_SELECT_F(swap, ps, pc), cos_sign);
 }
 
 namespace simd_int4 {
@@ -1775,8 +1932,8 @@ inline bool ToAffine(const Float4x4& _m, SimdFloat4* _translation,
 }
 
 inline Float4x4 Float4x4::FromEuler(_SimdFloat4 _v) {
-  const __m128 cos = Cos(_v);
-  const __m128 sin = Sin(_v);
+  __m128 sin, cos;
+  SinCos(_v, &sin, &cos);
 
   const float cx = GetX(cos);
   const float sx = GetX(sin);
@@ -1807,8 +1964,8 @@ inline Float4x4 Float4x4::FromAxisAngle(_SimdFloat4 _axis, _SimdFloat4 _angle) {
   const __m128 one = _mm_castsi128_ps(ione);
   const __m128 w_axis = _mm_castsi128_ps(_mm_slli_si128(ione, 12));
 
-  const __m128 sin = SplatX(SinX(_angle));
-  const __m128 cos = SplatX(CosX(_angle));
+  __m128 sin, cos;
+  SinCos(SplatX(_angle), &sin, &cos);
   const __m128 one_minus_cos = _mm_sub_ps(one, cos);
 
   const __m128 v0 =
@@ -549,7 +549,9 @@ OZZ_INLINE SimdFloat4 Cos(_SimdFloat4 _v);
 // same as their respective components in _v.
 OZZ_INLINE SimdFloat4 CosX(_SimdFloat4 _v);
 
-// Computes the per element arccosine of _v.
+// Computes the per element arccosine of _v, which must be in range [-1,1].
+// SIMD implementations use a polynomial approximation, whose maximum absolute
+// error is 3e-7.
 OZZ_INLINE SimdFloat4 ACos(_SimdFloat4 _v);
 
 // Computes the arccosine of the x component of _v and stores it in the x
@@ -565,7 +567,9 @@ OZZ_INLINE SimdFloat4 Sin(_SimdFloat4 _v);
 // same as their respective components in _v.
 OZZ_INLINE SimdFloat4 SinX(_SimdFloat4 _v);
 
-// Computes the per element arcsine of _v.
+// Computes the per element arcsine of _v, which must be in range [-1,1].
+// SIMD implementations use a polynomial approximation, whose maximum absolute
+// error is 2e-7.
 OZZ_INLINE SimdFloat4 ASin(_SimdFloat4 _v);
 
 // Computes the arcsine of the x component of _v and stores it in the x
@@ -582,6 +586,8 @@ OZZ_INLINE SimdFloat4 Tan(_SimdFloat4 _v);
 OZZ_INLINE SimdFloat4 TanX(_SimdFloat4 _v);
 
 // Computes the per element arctangent of _v.
+// SIMD implementations use a polynomial approximation, whose maximum absolute
+// error is 2e-7.
 OZZ_INLINE SimdFloat4 ATan(_SimdFloat4 _v);
 
 // Computes the arctangent of the x component of _v and stores it in the x
@@ -589,6 +595,25 @@ OZZ_INLINE SimdFloat4 ATan(_SimdFloat4 _v);
 // same as their respective components in _v.
 OZZ_INLINE SimdFloat4 ATanX(_SimdFloat4 _v);
 
+// Computes the per element arctangent of _y / _x, using the signs of both
+// arguments to determine the quadrant of the result, in range [-pi,pi]. Like
+// std::atan2, returns +/-0 or +/-pi if both _y and _x are +/-0.
+// SIMD implementations use a polynomial approximation, whose maximum absolute
+// error is 3e-7. Infinite arguments aren't supported.
+OZZ_INLINE SimdFloat4 ATan2(_SimdFloat4 _y, _SimdFloat4 _x);
+
+// Computes the arctangent of the x components of _y / _x and stores it in the x
+// component of the returned vector. y, z and w of the returned vector are the
+// same as their respective components in _y.
+OZZ_INLINE SimdFloat4 ATan2X(_SimdFloat4 _y, _SimdFloat4 _x);
+
+// Computes the per element sine and cosine of _v, sharing range reduction.
+// This is faster than calling Sin and Cos, as SIMD implementations use a
+// polynomial approximation, whose maximum absolute error is 1e-7 for |_v| up to
+// 8192. Precision degrades beyond, where Sin and Cos functions should be
+// preferred.
+OZZ_INLINE void SinCos(_SimdFloat4 _v, SimdFloat4* _sin, SimdFloat4* _cos);
+
 // Returns boolean selection of vectors _true and _false according to condition
 // _b. All bits a each component of _b must have the same value (O or
 // 0xffffffff) to ensure portability.
@@ -162,8 +162,8 @@ OZZ_INLINE SimdQuaternion SimdQuaternion::FromAxisAngle(_SimdFloat4 _axis,
                                                         _SimdFloat4 _angle) {
   assert(AreAllTrue1(IsNormalizedEst3(_axis)) && "axis is not normalized.");
   const SimdFloat4 half_angle = _angle * simd_float4::Load1(.5f);
-  const SimdFloat4 half_sin = SinX(half_angle);
-  const SimdFloat4 half_cos = CosX(half_angle);
+  SimdFloat4 half_sin, half_cos;
+  SinCos(half_angle, &half_sin, &half_cos);
   const SimdQuaternion quat = {SetW(_axis * SplatX(half_sin), half_cos)};
   return quat;
 }
@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#ifndef OZZ_OZZ_BASE_MEMORY_TRACKING_ALLOCATOR_H_
+#define OZZ_OZZ_BASE_MEMORY_TRACKING_ALLOCATOR_H_
+
+#include <atomic>
+
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+namespace memory {
+
+// Identifies ozz subsystems that allocate memory, so memory usage can be
+// broken down per subsystem by a TrackingAllocator.
+enum Tag {
+  kUntagged,   // Allocations done outside of any tagged scope.
+  kAnimation,  // Animation runtime data.
+  kSkeleton,   // Skeleton runtime data.
+  kTrack,      // Track runtime data.
+  kCache,      // Runtime caches, like SamplingCache.
+  kBuilder,    // Offline builders and optimizers temporary data.
+  kTagCount,
+};
+
+// Returns the name of _tag, or nullptr if _tag isn't valid.
+const char* TagName(Tag _tag);
+
+// Returns the tag of the current thread, kUntagged by default.
+Tag current_tag();
+
+// Sets the tag of the current thread for the lifetime of the ScopedTag object.
+// Previous tag is restored on destruction, so scopes can be nested.
+class ScopedTag {
+ public:
+  explicit ScopedTag(Tag _tag);
+  ~ScopedTag();
+
+ private:
+  // Disables copy and assignation.
+  ScopedTag(const ScopedTag&);
+  void operator=(const ScopedTag&);
+
+  Tag previous_;
+};
+
+// Allocator wrapper that accounts allocations per tag, forwarding them to
+// another allocator. Allocations are tagged with the tag of the allocating
+// thread (see ScopedTag).
+// It's an optional tool that has to be installed with
+// ozz::memory::SetDefaulAllocator(), before any ozz allocation is done, as
+// blocks allocated by another allocator can't be deallocated by this one.
+// Tracking is thread safe.
+class TrackingAllocator : public Allocator {
+ public:
+  // Constructs a tracking allocator that forwards allocations to _allocator.
+  // _allocator must outlive *this allocator.
+  explicit TrackingAllocator(Allocator* _allocator);
+
+  // Asserts all tracked memory was deallocated.
+  virtual ~TrackingAllocator();
+
+  // Memory statistics.
+  struct Statistics {
+    // Currently allocated bytes.
+    size_t bytes;
+    // High-water mark of allocated bytes.
+    size_t peak_bytes;
+    // Number of currently allocated blocks.
+    size_t blocks;
+    // Total number of allocations since creation.
+    size_t allocations;
+  };
+
+  // Gets statistics of allocations tagged with _tag.
+  Statistics statistics(Tag _tag) const;
+
+  // Gets statistics of all allocations, whatever their tag. Note that total
+  // peak isn't the sum of tags peaks, as they aren't necessarily reached at
+  // the same time.
+  Statistics total() const;
+
+  // Resets high-water marks to current allocated bytes.
+  void ResetPeaks();
+
+  virtual void* Allocate(size_t _size, size_t _alignment);
+  virtual void Deallocate(void* _block);
+
+ private:
+  // Disables copy and assignation.
+  TrackingAllocator(const TrackingAllocator&);
+  void operator=(const TrackingAllocator&);
+
+  // Atomic counters, updated concurrently.
+  struct Counters {
+    std::atomic<size_t> bytes;
+    std::atomic<size_t> peak_bytes;
+    std::atomic<size_t> blocks;
+    std::atomic<size_t> allocations;
+  };
+
+  void Track(Counters* _counters, size_t _size);
+  void Untrack(Counters* _counters, size_t _size);
+  static Statistics Read(const Counters& _counters);
+
+  // Allocator allocations are forwarded to.
+  Allocator* allocator_;
+
+  // Per tag counters.
+  Counters tags_[kTagCount];
+
+  // All allocations counters.
+  Counters total_;
+};
+}  // namespace memory
+}  // namespace ozz
+#endif  // OZZ_OZZ_BASE_MEMORY_TRACKING_ALLOCATOR_H_
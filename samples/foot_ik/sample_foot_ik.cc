@@ -27,6 +27,7 @@
 
 #include "ozz/animation/runtime/animation.h"
 #include "ozz/animation/runtime/ik_aim_job.h"
+#include "ozz/animation/runtime/ik_correction_job.h"
 #include "ozz/animation/runtime/ik_two_bone_job.h"
 #include "ozz/animation/runtime/local_to_model_job.h"
 #include "ozz/animation/runtime/sampling_job.h"
@@ -319,11 +320,6 @@ class FootIKSampleApplication : public ozz::sample::Application {
     const ozz::math::Float4x4 root = GetOffsettedRootTransform();
     const ozz::math::Float4x4 inv_root = Invert(root);
 
-    ozz::animation::LocalToModelJob ltm_job;
-    ltm_job.skeleton = &skeleton_;
-    ltm_job.input = make_span(locals_);
-    ltm_job.output = make_span(models_);
-
     // Perform IK
     for (size_t l = 0; l < kLegsCount; ++l) {
       const LegRayInfo& ray = rays_info_[l];
@@ -333,36 +329,18 @@ class FootIKSampleApplication : public ozz::sample::Application {
       const LegSetup& leg = legs_setup_[l];
 
       // Updates leg joint chain so ankle reaches its targetted position.
+      // Hip and knee hierarchies model-space transforms are updated as well.
       if (two_bone_ik_ &&
           !ApplyLegTwoBoneIK(leg, ankles_target_ws_[l], inv_root)) {
         return false;
       }
 
-      // Updates leg joints model-space transforms.
-      // Update will go from hip to ankle. Ankle's siblings might no be updated
-      // as local-to-model will stop as soon as ankle joint is reached.
-      ltm_job.from = leg.hip;
-      ltm_job.to = leg.ankle;
-      if (!ltm_job.Run()) {
-        return false;
-      }
-
       // Computes ankle orientation so it's aligned to the floor normal.
       const ozz::math::Float3 aim_ik_target(ankles_target_ws_[l] +
                                             ray.hit_normal);
       if (aim_ik_ && !ApplyAnkleAimIK(leg, aim_ik_target, inv_root)) {
         return false;
       }
-
-      // Updates model-space transformation now ankle local changes is done.
-      // Ankle rotation has already been updated, but its siblings (or it's
-      // parent siblings) might are not. So we local-to-model update must
-      // be complete starting from hip.
-      ltm_job.from = leg.hip;
-      ltm_job.to = ozz::animation::Skeleton::kMaxJoints;
-      if (!ltm_job.Run()) {
-        return false;
-      }
     }
     return true;
   }
@@ -396,15 +374,17 @@ class FootIKSampleApplication : public ozz::sample::Application {
     if (!ik_job.Run()) {
       return false;
     }
-    // Apply IK quaternions to their respective local-space transforms.
-    // Model-space transformations needs to be updated after a call to this
-    // function.
-    ozz::sample::MultiplySoATransformQuaternion(_leg.hip, start_correction,
-                                                make_span(locals_));
-    ozz::sample::MultiplySoATransformQuaternion(_leg.knee, mid_correction,
-                                                make_span(locals_));
-
-    return true;
+    // Apply IK quaternions to their respective local-space transforms, and
+    // updates hip and knee hierarchies model-space transforms accordingly.
+    // Corrections must be sorted by joint index, parents first.
+    const ozz::animation::IKCorrectionJob::Correction corrections[] = {
+        {_leg.hip, start_correction}, {_leg.knee, mid_correction}};
+    ozz::animation::IKCorrectionJob correction_job;
+    correction_job.skeleton = &skeleton_;
+    correction_job.corrections = corrections;
+    correction_job.models = make_span(models_);
+    correction_job.locals = make_span(locals_);
+    return correction_job.Run();
   }
 
   // This function will compute aim IK on the ankle, updating its rotations so
@@ -440,13 +420,16 @@ class FootIKSampleApplication : public ozz::sample::Application {
     if (!ik_job.Run()) {
       return false;
     }
-    // Apply IK quaternions to their respective local-space transforms.
-    // Model-space transformations needs to be updated after a call to this
-    // function.
-    ozz::sample::MultiplySoATransformQuaternion(_leg.ankle, correction,
-                                                make_span(locals_));
-
-    return true;
+    // Apply IK quaternion to ankle local-space transform, and updates ankle
+    // hierarchy model-space transforms accordingly.
+    const ozz::animation::IKCorrectionJob::Correction corrections[] = {
+        {_leg.ankle, correction}};
+    ozz::animation::IKCorrectionJob correction_job;
+    correction_job.skeleton = &skeleton_;
+    correction_job.corrections = corrections;
+    correction_job.models = make_span(models_);
+    correction_job.locals = make_span(locals_);
+    return correction_job.Run();
   }
 
   virtual bool OnDisplay(ozz::sample::Renderer* _renderer) {
@@ -443,12 +443,12 @@ int DrawPosture_FillUniforms(const ozz::animation::Skeleton& _skeleton,
 
   // Prepares computation constants.
   const int num_joints = _skeleton.num_joints();
-  const span<const int16_t>& parents = _skeleton.joint_parents();
+  const span<const int32_t>& parents = _skeleton.joint_parents();
 
   int instances = 0;
   for (int i = 0; i < num_joints && instances < _max_instances; ++i) {
     // Root isn't rendered.
-    const int16_t parent_id = parents[i];
+    const int parent_id = parents[i];
     if (parent_id == ozz::animation::Skeleton::kNoParent) {
       continue;
     }
@@ -602,7 +602,7 @@ bool RendererImpl::DrawPosture(const ozz::animation::Skeleton& _skeleton,
   }
 
   // Convert matrices to uniforms.
-  const int max_skeleton_pieces = animation::Skeleton::kMaxJoints * 2;
+  const int max_skeleton_pieces = _skeleton.num_joints() * 2;
   const size_t max_uniforms_size = max_skeleton_pieces * 2 * 16 * sizeof(float);
   float* uniforms =
       static_cast<float*>(scratch_buffer_.Resize(max_uniforms_size));
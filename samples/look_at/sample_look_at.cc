@@ -27,6 +27,7 @@
 
 #include "ozz/animation/runtime/animation.h"
 #include "ozz/animation/runtime/ik_aim_job.h"
+#include "ozz/animation/runtime/ik_correction_job.h"
 #include "ozz/animation/runtime/local_to_model_job.h"
 #include "ozz/animation/runtime/sampling_job.h"
 #include "ozz/animation/runtime/skeleton.h"
@@ -139,6 +140,10 @@ class LookAtSampleApplication : public ozz::sample::Application {
     ozz::math::SimdQuaternion correction;
     ik_job.joint_correction = &correction;
 
+    // Corrections of all chain joints, applied once the whole chain is solved.
+    // They're sorted parent first, as expected by IKCorrectionJob.
+    ozz::animation::IKCorrectionJob::Correction corrections[kMaxChainLength];
+
     // The algorithm iteratively updates from the first joint (closer to the
     // head) to the last (the further ancestor, closer to the pelvis). Joints
     // order is already validated. For the first joint, aim IK is applied with
@@ -197,16 +202,22 @@ class LookAtSampleApplication : public ozz::sample::Application {
         return false;
       }
 
-      // Apply IK quaternion to its respective local-space transforms.
-      ozz::sample::MultiplySoATransformQuaternion(joint, correction,
-                                                  make_span(locals_));
+      // Stores IK quaternion, to be applied to its respective joint.
+      ozz::animation::IKCorrectionJob::Correction& chain_correction =
+          corrections[chain_length_ - 1 - i];
+      chain_correction.joint = joint;
+      chain_correction.rotation = correction;
     }
 
-    // Skeleton model-space matrices need to be updated again. This re-uses the
-    // already setup job, but limits the update to childs of the last joint (the
-    // parent-iest of the chain).
-    ltm_job.from = previous_joint;
-    if (!ltm_job.Run()) {
+    // Applies corrections to skeleton model-space matrices. This updates
+    // chain joints and their children matrices only, without needing to
+    // convert local-space transforms again.
+    ozz::animation::IKCorrectionJob correction_job;
+    correction_job.skeleton = &skeleton_;
+    correction_job.corrections = {corrections,
+                                  static_cast<size_t>(chain_length_)};
+    correction_job.models = make_span(models_);
+    if (!correction_job.Run()) {
       return false;
     }
 
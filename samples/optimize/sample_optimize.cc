@@ -32,6 +32,7 @@
 
 #include "ozz/animation/offline/animation_builder.h"
 #include "ozz/animation/offline/animation_optimizer.h"
+#include "ozz/animation/offline/joints_setting_builder.h"
 #include "ozz/animation/offline/raw_animation.h"
 #include "ozz/animation/offline/raw_animation_utils.h"
 
@@ -50,6 +51,7 @@
 
 #include "framework/application.h"
 #include "framework/imgui.h"
+#include "framework/mesh.h"
 #include "framework/profile.h"
 #include "framework/renderer.h"
 #include "framework/utils.h"
@@ -63,6 +65,11 @@ OZZ_OPTIONS_DECLARE_STRING(skeleton, "Path to the runtime skeleton file.",
 OZZ_OPTIONS_DECLARE_STRING(animation, "Path to the raw animation file.",
                            "media/animation_raw.ozz", false)
 
+OZZ_OPTIONS_DECLARE_STRING(mesh,
+                           "Path to the skinned mesh (ozz archive format), "
+                           "used to derive per joint optimization settings.",
+                           "media/mesh.ozz", false)
+
 namespace {
 
 // Loads a raw animation from a file.
@@ -97,6 +104,7 @@ class OptimizeSampleApplication : public ozz::sample::Application {
   OptimizeSampleApplication()
       : selected_display_(eRuntimeAnimation),
         optimize_(true),
+        mesh_setting_enable_(true),
         joint_setting_enable_(true),
         joint_(0),
         error_record_med_(64),
@@ -185,14 +193,14 @@ class OptimizeSampleApplication : public ozz::sample::Application {
     // Computes the absolute error, aka the difference between the raw and
     // runtime model space transformation.
     const size_t num_joints = models_rt_.size();
-    float errors_sq[ozz::animation::Skeleton::kMaxJoints];
+    ozz::vector<float> errors_sq(num_joints);
     for (size_t i = 0; i < num_joints; ++i) {
       // Computes error based on the translation difference.
       errors_sq[i] = ozz::math::GetX(ozz::math::Length3Sqr(
           models_rt_[i].cols[3] - models_raw_[i].cols[3]));
     }
 
-    std::sort(errors_sq, errors_sq + models_rt_.size());
+    std::sort(errors_sq.begin(), errors_sq.end());
     error_record_med_.Push(std::sqrt(errors_sq[num_joints / 2]) * 1000.f);
     error_record_max_.Push(std::sqrt(errors_sq[num_joints - 1]) * 1000.f);
     joint_error_record_.Push(std::sqrt(errors_sq[joint_]) * 1000.f);
@@ -295,6 +303,12 @@ class OptimizeSampleApplication : public ozz::sample::Application {
       return false;
     }
 
+    // Reads skinned meshes and converts them to the joints setting builder
+    // input format.
+    if (!LoadSkinnedParts(OPTIONS_mesh)) {
+      return false;
+    }
+
     const int num_joints = skeleton_.num_joints();
     const int num_soa_joints = skeleton_.num_soa_joints();
 
@@ -326,6 +340,49 @@ class OptimizeSampleApplication : public ozz::sample::Application {
     return true;
   }
 
+  // Loads meshes from _filename and converts their parts to skeleton joint
+  // indices and weights, as expected by JointsSettingBuilder.
+  bool LoadSkinnedParts(const char* _filename) {
+    ozz::vector<ozz::sample::Mesh> meshes;
+    if (!ozz::sample::LoadMeshes(_filename, &meshes)) {
+      return false;
+    }
+    for (const ozz::sample::Mesh& mesh : meshes) {
+      if (mesh.highest_joint_index() >= skeleton_.num_joints()) {
+        ozz::log::Err() << "The provided mesh doesn't match skeleton "
+                           "(joint count mismatch)."
+                        << std::endl;
+        return false;
+      }
+      for (const ozz::sample::Mesh::Part& part : mesh.parts) {
+        const int vertex_count = part.vertex_count();
+        const int influences = part.influences_count();
+        skinned_parts_.resize(skinned_parts_.size() + 1);
+        SkinnedPart& skinned = skinned_parts_.back();
+        skinned.influences = influences;
+        for (int v = 0; v < vertex_count; ++v) {
+          skinned.positions.push_back(ozz::math::Float3(
+              part.positions[v * 3 + 0], part.positions[v * 3 + 1],
+              part.positions[v * 3 + 2]));
+
+          // Last weight isn't stored, it's restored from the others.
+          float remaining = 1.f;
+          for (int i = 0; i < influences; ++i) {
+            const uint16_t index = part.joint_indices[v * influences + i];
+            skinned.joint_indices.push_back(mesh.joint_remaps[index]);
+            const float weight =
+                i < influences - 1
+                    ? part.joint_weights[v * (influences - 1) + i]
+                    : remaining;
+            skinned.joint_weights.push_back(weight);
+            remaining -= weight;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
   virtual bool OnGui(ozz::sample::ImGui* _im_gui) {
     char label[64];
     // Exposes animation runtime playback controls.
@@ -355,6 +412,9 @@ class OptimizeSampleApplication : public ozz::sample::Application {
         rebuild |= _im_gui->DoSlider(label, 0.f, 1.f, &setting_.distance, .5f,
                                      optimize_);
 
+        rebuild |= _im_gui->DoCheckBox("Enable mesh settings",
+                                       &mesh_setting_enable_, optimize_);
+
         rebuild |= _im_gui->DoCheckBox("Enable joint setting",
                                        &joint_setting_enable_, optimize_);
 
@@ -477,11 +537,29 @@ class OptimizeSampleApplication : public ozz::sample::Application {
       // Setup global optimization settings.
       optimizer.setting = setting_;
 
+      // Derives joint specific optimization settings from the skinned mesh,
+      // so that joints moving small geometry are optimized more aggressively.
+      if (mesh_setting_enable_) {
+        ozz::vector<ozz::animation::offline::JointsSettingBuilder::Mesh> meshes(
+            skinned_parts_.size());
+        for (size_t i = 0; i < skinned_parts_.size(); ++i) {
+          meshes[i].positions = make_span(skinned_parts_[i].positions);
+          meshes[i].influences = skinned_parts_[i].influences;
+          meshes[i].joint_indices = make_span(skinned_parts_[i].joint_indices);
+          meshes[i].joint_weights = make_span(skinned_parts_[i].joint_weights);
+        }
+        ozz::animation::offline::JointsSettingBuilder builder;
+        builder.tolerance = setting_.tolerance;
+        builder.unskinned = setting_;
+        if (!builder(skeleton_, make_span(meshes),
+                     &optimizer.joints_setting_override)) {
+          return false;
+        }
+      }
+
       // Setup joint specific optimization settings.
       if (joint_setting_enable_) {
         optimizer.joints_setting_override[joint_] = joint_setting_;
-      } else {
-        optimizer.joints_setting_override.clear();
       }
 
       if (!optimizer(raw_animation_, skeleton_, &raw_optimized_animation_)) {
@@ -528,6 +606,18 @@ class OptimizeSampleApplication : public ozz::sample::Application {
   // Optimizer global settings.
   ozz::animation::offline::AnimationOptimizer::Setting setting_;
 
+  // Skinned mesh part, converted to skeleton joint indices and weights.
+  struct SkinnedPart {
+    ozz::vector<ozz::math::Float3> positions;
+    int influences;
+    ozz::vector<uint16_t> joint_indices;
+    ozz::vector<float> joint_weights;
+  };
+  ozz::vector<SkinnedPart> skinned_parts_;
+
+  // Select whether joint settings are derived from the skinned mesh.
+  bool mesh_setting_enable_;
+
   // Optimizer joint specific settings.
   bool joint_setting_enable_;
   int joint_;
@@ -32,6 +32,7 @@
 
 #include "ozz/animation/offline/raw_animation.h"
 #include "ozz/base/maths/transform.h"
+#include "ozz/base/memory/tracking_allocator.h"
 
 namespace ozz {
 namespace animation {
@@ -77,6 +78,8 @@ AdditiveAnimationBuilder::AdditiveAnimationBuilder() {}
 
 bool AdditiveAnimationBuilder::operator()(const RawAnimation& _input,
                                           RawAnimation* _output) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
   if (!_output) {
     return false;
   }
@@ -124,6 +127,8 @@ bool AdditiveAnimationBuilder::operator()(
     const RawAnimation& _input,
     const span<const math::Transform>& _reference_pose,
     RawAnimation* _output) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
   if (!_output) {
     return false;
   }
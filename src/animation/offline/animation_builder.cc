@@ -38,6 +38,7 @@
 #include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/simd_math.h"
 #include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
 
 // Internal include file
 #define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
@@ -154,7 +155,7 @@ bool LessAbs(float _left, float _right) {
 }
 
 // Compresses quaternion to ozz::animation::RotationKey format.
-// The 3 smallest components of the quaternion are quantized to 16 bits
+// The 3 smallest components of the quaternion are quantized to 15 bits
 // integers, while the largest is recomputed thanks to quaternion normalization
 // property (x^2+y^2+z^2+w^2 = 1). Because the 3 components are the 3 smallest,
 // their value cannot be greater than sqrt(2)/2. Thus quantization quality is
@@ -165,21 +166,18 @@ void CompressQuat(const ozz::math::Quaternion& _src,
   const float quat[4] = {_src.x, _src.y, _src.z, _src.w};
   const size_t largest = std::max_element(quat, quat + 4, LessAbs) - quat;
   assert(largest <= 3);
-  _dest->largest = largest & 0x3;
 
-  // Stores the sign of the largest component.
-  _dest->sign = quat[largest] < 0.f;
-
-  // Quantize the 3 smallest components on 16 bits signed integers.
+  // Quantize the 3 smallest components on 15 bits signed integers, scaled as
+  // 16 bits ones. The remaining bit of each value stores the largest
+  // component index and its sign.
   const float kFloat2Int = 32767.f * math::kSqrt2;
   const int kMapping[4][3] = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
   const int* map = kMapping[largest];
-  const int a = static_cast<int>(floor(quat[map[0]] * kFloat2Int + .5f));
-  const int b = static_cast<int>(floor(quat[map[1]] * kFloat2Int + .5f));
-  const int c = static_cast<int>(floor(quat[map[2]] * kFloat2Int + .5f));
-  _dest->value[0] = math::Clamp(-32767, a, 32767) & 0xffff;
-  _dest->value[1] = math::Clamp(-32767, b, 32767) & 0xffff;
-  _dest->value[2] = math::Clamp(-32767, c, 32767) & 0xffff;
+  const int values[3] = {
+      static_cast<int>(floor(quat[map[0]] * kFloat2Int * .5f + .5f)) * 2,
+      static_cast<int>(floor(quat[map[1]] * kFloat2Int * .5f + .5f)) * 2,
+      static_cast<int>(floor(quat[map[2]] * kFloat2Int * .5f + .5f)) * 2};
+  _dest->Pack(static_cast<int>(largest), quat[largest] < 0.f, values);
 }
 
 // Specialize for rotations in order to normalize quaternions.
@@ -243,6 +241,8 @@ void CopyToAnimation(ozz::vector<SortingRotationKey>* _src,
 // in the RawAnimation then the builder creates it.
 unique_ptr<Animation> AnimationBuilder::operator()(
     const RawAnimation& _input) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
   // Tests _raw_animation validity.
   if (!_input.Validate()) {
     return nullptr;
@@ -261,11 +261,12 @@ unique_ptr<Animation> AnimationBuilder::operator()(
   // if duration is 0.
   assert(duration > 0.f);  // This case is handled by Validate().
 
-  // Sets tracks count. Can be safely casted to uint16_t as number of tracks as
-  // already been validated.
-  const uint16_t num_tracks = static_cast<uint16_t>(_input.num_tracks());
+  // Sets tracks count. Track indices can be safely casted to uint16_t as
+  // number of tracks as already been validated. Note that the soa aligned
+  // number of tracks can exceed uint16_t range though.
+  const int num_tracks = _input.num_tracks();
   animation->num_tracks_ = num_tracks;
-  const uint16_t num_soa_tracks = Align(num_tracks, 4);
+  const int num_soa_tracks = Align(num_tracks, 4);
 
   // Declares and preallocates tracks to sort.
   size_t translations = 0, rotations = 0, scales = 0;
@@ -283,27 +284,29 @@ unique_ptr<Animation> AnimationBuilder::operator()(
   sorting_scales.reserve(scales);
 
   // Filters RawAnimation keys and copies them to the output sorting structure.
-  uint16_t i = 0;
+  int i = 0;
   for (; i < num_tracks; ++i) {
     const RawAnimation::JointTrack& raw_track = _input.tracks[i];
-    CopyRaw(raw_track.translations, i, duration, &sorting_translations);
-    CopyRaw(raw_track.rotations, i, duration, &sorting_rotations);
-    CopyRaw(raw_track.scales, i, duration, &sorting_scales);
+    const uint16_t track = static_cast<uint16_t>(i);
+    CopyRaw(raw_track.translations, track, duration, &sorting_translations);
+    CopyRaw(raw_track.rotations, track, duration, &sorting_rotations);
+    CopyRaw(raw_track.scales, track, duration, &sorting_scales);
   }
 
   // Add enough identity keys to match soa requirements.
   for (; i < num_soa_tracks; ++i) {
+    const uint16_t track = static_cast<uint16_t>(i);
     typedef RawAnimation::TranslationKey SrcTKey;
-    PushBackIdentityKey<SrcTKey>(i, 0.f, &sorting_translations);
-    PushBackIdentityKey<SrcTKey>(i, duration, &sorting_translations);
+    PushBackIdentityKey<SrcTKey>(track, 0.f, &sorting_translations);
+    PushBackIdentityKey<SrcTKey>(track, duration, &sorting_translations);
 
     typedef RawAnimation::RotationKey SrcRKey;
-    PushBackIdentityKey<SrcRKey>(i, 0.f, &sorting_rotations);
-    PushBackIdentityKey<SrcRKey>(i, duration, &sorting_rotations);
+    PushBackIdentityKey<SrcRKey>(track, 0.f, &sorting_rotations);
+    PushBackIdentityKey<SrcRKey>(track, duration, &sorting_rotations);
 
     typedef RawAnimation::ScaleKey SrcSKey;
-    PushBackIdentityKey<SrcSKey>(i, 0.f, &sorting_scales);
-    PushBackIdentityKey<SrcSKey>(i, duration, &sorting_scales);
+    PushBackIdentityKey<SrcSKey>(track, 0.f, &sorting_scales);
+    PushBackIdentityKey<SrcSKey>(track, duration, &sorting_scales);
   }
 
   // Allocate animation members.
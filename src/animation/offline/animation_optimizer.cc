@@ -27,28 +27,37 @@
 
 #include "ozz/animation/offline/animation_optimizer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <functional>
+#include <limits>
+#include <queue>
 
 // Internal include file
 #define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
 #include "animation/offline/decimate.h"
 #include "ozz/animation/offline/raw_animation.h"
 #include "ozz/animation/offline/raw_animation_utils.h"
+#include "ozz/animation/offline/task_runner.h"
 #include "ozz/animation/runtime/skeleton.h"
 #include "ozz/animation/runtime/skeleton_utils.h"
 #include "ozz/base/containers/stack.h"
 #include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/math_constant.h"
 #include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/memory/tracking_allocator.h"
 
 namespace ozz {
 namespace animation {
 namespace offline {
 
 // Setup default values (favoring quality).
-AnimationOptimizer::AnimationOptimizer() {}
+AnimationOptimizer::AnimationOptimizer()
+    : mode(kHierarchical),
+      algorithm(kRamerDouglasPeucker),
+      task_runner(nullptr) {}
 
 namespace {
 
@@ -167,7 +176,10 @@ struct HierarchyBuilder {
 class PositionAdapter {
  public:
   PositionAdapter(float _scale) : scale_(_scale) {}
-  bool Decimable(const RawAnimation::TranslationKey&) const { return true; }
+  bool Decimable(const RawAnimation::TranslationKey&,
+                 const RawAnimation::TranslationKey&) const {
+    return true;
+  }
   RawAnimation::TranslationKey Lerp(
       const RawAnimation::TranslationKey& _left,
       const RawAnimation::TranslationKey& _right,
@@ -182,6 +194,20 @@ class PositionAdapter {
                  const RawAnimation::TranslationKey& _b) const {
     return Length(_a.value - _b.value) * scale_;
   }
+  math::SimdFloat4 Distance4(const RawAnimation::TranslationKey& _left,
+                             const RawAnimation::TranslationKey& _right,
+                             const RawAnimation::TranslationKey* _keys) const {
+    math::SimdFloat4 values[3];
+    internal::LoadSoa<3>(&_keys[0].value.x, &_keys[1].value.x,
+                         &_keys[2].value.x, &_keys[3].value.x, values);
+    const math::SimdFloat4 alpha = internal::Alpha4(
+        _left.time, _right.time,
+        math::simd_float4::Load(_keys[0].time, _keys[1].time, _keys[2].time,
+                                _keys[3].time));
+    return internal::LerpDistance4<3>(&_left.value.x, &_right.value.x, values,
+                                      alpha) *
+           math::simd_float4::Load1(scale_);
+  }
 
  private:
   float scale_;
@@ -190,7 +216,10 @@ class PositionAdapter {
 class RotationAdapter {
  public:
   RotationAdapter(float _radius) : radius_(_radius) {}
-  bool Decimable(const RawAnimation::RotationKey&) const { return true; }
+  bool Decimable(const RawAnimation::RotationKey&,
+                 const RawAnimation::RotationKey&) const {
+    return true;
+  }
   RawAnimation::RotationKey Lerp(const RawAnimation::RotationKey& _left,
                                  const RawAnimation::RotationKey& _right,
                                  const RawAnimation::RotationKey& _ref) const {
@@ -213,6 +242,28 @@ class RotationAdapter {
     const float distance = 2.f * sine_half_angle * radius_;
     return distance;
   }
+  math::SimdFloat4 Distance4(const RawAnimation::RotationKey& _left,
+                             const RawAnimation::RotationKey& _right,
+                             const RawAnimation::RotationKey* _keys) const {
+    // Finds the shortest path, as LerpRotation does.
+    const math::Quaternion right =
+        Dot(_left.value, _right.value) < 0.f ? -_right.value : _right.value;
+    math::SimdFloat4 values[4];
+    internal::LoadSoa<4>(&_keys[0].value.x, &_keys[1].value.x,
+                         &_keys[2].value.x, &_keys[3].value.x, values);
+    const math::SimdFloat4 alpha = internal::Alpha4(
+        _left.time, _right.time,
+        math::simd_float4::Load(_keys[0].time, _keys[1].time, _keys[2].time,
+                                _keys[3].time));
+    const math::SimdFloat4 cos_half_angle =
+        internal::NLerpDot4(&_left.value.x, &right.x, values, alpha);
+    const math::SimdFloat4 sine_half_angle =
+        math::Sqrt(math::simd_float4::one() -
+                   math::Min(math::simd_float4::one(),
+                             cos_half_angle * cos_half_angle));
+    return math::simd_float4::Load1(2.f) * sine_half_angle *
+           math::simd_float4::Load1(radius_);
+  }
 
  private:
   float radius_;
@@ -221,7 +272,10 @@ class RotationAdapter {
 class ScaleAdapter {
  public:
   ScaleAdapter(float _length) : length_(_length) {}
-  bool Decimable(const RawAnimation::ScaleKey&) const { return true; }
+  bool Decimable(const RawAnimation::ScaleKey&,
+                 const RawAnimation::ScaleKey&) const {
+    return true;
+  }
   RawAnimation::ScaleKey Lerp(const RawAnimation::ScaleKey& _left,
                               const RawAnimation::ScaleKey& _right,
                               const RawAnimation::ScaleKey& _ref) const {
@@ -235,15 +289,536 @@ class ScaleAdapter {
                  const RawAnimation::ScaleKey& _right) const {
     return Length(_left.value - _right.value) * length_;
   }
+  math::SimdFloat4 Distance4(const RawAnimation::ScaleKey& _left,
+                             const RawAnimation::ScaleKey& _right,
+                             const RawAnimation::ScaleKey* _keys) const {
+    math::SimdFloat4 values[3];
+    internal::LoadSoa<3>(&_keys[0].value.x, &_keys[1].value.x,
+                         &_keys[2].value.x, &_keys[3].value.x, values);
+    const math::SimdFloat4 alpha = internal::Alpha4(
+        _left.time, _right.time,
+        math::simd_float4::Load(_keys[0].time, _keys[1].time, _keys[2].time,
+                                _keys[3].time));
+    return internal::LerpDistance4<3>(&_left.value.x, &_right.value.x, values,
+                                      alpha) *
+           math::simd_float4::Load1(length_);
+  }
 
  private:
   float length_;
 };
+
+// Optimizes a single channel (translation, rotation or scale) of a track per
+// task index. Channels are independent once hierarchy specs are known.
+class OptimizeTask : public Task {
+ public:
+  OptimizeTask(const RawAnimation& _input, const Skeleton& _skeleton,
+               const HierarchyBuilder& _hierarchy,
+               DecimationAlgorithm _algorithm, RawAnimation* _output)
+      : input_(_input),
+        skeleton_(_skeleton),
+        hierarchy_(_hierarchy),
+        algorithm_(_algorithm),
+        output_(_output),
+        tag_(memory::current_tag()) {}
+
+  static const int kChannels = 3;
+
+  virtual void Execute(int _index) const {
+    const memory::ScopedTag tag(tag_);
+
+    const int track = _index / kChannels;
+    const RawAnimation::JointTrack& input = input_.tracks[track];
+    RawAnimation::JointTrack& output = output_->tracks[track];
+
+    // Gets joint specs back.
+    const float joint_length = hierarchy_.specs[track].length;
+    const int parent = skeleton_.joint_parents()[track];
+    const float parent_scale =
+        (parent != Skeleton::kNoParent) ? hierarchy_.specs[parent].scale : 1.f;
+    const float tolerance = hierarchy_.specs[track].tolerance;
+
+    // Filters independently T, R and S tracks.
+    switch (_index % kChannels) {
+      case 0: {
+        // This joint translation is affected by parent scale.
+        const PositionAdapter tadap(parent_scale);
+        Decimate(input.translations, tadap, tolerance, algorithm_,
+                 &output.translations);
+        break;
+      }
+      case 1: {
+        // This joint rotation affects children translations/length.
+        const RotationAdapter radap(joint_length);
+        Decimate(input.rotations, radap, tolerance, algorithm_,
+                 &output.rotations);
+        break;
+      }
+      default: {
+        // This joint scale affects children translations/length.
+        const ScaleAdapter sadap(joint_length);
+        Decimate(input.scales, sadap, tolerance, algorithm_, &output.scales);
+        break;
+      }
+    }
+  }
+
+ private:
+  // Disables copy and assignment.
+  OptimizeTask(const OptimizeTask&);
+  void operator=(const OptimizeTask&);
+
+  const RawAnimation& input_;
+  const Skeleton& skeleton_;
+  const HierarchyBuilder& hierarchy_;
+  DecimationAlgorithm algorithm_;
+  RawAnimation* output_;
+
+  // Memory tag of the thread that created the task, re-established while
+  // executing as task runners can use any thread.
+  const memory::Tag tag_;
+};
+
+// Model-space optimization.
+
+// Samples _keys at _time, as if key _skip was removed (no key is skipped if
+// _skip is out of range). Same as raw animation sampling otherwise.
+template <typename _Keys, typename _Lerp>
+typename _Keys::value_type::Value SampleSkipping(const _Keys& _keys,
+                                                 const _Lerp& _lerp,
+                                                 float _time, size_t _skip) {
+  typedef typename _Keys::value_type Key;
+  const size_t size = _keys.size();
+  const size_t first = _skip == 0 ? 1 : 0;
+  const size_t last = _skip == size - 1 ? size - 2 : size - 1;
+  if (size == 0 || first >= size || last >= size) {
+    return Key::identity();
+  } else if (_time <= _keys[first].time) {
+    return _keys[first].value;
+  } else if (_time >= _keys[last].time) {
+    return _keys[last].value;
+  }
+  size_t right = 0;
+  for (size_t count = size; count > 0;) {  // Lower bound.
+    const size_t step = count / 2;
+    if (_keys[right + step].time < _time) {
+      right += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  right = right == _skip ? right + 1 : right;
+  const size_t left = right - 1 == _skip ? right - 2 : right - 1;
+  const float alpha =
+      (_time - _keys[left].time) / (_keys[right].time - _keys[left].time);
+  return _lerp(_keys[left].value, _keys[right].value, alpha);
+}
+
+// Identifies a translation, rotation or scale channel of a track.
+enum Channel { kTranslation, kRotation, kScale, kChannelCount };
+
+// Number of keys of a track channel.
+size_t ChannelSize(const RawAnimation::JointTrack& _track, int _channel) {
+  switch (_channel) {
+    case kTranslation:
+      return _track.translations.size();
+    case kRotation:
+      return _track.rotations.size();
+    default:
+      return _track.scales.size();
+  }
+}
+
+// Time of a key of a track channel.
+float ChannelKeyTime(const RawAnimation::JointTrack& _track, int _channel,
+                     size_t _key) {
+  switch (_channel) {
+    case kTranslation:
+      return _track.translations[_key].time;
+    case kRotation:
+      return _track.rotations[_key].time;
+    default:
+      return _track.scales[_key].time;
+  }
+}
+
+// Samples _track local-space matrix at _time. Key _key of channel _channel is
+// skipped, unless _channel is kChannelCount.
+math::Float4x4 SampleLocal(const RawAnimation::JointTrack& _track, float _time,
+                           int _channel, size_t _key) {
+  const size_t none = ~size_t(0);
+  const math::Float3 translation =
+      SampleSkipping(_track.translations, LerpTranslation, _time,
+                     _channel == kTranslation ? _key : none);
+  const math::Quaternion rotation =
+      SampleSkipping(_track.rotations, LerpRotation, _time,
+                     _channel == kRotation ? _key : none);
+  const math::Float3 scale = SampleSkipping(_track.scales, LerpScale, _time,
+                                            _channel == kScale ? _key : none);
+  return math::Float4x4::FromAffine(
+      math::simd_float4::Load3PtrU(&translation.x),
+      math::simd_float4::LoadPtrU(&rotation.x),
+      math::simd_float4::Load3PtrU(&scale.x));
+}
+
+// Constant data shared by model-space evaluations.
+struct ModelSpaceContext {
+  ModelSpaceContext(const RawAnimation& _input, const Skeleton& _skeleton,
+                    const AnimationOptimizer& _optimizer)
+      : skeleton(_skeleton),
+        num_joints(_skeleton.num_joints()),
+        tolerances(num_joints),
+        distances(num_joints),
+        subtree_ends(num_joints) {
+    // Error is evaluated at all original keyframe times, including animation
+    // boundaries.
+    times.push_back(0.f);
+    times.push_back(_input.duration);
+    for (const RawAnimation::JointTrack& track : _input.tracks) {
+      for (const RawAnimation::TranslationKey& key : track.translations) {
+        times.push_back(key.time);
+      }
+      for (const RawAnimation::RotationKey& key : track.rotations) {
+        times.push_back(key.time);
+      }
+      for (const RawAnimation::ScaleKey& key : track.scales) {
+        times.push_back(key.time);
+      }
+    }
+    std::sort(times.begin(), times.end());
+    times.erase(std::unique(times.begin(), times.end()), times.end());
+
+    // Joints are ordered depth-first, so a joint subtree is the range of
+    // joints that follow it, up to the first one that isn't its descendant.
+    const span<const int32_t>& parents = _skeleton.joint_parents();
+    for (int i = 0; i < num_joints; ++i) {
+      const AnimationOptimizer::Setting setting =
+          GetJointSetting(_optimizer, i);
+      tolerances[i] = setting.tolerance;
+      distances[i] = setting.distance;
+      int end = i + 1;
+      while (end < num_joints && parents[end] >= i) {
+        ++end;
+      }
+      subtree_ends[i] = end;
+    }
+
+    // Reference model-space matrices, for all times.
+    reference.resize(times.size() * num_joints);
+    UpdateModels(_input, 0, num_joints, 0, times.size(), &reference);
+  }
+
+  // Recomputes _models of joints [_joint_begin, _joint_end[ (parent excluded)
+  // for time indices [_time_begin, _time_end[.
+  void UpdateModels(const RawAnimation& _animation, int _joint_begin,
+                    int _joint_end, size_t _time_begin, size_t _time_end,
+                    ozz::vector<math::Float4x4>* _models) const {
+    const span<const int32_t>& parents = skeleton.joint_parents();
+    for (size_t t = _time_begin; t < _time_end; ++t) {
+      math::Float4x4* models = _models->data() + t * num_joints;
+      for (int i = _joint_begin; i < _joint_end; ++i) {
+        const math::Float4x4 local =
+            SampleLocal(_animation.tracks[i], times[t], kChannelCount, 0);
+        const int parent = parents[i];
+        models[i] =
+            parent == Skeleton::kNoParent ? local : models[parent] * local;
+      }
+    }
+  }
+
+  // Finds the range of time indices affected by key _key of a channel.
+  void AffectedTimes(const RawAnimation::JointTrack& _track, int _channel,
+                     size_t _key, size_t* _begin, size_t* _end) const {
+    const size_t size = ChannelSize(_track, _channel);
+    if (_key == 0) {
+      *_begin = 0;
+    } else {
+      const float prev = ChannelKeyTime(_track, _channel, _key - 1);
+      *_begin = std::upper_bound(times.begin(), times.end(), prev) -
+                times.begin();
+    }
+    if (_key == size - 1) {
+      *_end = times.size();
+    } else {
+      const float next = ChannelKeyTime(_track, _channel, _key + 1);
+      *_end = std::lower_bound(times.begin(), times.end(), next) -
+              times.begin();
+    }
+  }
+
+  const Skeleton& skeleton;
+  const int num_joints;
+  ozz::vector<float> times;
+  ozz::vector<float> tolerances;
+  ozz::vector<float> distances;
+  ozz::vector<int> subtree_ends;
+
+  // Model-space matrices of the input animation, indexed by time then joint.
+  ozz::vector<math::Float4x4> reference;
+
+ private:
+  ModelSpaceContext(const ModelSpaceContext&);
+  void operator=(const ModelSpaceContext&);
+};
+
+// Evaluates model-space error generated by removing a keyframe. Evaluator
+// owns scratch buffers, so an instance can't be shared across threads.
+class ModelSpaceEvaluator {
+ public:
+  explicit ModelSpaceEvaluator(const ModelSpaceContext& _context)
+      : context_(_context), candidate_(_context.num_joints) {}
+
+  // Returns the maximum ratio of error to tolerance, for all joints affected
+  // by removing key _key from _channel of _optimized _track. Any value greater
+  // than 1 means the key can't be removed. _models are _optimized model-space
+  // matrices, used for the unaffected ancestors.
+  float Evaluate(const RawAnimation& _optimized,
+                 const ozz::vector<math::Float4x4>& _models, int _track,
+                 int _channel, size_t _key) {
+    const int num_joints = context_.num_joints;
+    const span<const int32_t>& parents = context_.skeleton.joint_parents();
+    size_t begin, end;
+    context_.AffectedTimes(_optimized.tracks[_track], _channel, _key, &begin,
+                           &end);
+
+    float max_ratio = 0.f;
+    for (size_t t = begin; t < end; ++t) {
+      const float time = context_.times[t];
+      const math::Float4x4* models = _models.data() + t * num_joints;
+      const math::Float4x4* reference =
+          context_.reference.data() + t * num_joints;
+
+      // Joint and its descendants are affected by the removal.
+      for (int i = _track; i < context_.subtree_ends[_track]; ++i) {
+        const math::Float4x4 local =
+            i == _track
+                ? SampleLocal(_optimized.tracks[i], time, _channel, _key)
+                : SampleLocal(_optimized.tracks[i], time, kChannelCount, 0);
+        const int parent = parents[i];
+        if (parent == Skeleton::kNoParent) {
+          candidate_[i] = local;
+        } else if (i == _track) {
+          candidate_[i] = models[parent] * local;
+        } else {
+          candidate_[i] = candidate_[parent] * local;
+        }
+        max_ratio = math::Max(max_ratio, ErrorRatio(i, reference[i]));
+      }
+    }
+    return max_ratio;
+  }
+
+ private:
+  // Computes _joint error to tolerance ratio. Error is the maximum distance
+  // of the joint origin and of points at setting distance along joint axes.
+  float ErrorRatio(int _joint, const math::Float4x4& _reference) const {
+    const float distance = context_.distances[_joint];
+    const math::SimdFloat4 points[] = {
+        math::simd_float4::zero(),
+        math::simd_float4::Load(distance, 0.f, 0.f, 0.f),
+        math::simd_float4::Load(0.f, distance, 0.f, 0.f),
+        math::simd_float4::Load(0.f, 0.f, distance, 0.f)};
+    math::SimdFloat4 error = math::simd_float4::zero();
+    for (size_t i = 0; i < OZZ_ARRAY_SIZE(points); ++i) {
+      const math::SimdFloat4 diff =
+          TransformPoint(_reference, points[i]) -
+          TransformPoint(candidate_[_joint], points[i]);
+      error = math::Max(error, math::Length3(diff));
+    }
+    const float tolerance = context_.tolerances[_joint];
+    const float max_error = math::GetX(error);
+    if (tolerance > 0.f) {
+      return max_error / tolerance;
+    }
+    return max_error > 0.f ? std::numeric_limits<float>::infinity() : 0.f;
+  }
+
+  ModelSpaceEvaluator(const ModelSpaceEvaluator&);
+  void operator=(const ModelSpaceEvaluator&);
+
+  const ModelSpaceContext& context_;
+
+  // Candidate model-space matrices, indexed by joint. Only the evaluated
+  // subtree is up to date.
+  ozz::vector<math::Float4x4> candidate_;
+};
+
+// Removal candidate, identified by its time as key indices change as other
+// keys are removed.
+struct RemovalCandidate {
+  float ratio;
+  int track;
+  int channel;
+  float time;
+  bool operator>(const RemovalCandidate& _other) const {
+    if (ratio != _other.ratio) {
+      return ratio > _other.ratio;
+    }
+    if (track != _other.track) {
+      return track > _other.track;
+    }
+    if (channel != _other.channel) {
+      return channel > _other.channel;
+    }
+    return time > _other.time;
+  }
+};
+
+// Evaluates initial removal error of all the keys of a track.
+class EvaluateTrackTask : public Task {
+ public:
+  EvaluateTrackTask(const ModelSpaceContext& _context,
+                    const RawAnimation& _optimized,
+                    const ozz::vector<math::Float4x4>& _models,
+                    ozz::vector<ozz::vector<RemovalCandidate>>* _candidates)
+      : context_(_context),
+        optimized_(_optimized),
+        models_(_models),
+        candidates_(_candidates),
+        tag_(memory::current_tag()) {}
+
+  virtual void Execute(int _index) const {
+    const memory::ScopedTag tag(tag_);
+
+    ModelSpaceEvaluator evaluator(context_);
+    const RawAnimation::JointTrack& track = optimized_.tracks[_index];
+    ozz::vector<RemovalCandidate>& candidates = (*candidates_)[_index];
+    for (int channel = 0; channel < kChannelCount; ++channel) {
+      const size_t size = ChannelSize(track, channel);
+      for (size_t key = 0; size > 1 && key < size; ++key) {
+        const float ratio =
+            evaluator.Evaluate(optimized_, models_, _index, channel, key);
+        if (ratio <= 1.f) {
+          const RemovalCandidate candidate = {
+              ratio, _index, channel, ChannelKeyTime(track, channel, key)};
+          candidates.push_back(candidate);
+        }
+      }
+    }
+  }
+
+ private:
+  EvaluateTrackTask(const EvaluateTrackTask&);
+  void operator=(const EvaluateTrackTask&);
+
+  const ModelSpaceContext& context_;
+  const RawAnimation& optimized_;
+  const ozz::vector<math::Float4x4>& models_;
+  ozz::vector<ozz::vector<RemovalCandidate>>* candidates_;
+
+  // See OptimizeTask::tag_.
+  const memory::Tag tag_;
+};
+
+// Finds the index of the key at _time in a channel.
+template <typename _Keys>
+size_t FindKey(const _Keys& _keys, float _time) {
+  typedef typename _Keys::value_type Key;
+  return std::lower_bound(
+             _keys.begin(), _keys.end(), _time,
+             [](const Key& _key, float _t) { return _key.time < _t; }) -
+         _keys.begin();
+}
+
+// Removes key _key from _track _channel.
+void RemoveKey(RawAnimation::JointTrack* _track, int _channel, size_t _key) {
+  switch (_channel) {
+    case kTranslation:
+      _track->translations.erase(_track->translations.begin() + _key);
+      break;
+    case kRotation:
+      _track->rotations.erase(_track->rotations.begin() + _key);
+      break;
+    default:
+      _track->scales.erase(_track->scales.begin() + _key);
+      break;
+  }
+}
+
+// Optimizes _output (initialized with input animation) in model-space.
+void OptimizeModelSpace(const RawAnimation& _input, const Skeleton& _skeleton,
+                        const AnimationOptimizer& _optimizer,
+                        RawAnimation* _output) {
+  const ModelSpaceContext context(_input, _skeleton, _optimizer);
+
+  // Model-space matrices of the optimized animation, which is initially the
+  // same as the input.
+  ozz::vector<math::Float4x4> models = context.reference;
+
+  // Evaluates all keys, possibly concurrently.
+  const int num_tracks = _input.num_tracks();
+  ozz::vector<ozz::vector<RemovalCandidate>> initials(num_tracks);
+  const EvaluateTrackTask task(context, *_output, models, &initials);
+  if (_optimizer.task_runner) {
+    _optimizer.task_runner->Run(num_tracks, task);
+  } else {
+    for (int i = 0; i < num_tracks; ++i) {
+      task.Execute(i);
+    }
+  }
+
+  // Pushes candidates in a priority queue, smallest error first.
+  std::priority_queue<RemovalCandidate, ozz::vector<RemovalCandidate>,
+                      std::greater<RemovalCandidate>>
+      candidates;
+  for (const ozz::vector<RemovalCandidate>& track_candidates : initials) {
+    for (const RemovalCandidate& candidate : track_candidates) {
+      candidates.push(candidate);
+    }
+  }
+
+  ModelSpaceEvaluator evaluator(context);
+  while (!candidates.empty()) {
+    RemovalCandidate candidate = candidates.top();
+    candidates.pop();
+
+    RawAnimation::JointTrack& track = _output->tracks[candidate.track];
+    if (ChannelSize(track, candidate.channel) < 2) {
+      continue;  // The last key of a channel is never removed.
+    }
+    size_t key = 0;
+    switch (candidate.channel) {
+      case kTranslation:
+        key = FindKey(track.translations, candidate.time);
+        break;
+      case kRotation:
+        key = FindKey(track.rotations, candidate.time);
+        break;
+      default:
+        key = FindKey(track.scales, candidate.time);
+        break;
+    }
+
+    // Error depends on the keys removed since last evaluation.
+    const float ratio = evaluator.Evaluate(*_output, models, candidate.track,
+                                           candidate.channel, key);
+    if (ratio > 1.f) {
+      continue;  // Can't be removed anymore.
+    }
+    if (!candidates.empty() && ratio > candidates.top().ratio) {
+      // Other candidates are now cheaper.
+      candidate.ratio = ratio;
+      candidates.push(candidate);
+      continue;
+    }
+
+    // Removes the key and updates model-space matrices it affected.
+    size_t begin, end;
+    context.AffectedTimes(track, candidate.channel, key, &begin, &end);
+    RemoveKey(&track, candidate.channel, key);
+    context.UpdateModels(*_output, candidate.track,
+                         context.subtree_ends[candidate.track], begin, end,
+                         &models);
+  }
+}
 }  // namespace
 
 bool AnimationOptimizer::operator()(const RawAnimation& _input,
                                     const Skeleton& _skeleton,
                                     RawAnimation* _output) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
   if (!_output) {
     return false;
   }
@@ -262,35 +837,32 @@ bool AnimationOptimizer::operator()(const RawAnimation& _input,
     return false;
   }
 
-  // First computes bone lengths, that will be used when filtering.
-  const HierarchyBuilder hierarchy(&_input, &_skeleton, this);
-
   // Rebuilds output animation.
   _output->name = _input.name;
   _output->duration = _input.duration;
-  _output->tracks.resize(num_tracks);
 
-  for (int i = 0; i < num_tracks; ++i) {
-    const RawAnimation::JointTrack& input = _input.tracks[i];
-    RawAnimation::JointTrack& output = _output->tracks[i];
+  if (mode == kModelSpace) {
+    // Starts from the input animation, and removes keys one by one.
+    _output->tracks = _input.tracks;
+    OptimizeModelSpace(_input, _skeleton, *this, _output);
+    return _output->Validate();
+  }
+
+  // First computes bone lengths, that will be used when filtering.
+  const HierarchyBuilder hierarchy(&_input, &_skeleton, this);
 
-    // Gets joint specs back.
-    const float joint_length = hierarchy.specs[i].length;
-    const int parent = _skeleton.joint_parents()[i];
-    const float parent_scale =
-        (parent != Skeleton::kNoParent) ? hierarchy.specs[parent].scale : 1.f;
-    const float tolerance = hierarchy.specs[i].tolerance;
+  _output->tracks.resize(num_tracks);
 
-    // Filters independently T, R and S tracks.
-    // This joint translation is affected by parent scale.
-    const PositionAdapter tadap(parent_scale);
-    Decimate(input.translations, tadap, tolerance, &output.translations);
-    // This joint rotation affects children translations/length.
-    const RotationAdapter radap(joint_length);
-    Decimate(input.rotations, radap, tolerance, &output.rotations);
-    // This joint scale affects children translations/length.
-    const ScaleAdapter sadap(joint_length);
-    Decimate(input.scales, sadap, tolerance, &output.scales);
+  // Every channel of every track is optimized independently, each writing to
+  // its own output track. Output doesn't depend on execution order.
+  const OptimizeTask task(_input, _skeleton, hierarchy, algorithm, _output);
+  const int num_tasks = num_tracks * OptimizeTask::kChannels;
+  if (task_runner) {
+    task_runner->Run(num_tasks, task);
+  } else {
+    for (int i = 0; i < num_tasks; ++i) {
+      task.Execute(i);
+    }
   }
 
   // Output animation is always valid though.
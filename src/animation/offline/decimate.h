@@ -32,8 +32,10 @@
 #error "This header is private, it cannot be included from public headers."
 #endif  // OZZ_INCLUDE_PRIVATE_HEADER
 
+#include "ozz/animation/offline/decimation.h"
 #include "ozz/base/containers/stack.h"
 #include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/simd_math.h"
 
 #include <cassert>
 
@@ -41,16 +43,166 @@ namespace ozz {
 namespace animation {
 namespace offline {
 
+namespace internal {
+
+// Looks for the furthest key (further than _tolerance) from segment
+// [_first,_last], evaluating keys one at a time. Returns _first if all keys are
+// within tolerance. Non decimable keys are always selected.
+struct ScalarScanner {
+  template <typename _Track, typename _Adapter>
+  static size_t Furthest(const _Track& _src, const _Adapter& _adapter,
+                         float _tolerance, size_t _first, size_t _last) {
+    float max = -1.f;
+    size_t candidate = _first;
+    typename _Track::const_reference left = _src[_first];
+    typename _Track::const_reference right = _src[_last];
+    for (size_t i = _first + 1; i < _last; ++i) {
+      typename _Track::const_reference test = _src[i];
+      if (!_adapter.Decimable(test, _src[i - 1])) {
+        return i;
+      }
+      const float distance =
+          _adapter.Distance(_adapter.Lerp(left, right, test), test);
+      if (distance > _tolerance && distance > max) {
+        max = distance;
+        candidate = i;
+      }
+    }
+    return candidate;
+  }
+};
+
+// Same as ScalarScanner, but evaluates 4 keys at a time using
+// _Adapter::Distance4. Keys are selected in the same order as ScalarScanner.
+struct SimdScanner {
+  template <typename _Track, typename _Adapter>
+  static size_t Furthest(const _Track& _src, const _Adapter& _adapter,
+                         float _tolerance, size_t _first, size_t _last) {
+    float max = -1.f;
+    size_t candidate = _first;
+    typename _Track::const_reference left = _src[_first];
+    typename _Track::const_reference right = _src[_last];
+    size_t i = _first + 1;
+    for (; i + 4 <= _last; i += 4) {
+      // Non decimable keys are selected first.
+      for (size_t j = 0; j < 4; ++j) {
+        if (!_adapter.Decimable(_src[i + j], _src[i + j - 1])) {
+          return i + j;
+        }
+      }
+      float distances[4];
+      math::StorePtrU(_adapter.Distance4(left, right, &_src[i]), distances);
+      for (size_t j = 0; j < 4; ++j) {
+        if (distances[j] > _tolerance && distances[j] > max) {
+          max = distances[j];
+          candidate = i + j;
+        }
+      }
+    }
+    // Remaining keys.
+    for (; i < _last; ++i) {
+      typename _Track::const_reference test = _src[i];
+      if (!_adapter.Decimable(test, _src[i - 1])) {
+        return i;
+      }
+      const float distance =
+          _adapter.Distance(_adapter.Lerp(left, right, test), test);
+      if (distance > _tolerance && distance > max) {
+        max = distance;
+        candidate = i;
+      }
+    }
+    return candidate;
+  }
+};
+
+// Loads _N components of 4 values as SoA.
+template <int _N>
+inline void LoadSoa(const float* _v0, const float* _v1, const float* _v2,
+                    const float* _v3, math::SimdFloat4* _soa) {
+  for (int i = 0; i < _N; ++i) {
+    _soa[i] = math::simd_float4::Load(_v0[i], _v1[i], _v2[i], _v3[i]);
+  }
+}
+
+// Computes interpolation coefficients of 4 _times in range [_left,_right],
+// the same way as scalar adapters.
+inline math::SimdFloat4 Alpha4(float _left, float _right,
+                               math::_SimdFloat4 _times) {
+  return (_times - math::simd_float4::Load1(_left)) /
+         math::simd_float4::Load1(_right - _left);
+}
+
+// Computes the length of the difference between 4 _values and their linear
+// interpolation between _left and _right, the same way as math::Lerp and
+// math::Length.
+template <int _N>
+inline math::SimdFloat4 LerpDistance4(const float* _left, const float* _right,
+                                      const math::SimdFloat4* _values,
+                                      math::_SimdFloat4 _alpha) {
+  math::SimdFloat4 len2 = math::simd_float4::zero();
+  for (int i = 0; i < _N; ++i) {
+    const math::SimdFloat4 lerp =
+        math::simd_float4::Load1(_right[i] - _left[i]) * _alpha +
+        math::simd_float4::Load1(_left[i]);
+    const math::SimdFloat4 diff = lerp - _values[i];
+    len2 = len2 + diff * diff;
+  }
+  return math::Sqrt(len2);
+}
+
+// Specialization for scalar values, whose distance is an absolute difference.
+template <>
+inline math::SimdFloat4 LerpDistance4<1>(const float* _left,
+                                         const float* _right,
+                                         const math::SimdFloat4* _values,
+                                         math::_SimdFloat4 _alpha) {
+  const math::SimdFloat4 lerp =
+      math::simd_float4::Load1(_right[0] - _left[0]) * _alpha +
+      math::simd_float4::Load1(_left[0]);
+  return math::Abs(lerp - _values[0]);
+}
+
+// Computes the dot product of 4 quaternion _values with their normalized
+// linear interpolation between _left and _right, the same way as math::NLerp
+// and math::Dot.
+inline math::SimdFloat4 NLerpDot4(const float* _left, const float* _right,
+                                  const math::SimdFloat4* _values,
+                                  math::_SimdFloat4 _alpha) {
+  math::SimdFloat4 lerp[4];
+  math::SimdFloat4 sq_len = math::simd_float4::zero();
+  for (int i = 0; i < 4; ++i) {
+    lerp[i] = math::simd_float4::Load1(_right[i] - _left[i]) * _alpha +
+              math::simd_float4::Load1(_left[i]);
+    sq_len = sq_len + lerp[i] * lerp[i];
+  }
+  const math::SimdFloat4 inv_len =
+      math::simd_float4::one() / math::Sqrt(sq_len);
+  math::SimdFloat4 dot = math::simd_float4::zero();
+  for (int i = 0; i < 4; ++i) {
+    dot = dot + (lerp[i] * inv_len) * _values[i];
+  }
+  return dot;
+}
+}  // namespace internal
+
 // Decimation algorithm based on Ramer–Douglas–Peucker.
 // https://en.wikipedia.org/wiki/Ramer%E2%80%93Douglas%E2%80%93Peucker_algorithm
 // _Track must have std::vector interface.
 // Adapter must have the following interface:
 // struct Adapter {
-//  bool Decimable(const Key&) const;
+//  // Tests if _key can be removed. _previous is the key preceding _key.
+//  bool Decimable(const Key& _key, const Key& _previous) const;
 //  Key Lerp(const Key& _left, const Key& _right, const Key& _ref) const;
 //  float Distance(const Key& _a, const Key& _b) const;
+//  // Computes the distance of the 4 consecutive keys _keys[0-3] to their
+//  // interpolated value (same as Distance(Lerp(...), key)).
+//  math::SimdFloat4 Distance4(const Key& _left, const Key& _right,
+//                             const Key* _keys) const;
 // };
-template <typename _Track, typename _Adapter>
+// _Scanner is the strategy used to evaluate segment keys, either
+// internal::ScalarScanner or internal::SimdScanner.
+template <typename _Scanner, typename _Track, typename _Adapter>
 void Decimate(const _Track& _src, const _Adapter& _adapter, float _tolerance,
               _Track* _dest) {
   // Early out if not enough data.
@@ -78,29 +230,15 @@ void Decimate(const _Track& _src, const _Adapter& _adapter, float _tolerance,
     segments.pop();
 
     // Looks for the furthest point from the segment.
-    float max = -1.f;
-    size_t candidate = segment.first;
-    typename _Track::const_reference left = _src[segment.first];
-    typename _Track::const_reference right = _src[segment.second];
-    for (size_t i = segment.first + 1; i < segment.second; ++i) {
-      assert(!included[i] && "Included points should be processed once only.");
-      typename _Track::const_reference test = _src[i];
-      if (!_adapter.Decimable(test)) {
-        candidate = i;
-        break;
-      } else {
-        const float distance =
-            _adapter.Distance(_adapter.Lerp(left, right, test), test);
-        if (distance > _tolerance && distance > max) {
-          max = distance;
-          candidate = i;
-        }
-      }
-    }
+    const size_t candidate =
+        _Scanner::Furthest(_src, _adapter, _tolerance, segment.first,
+                           segment.second);
 
     // If found, include the point and pushes the 2 new segments (before and
     // after the new point).
     if (candidate != segment.first) {
+      assert(!included[candidate] &&
+             "Included points should be processed once only.");
       included[candidate] = true;
       if (candidate - segment.first > 1) {
         segments.push(Segment(segment.first, candidate));
@@ -125,11 +263,21 @@ void Decimate(const _Track& _src, const _Adapter& _adapter, float _tolerance,
     typename _Track::const_reference last = *(--end);
     typename _Track::const_reference penultimate = *(--end);
     const float distance = _adapter.Distance(penultimate, last);
-    if (_adapter.Decimable(last) && distance <= _tolerance) {
+    if (_adapter.Decimable(last, penultimate) && distance <= _tolerance) {
       _dest->pop_back();
     }
   }
 }
+// Decimates using the scanning strategy matching _algorithm.
+template <typename _Track, typename _Adapter>
+void Decimate(const _Track& _src, const _Adapter& _adapter, float _tolerance,
+              DecimationAlgorithm _algorithm, _Track* _dest) {
+  if (_algorithm == kRamerDouglasPeuckerSimd) {
+    Decimate<internal::SimdScanner>(_src, _adapter, _tolerance, _dest);
+  } else {
+    Decimate<internal::ScalarScanner>(_src, _adapter, _tolerance, _dest);
+  }
+}
 }  // namespace offline
 }  // namespace animation
 }  // namespace ozz
@@ -170,7 +170,7 @@ bool ExtractAnimation(FbxSceneLoader& _scene_loader, const SamplingInfo& _info,
       const math::Float4x4 local_matrix = math::Float4x4::FromAffine(t, q, s);
 
       ozz::vector<math::Float4x4>& node_matrices = world_matrices[i];
-      const int16_t parent = _skeleton.joint_parents()[i];
+      const int parent = _skeleton.joint_parents()[i];
       if (parent != Skeleton::kNoParent) {
         const ozz::vector<math::Float4x4>& parent_matrices =
             world_matrices[parent];
@@ -210,7 +210,7 @@ bool ExtractAnimation(FbxSceneLoader& _scene_loader, const SamplingInfo& _info,
     track.translations.resize(fixed_it.num_keys());
     track.scales.resize(fixed_it.num_keys());
 
-    const int16_t parent = _skeleton.joint_parents()[i];
+    const int parent = _skeleton.joint_parents()[i];
     ozz::vector<math::Float4x4>& node_world_matrices = world_matrices[i];
     ozz::vector<math::Float4x4>& node_world_inv_matrices =
         world_inv_matrices[parent != Skeleton::kNoParent ? parent : 0];
@@ -0,0 +1,132 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/offline/joints_setting_builder.h"
+
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/memory/tracking_allocator.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+JointsSettingBuilder::JointsSettingBuilder() : tolerance(1e-3f), unskinned() {}
+
+namespace {
+bool ValidateMesh(const JointsSettingBuilder::Mesh& _mesh, int _num_joints) {
+  if (_mesh.influences <= 0) {
+    return _mesh.positions.empty();
+  }
+  const size_t count = _mesh.positions.size() * _mesh.influences;
+  if (_mesh.joint_indices.size() != count ||
+      _mesh.joint_weights.size() != count) {
+    return false;
+  }
+  for (const uint16_t joint : _mesh.joint_indices) {
+    if (joint >= _num_joints) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+bool JointsSettingBuilder::operator()(
+    const Skeleton& _skeleton, const span<const Mesh>& _meshes,
+    AnimationOptimizer::JointsSetting* _settings) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
+  if (!_settings) {
+    return false;
+  }
+  _settings->clear();
+
+  const int num_joints = _skeleton.num_joints();
+  for (const Mesh& mesh : _meshes) {
+    if (!ValidateMesh(mesh, num_joints)) {
+      return false;
+    }
+  }
+
+  // Computes bind pose joints position, vertices are expected in the same
+  // space.
+  ozz::vector<math::Float4x4> models(num_joints);
+  LocalToModelJob ltm_job;
+  ltm_job.skeleton = &_skeleton;
+  ltm_job.input = _skeleton.joint_bind_poses();
+  ltm_job.output = make_span(models);
+  if (!ltm_job.Run()) {
+    return false;
+  }
+
+  // Finds the farthest weighted vertex of each joint. A negative distance
+  // means that joint doesn't influence any vertex.
+  ozz::vector<float> distances(num_joints, -1.f);
+  for (const Mesh& mesh : _meshes) {
+    const uint16_t* joint = mesh.joint_indices.begin();
+    const float* weight = mesh.joint_weights.begin();
+    for (const math::Float3& position : mesh.positions) {
+      const math::SimdFloat4 vertex = math::simd_float4::Load3PtrU(&position.x);
+      for (int i = 0; i < mesh.influences; ++i, ++joint, ++weight) {
+        if (*weight <= 0.f) {
+          continue;
+        }
+        const float distance =
+            math::GetX(math::Length3(vertex - models[*joint].cols[3]));
+        distances[*joint] = math::Max(distances[*joint], distance * *weight);
+      }
+    }
+  }
+
+  // Joints whose descendants are skinned aren't considered unskinned, their
+  // error is visible through their descendants. Joints are ordered
+  // depth-first, so children are processed before their parent.
+  ozz::vector<bool> skinned(num_joints);
+  const span<const int32_t>& parents = _skeleton.joint_parents();
+  for (int i = num_joints - 1; i >= 0; --i) {
+    skinned[i] = skinned[i] || distances[i] >= 0.f;
+    const int parent = parents[i];
+    if (skinned[i] && parent != Skeleton::kNoParent) {
+      skinned[parent] = true;
+    }
+  }
+
+  for (int i = 0; i < num_joints; ++i) {
+    (*_settings)[i] =
+        skinned[i] ? AnimationOptimizer::Setting(tolerance,
+                                                 math::Max(distances[i], 0.f))
+                   : unskinned;
+  }
+  return true;
+}
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/offline/raw_event_track.h"
+
+#include "ozz/base/containers/string_archive.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/log.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+bool RawEventTrack::Validate() const {
+  float previous_ratio = 0.f;
+  for (size_t e = 0; e < events.size(); ++e) {
+    const float event_ratio = events[e].ratio;
+    // Tests event's ratio is in range [0:1].
+    if (event_ratio < 0.f || event_ratio > 1.f) {
+      return false;
+    }
+    // Tests that events are sorted. Events can share the same ratio.
+    if (event_ratio < previous_ratio) {
+      return false;
+    }
+    previous_ratio = event_ratio;
+  }
+  return true;  // Validated.
+}
+
+void RawEventTrack::Save(io::OArchive& _archive) const {
+  const uint32_t num_events = static_cast<uint32_t>(events.size());
+  _archive << num_events;
+  for (size_t e = 0; e < events.size(); ++e) {
+    _archive << events[e].ratio;
+    _archive << events[e].id;
+  }
+  _archive << name;
+}
+
+void RawEventTrack::Load(io::IArchive& _archive, uint32_t _version) {
+  if (_version != 1) {
+    log::Err() << "Unsupported RawEventTrack version " << _version << "."
+               << std::endl;
+    return;
+  }
+
+  uint32_t num_events;
+  _archive >> num_events;
+  events.resize(num_events);
+  for (size_t e = 0; e < events.size(); ++e) {
+    _archive >> events[e].ratio;
+    _archive >> events[e].id;
+  }
+  _archive >> name;
+}
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
@@ -39,7 +39,7 @@ namespace ozz {
 namespace io {
 
 // Can be declared locally as it's only referenced from this file.
-OZZ_IO_TYPE_VERSION_T1(1, typename _ValueType,
+OZZ_IO_TYPE_VERSION_T1(2, typename _ValueType,
                        animation::offline::RawTrackKeyframe<_ValueType>)
 
 template <typename _ValueType>
@@ -55,12 +55,16 @@ struct Extern<animation::offline::RawTrackKeyframe<_ValueType>> {
       _archive << interp;
       _archive << keyframe.ratio;
       _archive << keyframe.value;
+      if (keyframe.interpolation ==
+          animation::offline::RawTrackInterpolation::kCubic) {
+        _archive << keyframe.in_tangent;
+        _archive << keyframe.out_tangent;
+      }
     }
   }
   static void Load(IArchive& _archive,
                    animation::offline::RawTrackKeyframe<_ValueType>* _keyframes,
                    size_t _count, uint32_t _version) {
-    (void)_version;
     for (size_t i = 0; i < _count; ++i) {
       animation::offline::RawTrackKeyframe<_ValueType>& keyframe =
           _keyframes[i];
@@ -70,6 +74,13 @@ struct Extern<animation::offline::RawTrackKeyframe<_ValueType>> {
           static_cast<animation::offline::RawTrackInterpolation::Value>(interp);
       _archive >> keyframe.ratio;
       _archive >> keyframe.value;
+      // Cubic keys were introduced with version 2.
+      if (_version >= 2 &&
+          keyframe.interpolation ==
+              animation::offline::RawTrackInterpolation::kCubic) {
+        _archive >> keyframe.in_tangent;
+        _archive >> keyframe.out_tangent;
+      }
     }
   }
 };
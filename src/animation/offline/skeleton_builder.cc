@@ -34,6 +34,7 @@
 #include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
 
 namespace ozz {
 namespace animation {
@@ -45,26 +46,28 @@ struct JointLister {
   explicit JointLister(int _num_joints) { linear_joints.reserve(_num_joints); }
   void operator()(const RawSkeleton::Joint& _current,
                   const RawSkeleton::Joint* _parent) {
-    // Looks for the "lister" parent.
-    int16_t parent = Skeleton::kNoParent;
+    // Looks for the "lister" parent. Joints are traversed in depth-first
+    // order, so the parent is necessarily part of the current ancestors path.
+    int32_t parent = Skeleton::kNoParent;
     if (_parent) {
-      // Start searching from the last joint.
-      int16_t j = static_cast<int16_t>(linear_joints.size()) - 1;
-      for (; j >= 0; --j) {
-        if (linear_joints[j].joint == _parent) {
-          parent = j;
-          break;
-        }
+      while (!path.empty() && linear_joints[path.back()].joint != _parent) {
+        path.pop_back();
       }
-      assert(parent >= 0);
+      assert(!path.empty());
+      parent = path.back();
+    } else {
+      path.clear();
     }
+    path.push_back(static_cast<int32_t>(linear_joints.size()));
     const Joint listed = {&_current, parent};
     linear_joints.push_back(listed);
   }
   struct Joint {
     const RawSkeleton::Joint* joint;
-    int16_t parent;
+    int32_t parent;
   };
+  // Indices of the joints of the current depth-first traversal path.
+  ozz::vector<int32_t> path;
   // Array of joints in the traversed DAG order.
   ozz::vector<Joint> linear_joints;
 };
@@ -76,6 +79,8 @@ struct JointLister {
 // skeleton sub-hierarchy.
 unique_ptr<ozz::animation::Skeleton> SkeletonBuilder::operator()(
     const RawSkeleton& _raw_skeleton) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
   // Tests _raw_skeleton validity.
   if (!_raw_skeleton.Validate()) {
     return nullptr;
@@ -0,0 +1,255 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/offline/skeleton_merger.h"
+
+#include <cassert>
+
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/skeleton_utils.h"
+#include "ozz/base/maths/transform.h"
+#include "ozz/base/memory/tracking_allocator.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+SkeletonMerger::Part::Part()
+    : skeleton(nullptr), parent(Skeleton::kNoParent), joint(0) {}
+
+namespace {
+bool ValidateParts(const span<const SkeletonMerger::Part>& _parts) {
+  if (_parts.empty()) {
+    return false;
+  }
+  int num_joints = 0;
+  for (size_t i = 0; i < _parts.size(); ++i) {
+    const SkeletonMerger::Part& part = _parts[i];
+    if (!part.skeleton) {
+      return false;
+    }
+    num_joints += part.skeleton->num_joints();
+
+    // Parts can only be attached to a previous part, which prevents cycles.
+    if (part.parent == Skeleton::kNoParent) {
+      continue;
+    }
+    if (part.parent < 0 || part.parent >= static_cast<int>(i) ||
+        part.joint < 0 ||
+        part.joint >= _parts[part.parent].skeleton->num_joints()) {
+      return false;
+    }
+  }
+  return num_joints <= Skeleton::kMaxJoints;
+}
+
+// Copies parts joints to a RawSkeleton hierarchy, filling remapping tables
+// along the way. Joints are processed in the same depth-first order as
+// SkeletonBuilder, so remapping tables match built skeleton joint indices.
+class HierarchyMerger {
+ public:
+  HierarchyMerger(const span<const SkeletonMerger::Part>& _parts,
+                  ozz::vector<SkeletonMerger::JointRemap>* _remaps)
+      : parts_(_parts), remaps_(_remaps), num_joints_(0) {
+    _remaps->resize(_parts.size());
+    for (size_t i = 0; i < _parts.size(); ++i) {
+      (*_remaps)[i].resize(_parts[i].skeleton->num_joints());
+    }
+  }
+
+  // Copies children of _joint of _part, or merged roots if _part is
+  // Skeleton::kNoParent, to _children.
+  void CopyChildren(int _part, int _joint,
+                    RawSkeleton::Joint::Children* _children) {
+    ozz::vector<Child> children;
+
+    // Part's own children first.
+    if (_part != Skeleton::kNoParent) {
+      const span<const int32_t>& parents =
+          parts_[_part].skeleton->joint_parents();
+      for (int i = _joint + 1, num_joints = static_cast<int>(parents.size());
+           i < num_joints && parents[i] >= _joint; ++i) {
+        if (parents[i] == _joint) {
+          const Child child = {_part, i};
+          children.push_back(child);
+        }
+      }
+    }
+
+    // Then roots of attached parts.
+    for (int i = _part + 1, num_parts = static_cast<int>(parts_.size());
+         i < num_parts; ++i) {
+      const SkeletonMerger::Part& part = parts_[i];
+      if (part.parent != _part ||
+          (_part != Skeleton::kNoParent && part.joint != _joint)) {
+        continue;
+      }
+      const span<const int32_t>& parents = part.skeleton->joint_parents();
+      for (int j = 0, num_joints = static_cast<int>(parents.size());
+           j < num_joints; ++j) {
+        if (parents[j] == Skeleton::kNoParent) {
+          const Child child = {i, j};
+          children.push_back(child);
+        }
+      }
+    }
+
+    // Copies and recurses.
+    _children->resize(children.size());
+    for (size_t i = 0; i < children.size(); ++i) {
+      const Child& child = children[i];
+      const Skeleton& skeleton = *parts_[child.part].skeleton;
+      RawSkeleton::Joint& joint = (*_children)[i];
+      joint.name = skeleton.joint_names()[child.joint];
+      joint.transform = GetJointLocalBindPose(skeleton, child.joint);
+      (*remaps_)[child.part][child.joint] = num_joints_++;
+
+      CopyChildren(child.part, child.joint, &joint.children);
+    }
+  }
+
+  int num_joints() const { return num_joints_; }
+
+ private:
+  struct Child {
+    int part;
+    int joint;
+  };
+
+  const span<const SkeletonMerger::Part> parts_;
+  ozz::vector<SkeletonMerger::JointRemap>* remaps_;
+  int num_joints_;
+};
+}  // namespace
+
+ozz::unique_ptr<Skeleton> SkeletonMerger::operator()(
+    const span<const Part>& _parts, ozz::vector<JointRemap>* _remaps) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
+  if (!_remaps) {
+    return nullptr;
+  }
+  _remaps->clear();
+
+  if (!ValidateParts(_parts)) {
+    return nullptr;
+  }
+
+  // Merges all parts to a raw skeleton.
+  RawSkeleton raw_skeleton;
+  HierarchyMerger merger(_parts, _remaps);
+  merger.CopyChildren(Skeleton::kNoParent, Skeleton::kNoParent,
+                      &raw_skeleton.roots);
+  assert(merger.num_joints() == raw_skeleton.num_joints());
+
+  // Builds runtime skeleton, whose joints are in the same order as the
+  // remapping tables.
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton = builder(raw_skeleton);
+  if (!skeleton) {
+    _remaps->clear();
+  }
+  return skeleton;
+}
+
+bool SkeletonMerger::operator()(
+    const span<const Part>& _parts, const span<const JointRemap>& _remaps,
+    const span<const RawAnimation* const>& _animations,
+    RawAnimation* _output) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
+  if (!_output) {
+    return false;
+  }
+  // Reset output animation to default.
+  *_output = RawAnimation();
+
+  if (!ValidateParts(_parts) || _remaps.size() != _parts.size() ||
+      _animations.size() != _parts.size()) {
+    return false;
+  }
+
+  // Validates remapping tables and animations.
+  int num_joints = 0;
+  const RawAnimation* reference = nullptr;
+  for (size_t i = 0; i < _parts.size(); ++i) {
+    const int part_joints = _parts[i].skeleton->num_joints();
+    if (static_cast<int>(_remaps[i].size()) != part_joints) {
+      return false;
+    }
+    num_joints += part_joints;
+
+    const RawAnimation* animation = _animations[i];
+    if (!animation) {
+      continue;
+    }
+    if (animation->num_tracks() != part_joints || !animation->Validate() ||
+        (reference && animation->duration != reference->duration)) {
+      return false;
+    }
+    reference = reference ? reference : animation;
+  }
+
+  // Rebuilds output animation.
+  if (reference) {
+    _output->name = reference->name;
+    _output->duration = reference->duration;
+  }
+  _output->tracks.resize(num_joints);
+  for (size_t i = 0; i < _parts.size(); ++i) {
+    const Skeleton& skeleton = *_parts[i].skeleton;
+    const RawAnimation* animation = _animations[i];
+    for (int j = 0; j < skeleton.num_joints(); ++j) {
+      const int remap = _remaps[i][j];
+      if (remap < 0 || remap >= num_joints) {
+        *_output = RawAnimation();
+        return false;
+      }
+      RawAnimation::JointTrack& track = _output->tracks[remap];
+      if (animation) {
+        track = animation->tracks[j];
+      } else {
+        // Joints of parts without animation are set to their bind pose.
+        const math::Transform bind_pose = GetJointLocalBindPose(skeleton, j);
+        const RawAnimation::TranslationKey tkey = {0.f, bind_pose.translation};
+        track.translations.push_back(tkey);
+        const RawAnimation::RotationKey rkey = {0.f, bind_pose.rotation};
+        track.rotations.push_back(rkey);
+        const RawAnimation::ScaleKey skey = {0.f, bind_pose.scale};
+        track.scales.push_back(skey);
+      }
+    }
+  }
+
+  return true;
+}
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,82 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/offline/task_runner.h"
+
+#include <atomic>
+#include <thread>
+
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/memory/tracking_allocator.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+ThreadedTaskRunner::ThreadedTaskRunner(int _num_threads)
+    : num_threads_(_num_threads) {
+  if (num_threads_ <= 0) {
+    num_threads_ = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  if (num_threads_ <= 0) {
+    num_threads_ = 1;
+  }
+}
+
+namespace {
+// Memory tags are per thread, so the tag of the thread that called Run is
+// re-established on worker threads.
+void ExecuteTasks(const Task* _task, int _count, std::atomic<int>* _next,
+                  memory::Tag _tag) {
+  const memory::ScopedTag tag(_tag);
+  for (int index = _next->fetch_add(1); index < _count;
+       index = _next->fetch_add(1)) {
+    _task->Execute(index);
+  }
+}
+}  // namespace
+
+void ThreadedTaskRunner::Run(int _count, const Task& _task) {
+  std::atomic<int> next(0);
+  const memory::Tag tag = memory::current_tag();
+
+  // No need to spawn more threads than tasks. Calling thread is used as one of
+  // the workers.
+  const int num_spawned = (_count < num_threads_ ? _count : num_threads_) - 1;
+  ozz::vector<std::thread> threads;
+  threads.reserve(num_spawned > 0 ? num_spawned : 0);
+  for (int i = 0; i < num_spawned; ++i) {
+    threads.emplace_back(&ExecuteTasks, &_task, _count, &next, tag);
+  }
+  ExecuteTasks(&_task, _count, &next, tag);
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+}
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,467 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+// Measures the error introduced by building and optimizing an animation. The
+// runtime animation is compared to the raw (reference) animation it was built
+// from. Comparison is done in model-space, at regular sampling intervals, which
+// is what matters for the final rendering: local-space errors accumulate along
+// the hierarchy.
+// The tool also outputs the number of keyframes and memory used per track,
+// which allows to measure compression ratio. Outputs can be written as a json
+// file, and a maximum error can be specified so that the tool fails when it's
+// exceeded, allowing to use it as a continuous integration check.
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/animation_optimizer.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_animation_utils.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/log.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+#include "ozz/options/options.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/animation_keyframe.h"
+
+OZZ_OPTIONS_DECLARE_STRING(skeleton, "Path to the runtime skeleton file.", "",
+                           true)
+
+OZZ_OPTIONS_DECLARE_STRING(raw_animation,
+                           "Path to the raw (reference) animation file.", "",
+                           true)
+
+OZZ_OPTIONS_DECLARE_STRING(animation,
+                           "Path to the runtime animation file to evaluate. If "
+                           "not specified, runtime animation is built from the "
+                           "raw animation.",
+                           "", false)
+
+OZZ_OPTIONS_DECLARE_BOOL(optimize,
+                         "Optimizes raw animation before building it. Only "
+                         "used if runtime animation isn't specified.",
+                         true, false)
+
+OZZ_OPTIONS_DECLARE_BOOL(model_space,
+                         "Uses model-space optimization mode, which removes "
+                         "more keyframes but is slower.",
+                         false, false)
+
+static bool ValidatePositive(const ozz::options::Option& _option,
+                             int /*_argc*/) {
+  const ozz::options::FloatOption& option =
+      static_cast<const ozz::options::FloatOption&>(_option);
+  return option >= 0.f;
+}
+
+OZZ_OPTIONS_DECLARE_FLOAT_FN(tolerance,
+                             "Optimization tolerance, in meters. Only used if "
+                             "optimization is enabled.",
+                             1e-3f, false, &ValidatePositive)
+
+OZZ_OPTIONS_DECLARE_FLOAT_FN(distance,
+                             "Distance (from the joint) at which error is "
+                             "measured, in meters. Also used as optimization "
+                             "distance.",
+                             1e-1f, false, &ValidatePositive)
+
+static bool ValidateFrequency(const ozz::options::Option& _option,
+                              int /*_argc*/) {
+  const ozz::options::FloatOption& option =
+      static_cast<const ozz::options::FloatOption&>(_option);
+  return option > 0.f;
+}
+
+OZZ_OPTIONS_DECLARE_FLOAT_FN(frequency,
+                             "Sampling frequency used to measure error, in hz.",
+                             60.f, false, &ValidateFrequency)
+
+OZZ_OPTIONS_DECLARE_FLOAT_FN(max_error,
+                             "Maximum model-space error, in meters. The tool "
+                             "fails if it's exceeded. 0 disables the check.",
+                             0.f, false, &ValidatePositive)
+
+OZZ_OPTIONS_DECLARE_STRING(json, "Outputs results to a json file.", "", false)
+
+namespace {
+
+template <typename _Type>
+bool Load(const char* _filename, const char* _type, _Type* _object) {
+  ozz::log::Log() << "Loading " << _type << " archive " << _filename << "."
+                  << std::endl;
+  ozz::io::File file(_filename, "rb");
+  if (!file.opened()) {
+    ozz::log::Err() << "Failed to open " << _type << " file " << _filename
+                    << "." << std::endl;
+    return false;
+  }
+  ozz::io::IArchive archive(&file);
+  if (!archive.TestTag<_Type>()) {
+    ozz::log::Err() << "Failed to load " << _type << " instance from file "
+                    << _filename << "." << std::endl;
+    return false;
+  }
+  archive >> *_object;
+  return true;
+}
+
+// Per joint measured statistics.
+struct JointStats {
+  float max_error;
+  double sum_sq_error;
+  size_t raw_keys;
+  size_t runtime_keys;
+  size_t runtime_bytes;
+};
+
+// Computes root mean square from a sum of squared errors and their count.
+// Returns 0 if there's nothing to average.
+double Rms(double _sum_sq_error, double _count) {
+  return _count > 0. ? std::sqrt(_sum_sq_error / _count) : 0.;
+}
+
+// Samples raw animation at _time and converts AoS transforms to SoA.
+bool SampleRawAnimation(const ozz::animation::offline::RawAnimation& _animation,
+                        float _time,
+                        ozz::span<ozz::math::SoaTransform> _locals) {
+  for (int i = 0; i < _animation.num_tracks(); i += 4) {
+    ozz::math::SimdFloat4 translations[4];
+    ozz::math::SimdFloat4 rotations[4];
+    ozz::math::SimdFloat4 scales[4];
+
+    // Works on 4 consecutive tracks, or what remains to be processed.
+    const int jmax = ozz::math::Min(_animation.num_tracks() - i, 4);
+    for (int j = 0; j < jmax; ++j) {
+      ozz::math::Transform transform;
+      if (!SampleTrack(_animation.tracks[i + j], _time, &transform)) {
+        return false;
+      }
+      translations[j] =
+          ozz::math::simd_float4::Load3PtrU(&transform.translation.x);
+      rotations[j] = ozz::math::simd_float4::LoadPtrU(&transform.rotation.x);
+      scales[j] = ozz::math::simd_float4::Load3PtrU(&transform.scale.x);
+    }
+    for (int j = jmax; j < 4; ++j) {
+      translations[j] = ozz::math::simd_float4::zero();
+      rotations[j] = ozz::math::simd_float4::w_axis();
+      scales[j] = ozz::math::simd_float4::one();
+    }
+    ozz::math::SoaTransform& output = _locals[i / 4];
+    ozz::math::Transpose4x3(translations, &output.translation.x);
+    ozz::math::Transpose4x4(rotations, &output.rotation.x);
+    ozz::math::Transpose4x3(scales, &output.scale.x);
+  }
+  return true;
+}
+
+// Computes the distance between _a and _b transformed points. Points are the
+// joint origin, and points at _distance along each joint axis, which allows to
+// take rotation and scale into account.
+float ComputeError(const ozz::math::Float4x4& _a, const ozz::math::Float4x4& _b,
+                   float _distance) {
+  using ozz::math::SimdFloat4;
+  const SimdFloat4 points[] = {
+      ozz::math::simd_float4::zero(),
+      ozz::math::simd_float4::Load(_distance, 0.f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, _distance, 0.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, 0.f, _distance, 0.f)};
+  SimdFloat4 error = ozz::math::simd_float4::zero();
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(points); ++i) {
+    const SimdFloat4 diff =
+        TransformPoint(_a, points[i]) - TransformPoint(_b, points[i]);
+    error = ozz::math::Max(error, ozz::math::Length3(diff));
+  }
+  return ozz::math::GetX(error);
+}
+
+// Counts runtime keys per track. Keys of SoA padding tracks are ignored.
+template <typename _Key>
+void CountKeys(ozz::span<const _Key> _keys, size_t _key_size,
+               ozz::vector<JointStats>* _stats) {
+  for (const _Key& key : _keys) {
+    if (key.track < _stats->size()) {
+      JointStats& stats = (*_stats)[key.track];
+      ++stats.runtime_keys;
+      stats.runtime_bytes += _key_size;
+    }
+  }
+}
+
+// Outputs _string to _stream as a json string, escaping quotes, backslashes
+// and control characters.
+void OutputJsonString(std::ostream& _stream, const char* _string) {
+  _stream << '"';
+  for (const char* c = _string; *c; ++c) {
+    switch (*c) {
+      case '"':
+        _stream << "\\\"";
+        break;
+      case '\\':
+        _stream << "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          const char* digits = "0123456789abcdef";
+          _stream << "\\u00" << digits[(*c >> 4) & 0xf] << digits[*c & 0xf];
+        } else {
+          _stream << *c;
+        }
+        break;
+    }
+  }
+  _stream << '"';
+}
+
+bool OutputJson(const char* _filename,
+                const ozz::animation::Skeleton& _skeleton,
+                const ozz::vector<JointStats>& _stats, float _max_error,
+                double _rms_error, double _num_samples,
+                size_t _animation_size) {
+  std::ofstream file(_filename);
+  if (!file.is_open()) {
+    ozz::log::Err() << "Failed to open json output file \"" << _filename
+                    << "\"." << std::endl;
+    return false;
+  }
+  file << std::setprecision(9);
+  file << "{\n  \"max_error\": " << _max_error << ",\n";
+  file << "  \"rms_error\": " << _rms_error << ",\n";
+  file << "  \"animation_bytes\": " << _animation_size << ",\n";
+  file << "  \"joints\": [";
+  for (size_t i = 0; i < _stats.size(); ++i) {
+    const JointStats& stats = _stats[i];
+    file << (i == 0 ? "\n" : ",\n") << "    {\n";
+    file << "      \"name\": ";
+    OutputJsonString(file, _skeleton.joint_names()[i]);
+    file << ",\n";
+    file << "      \"max_error\": " << stats.max_error << ",\n";
+    file << "      \"rms_error\": " << Rms(stats.sum_sq_error, _num_samples)
+         << ",\n";
+    file << "      \"raw_keys\": " << stats.raw_keys << ",\n";
+    file << "      \"runtime_keys\": " << stats.runtime_keys << ",\n";
+    file << "      \"runtime_bytes\": " << stats.runtime_bytes << "\n    }";
+  }
+  file << "\n  ]\n}\n";
+  return true;
+}
+}  // namespace
+
+int main(int _argc, const char** _argv) {
+  // Parses arguments.
+  ozz::options::ParseResult parse_result = ozz::options::ParseCommandLine(
+      _argc, _argv, "1.0",
+      "Measures model-space error of a runtime animation compared to its raw "
+      "animation");
+  if (parse_result != ozz::options::kSuccess) {
+    return parse_result == ozz::options::kExitSuccess ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+  }
+
+  ozz::animation::Skeleton skeleton;
+  if (!Load(OPTIONS_skeleton, "skeleton", &skeleton)) {
+    return EXIT_FAILURE;
+  }
+
+  ozz::animation::offline::RawAnimation raw_animation;
+  if (!Load(OPTIONS_raw_animation, "raw animation", &raw_animation)) {
+    return EXIT_FAILURE;
+  }
+  if (!raw_animation.Validate() ||
+      raw_animation.num_tracks() != skeleton.num_joints()) {
+    ozz::log::Err() << "Raw animation is invalid or doesn't match skeleton."
+                    << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Loads or builds the runtime animation.
+  ozz::unique_ptr<ozz::animation::Animation> animation;
+  if (OPTIONS_animation.value()[0] != 0) {
+    animation = ozz::make_unique<ozz::animation::Animation>();
+    if (!Load(OPTIONS_animation, "animation", animation.get())) {
+      return EXIT_FAILURE;
+    }
+  } else {
+    ozz::animation::offline::RawAnimation optimized;
+    if (OPTIONS_optimize) {
+      ozz::animation::offline::AnimationOptimizer optimizer;
+      optimizer.setting.tolerance = OPTIONS_tolerance;
+      optimizer.setting.distance = OPTIONS_distance;
+      optimizer.mode =
+          OPTIONS_model_space
+              ? ozz::animation::offline::AnimationOptimizer::kModelSpace
+              : ozz::animation::offline::AnimationOptimizer::kHierarchical;
+      if (!optimizer(raw_animation, skeleton, &optimized)) {
+        ozz::log::Err() << "Failed to optimize animation." << std::endl;
+        return EXIT_FAILURE;
+      }
+    } else {
+      optimized = raw_animation;
+    }
+    ozz::animation::offline::AnimationBuilder builder;
+    animation = builder(optimized);
+    if (!animation) {
+      ozz::log::Err() << "Failed to build runtime animation." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (animation->num_tracks() != skeleton.num_joints()) {
+    ozz::log::Err() << "Runtime animation doesn't match skeleton." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Counts keys.
+  const int num_joints = skeleton.num_joints();
+  const JointStats zero_stats = {0.f, 0., 0, 0, 0};
+  ozz::vector<JointStats> stats(num_joints, zero_stats);
+  for (int i = 0; i < num_joints; ++i) {
+    const ozz::animation::offline::RawAnimation::JointTrack& track =
+        raw_animation.tracks[i];
+    stats[i].raw_keys = track.translations.size() + track.rotations.size() +
+                        track.scales.size();
+  }
+  CountKeys(animation->translations(), sizeof(ozz::animation::Float3Key),
+            &stats);
+  CountKeys(animation->rotations(), sizeof(ozz::animation::QuaternionKey),
+            &stats);
+  CountKeys(animation->scales(), sizeof(ozz::animation::Float3Key), &stats);
+
+  // Allocates runtime buffers.
+  const int num_soa_joints = skeleton.num_soa_joints();
+  ozz::vector<ozz::math::SoaTransform> raw_locals(num_soa_joints);
+  ozz::vector<ozz::math::SoaTransform> rt_locals(num_soa_joints);
+  ozz::vector<ozz::math::Float4x4> raw_models(num_joints);
+  ozz::vector<ozz::math::Float4x4> rt_models(num_joints);
+  ozz::animation::SamplingCache cache(num_joints);
+
+  // Samples both animations at a fixed rate and compares model-space
+  // transforms.
+  const ozz::animation::offline::FixedRateSamplingTime sampling(
+      raw_animation.duration, OPTIONS_frequency);
+  for (size_t k = 0; k < sampling.num_keys(); ++k) {
+    const float time = sampling.time(k);
+
+    if (!SampleRawAnimation(raw_animation, time, make_span(raw_locals))) {
+      ozz::log::Err() << "Failed to sample raw animation." << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    ozz::animation::SamplingJob sampling_job;
+    sampling_job.animation = animation.get();
+    sampling_job.cache = &cache;
+    sampling_job.ratio = raw_animation.duration > 0.f
+                             ? time / raw_animation.duration
+                             : 0.f;
+    sampling_job.output = make_span(rt_locals);
+    if (!sampling_job.Run()) {
+      ozz::log::Err() << "Failed to sample runtime animation." << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    ozz::animation::LocalToModelJob ltm_job;
+    ltm_job.skeleton = &skeleton;
+    ltm_job.input = make_span(raw_locals);
+    ltm_job.output = make_span(raw_models);
+    if (!ltm_job.Run()) {
+      return EXIT_FAILURE;
+    }
+    ltm_job.input = make_span(rt_locals);
+    ltm_job.output = make_span(rt_models);
+    if (!ltm_job.Run()) {
+      return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < num_joints; ++i) {
+      const float error =
+          ComputeError(raw_models[i], rt_models[i], OPTIONS_distance);
+      stats[i].max_error = ozz::math::Max(stats[i].max_error, error);
+      stats[i].sum_sq_error += static_cast<double>(error) * error;
+    }
+  }
+
+  // Outputs results.
+  const double num_samples = static_cast<double>(sampling.num_keys());
+  float max_error = 0.f;
+  double sum_sq_error = 0.;
+  size_t raw_keys = 0, runtime_keys = 0, runtime_bytes = 0;
+  ozz::log::Out() << std::left << std::setw(32) << "Joint" << std::right
+                  << std::setw(14) << "Max (mm)" << std::setw(14) << "RMS (mm)"
+                  << std::setw(10) << "Raw keys" << std::setw(10) << "Keys"
+                  << std::setw(10) << "Bytes" << std::endl;
+  for (int i = 0; i < num_joints; ++i) {
+    const JointStats& joint = stats[i];
+    max_error = ozz::math::Max(max_error, joint.max_error);
+    sum_sq_error += joint.sum_sq_error;
+    raw_keys += joint.raw_keys;
+    runtime_keys += joint.runtime_keys;
+    runtime_bytes += joint.runtime_bytes;
+    ozz::log::Out() << std::left << std::setw(32) << skeleton.joint_names()[i]
+                    << std::right << std::fixed << std::setprecision(3)
+                    << std::setw(14) << joint.max_error * 1000.f
+                    << std::setw(14)
+                    << Rms(joint.sum_sq_error, num_samples) * 1000.
+                    << std::setw(10) << joint.raw_keys << std::setw(10)
+                    << joint.runtime_keys << std::setw(10)
+                    << joint.runtime_bytes << std::endl;
+  }
+  const double rms_error = Rms(sum_sq_error, num_samples * num_joints);
+  ozz::log::Out() << std::left << std::setw(32) << "Total" << std::right
+                  << std::setw(14) << max_error * 1000.f << std::setw(14)
+                  << rms_error * 1000. << std::setw(10) << raw_keys
+                  << std::setw(10) << runtime_keys << std::setw(10)
+                  << runtime_bytes << std::defaultfloat << std::endl;
+  ozz::log::Out() << "Runtime animation size: " << animation->size()
+                  << " bytes." << std::endl;
+
+  if (OPTIONS_json.value()[0] != 0 &&
+      !OutputJson(OPTIONS_json, skeleton, stats, max_error, rms_error,
+                  num_samples, animation->size())) {
+    return EXIT_FAILURE;
+  }
+
+  if (OPTIONS_max_error > 0.f && max_error > OPTIONS_max_error) {
+    ozz::log::Err() << "Maximum error " << max_error
+                    << " exceeds the threshold " << OPTIONS_max_error << "."
+                    << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
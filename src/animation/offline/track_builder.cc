@@ -27,16 +27,26 @@
 
 #include "ozz/animation/offline/track_builder.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
 #include <limits>
 
 #include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
 
+#include "ozz/animation/offline/raw_event_track.h"
 #include "ozz/animation/offline/raw_track.h"
 
+#include "ozz/animation/runtime/compressed_track.h"
+#include "ozz/animation/runtime/event_track.h"
 #include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_bundle.h"
+#include "ozz/animation/runtime/track_sampling_job.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/math_constant.h"
+#include "ozz/base/maths/math_ex.h"
 
 namespace ozz {
 namespace animation {
@@ -79,6 +89,9 @@ void PatchBeginEndKeys(const _RawTrack& _input,
       keyframes->push_back(_input.keyframes[i]);
     }
     if (_input.keyframes.back().ratio != 1.f) {
+      // Value is constant after the last key, so its curve is meaningless.
+      keyframes->back().interpolation = RawTrackInterpolation::kLinear;
+
       const typename _RawTrack::Keyframe& src_key = _input.keyframes.back();
       const typename _RawTrack::Keyframe end = {RawTrackInterpolation::kLinear,
                                                 1.f, src_key.value};
@@ -87,6 +100,18 @@ void PatchBeginEndKeys(const _RawTrack& _input,
   }
 }
 
+// Tests if _input uses cubic interpolation, which isn't supported by compressed
+// tracks and bundles.
+template <typename _RawTrack>
+bool HasCubicKeys(const _RawTrack& _input) {
+  for (size_t i = 0; i < _input.keyframes.size(); ++i) {
+    if (_input.keyframes[i].interpolation == RawTrackInterpolation::kCubic) {
+      return true;
+    }
+  }
+  return false;
+}
+
 template <typename _Keyframes>
 void Fixup(_Keyframes* _keyframes) {
   // Nothing to do by default.
@@ -100,6 +125,8 @@ void Fixup(_Keyframes* _keyframes) {
 // in the RawAnimation then the builder creates it.
 template <typename _RawTrack, typename _Track>
 unique_ptr<_Track> TrackBuilder::Build(const _RawTrack& _input) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
   // Tests _raw_animation validity.
   if (!_input.Validate()) {
     return unique_ptr<_Track>();
@@ -125,21 +152,41 @@ unique_ptr<_Track> TrackBuilder::Build(const _RawTrack& _input) const {
   // the shortest path during the normalized-lerp.
   Fixup(&keyframes);
 
+  // Cubic buffers are only allocated if a curve is used. Last key has no
+  // curve.
+  bool cubic = false;
+  for (size_t i = 0; i < keyframes.size() - 1; ++i) {
+    cubic |= keyframes[i].interpolation == RawTrackInterpolation::kCubic;
+  }
+
   // Allocates output track.
   const size_t name_len = _input.name.size();
-  track->Allocate(keyframes.size(), _input.name.size());
+  track->Allocate(keyframes.size(), _input.name.size(), cubic);
 
   // Copy all keys to output.
   assert(keyframes.size() == track->ratios_.size() &&
          keyframes.size() == track->values_.size() &&
          keyframes.size() <= track->steps_.size() * 8);
   memset(track->steps_.data(), 0, track->steps_.size_bytes());
+  memset(track->cubics_.data(), 0, track->cubics_.size_bytes());
+  memset(static_cast<void*>(track->tangents_.data()), 0,
+         track->tangents_.size_bytes());
   for (size_t i = 0; i < keyframes.size(); ++i) {
     const typename _RawTrack::Keyframe& src_key = keyframes[i];
     track->ratios_[i] = src_key.ratio;
     track->values_[i] = src_key.value;
     track->steps_[i / 8] |=
         (src_key.interpolation == RawTrackInterpolation::kStep) << (i & 7);
+
+    // Tangents are premultiplied by the ratio difference of the 2 keys.
+    if (src_key.interpolation == RawTrackInterpolation::kCubic &&
+        i + 1 < keyframes.size()) {
+      const typename _RawTrack::Keyframe& next_key = keyframes[i + 1];
+      const float dt = next_key.ratio - src_key.ratio;
+      track->cubics_[i / 8] |= 1 << (i & 7);
+      track->tangents_[i * 2] = src_key.out_tangent * dt;
+      track->tangents_[i * 2 + 1] = next_key.in_tangent * dt;
+    }
   }
 
   // Copy track's name.
@@ -182,17 +229,26 @@ void Fixup<RawQuaternionTrack::Keyframes>(
     // Normalizes input quaternion.
     src_key = NormalizeSafe(src_key, identity);
 
-    // Ensures quaternions are all on the same hemisphere.
+    // Ensures quaternions are all on the same hemisphere. Tangents are
+    // negated along with the value.
+    bool negate;
     if (i == 0) {
-      if (src_key.w < 0.f) {
-        src_key = -src_key;  // Q an -Q are the same rotation.
-      }
+      negate = src_key.w < 0.f;
     } else {
       RawQuaternionTrack::ValueType& prev_key = _keyframes->at(i - 1).value;
       const float dot = src_key.x * prev_key.x + src_key.y * prev_key.y +
                         src_key.z * prev_key.z + src_key.w * prev_key.w;
-      if (dot < 0.f) {
-        src_key = -src_key;  // Q an -Q are the same rotation.
+      negate = dot < 0.f;
+    }
+    if (negate) {
+      src_key = -src_key;  // Q an -Q are the same rotation.
+      RawQuaternionTrack::Keyframe& key = _keyframes->at(i);
+      if (key.interpolation == RawTrackInterpolation::kCubic) {
+        key.out_tangent = -key.out_tangent;
+      }
+      if (i > 0 && _keyframes->at(i - 1).interpolation ==
+                       RawTrackInterpolation::kCubic) {
+        key.in_tangent = -key.in_tangent;
       }
     }
   }
@@ -203,6 +259,349 @@ unique_ptr<QuaternionTrack> TrackBuilder::operator()(
     const RawQuaternionTrack& _input) const {
   return Build<RawQuaternionTrack, QuaternionTrack>(_input);
 }
+
+namespace {
+// Extracts components to quantize from a value.
+void ToComponents(float _value, float* _components) {
+  _components[0] = _value;
+}
+void ToComponents(const math::Float2& _value, float* _components) {
+  _components[0] = _value.x;
+  _components[1] = _value.y;
+}
+void ToComponents(const math::Float3& _value, float* _components) {
+  _components[0] = _value.x;
+  _components[1] = _value.y;
+  _components[2] = _value.z;
+}
+void ToComponents(const math::Float4& _value, float* _components) {
+  _components[0] = _value.x;
+  _components[1] = _value.y;
+  _components[2] = _value.z;
+  _components[3] = _value.w;
+}
+
+// Quantizes float components relatively to the range _offsets/_scales.
+template <typename _ValueType>
+void QuantizeValue(const _ValueType& _value, int _bits, const float* _offsets,
+                   const float* _scales, uint32_t* _quantized) {
+  const int kComponents =
+      animation::internal::CompressedTrackComponents<_ValueType>::kCount;
+  const uint32_t max = (1u << _bits) - 1;
+  float components[kComponents];
+  ToComponents(_value, components);
+  for (int i = 0; i < kComponents; ++i) {
+    const float q = _scales[i] != 0.f
+                        ? (components[i] - _offsets[i]) / _scales[i] + .5f
+                        : 0.f;
+    _quantized[i] = math::Min(static_cast<uint32_t>(math::Max(0.f, q)), max);
+  }
+}
+
+// Quantizes quaternion 3 smallest components, see CompressQuat in
+// animation_builder. Components are stored on _bits - 1 bits, upper bits
+// storing largest component index and sign.
+void QuantizeValue(const math::Quaternion& _value, int _bits,
+                   const float* /*_offsets*/, const float* /*_scales*/,
+                   uint32_t* _quantized) {
+  const float quat[4] = {_value.x, _value.y, _value.z, _value.w};
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (std::abs(quat[i]) > std::abs(quat[largest])) {
+      largest = i;
+    }
+  }
+  const int shift = _bits - 1;
+  const uint32_t mask = (1u << shift) - 1;
+  const int kMapping[4][3] = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+  const int* map = kMapping[largest];
+  for (int i = 0; i < 3; ++i) {
+    const float unit = (quat[map[i]] * math::kSqrt2 + 1.f) * .5f;
+    const float q = math::Clamp(0.f, unit, 1.f) * mask + .5f;
+    _quantized[i] = math::Min(static_cast<uint32_t>(q), mask);
+  }
+  _quantized[0] |= (largest & 1) << shift;
+  _quantized[1] |= (largest >> 1) << shift;
+  _quantized[2] |= (quat[largest] < 0.f) << shift;
+}
+
+// Computes quantization range of every component.
+template <typename _Keyframes>
+void ComputeRanges(const _Keyframes& _keyframes, int _bits, float* _offsets,
+                   float* _scales) {
+  typedef typename _Keyframes::value_type::ValueType ValueType;
+  const int kComponents =
+      animation::internal::CompressedTrackComponents<ValueType>::kCount;
+  // Begin and end keys are always patched, so there's at least a key.
+  assert(!_keyframes.empty());
+  float mins[kComponents];
+  ToComponents(_keyframes[0].value, mins);
+  float maxs[kComponents];
+  ToComponents(_keyframes[0].value, maxs);
+  for (size_t k = 1; k < _keyframes.size(); ++k) {
+    float components[kComponents];
+    ToComponents(_keyframes[k].value, components);
+    for (int i = 0; i < kComponents; ++i) {
+      mins[i] = math::Min(mins[i], components[i]);
+      maxs[i] = math::Max(maxs[i], components[i]);
+    }
+  }
+  for (int i = 0; i < kComponents; ++i) {
+    _offsets[i] = mins[i];
+    _scales[i] = (maxs[i] - mins[i]) / ((1u << _bits) - 1);
+  }
+}
+
+// Quaternion components are quantized in a constant range.
+void ComputeRanges(const RawQuaternionTrack::Keyframes& /*_keyframes*/,
+                   int /*_bits*/, float* /*_offsets*/, float* /*_scales*/) {}
+
+// Quantizes _ratio to _max_ratio range. Ratio is rounded down, the same way
+// sampling scales ratios, so that sampling a track at a key ratio returns that
+// key value.
+uint16_t QuantizeRatio(float _ratio, int _max_ratio) {
+  return static_cast<uint16_t>(std::floor(_ratio * _max_ratio));
+}
+}  // namespace
+
+// Compresses _input, trying 8 bits components first, and falls back to 16 bits
+// if error exceeds _tolerance.
+template <typename _RawTrack, typename _Track>
+unique_ptr<_Track> TrackBuilder::Compress(const _RawTrack& _input,
+                                          float _tolerance) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+  typedef typename _RawTrack::ValueType ValueType;
+  const int kComponents = _Track::kComponents;
+
+  // Tests _input validity.
+  if (!_input.Validate() || HasCubicKeys(_input)) {
+    return unique_ptr<_Track>();
+  }
+
+  // Ensures there's a key frame at the start and end of the track, and fixes
+  // values up like uncompressed tracks.
+  typename _RawTrack::Keyframes reference;
+  PatchBeginEndKeys(_input, &reference);
+  Fixup(&reference);
+
+  // Keys whose quantized ratios collide can't be distinguished at runtime,
+  // where only the last of them is ever sampled. They are merged to the last
+  // one, the error of removing the others being measured below.
+  typename _RawTrack::Keyframes keyframes;
+  for (size_t k = 0; k < reference.size(); ++k) {
+    if (!keyframes.empty() &&
+        QuantizeRatio(keyframes.back().ratio, _Track::kMaxRatio) ==
+            QuantizeRatio(reference[k].ratio, _Track::kMaxRatio)) {
+      keyframes.back() = reference[k];
+    } else {
+      keyframes.push_back(reference[k]);
+    }
+  }
+  Fixup(&keyframes);
+
+  unique_ptr<_Track> track;
+  for (int bits = 8;; bits = 16) {
+    track = make_unique<_Track>();
+    track->Allocate(keyframes.size(), bits, _input.name.size());
+    ComputeRanges(keyframes, bits, track->offsets_, track->scales_);
+
+    memset(track->steps_.data(), 0, track->steps_.size_bytes());
+    uint16_t* values16 = reinterpret_cast<uint16_t*>(track->values_.data());
+    for (size_t k = 0; k < keyframes.size(); ++k) {
+      const typename _RawTrack::Keyframe& src_key = keyframes[k];
+      track->ratios_[k] = QuantizeRatio(src_key.ratio, _Track::kMaxRatio);
+      track->steps_[k / 8] |=
+          (src_key.interpolation == RawTrackInterpolation::kStep) << (k & 7);
+
+      uint32_t quantized[kComponents];
+      QuantizeValue(src_key.value, bits, track->offsets_, track->scales_,
+                    quantized);
+      for (int i = 0; i < kComponents; ++i) {
+        if (bits == 8) {
+          track->values_[k * kComponents + i] =
+              static_cast<uint8_t>(quantized[i]);
+        } else {
+          values16[k * kComponents + i] = static_cast<uint16_t>(quantized[i]);
+        }
+      }
+    }
+
+    // Measures ratios and values quantization error, sampling the compressed
+    // track at all the reference keys ratios.
+    float error = 0.f;
+    ValueType sample;
+    animation::internal::TrackSamplingJob<_Track> sampling;
+    sampling.track = track.get();
+    sampling.result = &sample;
+    for (size_t k = 0; k < reference.size(); ++k) {
+      sampling.ratio = reference[k].ratio;
+      if (!sampling.Run()) {
+        return unique_ptr<_Track>();
+      }
+      error = math::Max(
+          error, animation::internal::TrackPolicy<ValueType>::Distance(
+                     sample, reference[k].value));
+    }
+    if (error <= _tolerance || bits == 16) {
+      break;
+    }
+  }
+
+  // Copy track's name.
+  if (!_input.name.empty()) {
+    strcpy(track->name_, _input.name.c_str());
+  }
+
+  return track;  // Success.
+}
+
+unique_ptr<CompressedFloatTrack> TrackBuilder::operator()(
+    const RawFloatTrack& _input, float _tolerance) const {
+  return Compress<RawFloatTrack, CompressedFloatTrack>(_input, _tolerance);
+}
+unique_ptr<CompressedFloat2Track> TrackBuilder::operator()(
+    const RawFloat2Track& _input, float _tolerance) const {
+  return Compress<RawFloat2Track, CompressedFloat2Track>(_input, _tolerance);
+}
+unique_ptr<CompressedFloat3Track> TrackBuilder::operator()(
+    const RawFloat3Track& _input, float _tolerance) const {
+  return Compress<RawFloat3Track, CompressedFloat3Track>(_input, _tolerance);
+}
+unique_ptr<CompressedFloat4Track> TrackBuilder::operator()(
+    const RawFloat4Track& _input, float _tolerance) const {
+  return Compress<RawFloat4Track, CompressedFloat4Track>(_input, _tolerance);
+}
+unique_ptr<CompressedQuaternionTrack> TrackBuilder::operator()(
+    const RawQuaternionTrack& _input, float _tolerance) const {
+  return Compress<RawQuaternionTrack, CompressedQuaternionTrack>(_input,
+                                                                 _tolerance);
+}
+
+namespace {
+// Evaluates patched _keys at _ratio, the same way TrackSamplingJob does. If
+// _left is true and there's a key at _ratio, it returns the value before the
+// key, which is different if previous key is a step.
+float EvaluateKeys(const RawFloatTrack::Keyframes& _keys, float _ratio,
+                   bool _left) {
+  const RawFloatTrack::Keyframe* k1 = std::upper_bound(
+      _keys.data(), _keys.data() + _keys.size(), _ratio,
+      [](float _r, const RawFloatTrack::Keyframe& _key) {
+        return _r < _key.ratio;
+      });
+  const RawFloatTrack::Keyframe* k0 = k1 - 1;
+  if (_left && k0->ratio == _ratio && k0 != _keys.data()) {
+    const RawFloatTrack::Keyframe* prev = k0 - 1;
+    return prev->interpolation == RawTrackInterpolation::kStep ? prev->value
+                                                               : k0->value;
+  }
+  if (k1 == _keys.data() + _keys.size() ||
+      k0->interpolation == RawTrackInterpolation::kStep) {
+    return k0->value;
+  }
+  const float alpha = (_ratio - k0->ratio) / (k1->ratio - k0->ratio);
+  return animation::internal::TrackPolicy<float>::Lerp(k0->value, k1->value,
+                                                       alpha);
+}
+}  // namespace
+
+unique_ptr<FloatTrackBundle> TrackBuilder::operator()(
+    const span<const RawFloatTrack>& _inputs) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
+  // Tests all tracks validity. Cubic keys aren't supported.
+  for (const RawFloatTrack& input : _inputs) {
+    if (!input.Validate() || HasCubicKeys(input)) {
+      return unique_ptr<FloatTrackBundle>();
+    }
+  }
+
+  // Patches all tracks so they all have a keyframe at the start and end, and
+  // collects ratios. Keys following a step key are discontinuities.
+  const size_t num_tracks = _inputs.size();
+  ozz::vector<RawFloatTrack::Keyframes> tracks(num_tracks);
+  ozz::vector<float> ratios;
+  ozz::vector<float> discontinuities;
+  for (size_t i = 0; i < num_tracks; ++i) {
+    RawFloatTrack::Keyframes& keys = tracks[i];
+    PatchBeginEndKeys(_inputs[i], &keys);
+    for (size_t k = 0; k < keys.size(); ++k) {
+      ratios.push_back(keys[k].ratio);
+      if (k > 0 &&
+          keys[k - 1].interpolation == RawTrackInterpolation::kStep) {
+        discontinuities.push_back(keys[k].ratio);
+      }
+    }
+  }
+  std::sort(ratios.begin(), ratios.end());
+  ratios.erase(std::unique(ratios.begin(), ratios.end()), ratios.end());
+  std::sort(discontinuities.begin(), discontinuities.end());
+  discontinuities.erase(
+      std::unique(discontinuities.begin(), discontinuities.end()),
+      discontinuities.end());
+
+  // Discontinuities ratios are doubled, the first key being evaluated on the
+  // left of the discontinuity.
+  struct Key {
+    float ratio;
+    bool left;
+  };
+  ozz::vector<Key> keys;
+  keys.reserve(ratios.size() + discontinuities.size());
+  for (const float ratio : ratios) {
+    if (std::binary_search(discontinuities.begin(), discontinuities.end(),
+                           ratio)) {
+      const Key left = {ratio, true};
+      keys.push_back(left);
+    }
+    const Key key = {ratio, false};
+    keys.push_back(key);
+  }
+
+  // Allocates output bundle.
+  unique_ptr<FloatTrackBundle> bundle = make_unique<FloatTrackBundle>();
+  bundle->Allocate(keys.size(), static_cast<int>(num_tracks));
+
+  // Evaluates every track at every key, padding values set to 0.
+  const size_t stride = bundle->num_soa_tracks() * 4;
+  assert(bundle->values_.size() == keys.size() * stride);
+  std::fill(bundle->values_.begin(), bundle->values_.end(), 0.f);
+  for (size_t k = 0; k < keys.size(); ++k) {
+    bundle->ratios_[k] = keys[k].ratio;
+    float* values = bundle->values_.begin() + k * stride;
+    for (size_t i = 0; i < num_tracks; ++i) {
+      values[i] = EvaluateKeys(tracks[i], keys[k].ratio, keys[k].left);
+    }
+  }
+
+  return bundle;  // Success.
+}
+
+unique_ptr<EventTrack> TrackBuilder::operator()(
+    const RawEventTrack& _input) const {
+  const memory::ScopedTag tag(memory::kBuilder);
+
+  // Tests _input validity.
+  if (!_input.Validate()) {
+    return unique_ptr<EventTrack>();
+  }
+
+  // Everything is fine, allocates and fills the track.
+  unique_ptr<EventTrack> track = make_unique<EventTrack>();
+  const size_t name_len = _input.name.size();
+  track->Allocate(_input.events.size(), name_len);
+
+  for (size_t i = 0; i < _input.events.size(); ++i) {
+    track->ratios_[i] = _input.events[i].ratio;
+    track->ids_[i] = _input.events[i].id;
+  }
+
+  // Copy track's name.
+  if (name_len) {
+    strcpy(track->name_, _input.name.c_str());
+  }
+
+  return track;  // Success.
+}
 }  // namespace offline
 }  // namespace animation
 }  // namespace ozz
@@ -0,0 +1,82 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/offline/track_edges_builder.h"
+
+#include <cstring>
+
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_edges.h"
+#include "ozz/animation/runtime/track_triggering_job.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/memory/allocator.h"
+
+namespace ozz {
+namespace animation {
+namespace offline {
+
+ozz::unique_ptr<TrackEdges> TrackEdgesBuilder::operator()(
+    const FloatTrack& _track, float _threshold) const {
+  // A track without any key isn't valid (not built by TrackBuilder).
+  if (_track.ratios().empty()) {
+    return ozz::unique_ptr<TrackEdges>();
+  }
+
+  // Collects edges of a single loop, in forward direction.
+  TrackTriggeringJob job;
+  job.track = &_track;
+  job.threshold = _threshold;
+  job.from = 0.f;
+  job.to = 1.f;
+  TrackTriggeringJob::Iterator iterator;
+  job.iterator = &iterator;
+  if (!job.Run()) {
+    return ozz::unique_ptr<TrackEdges>();
+  }
+
+  ozz::vector<TrackTriggeringJob::Edge> edges;
+  for (; iterator != job.end(); ++iterator) {
+    edges.push_back(*iterator);
+  }
+
+  // Everything is fine, allocates and fills the table.
+  ozz::unique_ptr<TrackEdges> output = make_unique<TrackEdges>();
+  output->Allocate(edges.size());
+  output->threshold_ = _threshold;
+
+  std::memset(output->risings_.data(), 0, output->risings_.size_bytes());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    output->ratios_[i] = edges[i].ratio;
+    output->risings_[i / 8] |=
+        static_cast<uint8_t>(edges[i].rising ? 1 << (i & 7) : 0);
+  }
+
+  return output;
+}
+}  // namespace offline
+}  // namespace animation
+}  // namespace ozz
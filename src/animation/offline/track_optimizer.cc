@@ -34,7 +34,10 @@
 #define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
 #include "animation/offline/decimate.h"
 
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/memory/tracking_allocator.h"
 
 #include "ozz/animation/offline/raw_track.h"
 
@@ -46,8 +49,10 @@ namespace animation {
 namespace offline {
 
 // Setup default values (favoring quality).
-TrackOptimizer::TrackOptimizer() : tolerance(1e-3f) {  // 1 mm.
-}
+TrackOptimizer::TrackOptimizer()
+    : tolerance(1e-3f),  // 1 mm.
+      algorithm(kRamerDouglasPeucker),
+      fit_curves(false) {}
 
 namespace {
 
@@ -58,15 +63,19 @@ struct Adapter {
 
   Adapter() {}
 
-  bool Decimable(const _KeyFrame& _key) const {
+  bool Decimable(const _KeyFrame& _key, const _KeyFrame& _previous) const {
     // RawTrackInterpolation::kStep keyframes aren't optimized, as steps can't
-    // be interpolated.
-    return _key.interpolation != RawTrackInterpolation::kStep;
+    // be interpolated. Neither are cubic keys, nor keys ending a curve (whose
+    // previous key is cubic), as removing them would change the curve.
+    return _key.interpolation != RawTrackInterpolation::kStep &&
+           _key.interpolation != RawTrackInterpolation::kCubic &&
+           _previous.interpolation != RawTrackInterpolation::kCubic;
   }
 
   _KeyFrame Lerp(const _KeyFrame& _left, const _KeyFrame& _right,
                  const _KeyFrame& _ref) const {
-    assert(Decimable(_ref));
+    assert(_ref.interpolation != RawTrackInterpolation::kStep &&
+           _ref.interpolation != RawTrackInterpolation::kCubic);
     const float alpha =
         (_ref.ratio - _left.ratio) / (_right.ratio - _left.ratio);
     assert(alpha >= 0.f && alpha <= 1.f);
@@ -78,10 +87,263 @@ struct Adapter {
   float Distance(const _KeyFrame& _a, const _KeyFrame& _b) const {
     return Policy::Distance(_a.value, _b.value);
   }
+
+  math::SimdFloat4 Distance4(const _KeyFrame& _left, const _KeyFrame& _right,
+                             const _KeyFrame* _keys) const {
+    math::SimdFloat4 values[kComponents];
+    internal::LoadSoa<kComponents>(
+        Components(_keys[0]), Components(_keys[1]), Components(_keys[2]),
+        Components(_keys[3]), values);
+    const math::SimdFloat4 alpha = internal::Alpha4(
+        _left.ratio, _right.ratio,
+        math::simd_float4::Load(_keys[0].ratio, _keys[1].ratio, _keys[2].ratio,
+                                _keys[3].ratio));
+    return Distance4(Components(_left), Components(_right), values, alpha,
+                     static_cast<ValueType*>(nullptr));
+  }
+
+ private:
+  // Number of float components of a value.
+  static const int kComponents = sizeof(ValueType) / sizeof(float);
+
+  static const float* Components(const _KeyFrame& _key) {
+    return reinterpret_cast<const float*>(&_key.value);
+  }
+
+  // Linear values distance, see TrackPolicy::Distance.
+  template <typename _Type>
+  static math::SimdFloat4 Distance4(const float* _left, const float* _right,
+                                    const math::SimdFloat4* _values,
+                                    math::_SimdFloat4 _alpha, _Type*) {
+    return internal::LerpDistance4<kComponents>(_left, _right, _values,
+                                                _alpha);
+  }
+
+  // Quaternion distance, see TrackPolicy<math::Quaternion>::Distance.
+  static math::SimdFloat4 Distance4(const float* _left, const float* _right,
+                                    const math::SimdFloat4* _values,
+                                    math::_SimdFloat4 _alpha,
+                                    math::Quaternion*) {
+    const math::SimdFloat4 cos_half_angle =
+        internal::NLerpDot4(_left, _right, _values, _alpha);
+    return math::simd_float4::one() -
+           math::Min(math::simd_float4::one(), math::Abs(cos_half_angle));
+  }
 };
 
+// Evaluates segment starting at key _i0 of _keys at _alpha, whatever its
+// interpolation mode.
+template <typename _Keyframes>
+typename _Keyframes::value_type::ValueType EvaluateSegment(
+    const _Keyframes& _keys, size_t _i0, float _alpha) {
+  typedef typename _Keyframes::value_type::ValueType ValueType;
+  typedef typename animation::internal::TrackPolicy<ValueType> Policy;
+  const typename _Keyframes::value_type& k0 = _keys[_i0];
+  const typename _Keyframes::value_type& k1 = _keys[_i0 + 1];
+  switch (k0.interpolation) {
+    case RawTrackInterpolation::kStep:
+      return k0.value;
+    case RawTrackInterpolation::kCubic: {
+      const float dt = k1.ratio - k0.ratio;
+      return Policy::Hermite(k0.value, k0.out_tangent * dt, k1.value,
+                             k1.in_tangent * dt, _alpha);
+    }
+    default:
+      return Policy::Lerp(k0.value, k1.value, _alpha);
+  }
+}
+
+// Fits keys with cubic Hermite curves.
+// Tangents are computed at every source key, from curves tangents if the source
+// is already cubic, or estimated from neighbor keys otherwise. Then curves are
+// greedily extended from one key to the furthest next one, as long as every
+// source reference sample remains within tolerance. References are sampled at
+// the keys and in between, to catch curves overshooting.
+template <typename _Keyframes>
+class CurveFitter {
+ public:
+  typedef typename _Keyframes::value_type Keyframe;
+  typedef typename Keyframe::ValueType ValueType;
+  typedef typename animation::internal::TrackPolicy<ValueType> Policy;
+
+  CurveFitter(const _Keyframes& _src, float _tolerance)
+      : src_(_src), tolerance_(_tolerance) {}
+
+  void operator()(_Keyframes* _dest) {
+    const size_t num_keys = src_.size();
+    if (num_keys < 3) {
+      *_dest = src_;
+      return;
+    }
+
+    ComputeTangents();
+    ComputeSamples();
+
+    _dest->clear();
+    for (size_t i = 0; i < num_keys - 1;) {
+      Keyframe key = src_[i];
+      key.in_tangent = in_tangents_[i];
+      key.out_tangent = out_tangents_[i];
+
+      // Steps are kept as is.
+      if (key.interpolation == RawTrackInterpolation::kStep) {
+        _dest->push_back(key);
+        ++i;
+        continue;
+      }
+
+      const size_t fit = Furthest(i);
+      if (fit == i) {
+        // Even a single segment doesn't fit a curve, source interpolation is
+        // kept.
+        _dest->push_back(key);
+        ++i;
+      } else {
+        key.interpolation = RawTrackInterpolation::kCubic;
+        _dest->push_back(key);
+        i = fit;
+      }
+    }
+
+    // Last key.
+    Keyframe key = src_.back();
+    key.in_tangent = in_tangents_.back();
+    key.out_tangent = out_tangents_.back();
+    _dest->push_back(key);
+  }
+
+ private:
+  // Computes in and out tangents of every key. Keys can't be used across a
+  // step, so one sided differences are used around steps and track ends.
+  void ComputeTangents() {
+    const size_t num_keys = src_.size();
+    in_tangents_.resize(num_keys);
+    out_tangents_.resize(num_keys);
+    for (size_t i = 0; i < num_keys; ++i) {
+      const bool left =
+          i > 0 && src_[i - 1].interpolation != RawTrackInterpolation::kStep;
+      const bool right = i + 1 < num_keys &&
+                         src_[i].interpolation != RawTrackInterpolation::kStep;
+      const Keyframe& k0 = left ? src_[i - 1] : src_[i];
+      const Keyframe& k1 = right ? src_[i + 1] : src_[i];
+      const ValueType estimated =
+          left || right
+              ? (k1.value - k0.value) * (1.f / (k1.ratio - k0.ratio))
+              : src_[i].value - src_[i].value;
+      in_tangents_[i] =
+          i > 0 && src_[i - 1].interpolation == RawTrackInterpolation::kCubic
+              ? src_[i].in_tangent
+              : estimated;
+      out_tangents_[i] = src_[i].interpolation == RawTrackInterpolation::kCubic
+                             ? src_[i].out_tangent
+                             : estimated;
+    }
+  }
+
+  // Samples reference track at keys and in between.
+  void ComputeSamples() {
+    const size_t num_segments = src_.size() - 1;
+    samples_.resize(num_segments * kSamples);
+    for (size_t i = 0; i < num_segments; ++i) {
+      for (int j = 0; j < kSamples; ++j) {
+        const float alpha = static_cast<float>(j) / kSamples;
+        Sample& sample = samples_[i * kSamples + j];
+        sample.ratio = math::Lerp(src_[i].ratio, src_[i + 1].ratio, alpha);
+        sample.value = EvaluateSegment(src_, i, alpha);
+      }
+    }
+  }
+
+  // Tests if a curve from key _i0 to _i1 fits all reference samples in
+  // between.
+  bool Fits(size_t _i0, size_t _i1) const {
+    const Keyframe& k0 = src_[_i0];
+    const Keyframe& k1 = src_[_i1];
+    const float dt = k1.ratio - k0.ratio;
+    const ValueType t0 = out_tangents_[_i0] * dt;
+    const ValueType t1 = in_tangents_[_i1] * dt;
+    for (size_t i = _i0 * kSamples + 1; i < _i1 * kSamples; ++i) {
+      const Sample& sample = samples_[i];
+      const float alpha = (sample.ratio - k0.ratio) / dt;
+      const ValueType value =
+          Policy::Hermite(k0.value, t0, k1.value, t1, alpha);
+      if (Policy::Distance(value, sample.value) > tolerance_) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Searches for the furthest key a curve starting at _first can reach. Curve
+  // length grows exponentially, and is then refined with a binary search.
+  // Returns _first if no curve fits.
+  size_t Furthest(size_t _first) const {
+    // Curves can't span over a step.
+    size_t last = _first + 1;
+    while (last < src_.size() - 1 &&
+           src_[last].interpolation != RawTrackInterpolation::kStep) {
+      ++last;
+    }
+
+    size_t fit = _first;
+    size_t fail = last + 1;
+    for (size_t step = 1; _first + step <= last; step *= 2) {
+      if (!Fits(_first, _first + step)) {
+        fail = _first + step;
+        break;
+      }
+      fit = _first + step;
+    }
+    if (fail == last + 1 && fit != last) {
+      if (Fits(_first, last)) {
+        fit = last;
+      } else {
+        fail = last;
+      }
+    }
+    while (fit != _first && fail - fit > 1) {
+      const size_t mid = fit + (fail - fit) / 2;
+      if (Fits(_first, mid)) {
+        fit = mid;
+      } else {
+        fail = mid;
+      }
+    }
+    return fit;
+  }
+
+  // Number of reference samples per source segment.
+  static const int kSamples = 4;
+
+  struct Sample {
+    float ratio;
+    ValueType value;
+  };
+
+  const _Keyframes& src_;
+  float tolerance_;
+  ozz::vector<ValueType> in_tangents_;
+  ozz::vector<ValueType> out_tangents_;
+  ozz::vector<Sample> samples_;
+};
+
+template <typename _Keyframes>
+void FitCurves(const _Keyframes& _src, float _tolerance, _Keyframes* _dest) {
+  CurveFitter<_Keyframes> fitter(_src, _tolerance);
+  fitter(_dest);
+}
+
+// Curves fitting isn't supported for quaternions.
+void FitCurves(const RawQuaternionTrack::Keyframes& _src, float /*_tolerance*/,
+               RawQuaternionTrack::Keyframes* _dest) {
+  *_dest = _src;
+}
+
 template <typename _Track>
-inline bool Optimize(float _tolerance, const _Track& _input, _Track* _output) {
+inline bool Optimize(float _tolerance, DecimationAlgorithm _algorithm,
+                     bool _fit_curves, const _Track& _input, _Track* _output) {
+  const memory::ScopedTag tag(memory::kBuilder);
+
   if (!_output) {
     return false;
   }
@@ -97,8 +359,13 @@ inline bool Optimize(float _tolerance, const _Track& _input, _Track* _output) {
   _output->name = _input.name;
 
   // Optimizes.
-  const Adapter<typename _Track::Keyframe> adapter;
-  Decimate(_input.keyframes, adapter, _tolerance, &_output->keyframes);
+  if (_fit_curves) {
+    FitCurves(_input.keyframes, _tolerance, &_output->keyframes);
+  } else {
+    const Adapter<typename _Track::Keyframe> adapter;
+    Decimate(_input.keyframes, adapter, _tolerance, _algorithm,
+             &_output->keyframes);
+  }
 
   // Output animation is always valid though.
   return _output->Validate();
@@ -107,23 +374,24 @@ inline bool Optimize(float _tolerance, const _Track& _input, _Track* _output) {
 
 bool TrackOptimizer::operator()(const RawFloatTrack& _input,
                                 RawFloatTrack* _output) const {
-  return Optimize(tolerance, _input, _output);
+  return Optimize(tolerance, algorithm, fit_curves, _input, _output);
 }
 bool TrackOptimizer::operator()(const RawFloat2Track& _input,
                                 RawFloat2Track* _output) const {
-  return Optimize(tolerance, _input, _output);
+  return Optimize(tolerance, algorithm, fit_curves, _input, _output);
 }
 bool TrackOptimizer::operator()(const RawFloat3Track& _input,
                                 RawFloat3Track* _output) const {
-  return Optimize(tolerance, _input, _output);
+  return Optimize(tolerance, algorithm, fit_curves, _input, _output);
 }
 bool TrackOptimizer::operator()(const RawFloat4Track& _input,
                                 RawFloat4Track* _output) const {
-  return Optimize(tolerance, _input, _output);
+  return Optimize(tolerance, algorithm, fit_curves, _input, _output);
 }
 bool TrackOptimizer::operator()(const RawQuaternionTrack& _input,
                                 RawQuaternionTrack* _output) const {
-  return Optimize(1.f - std::cos(.5f * tolerance), _input, _output);
+  return Optimize(1.f - std::cos(.5f * tolerance), algorithm, false, _input,
+                  _output);
 }
 }  // namespace offline
 }  // namespace animation
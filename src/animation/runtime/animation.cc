@@ -35,6 +35,7 @@
 #include "ozz/base/maths/math_archive.h"
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
 
 // Internal include file
 #define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
@@ -61,6 +62,7 @@ void Animation::Allocate(size_t _name_len, size_t _translation_count,
          rotations_.size() == 0 && scales_.size() == 0);
 
   // Compute overall size and allocate a single buffer for all the data.
+  const memory::ScopedTag tag(memory::kAnimation);
   const size_t buffer_size = (_name_len > 0 ? _name_len + 1 : 0) +
                              _translation_count * sizeof(Float3Key) +
                              _rotation_count * sizeof(QuaternionKey) +
@@ -120,14 +122,10 @@ void Animation::Save(ozz::io::OArchive& _archive) const {
     _archive << ozz::io::MakeArray(key.value);
   }
 
+  // Values are serialized with their largest component and sign flag bits.
   for (const QuaternionKey& key : rotations_) {
     _archive << key.ratio;
-    uint16_t track = key.track;
-    _archive << track;
-    uint8_t largest = key.largest;
-    _archive << largest;
-    bool sign = key.sign;
-    _archive << sign;
+    _archive << key.track;
     _archive << ozz::io::MakeArray(key.value);
   }
 
@@ -144,8 +142,9 @@ void Animation::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   duration_ = 0.f;
   num_tracks_ = 0;
 
-  // No retro-compatibility with anterior versions.
-  if (_version != 6) {
+  // Version 6 is still supported, see rotation keys loading below. No
+  // retro-compatibility with anterior versions.
+  if (_version != 6 && _version != 7) {
     log::Err() << "Unsupported Animation version " << _version << "."
                << std::endl;
     return;
@@ -181,16 +180,21 @@ void Animation::Load(ozz::io::IArchive& _archive, uint32_t _version) {
 
   for (QuaternionKey& key : rotations_) {
     _archive >> key.ratio;
-    uint16_t track;
-    _archive >> track;
-    key.track = track;
-    uint8_t largest;
-    _archive >> largest;
-    key.largest = largest & 3;
-    bool sign;
-    _archive >> sign;
-    key.sign = sign & 1;
-    _archive >> ozz::io::MakeArray(key.value);
+    _archive >> key.track;
+    if (_version == 6) {
+      // Version 6 stored 16 bits values and separate flags. Values are rounded
+      // to 15 bits, in order to pack flags in their least significant bit.
+      uint8_t largest;
+      _archive >> largest;
+      bool sign;
+      _archive >> sign;
+      int16_t values[3];
+      _archive >> ozz::io::MakeArray(values);
+      const int ivalues[3] = {values[0], values[1], values[2]};
+      key.Pack(largest & 3, sign, ivalues);
+    } else {
+      _archive >> ozz::io::MakeArray(key.value);
+    }
   }
 
   for (Float3Key& key : scales_) {
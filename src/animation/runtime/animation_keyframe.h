@@ -57,22 +57,43 @@ struct Float3Key {
 // component is in range [0:1]. This property allows to quantize the 3
 // components to 3 signed integer 16 bits values. The 4th component is restored
 // at runtime, using the knowledge that |w| = sqrt(1 - (a^2 + b^2 + c^2)).
-// The sign of this 4th component is stored using 1 bit taken from the track
-// member.
 //
 // In more details, compression algorithm stores the 3 smallest components of
 // the quaternion and restores the largest. The 3 smallest can be pre-multiplied
 // by sqrt(2) to gain some precision indeed.
 //
+// The index of the largest component (2 bits) and its sign (1 bit) are stored
+// in the least significant bit of each of the 3 quantized values, leaving the
+// whole 16 bits of track member to index up to 65535 tracks. Values are thus
+// quantized to 15 bits, with the same scale as 16 bits ones once flag bits are
+// masked out.
+//
 // Quantization could be reduced to 11-11-10 bits as often used for animation
 // key frames, but in this case RotationKey structure would induce 16 bits of
 // padding.
 struct QuaternionKey {
   float ratio;
-  uint16_t track : 13;   // The track this key frame belongs to.
-  uint16_t largest : 2;  // The largest component of the quaternion.
-  uint16_t sign : 1;     // The sign of the largest component. 1 for negative.
-  int16_t value[3];      // The quantized value of the 3 smallest components.
+  uint16_t track;    // The track this key frame belongs to.
+  int16_t value[3];  // The quantized value of the 3 smallest components, and
+                     // largest component index and sign flags.
+
+  // The largest component of the quaternion.
+  int largest() const { return (value[0] & 1) | ((value[1] & 1) << 1); }
+
+  // The sign of the largest component. 1 for negative.
+  int sign() const { return value[2] & 1; }
+
+  // Packs quantized _values (16 bits scale), _largest and _sign flags to
+  // *this key's values. _values are rounded to the nearest even number to free
+  // their least significant bit.
+  void Pack(int _largest, int _sign, const int _values[3]) {
+    const int flags[3] = {_largest & 1, (_largest >> 1) & 1, _sign & 1};
+    for (int i = 0; i < 3; ++i) {
+      const int even = (_values[i] + (_values[i] > 0 ? 1 : 0)) & ~1;
+      const int clamped = even < -32766 ? -32766 : even > 32766 ? 32766 : even;
+      value[i] = static_cast<int16_t>(clamped | flags[i]);
+    }
+  }
 };
 
 }  // namespace animation
@@ -156,35 +156,41 @@ namespace {
     _out.scale = _out.scale * rcp_scale;                                       \
   } while (void(0), 0)
 
+// Defines the maximum number of soa joints processed at once by blending
+// stages, which bounds accumulated weights stack allocation.
+const size_t kMaxChunkSoAJoints = 256;
+
 // Defines parameters that are passed through blending stages.
+// Blending stages process the [begin,end[ range of soa joints.
 struct ProcessArgs {
-  ProcessArgs(const BlendingJob& _job)
+  ProcessArgs(const BlendingJob& _job, size_t _begin, size_t _end)
       : job(_job),
-        num_soa_joints(_job.bind_pose.size()),
+        begin(_begin),
+        end(_end),
         num_passes(0),
         num_partial_passes(0),
         accumulated_weight(0.f) {
     // The range of all buffers has already been validated.
-    assert(job.output.size() >= num_soa_joints);
-    assert(OZZ_ARRAY_SIZE(accumulated_weights) >= num_soa_joints);
+    assert(job.output.size() >= end);
+    assert(OZZ_ARRAY_SIZE(accumulated_weights) >= end - begin);
   }
 
-  // Allocates enough space to store a accumulated weights per-joint.
-  // It will be initialized by the first pass processed, if any.
-  // This is quite big for a stack allocation (4 byte * maximum number of
-  // joints). This is one of the reasons why the number of joints is limited
-  // by the API.
-  // Note that this array is used with SoA data.
+  // Allocates enough space to store a accumulated weights per-joint of a
+  // chunk. It will be initialized by the first pass processed, if any.
+  // This is quite big for a stack allocation (4 byte * 1024 joints), which is
+  // why joints are processed in chunks.
+  // Note that this array is used with SoA data, and indexed relatively to
+  // begin.
   // This is the first argument in order to avoid wasting too much space with
   // alignment padding.
-  math::SimdFloat4 accumulated_weights[Skeleton::kMaxSoAJoints];
+  math::SimdFloat4 accumulated_weights[kMaxChunkSoAJoints];
 
   // The job to process.
   const BlendingJob& job;
 
-  // The number of transforms to process as defined by the size of the bind
-  // pose.
-  size_t num_soa_joints;
+  // The range of soa transforms to process.
+  size_t begin;
+  size_t end;
 
   // Number of processed blended passes (excluding passes with a weight <= 0.f),
   // including partial passes.
@@ -209,9 +215,9 @@ void BlendLayers(ProcessArgs* _args) {
   // Iterates through all layers and blend them to the output.
   for (const BlendingJob::Layer& layer : _args->job.layers) {
     // Asserts buffer sizes, which must never fail as it has been validated.
-    assert(layer.transform.size() >= _args->num_soa_joints);
+    assert(layer.transform.size() >= _args->end);
     assert(layer.joint_weights.empty() ||
-           (layer.joint_weights.size() >= _args->num_soa_joints));
+           (layer.joint_weights.size() >= _args->end));
 
     // Skip irrelevant layers.
     if (layer.weight <= 0.f) {
@@ -228,40 +234,40 @@ void BlendLayers(ProcessArgs* _args) {
       ++_args->num_partial_passes;
 
       if (_args->num_passes == 0) {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform* dest = _args->job.output.begin() + i;
           const math::SimdFloat4 weight =
               layer_weight * math::Max0(layer.joint_weights[i]);
-          _args->accumulated_weights[i] = weight;
+          _args->accumulated_weights[i - _args->begin] = weight;
           OZZ_BLEND_1ST_PASS(src, weight, dest);
         }
       } else {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform* dest = _args->job.output.begin() + i;
           const math::SimdFloat4 weight =
               layer_weight * math::Max0(layer.joint_weights[i]);
-          _args->accumulated_weights[i] =
-              _args->accumulated_weights[i] + weight;
+          _args->accumulated_weights[i - _args->begin] =
+              _args->accumulated_weights[i - _args->begin] + weight;
           OZZ_BLEND_N_PASS(src, weight, dest);
         }
       }
     } else {
       // This is a full layer.
       if (_args->num_passes == 0) {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform* dest = _args->job.output.begin() + i;
-          _args->accumulated_weights[i] = layer_weight;
+          _args->accumulated_weights[i - _args->begin] = layer_weight;
           OZZ_BLEND_1ST_PASS(src, layer_weight, dest);
         }
       } else {
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform* dest = _args->job.output.begin() + i;
-          _args->accumulated_weights[i] =
-              _args->accumulated_weights[i] + layer_weight;
+          _args->accumulated_weights[i - _args->begin] =
+              _args->accumulated_weights[i - _args->begin] + layer_weight;
           OZZ_BLEND_N_PASS(src, layer_weight, dest);
         }
       }
@@ -277,7 +283,7 @@ void BlendBindPose(ProcessArgs* _args) {
   assert(_args);
 
   // Asserts buffer sizes, which must never fail as it has been validated.
-  assert(_args->job.bind_pose.size() >= _args->num_soa_joints);
+  assert(_args->job.bind_pose.size() >= _args->end);
 
   if (_args->num_partial_passes == 0) {
     // No partial blending pass detected, threshold can be tested globally.
@@ -287,7 +293,7 @@ void BlendBindPose(ProcessArgs* _args) {
       if (_args->num_passes == 0) {
         // Strictly copying bind-pose.
         _args->accumulated_weight = 1.f;
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           _args->job.output[i] = _args->job.bind_pose[i];
         }
       } else {
@@ -298,7 +304,7 @@ void BlendBindPose(ProcessArgs* _args) {
         const math::SimdFloat4 simd_bp_weight =
             math::simd_float4::Load1(bp_weight);
 
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = _args->job.bind_pose[i];
           math::SoaTransform* dest = _args->job.output.begin() + i;
           OZZ_BLEND_N_PASS(src, simd_bp_weight, dest);
@@ -314,13 +320,13 @@ void BlendBindPose(ProcessArgs* _args) {
     // There's been at least 1 pass as num_partial_passes != 0.
     assert(_args->num_passes != 0);
 
-    for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+    for (size_t i = _args->begin; i < _args->end; ++i) {
       const math::SoaTransform& src = _args->job.bind_pose[i];
       math::SoaTransform* dest = _args->job.output.begin() + i;
       const math::SimdFloat4 bp_weight =
-          math::Max0(threshold - _args->accumulated_weights[i]);
-      _args->accumulated_weights[i] =
-          math::Max(threshold, _args->accumulated_weights[i]);
+          math::Max0(threshold - _args->accumulated_weights[i - _args->begin]);
+      _args->accumulated_weights[i - _args->begin] =
+          math::Max(threshold, _args->accumulated_weights[i - _args->begin]);
       OZZ_BLEND_N_PASS(src, bp_weight, dest);
     }
   }
@@ -338,7 +344,7 @@ void Normalize(ProcessArgs* _args) {
     // division to all joints.
     const math::SimdFloat4 ratio =
         math::simd_float4::Load1(1.f / _args->accumulated_weight);
-    for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+    for (size_t i = _args->begin; i < _args->end; ++i) {
       math::SoaTransform& dest = _args->job.output[i];
       dest.rotation = NormalizeEst(dest.rotation);
       dest.translation = dest.translation * ratio;
@@ -347,8 +353,9 @@ void Normalize(ProcessArgs* _args) {
   } else {
     // Partial blending normalization requires to compute the divider per-joint.
     const math::SimdFloat4 one = math::simd_float4::one();
-    for (size_t i = 0; i < _args->num_soa_joints; ++i) {
-      const math::SimdFloat4 ratio = one / _args->accumulated_weights[i];
+    for (size_t i = _args->begin; i < _args->end; ++i) {
+      const math::SimdFloat4 ratio =
+          one / _args->accumulated_weights[i - _args->begin];
       math::SoaTransform& dest = _args->job.output[i];
       dest.rotation = NormalizeEst(dest.rotation);
       dest.translation = dest.translation * ratio;
@@ -364,9 +371,9 @@ void AddLayers(ProcessArgs* _args) {
   // Iterates through all layers and blend them to the output.
   for (const BlendingJob::Layer& layer : _args->job.additive_layers) {
     // Asserts buffer sizes, which must never fail as it has been validated.
-    assert(layer.transform.size() >= _args->num_soa_joints);
+    assert(layer.transform.size() >= _args->end);
     assert(layer.joint_weights.empty() ||
-           (layer.joint_weights.size() >= _args->num_soa_joints));
+           (layer.joint_weights.size() >= _args->end));
 
     // Prepares constants.
     const math::SimdFloat4 one = math::simd_float4::one();
@@ -378,7 +385,7 @@ void AddLayers(ProcessArgs* _args) {
 
       if (!layer.joint_weights.empty()) {
         // This layer has per-joint weights.
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           const math::SimdFloat4 weight =
@@ -394,7 +401,7 @@ void AddLayers(ProcessArgs* _args) {
         const math::SoaFloat3 one_minus_weight_f3 = {
             one_minus_weight, one_minus_weight, one_minus_weight};
 
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           OZZ_ADD_PASS(src, layer_weight, dest);
@@ -407,7 +414,7 @@ void AddLayers(ProcessArgs* _args) {
 
       if (!layer.joint_weights.empty()) {
         // This layer has per-joint weights.
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           const math::SimdFloat4 weight =
@@ -418,7 +425,7 @@ void AddLayers(ProcessArgs* _args) {
       } else {
         // This is a full layer.
         const math::SimdFloat4 one_minus_weight = one - layer_weight;
-        for (size_t i = 0; i < _args->num_soa_joints; ++i) {
+        for (size_t i = _args->begin; i < _args->end; ++i) {
           const math::SoaTransform& src = layer.transform[i];
           math::SoaTransform& dest = _args->job.output[i];
           OZZ_SUB_PASS(src, layer_weight, dest);
@@ -436,20 +443,28 @@ bool BlendingJob::Run() const {
     return false;
   }
 
-  // Initializes blended parameters that are exchanged across blend stages.
-  ProcessArgs process_args(*this);
+  // Joints are processed in chunks, each one going through all blending
+  // stages. The whole range is processed at once by a single chunk for
+  // skeletons up to 1024 joints.
+  const size_t num_soa_joints = bind_pose.size();
+  for (size_t begin = 0; begin < num_soa_joints; begin += kMaxChunkSoAJoints) {
+    const size_t end = math::Min(begin + kMaxChunkSoAJoints, num_soa_joints);
+
+    // Initializes blended parameters that are exchanged across blend stages.
+    ProcessArgs process_args(*this, begin, end);
 
-  // Blends all layers to the job output buffers.
-  BlendLayers(&process_args);
+    // Blends all layers to the job output buffers.
+    BlendLayers(&process_args);
 
-  // Applies bind pose.
-  BlendBindPose(&process_args);
+    // Applies bind pose.
+    BlendBindPose(&process_args);
 
-  // Normalizes output.
-  Normalize(&process_args);
+    // Normalizes output.
+    Normalize(&process_args);
 
-  // Process additive blending.
-  AddLayers(&process_args);
+    // Process additive blending.
+    AddLayers(&process_args);
+  }
 
   return true;
 }
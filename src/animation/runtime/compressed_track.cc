@@ -0,0 +1,268 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/compressed_track.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "ozz/base/io/archive.h"
+#include "ozz/base/log.h"
+#include "ozz/base/maths/math_constant.h"
+#include "ozz/base/maths/math_ex.h"
+#include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
+
+namespace ozz {
+namespace animation {
+namespace internal {
+namespace {
+// Restores a value from its dequantized components.
+inline void Dequantize(const uint32_t* _quantized, int /*_bits*/,
+                       const float* _offsets, const float* _scales,
+                       float* _value) {
+  *_value = _offsets[0] + _quantized[0] * _scales[0];
+}
+inline void Dequantize(const uint32_t* _quantized, int /*_bits*/,
+                       const float* _offsets, const float* _scales,
+                       math::Float2* _value) {
+  *_value = math::Float2(_offsets[0] + _quantized[0] * _scales[0],
+                         _offsets[1] + _quantized[1] * _scales[1]);
+}
+inline void Dequantize(const uint32_t* _quantized, int /*_bits*/,
+                       const float* _offsets, const float* _scales,
+                       math::Float3* _value) {
+  *_value = math::Float3(_offsets[0] + _quantized[0] * _scales[0],
+                         _offsets[1] + _quantized[1] * _scales[1],
+                         _offsets[2] + _quantized[2] * _scales[2]);
+}
+inline void Dequantize(const uint32_t* _quantized, int /*_bits*/,
+                       const float* _offsets, const float* _scales,
+                       math::Float4* _value) {
+  *_value = math::Float4(_offsets[0] + _quantized[0] * _scales[0],
+                         _offsets[1] + _quantized[1] * _scales[1],
+                         _offsets[2] + _quantized[2] * _scales[2],
+                         _offsets[3] + _quantized[3] * _scales[3]);
+}
+
+// Restores the 3 smallest components of the quaternion, and the largest one
+// from normalization. Upper bit of the first two components stores the index
+// of the largest component, upper bit of the third one stores its sign.
+inline void Dequantize(const uint32_t* _quantized, int _bits,
+                       const float* /*_offsets*/, const float* /*_scales*/,
+                       math::Quaternion* _value) {
+  const int shift = _bits - 1;
+  const uint32_t mask = (1u << shift) - 1;
+  const float scale = 2.f / mask;
+  const float a = ((_quantized[0] & mask) * scale - 1.f) * math::kSqrt2_2;
+  const float b = ((_quantized[1] & mask) * scale - 1.f) * math::kSqrt2_2;
+  const float c = ((_quantized[2] & mask) * scale - 1.f) * math::kSqrt2_2;
+  const uint32_t largest =
+      (_quantized[0] >> shift) | ((_quantized[1] >> shift) << 1);
+  const float d2 = 1.f - (a * a + b * b + c * c);
+  const float d = std::sqrt(math::Max(0.f, d2)) *
+                  ((_quantized[2] >> shift) != 0 ? -1.f : 1.f);
+
+  float cpnt[4];
+  const int kMapping[4][3] = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+  const int* map = kMapping[largest];
+  cpnt[map[0]] = a;
+  cpnt[map[1]] = b;
+  cpnt[map[2]] = c;
+  cpnt[largest] = d;
+  *_value = math::Quaternion(cpnt[0], cpnt[1], cpnt[2], cpnt[3]);
+}
+}  // namespace
+
+template <typename _ValueType>
+CompressedTrack<_ValueType>::CompressedTrack()
+    : value_bits_(16), name_(nullptr) {
+  for (int i = 0; i < 4; ++i) {
+    offsets_[i] = 0.f;
+    scales_[i] = 0.f;
+  }
+}
+
+template <typename _ValueType>
+CompressedTrack<_ValueType>::~CompressedTrack() {
+  Deallocate();
+}
+
+template <typename _ValueType>
+void CompressedTrack<_ValueType>::Allocate(size_t _keys_count, int _value_bits,
+                                           size_t _name_len) {
+  assert(ratios_.size() == 0 && values_.size() == 0);
+  assert(_value_bits == 8 || _value_bits == 16);
+
+  // Compute overall size and allocate a single buffer for all the data.
+  const memory::ScopedTag tag(memory::kTrack);
+  const size_t values_size = _keys_count * kComponents * (_value_bits / 8);
+  const size_t buffer_size = _keys_count * sizeof(uint16_t) +  // ratios
+                             values_size +                     // values
+                             (_keys_count + 7) * sizeof(uint8_t) / 8 +  // steps
+                             (_name_len > 0 ? _name_len + 1 : 0);
+  span<char> buffer = {static_cast<char*>(memory::default_allocator()->Allocate(
+                           buffer_size, alignof(uint16_t))),
+                       buffer_size};
+
+  // Fix up pointers. Serves larger alignment values first. Values buffer
+  // follows 16 bits ratios, so it's properly aligned to be read as 16 bits
+  // integers.
+  ratios_ = fill_span<uint16_t>(buffer, _keys_count);
+  values_ = fill_span<uint8_t>(buffer, values_size);
+  steps_ = fill_span<uint8_t>(buffer, (_keys_count + 7) / 8);
+
+  // Let name be nullptr if track has no name.
+  name_ =
+      _name_len > 0 ? fill_span<char>(buffer, _name_len + 1).data() : nullptr;
+
+  assert(buffer.empty() && "Whole buffer should be consumned");
+
+  value_bits_ = _value_bits;
+}
+
+template <typename _ValueType>
+void CompressedTrack<_ValueType>::Deallocate() {
+  // Deallocate everything at once.
+  memory::default_allocator()->Deallocate(as_writable_bytes(ratios_).data());
+
+  ratios_ = {};
+  values_ = {};
+  steps_ = {};
+  name_ = nullptr;
+}
+
+template <typename _ValueType>
+_ValueType CompressedTrack<_ValueType>::value(size_t _key) const {
+  assert(_key < ratios_.size());
+  uint32_t quantized[kComponents];
+  const size_t first = _key * kComponents;
+  if (value_bits_ == 8) {
+    for (int i = 0; i < kComponents; ++i) {
+      quantized[i] = values_[first + i];
+    }
+  } else {
+    const uint16_t* values16 =
+        reinterpret_cast<const uint16_t*>(values_.data());
+    for (int i = 0; i < kComponents; ++i) {
+      quantized[i] = values16[first + i];
+    }
+  }
+  _ValueType value;
+  Dequantize(quantized, value_bits_, offsets_, scales_, &value);
+  return value;
+}
+
+template <typename _ValueType>
+size_t CompressedTrack<_ValueType>::size() const {
+  const size_t size = sizeof(*this) + ratios_.size_bytes() +
+                      values_.size_bytes() + steps_.size_bytes();
+  return size;
+}
+
+template <typename _ValueType>
+void CompressedTrack<_ValueType>::Save(ozz::io::OArchive& _archive) const {
+  uint32_t num_keys = static_cast<uint32_t>(ratios_.size());
+  _archive << num_keys;
+
+  _archive << static_cast<uint8_t>(value_bits_);
+
+  const size_t name_len = name_ ? std::strlen(name_) : 0;
+  _archive << static_cast<int32_t>(name_len);
+
+  _archive << ozz::io::MakeArray(offsets_);
+  _archive << ozz::io::MakeArray(scales_);
+  _archive << ozz::io::MakeArray(ratios_);
+
+  // 16 bits values are serialized as such, to handle endianness.
+  if (value_bits_ == 8) {
+    _archive << ozz::io::MakeArray(values_);
+  } else {
+    _archive << ozz::io::MakeArray(
+        reinterpret_cast<const uint16_t*>(values_.data()),
+        values_.size() / 2);
+  }
+  _archive << ozz::io::MakeArray(steps_);
+
+  _archive << ozz::io::MakeArray(name_, name_len);
+}
+
+template <typename _ValueType>
+void CompressedTrack<_ValueType>::Load(ozz::io::IArchive& _archive,
+                                       uint32_t _version) {
+  // Destroy track in case it was already used before.
+  Deallocate();
+
+  if (_version > 1) {
+    log::Err() << "Unsupported CompressedTrack version " << _version << "."
+               << std::endl;
+    return;
+  }
+
+  uint32_t num_keys;
+  _archive >> num_keys;
+
+  uint8_t value_bits;
+  _archive >> value_bits;
+  if (value_bits != 8 && value_bits != 16) {
+    log::Err() << "Invalid CompressedTrack value bits " << int(value_bits)
+               << "." << std::endl;
+    return;
+  }
+
+  int32_t name_len;
+  _archive >> name_len;
+
+  Allocate(num_keys, value_bits, name_len);
+
+  _archive >> ozz::io::MakeArray(offsets_);
+  _archive >> ozz::io::MakeArray(scales_);
+  _archive >> ozz::io::MakeArray(ratios_);
+  if (value_bits_ == 8) {
+    _archive >> ozz::io::MakeArray(values_);
+  } else {
+    _archive >> ozz::io::MakeArray(reinterpret_cast<uint16_t*>(values_.data()),
+                                   values_.size() / 2);
+  }
+  _archive >> ozz::io::MakeArray(steps_);
+
+  if (name_) {  // nullptr name_ is supported.
+    _archive >> ozz::io::MakeArray(name_, name_len);
+    name_[name_len] = 0;
+  }
+}
+
+// Explicitly instantiate supported tracks.
+template class CompressedTrack<float>;
+template class CompressedTrack<math::Float2>;
+template class CompressedTrack<math::Float3>;
+template class CompressedTrack<math::Float4>;
+template class CompressedTrack<math::Quaternion>;
+
+}  // namespace internal
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,122 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/event_track.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "ozz/base/io/archive.h"
+#include "ozz/base/log.h"
+#include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
+
+namespace ozz {
+namespace animation {
+
+EventTrack::EventTrack() : name_(nullptr) {}
+
+EventTrack::~EventTrack() { Deallocate(); }
+
+void EventTrack::Allocate(size_t _events_count, size_t _name_len) {
+  assert(ratios_.size() == 0 && ids_.size() == 0);
+
+  // Compute overall size and allocate a single buffer for all the data.
+  const memory::ScopedTag tag(memory::kTrack);
+  const size_t buffer_size = _events_count * sizeof(float) +     // ratios
+                             _events_count * sizeof(uint16_t) +  // ids
+                             (_name_len > 0 ? _name_len + 1 : 0);
+  span<char> buffer = {static_cast<char*>(memory::default_allocator()->Allocate(
+                           buffer_size, alignof(float))),
+                       buffer_size};
+
+  // Fix up pointers. Serves larger alignment values first.
+  ratios_ = fill_span<float>(buffer, _events_count);
+  ids_ = fill_span<uint16_t>(buffer, _events_count);
+
+  // Let name be nullptr if track has no name.
+  name_ =
+      _name_len > 0 ? fill_span<char>(buffer, _name_len + 1).data() : nullptr;
+
+  assert(buffer.empty() && "Whole buffer should be consumned");
+}
+
+void EventTrack::Deallocate() {
+  // Deallocate everything at once.
+  memory::default_allocator()->Deallocate(as_writable_bytes(ratios_).data());
+
+  ratios_ = {};
+  ids_ = {};
+  name_ = nullptr;
+}
+
+size_t EventTrack::size() const {
+  const size_t size = sizeof(*this) + ratios_.size_bytes() + ids_.size_bytes();
+  return size;
+}
+
+void EventTrack::Save(ozz::io::OArchive& _archive) const {
+  const uint32_t num_events = static_cast<uint32_t>(ratios_.size());
+  _archive << num_events;
+
+  const size_t name_len = name_ ? std::strlen(name_) : 0;
+  _archive << static_cast<int32_t>(name_len);
+
+  _archive << ozz::io::MakeArray(ratios_);
+  _archive << ozz::io::MakeArray(ids_);
+
+  _archive << ozz::io::MakeArray(name_, name_len);
+}
+
+void EventTrack::Load(ozz::io::IArchive& _archive, uint32_t _version) {
+  // Destroy track in case it was already used before.
+  Deallocate();
+
+  if (_version != 1) {
+    log::Err() << "Unsupported EventTrack version " << _version << "."
+               << std::endl;
+    return;
+  }
+
+  uint32_t num_events;
+  _archive >> num_events;
+
+  int32_t name_len;
+  _archive >> name_len;
+
+  Allocate(num_events, name_len);
+
+  _archive >> ozz::io::MakeArray(ratios_);
+  _archive >> ozz::io::MakeArray(ids_);
+
+  if (name_) {  // nullptr name_ is supported.
+    _archive >> ozz::io::MakeArray(name_, name_len);
+    name_[name_len] = 0;
+  }
+}
+}  // namespace animation
+}  // namespace ozz
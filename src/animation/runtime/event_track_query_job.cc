@@ -0,0 +1,151 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/event_track_query_job.h"
+
+#include <cassert>
+#include <cmath>
+
+#include "ozz/animation/runtime/event_track.h"
+
+namespace ozz {
+namespace animation {
+
+EventTrackQueryJob::EventTrackQueryJob()
+    : from(0.f), to(0.f), track(nullptr), iterator(nullptr) {}
+
+bool EventTrackQueryJob::Validate() const {
+  bool valid = true;
+  valid &= track != nullptr;
+  valid &= iterator != nullptr;
+  return valid;
+}
+
+bool EventTrackQueryJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Events can only be found in a valid range of ratio.
+  if (from == to) {
+    *iterator = end();
+    return true;
+  }
+
+  *iterator = Iterator(this);
+
+  return true;
+}
+
+namespace {
+// Finds the index of the first event after _ratio, in _outer loop space. If
+// _inclusive, events at _ratio are included.
+inline ptrdiff_t SearchEvent(const EventTrack& _track, float _outer,
+                             float _ratio, bool _inclusive) {
+  const span<const float>& ratios = _track.ratios();
+  ptrdiff_t first = 0;
+  ptrdiff_t count = ratios.size();
+  while (count > 0) {
+    const ptrdiff_t step = count / 2;
+    const float ratio = ratios[first + step] + _outer;
+    if (ratio < _ratio || (!_inclusive && ratio == _ratio)) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+}  // namespace
+
+EventTrackQueryJob::Iterator::Iterator(const EventTrackQueryJob* _job)
+    : job_(_job) {
+  // Outer loop initialization.
+  outer_ = std::floor(job_->from);
+
+  // Inner loop initialization. Forward, the first event is the first one after
+  // "from". Backward, it's the last one before "from".
+  inner_ = job_->from < job_->to
+               ? SearchEvent(*job_->track, outer_, job_->from, false)
+               : SearchEvent(*job_->track, outer_, job_->from, true) - 1;
+
+  // Evaluates first event.
+  ++*this;
+}
+
+const EventTrackQueryJob::Iterator& EventTrackQueryJob::Iterator::operator++() {
+  assert(*this != job_->end() && "Can't increment end iterator.");
+
+  const EventTrack& track = *job_->track;
+  const span<const float>& ratios = track.ratios();
+  const ptrdiff_t num_events = ratios.size();
+
+  if (job_->to > job_->from) {
+    for (; outer_ <= job_->to; outer_ += 1.f) {
+      // Events after "from" are sorted, so the next one is either in range or
+      // there's no further event.
+      if (inner_ < num_events) {
+        const float ratio = ratios[inner_] + outer_;
+        if (ratio > job_->to) {
+          break;  // Won't find any further event.
+        }
+        event_.ratio = ratio;
+        event_.id = track.ids()[inner_];
+        ++inner_;
+        return *this;  // Yield found event.
+      }
+      inner_ = 0;  // Ready for next loop.
+    }
+  } else {
+    for (; outer_ + 1.f >= job_->to; outer_ -= 1.f) {
+      for (; inner_ >= 0; --inner_) {
+        const float ratio = ratios[inner_] + outer_;
+        if (ratio < job_->to) {
+          *this = job_->end();  // Won't find any further event.
+          return *this;
+        }
+        // Events at the end of the previous loop can match "from", which is
+        // excluded.
+        if (ratio < job_->from) {
+          event_.ratio = ratio;
+          event_.id = track.ids()[inner_];
+          --inner_;
+          return *this;  // Yield found event.
+        }
+      }
+      inner_ = num_events - 1;  // Ready for next loop.
+    }
+  }
+
+  // Set iterator to end position.
+  *this = job_->end();
+
+  return *this;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,216 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/ik_aim_soa_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/ik_soa_math.h"
+
+using namespace ozz::math;
+
+namespace ozz {
+namespace animation {
+IKAimSoaJob::IKAimSoaJob()
+    : target(SoaFloat3::zero()),
+      forward(SoaFloat3::x_axis()),
+      offset(SoaFloat3::zero()),
+      up(SoaFloat3::y_axis()),
+      pole_vector(SoaFloat3::y_axis()),
+      twist_angle(simd_float4::zero()),
+      weight(simd_float4::one()),
+      joint(nullptr),
+      joint_correction(nullptr),
+      reached(nullptr) {}
+
+bool IKAimSoaJob::Validate() const {
+  bool valid = true;
+  valid &= joint != nullptr;
+  valid &= joint_correction != nullptr;
+  valid &= AreAllTrue(IsNormalizedEst(forward));
+  return valid;
+}
+
+namespace {
+
+// See IKAimJob ComputeOffsettedForward. Returns a mask of the lanes whose
+// offsetted forward vector exists.
+SimdInt4 ComputeSoaOffsettedForward(const SoaFloat3& _forward,
+                                    const SoaFloat3& _offset,
+                                    const SoaFloat3& _target,
+                                    SoaFloat3* _offsetted_forward) {
+  // AO is projected offset vector onto the normalized forward vector.
+  const SimdFloat4 AOl = Dot(_forward, _offset);
+
+  // Compute square length of ac using Pythagorean theorem.
+  const SimdFloat4 ACl2 = LengthSqr(_offset) - AOl * AOl;
+
+  // Square length of target vector, aka circle radius.
+  const SimdFloat4 r2 = LengthSqr(_target);
+
+  // If offset is outside of the sphere defined by target length, the target
+  // isn't reachable.
+  const SimdInt4 reachable = CmpLe(ACl2, r2);
+
+  // AIl is the length of the vector from offset to sphere intersection.
+  // Unreachable lanes are clamped to 0 to avoid computing sqrt of a negative
+  // value.
+  const SimdFloat4 AIl = Sqrt(Max(r2 - ACl2, simd_float4::zero()));
+
+  // The distance from offset position to the intersection with the sphere is
+  // (AIl - AOl) Intersection point on the sphere can thus be computed.
+  *_offsetted_forward = _offset + _forward * (AIl - AOl);
+
+  return reachable;
+}
+}  // namespace
+
+bool IKAimSoaJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const SimdFloat4 zero = simd_float4::zero();
+  const SimdFloat4 one = simd_float4::one();
+
+  // If matrices aren't invertible, they'll be all 0 (ozz::math
+  // implementation), which will result in identity correction quaternions.
+  SimdInt4 invertible;
+  const SoaFloat4x4 inv_joint = Invert(*joint, &invertible);
+
+  // Computes joint to target vector, in joint local-space (_js).
+  const SoaFloat3 joint_to_target_js =
+      internal::TransformPoint(inv_joint, target);
+  const SimdFloat4 joint_to_target_js_len2 = LengthSqr(joint_to_target_js);
+
+  // Recomputes forward vector to account for offset.
+  // If the offset is further than target, it won't be reachable.
+  SoaFloat3 offsetted_forward;
+  const SimdInt4 lreached = ComputeSoaOffsettedForward(
+      forward, offset, joint_to_target_js, &offsetted_forward);
+  // Copies reachability result.
+  if (reached != nullptr) {
+    *reached = lreached;
+  }
+
+  // Target can't be reached or is too close to joint position to find a
+  // direction.
+  const SimdInt4 identity =
+      Or(Not(lreached), CmpEq(joint_to_target_js_len2, zero));
+  if (AreAllTrue(identity)) {
+    *joint_correction = SoaQuaternion::identity();
+    return true;
+  }
+
+  // Calculates joint_to_target_rot_ss quaternion which solves for
+  // offsetted_forward vector rotating onto the target.
+  const SoaQuaternion joint_to_target_rot_js =
+      internal::QuaternionFromVectors(offsetted_forward, joint_to_target_js);
+
+  // Calculates rotate_plane_js quaternion which aligns joint up to the pole
+  // vector.
+  const SoaFloat3 corrected_up_js =
+      internal::TransformVector(joint_to_target_rot_js, up);
+
+  // Compute (and normalize) reference and pole planes normals.
+  const SoaFloat3 pole_vector_js =
+      internal::TransformVector(inv_joint, pole_vector);
+  const SoaFloat3 ref_joint_normal_js =
+      Cross(pole_vector_js, joint_to_target_js);
+  const SoaFloat3 joint_normal_js = Cross(corrected_up_js, joint_to_target_js);
+  const SimdFloat4 ref_joint_normal_js_len2 = LengthSqr(ref_joint_normal_js);
+  const SimdFloat4 joint_normal_js_len2 = LengthSqr(joint_normal_js);
+
+  // Computes rotation axis, which is either joint_to_target_js or
+  // -joint_to_target_js depending on rotation direction.
+  const SoaFloat3 rotate_plane_axis_js =
+      joint_to_target_js * RSqrtEstNR(joint_to_target_js_len2);
+
+  // Computing rotation plane requires valid normals.
+  const SimdInt4 valid_plane =
+      And(And(CmpNe(joint_to_target_js_len2, zero),
+              CmpNe(joint_normal_js_len2, zero)),
+          CmpNe(ref_joint_normal_js_len2, zero));
+
+  // Computes angle cosine between the 2 normalized plane normals.
+  const SimdFloat4 rotate_plane_cos_angle =
+      Dot(joint_normal_js * RSqrtEstNR(joint_normal_js_len2),
+          ref_joint_normal_js * RSqrtEstNR(ref_joint_normal_js_len2));
+  const SoaFloat3 rotate_plane_axis_flipped_js = internal::XorSign(
+      rotate_plane_axis_js, Dot(ref_joint_normal_js, corrected_up_js));
+
+  // Builds quaternion along rotation axis.
+  const SoaQuaternion rotate_plane_js = internal::Select(
+      valid_plane,
+      internal::QuaternionFromAxisCosAngle(
+          rotate_plane_axis_flipped_js,
+          Clamp(-one, rotate_plane_cos_angle, one)),
+      SoaQuaternion::identity());
+
+  // Twists rotation plane.
+  SoaQuaternion twisted;
+  if (!AreAllTrue(CmpEq(twist_angle, zero))) {
+    // If a twist angle is provided, rotation angle is rotated around joint to
+    // target vector.
+    const SoaQuaternion twist_ss =
+        internal::QuaternionFromAxisAngle(rotate_plane_axis_js, twist_angle);
+    twisted = twist_ss * rotate_plane_js * joint_to_target_rot_js;
+  } else {
+    twisted = rotate_plane_js * joint_to_target_rot_js;
+  }
+
+  // Weights output quaternion.
+
+  // Fix up quaternions so w is always positive, which is required for NLerp
+  // (with identity quaternion) to lerp the shortest path.
+  const SoaQuaternion twisted_fu = internal::PositiveW(twisted);
+
+  SoaQuaternion correction;
+  const SimdInt4 partial = CmpLt(weight, one);
+  if (!AreAllFalse(partial)) {
+    // NLerp joint rotations. Like IKAimJob, lerps the quaternion before its w
+    // is fixed up.
+    const SoaQuaternion lerp =
+        NLerpEst(SoaQuaternion::identity(), twisted, Max(zero, weight));
+    correction = internal::Select(partial, lerp, twisted_fu);
+  } else {
+    // Quaternion doesn't need interpolation
+    correction = twisted_fu;
+  }
+
+  *joint_correction =
+      internal::Select(identity, SoaQuaternion::identity(), correction);
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
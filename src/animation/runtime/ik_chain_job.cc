@@ -0,0 +1,217 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/ik_chain_job.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_float.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/ik_soa_math.h"
+
+using namespace ozz::math;
+
+namespace ozz {
+namespace animation {
+IKChainJob::IKChainJob()
+    : target(simd_float4::zero()),
+      max_iterations(16),
+      tolerance(1e-3f),
+      weight(1.f),
+      reached(nullptr),
+      iterations(nullptr) {}
+
+bool IKChainJob::Validate() const {
+  bool valid = true;
+  valid &= joints.size() >= 2 && joints.size() <= kMaxJoints;
+  valid &= corrections.size() + 1 >= joints.size();
+  valid &= max_iterations >= 0;
+  valid &= tolerance >= 0.f;
+
+  // Joints must be valid and sorted.
+  int previous = -1;
+  for (const int joint : joints) {
+    valid &= joint > previous && static_cast<size_t>(joint) < models.size();
+    previous = joint;
+  }
+  return valid;
+}
+
+namespace {
+
+// Extracts the AoS position of _lane from SoA positions _soa.
+SimdFloat4 ExtractLane(const SoaFloat3& _soa, int _lane) {
+  const SimdFloat4 in[4] = {_soa.x, _soa.y, _soa.z, simd_float4::zero()};
+  SimdFloat4 out[4];
+  Transpose4x4(in, out);
+  return out[_lane];
+}
+
+// Rotates, around _pivot and by _rotation, positions of the joints whose index
+// is greater than _joint. Accumulated rotations of the joints whose index is
+// greater or equal to _joint are updated too.
+void RotateDescendants(int _joint, _SimdFloat4 _pivot,
+                       const SimdQuaternion& _rotation, int _num_soa,
+                       SoaFloat3* _positions, SoaQuaternion* _rotations) {
+  const SoaFloat3 pivot = {SplatX(_pivot), SplatY(_pivot), SplatZ(_pivot)};
+  const SimdFloat4 q = _rotation.xyzw;
+  const SoaQuaternion rotation = {SplatX(q), SplatY(q), SplatZ(q), SplatW(q)};
+
+  // Only the first group has joints that aren't updated.
+  const int first = _joint / 4;
+  const SimdInt4 lanes =
+      simd_int4::Load(first * 4, first * 4 + 1, first * 4 + 2, first * 4 + 3);
+  const SimdInt4 joint = simd_int4::Load1(_joint);
+  const SimdInt4 rotate_position = CmpGt(lanes, joint);
+  const SimdInt4 rotate_rotation = CmpGe(lanes, joint);
+
+  SoaFloat3& positions = _positions[first];
+  positions = internal::Select(
+      rotate_position,
+      pivot + internal::TransformVector(rotation, positions - pivot),
+      positions);
+  SoaQuaternion& rotations = _rotations[first];
+  rotations = internal::Select(rotate_rotation, rotation * rotations,
+                               rotations);
+
+  for (int i = first + 1; i < _num_soa; ++i) {
+    _positions[i] =
+        pivot + internal::TransformVector(rotation, _positions[i] - pivot);
+    _rotations[i] = rotation * _rotations[i];
+  }
+}
+}  // namespace
+
+bool IKChainJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  const int num_joints = static_cast<int>(joints.size());
+  const int num_soa = (num_joints + 3) / 4;
+  const int end_joint = num_joints - 1;
+
+  // Loads chain joints positions as SoA. Last group is padded with the end
+  // joint, which is never used as a pivot.
+  SoaFloat3 positions[kMaxJoints / 4];
+  SoaQuaternion rotations[kMaxJoints / 4];
+  for (int i = 0; i < num_soa; ++i) {
+    SimdFloat4 aos[4];
+    for (int j = 0; j < 4; ++j) {
+      const int joint = joints[std::min(i * 4 + j, end_joint)];
+      aos[j] = models[joint].cols[3];
+    }
+    SimdFloat4 soa[4];
+    Transpose4x4(aos, soa);
+    positions[i] = SoaFloat3::Load(soa[0], soa[1], soa[2]);
+    rotations[i] = SoaQuaternion::identity();
+  }
+
+  // Iterates until target is reached, the end of the chain stops moving, or
+  // iterations count limit is hit.
+  const SimdFloat4 tolerance2 = simd_float4::Load1(tolerance * tolerance);
+  const SimdFloat4 stall2 = tolerance2 * simd_float4::Load1(1e-4f);
+  SimdFloat4 end = models[joints[end_joint]].cols[3];
+  bool lreached = AreAllTrue1(CmpLe(Length3Sqr(target - end), tolerance2));
+  int iteration = 0;
+  while (!lreached && iteration < max_iterations) {
+    ++iteration;
+    const SimdFloat4 previous_end = end;
+    for (int i = end_joint - 1; i >= 0; --i) {
+      const SimdFloat4 pivot = ExtractLane(positions[i / 4], i & 3);
+      const SimdFloat4 pivot_to_end = end - pivot;
+      const SimdQuaternion rotation =
+          SimdQuaternion::FromVectors(pivot_to_end, target - pivot);
+      end = pivot + TransformVector(rotation, pivot_to_end);
+      RotateDescendants(i, pivot, rotation, num_soa, positions, rotations);
+    }
+    lreached = AreAllTrue1(CmpLe(Length3Sqr(target - end), tolerance2));
+    if (AreAllTrue1(CmpLe(Length3Sqr(end - previous_end), stall2))) {
+      break;
+    }
+  }
+
+  if (reached) {
+    *reached = lreached && weight >= 1.f;
+  }
+  if (iterations) {
+    *iterations = iteration;
+  }
+
+  // Converts accumulated model-space rotations to local-space corrections.
+  // Joint model-space rotation delta is its accumulated rotation, minus its
+  // parent one. It's then expressed in joint local-space, which for a uniform
+  // scale is done by transforming quaternion axis with the transposed joint
+  // matrix, preserving its length.
+  const SimdFloat4 identity = simd_float4::w_axis();
+  const SimdFloat4 simd_weight = Max0(simd_float4::Load1(weight));
+  SimdQuaternion parent = SimdQuaternion::identity();
+  for (int i = 0; i < num_soa; ++i) {
+    const SimdFloat4 soa[4] = {rotations[i].x, rotations[i].y, rotations[i].z,
+                               rotations[i].w};
+    SimdQuaternion aos[4];
+    Transpose4x4(soa, &aos->xyzw);
+    for (int j = 0; j < 4 && i * 4 + j < end_joint; ++j) {
+      const SimdQuaternion delta = Conjugate(parent) * aos[j];
+      parent = aos[j];
+
+      const int joint = joints[i * 4 + j];
+      const SimdFloat4 axis_js =
+          TransformVector(Transpose(models[joint]), delta.xyzw);
+      const SimdFloat4 xyz =
+          NormalizeSafe3(axis_js, simd_float4::zero()) *
+          SplatX(Length3(delta.xyzw));
+      const SimdQuaternion correction = {SetW(xyz, SplatW(delta.xyzw))};
+
+      // Fix up quaternions so w is always positive, which is required for
+      // NLerp (with identity quaternion) to lerp the shortest path.
+      const SimdFloat4 correction_fu =
+          Xor(correction.xyzw,
+              And(simd_int4::mask_sign(),
+                  CmpLt(SplatW(correction.xyzw), simd_float4::zero())));
+
+      IKCorrectionJob::Correction& output = corrections[i * 4 + j];
+      output.joint = joint;
+      if (weight < 1.f) {
+        // Accurate normalization, as errors would accumulate along the chain.
+        output.rotation.xyzw =
+            Normalize4(Lerp(identity, correction_fu, simd_weight));
+      } else {
+        output.rotation.xyzw = correction_fu;
+      }
+    }
+  }
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,157 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/ik_correction_job.h"
+
+#include <cassert>
+
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_transform.h"
+
+namespace ozz {
+namespace animation {
+
+IKCorrectionJob::IKCorrectionJob() : skeleton(nullptr) {}
+
+bool IKCorrectionJob::Validate() const {
+  if (!skeleton) {
+    return false;
+  }
+
+  const int num_joints = skeleton->num_joints();
+  const size_t num_soa_joints = (static_cast<size_t>(num_joints) + 3) / 4;
+
+  bool valid = true;
+  valid &= models.size() >= static_cast<size_t>(num_joints);
+  valid &= locals.empty() || locals.size() >= num_soa_joints;
+  valid &= corrections.size() <= kMaxCorrections;
+
+  // Joints must be valid and sorted.
+  int previous = Skeleton::kNoParent;
+  for (const Correction& correction : corrections) {
+    valid &= correction.joint > previous && correction.joint < num_joints;
+    previous = correction.joint;
+  }
+  return valid;
+}
+
+namespace {
+// Multiplies the local-space rotation of joint _index with _quat.
+void MultiplyLocalRotation(int _index, const math::SimdQuaternion& _quat,
+                           math::SoaTransform* _locals) {
+  math::SoaTransform& soa_transform = _locals[_index / 4];
+  math::SimdQuaternion aos_quats[4];
+  math::Transpose4x4(&soa_transform.rotation.x, &aos_quats->xyzw);
+  math::SimdQuaternion& aos_quat = aos_quats[_index & 3];
+  aos_quat = aos_quat * _quat;
+  math::Transpose4x4(&aos_quats->xyzw, &soa_transform.rotation.x);
+}
+}  // namespace
+
+bool IKCorrectionJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  if (corrections.empty()) {
+    return true;
+  }
+
+  const span<const int32_t>& parents = skeleton->joint_parents();
+  const int num_joints = skeleton->num_joints();
+
+  // Stack of the model-space deltas of the corrected joints being traversed,
+  // innermost last. Descendants of a corrected joint are transformed by the
+  // delta of their closest corrected ancestor.
+  math::Float4x4 deltas[kMaxCorrections];
+  int roots[kMaxCorrections];
+  int depth = 0;
+
+  const Correction* correction = corrections.begin();
+  const Correction* const end = corrections.end();
+  for (int i = correction->joint; i < num_joints;) {
+    // Pops corrected joints whose hierarchy was exited. Indices of a joint
+    // hierarchy are contiguous, and all greater than the joint index.
+    const int parent = parents[i];
+    while (depth && parent < roots[depth - 1]) {
+      --depth;
+    }
+
+    if (correction != end && correction->joint == i) {
+      math::Float4x4& model = models[i];
+      const math::Float4x4 original = model;
+      if (depth) {
+        model = deltas[depth - 1] * original;
+      }
+
+      // Corrects model-space matrix.
+      model = model * math::Float4x4::FromQuaternion(correction->rotation.xyzw);
+
+      // Computes the delta that transforms its descendants original matrices
+      // to corrected ones. This isn't needed if joint has no child, which is
+      // the first joint following it in depth-first order. A non invertible
+      // matrix (IK jobs output identity corrections for these) keeps its parent
+      // delta.
+      if (i + 1 < num_joints && parents[i + 1] == i) {
+        math::SimdInt4 invertible;
+        const math::Float4x4 inv_original = Invert(original, &invertible);
+        if (math::AreAllTrue1(invertible)) {
+          deltas[depth] = model * inv_original;
+        } else {
+          deltas[depth] =
+              depth ? deltas[depth - 1] : math::Float4x4::identity();
+        }
+        roots[depth] = i;
+        ++depth;
+      }
+
+      if (!locals.empty()) {
+        MultiplyLocalRotation(i, correction->rotation, locals.begin());
+      }
+      ++correction;
+      ++i;
+    } else if (depth) {
+      // Updates the joints of the innermost corrected hierarchy, up to the next
+      // corrected joint.
+      const math::Float4x4 delta = deltas[depth - 1];
+      const int root = roots[depth - 1];
+      const int next = correction != end ? correction->joint : num_joints;
+      for (; i < next && parents[i] >= root; ++i) {
+        models[i] = delta * models[i];
+      }
+    } else if (correction != end) {
+      // Outside of any corrected hierarchy, jumps to the next corrected joint.
+      i = correction->joint;
+    } else {
+      break;
+    }
+  }
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,187 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef OZZ_ANIMATION_RUNTIME_IK_SOA_MATH_H_
+#define OZZ_ANIMATION_RUNTIME_IK_SOA_MATH_H_
+
+#include "ozz/base/platform.h"
+#ifndef OZZ_INCLUDE_PRIVATE_HEADER
+#error "This header is private, it cannot be included from public headers."
+#endif  // OZZ_INCLUDE_PRIVATE_HEADER
+
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_float.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+namespace ozz {
+namespace animation {
+namespace internal {
+
+// Defines SoA math functions used by SoA IK jobs. They're the SoA counterparts
+// of SimdFloat4 / SimdQuaternion functions used by single chain IK jobs, and
+// follow the same semantic, so that both jobs output the same results.
+
+// Transforms point _v with matrix _m, w is considered to be 1.
+OZZ_INLINE math::SoaFloat3 TransformPoint(const math::SoaFloat4x4& _m,
+                                          const math::SoaFloat3& _v) {
+  const math::SoaFloat3 r = {
+      _m.cols[0].x * _v.x + _m.cols[1].x * _v.y + _m.cols[2].x * _v.z +
+          _m.cols[3].x,
+      _m.cols[0].y * _v.x + _m.cols[1].y * _v.y + _m.cols[2].y * _v.z +
+          _m.cols[3].y,
+      _m.cols[0].z * _v.x + _m.cols[1].z * _v.y + _m.cols[2].z * _v.z +
+          _m.cols[3].z};
+  return r;
+}
+
+// Transforms vector _v with matrix _m, w is considered to be 0.
+OZZ_INLINE math::SoaFloat3 TransformVector(const math::SoaFloat4x4& _m,
+                                           const math::SoaFloat3& _v) {
+  const math::SoaFloat3 r = {
+      _m.cols[0].x * _v.x + _m.cols[1].x * _v.y + _m.cols[2].x * _v.z,
+      _m.cols[0].y * _v.x + _m.cols[1].y * _v.y + _m.cols[2].y * _v.z,
+      _m.cols[0].z * _v.x + _m.cols[1].z * _v.y + _m.cols[2].z * _v.z};
+  return r;
+}
+
+// Rotates vector _v with quaternion _q.
+OZZ_INLINE math::SoaFloat3 TransformVector(const math::SoaQuaternion& _q,
+                                           const math::SoaFloat3& _v) {
+  // _v + 2.f * cross(_q.xyz, cross(_q.xyz, _v) + _q.w * _v)
+  const math::SoaFloat3 q = {_q.x, _q.y, _q.z};
+  const math::SoaFloat3 cross1 = Cross(q, _v) + _v * _q.w;
+  const math::SoaFloat3 cross2 = Cross(q, cross1);
+  return _v + cross2 + cross2;
+}
+
+// Returns the position part of matrix _m.
+OZZ_INLINE math::SoaFloat3 Translation(const math::SoaFloat4x4& _m) {
+  const math::SoaFloat3 r = {_m.cols[3].x, _m.cols[3].y, _m.cols[3].z};
+  return r;
+}
+
+// Selects _true or _false vectors components, according to _b.
+OZZ_INLINE math::SoaFloat3 Select(math::_SimdInt4 _b,
+                                  const math::SoaFloat3& _true,
+                                  const math::SoaFloat3& _false) {
+  const math::SoaFloat3 r = {math::Select(_b, _true.x, _false.x),
+                             math::Select(_b, _true.y, _false.y),
+                             math::Select(_b, _true.z, _false.z)};
+  return r;
+}
+
+OZZ_INLINE math::SoaQuaternion Select(math::_SimdInt4 _b,
+                                      const math::SoaQuaternion& _true,
+                                      const math::SoaQuaternion& _false) {
+  const math::SoaQuaternion r = {math::Select(_b, _true.x, _false.x),
+                                 math::Select(_b, _true.y, _false.y),
+                                 math::Select(_b, _true.z, _false.z),
+                                 math::Select(_b, _true.w, _false.w)};
+  return r;
+}
+
+// Flips the sign of _v components whose _sign is negative.
+OZZ_INLINE math::SoaFloat3 XorSign(const math::SoaFloat3& _v,
+                                   math::_SimdFloat4 _sign) {
+  const math::SimdFloat4 flip =
+      math::And(_sign, math::simd_int4::mask_sign());
+  const math::SoaFloat3 r = {math::Xor(_v.x, flip), math::Xor(_v.y, flip),
+                             math::Xor(_v.z, flip)};
+  return r;
+}
+
+// Fixes up quaternions so w is always positive.
+OZZ_INLINE math::SoaQuaternion PositiveW(const math::SoaQuaternion& _q) {
+  const math::SimdInt4 flip =
+      math::And(math::simd_int4::mask_sign(),
+                math::CmpLt(_q.w, math::simd_float4::zero()));
+  const math::SoaQuaternion r = {math::Xor(_q.x, flip), math::Xor(_q.y, flip),
+                                 math::Xor(_q.z, flip), math::Xor(_q.w, flip)};
+  return r;
+}
+
+// See SimdQuaternion::FromAxisAngle.
+OZZ_INLINE math::SoaQuaternion QuaternionFromAxisAngle(
+    const math::SoaFloat3& _axis, math::_SimdFloat4 _angle) {
+  const math::SimdFloat4 half_angle = _angle * math::simd_float4::Load1(.5f);
+  math::SimdFloat4 half_sin, half_cos;
+  math::SinCos(half_angle, &half_sin, &half_cos);
+  const math::SoaQuaternion r = {_axis.x * half_sin, _axis.y * half_sin,
+                                 _axis.z * half_sin, half_cos};
+  return r;
+}
+
+// See SimdQuaternion::FromAxisCosAngle.
+OZZ_INLINE math::SoaQuaternion QuaternionFromAxisCosAngle(
+    const math::SoaFloat3& _axis, math::_SimdFloat4 _cos) {
+  const math::SimdFloat4 one = math::simd_float4::one();
+  const math::SimdFloat4 half_cos2 =
+      (one + _cos) * math::simd_float4::Load1(.5f);
+  const math::SimdFloat4 half_sin = math::Sqrt(one - half_cos2);
+  const math::SoaQuaternion r = {_axis.x * half_sin, _axis.y * half_sin,
+                                 _axis.z * half_sin, math::Sqrt(half_cos2)};
+  return r;
+}
+
+// See SimdQuaternion::FromVectors.
+OZZ_INLINE math::SoaQuaternion QuaternionFromVectors(
+    const math::SoaFloat3& _from, const math::SoaFloat3& _to) {
+  const math::SimdFloat4 zero = math::simd_float4::zero();
+  const math::SimdFloat4 epsilon = math::simd_float4::Load1(1.e-6f);
+
+  const math::SimdFloat4 norm_from_norm_to =
+      math::Sqrt(LengthSqr(_from) * LengthSqr(_to));
+  const math::SimdFloat4 real_part = norm_from_norm_to + Dot(_from, _to);
+
+  // If _from and _to are exactly opposite, rotate 180 degrees around an
+  // arbitrary orthogonal axis.
+  const math::SimdInt4 opposite =
+      math::CmpLt(real_part, epsilon * norm_from_norm_to);
+  const math::SimdInt4 x_major =
+      math::CmpGt(math::Abs(_from.x), math::Abs(_from.z));
+  const math::SoaFloat3 ortho = {
+      math::Select(x_major, -_from.y, zero),
+      math::Select(x_major, _from.x, -_from.z),
+      math::Select(x_major, zero, _from.y)};
+
+  // This is the general code path.
+  const math::SoaFloat3 cross = Cross(_from, _to);
+  const math::SoaQuaternion quat = {
+      math::Select(opposite, ortho.x, cross.x),
+      math::Select(opposite, ortho.y, cross.y),
+      math::Select(opposite, ortho.z, cross.z),
+      math::Select(opposite, zero, real_part)};
+
+  // Null vectors result in identity quaternion.
+  const math::SimdInt4 null = math::CmpLt(norm_from_norm_to, epsilon);
+  return Select(null, math::SoaQuaternion::identity(), Normalize(quat));
+}
+}  // namespace internal
+}  // namespace animation
+}  // namespace ozz
+#endif  // OZZ_ANIMATION_RUNTIME_IK_SOA_MATH_H_
@@ -213,8 +213,8 @@ SimdQuaternion ComputeMidJoint(const IKTwoBoneJob& _job,
   const SimdFloat4 mid_cos_angles =
       Clamp(_setup.m_one, mid_cos_angles_unclamped, _setup.one);
 
-  // Computes corrected angle
-  const SimdFloat4 mid_corrected_angle = ACosX(mid_cos_angles);
+  // Computes corrected (x) and initial (y) angles at once.
+  const SimdFloat4 mid_angles = ACos(mid_cos_angles);
 
   // Computes initial angle.
   // The sign of this angle needs to be decided. It's considered negative if
@@ -224,10 +224,10 @@ SimdQuaternion ComputeMidJoint(const IKTwoBoneJob& _job,
   const SimdInt4 bent_side_flip = SplatX(
       CmpLt(Dot3(bent_side_ref, _setup.mid_end_ms), simd_float4::zero()));
   const SimdFloat4 mid_initial_angle =
-      Xor(ACosX(SplatY(mid_cos_angles)), And(bent_side_flip, _setup.mask_sign));
+      Xor(SplatY(mid_angles), And(bent_side_flip, _setup.mask_sign));
 
   // Finally deduces initial to corrected angle difference.
-  const SimdFloat4 mid_angles_diff = mid_corrected_angle - mid_initial_angle;
+  const SimdFloat4 mid_angles_diff = mid_angles - mid_initial_angle;
 
   // Builds queternion.
   return SimdQuaternion::FromAxisAngle(_job.mid_axis, mid_angles_diff);
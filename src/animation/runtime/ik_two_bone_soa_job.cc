@@ -0,0 +1,367 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/ik_two_bone_soa_job.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+// Internal include file
+#define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
+#include "animation/runtime/ik_soa_math.h"
+
+using namespace ozz::math;
+
+namespace ozz {
+namespace animation {
+IKTwoBoneSoaJob::IKTwoBoneSoaJob()
+    : target(SoaFloat3::zero()),
+      mid_axis(SoaFloat3::z_axis()),
+      pole_vector(SoaFloat3::y_axis()),
+      twist_angle(simd_float4::zero()),
+      soften(simd_float4::one()),
+      weight(simd_float4::one()),
+      start_joint(nullptr),
+      mid_joint(nullptr),
+      end_joint(nullptr),
+      start_joint_correction(nullptr),
+      mid_joint_correction(nullptr),
+      reached(nullptr) {}
+
+bool IKTwoBoneSoaJob::Validate() const {
+  bool valid = true;
+  valid &= start_joint && mid_joint && end_joint;
+  valid &= start_joint_correction && mid_joint_correction;
+  valid &= AreAllTrue(IsNormalizedEst(mid_axis));
+  return valid;
+}
+
+namespace {
+
+// Local data structure used to share constant data accross ik stages.
+struct IKSoaConstantSetup {
+  IKSoaConstantSetup(const IKTwoBoneSoaJob& _job) {
+    // Computes inverse matrices required to change to start and mid spaces.
+    // If matrices aren't invertible, they'll be all 0, which will result in
+    // identity correction quaternions.
+    SimdInt4 invertible;
+    inv_start_joint = Invert(*_job.start_joint, &invertible);
+    const SoaFloat4x4 inv_mid_joint = Invert(*_job.mid_joint, &invertible);
+
+    // Transform some positions to mid joint space (_ms)
+    const SoaFloat3 start_ms = internal::TransformPoint(
+        inv_mid_joint, internal::Translation(*_job.start_joint));
+    const SoaFloat3 end_ms = internal::TransformPoint(
+        inv_mid_joint, internal::Translation(*_job.end_joint));
+
+    // Transform some positions to start joint space (_ss)
+    const SoaFloat3 mid_ss = internal::TransformPoint(
+        inv_start_joint, internal::Translation(*_job.mid_joint));
+    const SoaFloat3 end_ss = internal::TransformPoint(
+        inv_start_joint, internal::Translation(*_job.end_joint));
+
+    // Computes bones vectors and length in mid and start spaces.
+    start_mid_ms = -start_ms;
+    mid_end_ms = end_ms;
+    start_mid_ss = mid_ss;
+    const SoaFloat3 mid_end_ss = end_ss - mid_ss;
+    const SoaFloat3 start_end_ss = end_ss;
+    start_mid_ss_len2 = LengthSqr(start_mid_ss);
+    mid_end_ss_len2 = LengthSqr(mid_end_ss);
+    start_end_ss_len2 = LengthSqr(start_end_ss);
+  }
+
+  // Inverse matrices
+  SoaFloat4x4 inv_start_joint;
+
+  // Bones vectors and length in mid and start spaces (_ms and _ss).
+  SoaFloat3 start_mid_ms;
+  SoaFloat3 mid_end_ms;
+  SoaFloat3 start_mid_ss;
+  SimdFloat4 start_mid_ss_len2;
+  SimdFloat4 mid_end_ss_len2;
+  SimdFloat4 start_end_ss_len2;
+};
+
+// Smoothen target positions, see IKTwoBoneJob SoftenTarget.
+SimdInt4 SoftenSoaTarget(const IKTwoBoneSoaJob& _job,
+                         const IKSoaConstantSetup& _setup,
+                         SoaFloat3* _start_target_ss,
+                         SimdFloat4* _start_target_ss_len2) {
+  const SimdFloat4 zero = simd_float4::zero();
+  const SimdFloat4 one = simd_float4::one();
+
+  // Handles position in start joint space (_ss)
+  const SoaFloat3 start_target_original_ss =
+      internal::TransformPoint(_setup.inv_start_joint, _job.target);
+  const SimdFloat4 start_target_original_ss_len2 =
+      LengthSqr(start_target_original_ss);
+  const SimdFloat4 start_mid_ss_len = Sqrt(_setup.start_mid_ss_len2);
+  const SimdFloat4 mid_end_ss_len = Sqrt(_setup.mid_end_ss_len2);
+  const SimdFloat4 start_target_original_ss_len =
+      Sqrt(start_target_original_ss_len2);
+  const SimdFloat4 bone_len_diff_abs = Abs(start_mid_ss_len - mid_end_ss_len);
+  const SimdFloat4 bones_chain_len = start_mid_ss_len + mid_end_ss_len;
+  const SimdFloat4 da = bones_chain_len * Clamp(zero, _job.soften, one);
+  const SimdFloat4 ds = bones_chain_len - da;
+
+  // Softens target positions if they are further than a ratio (_soften) of
+  // the whole bone chain length. ds and start_target_original_ss_len need to
+  // be != 0, because they're used as a denominator.
+  const SimdInt4 further = CmpGt(start_target_original_ss_len, da);
+  const SimdInt4 soften =
+      And(And(further, CmpGt(start_target_original_ss_len, zero)),
+          CmpGt(ds, zero));
+  if (!AreAllFalse(soften)) {
+    // Finds interpolation ratio (aka alpha).
+    const SimdFloat4 alpha = (start_target_original_ss_len - da) * RcpEst(ds);
+    // Approximate an exponential function with : 1-(3^4)/(alpha+3)^4
+    const SimdFloat4 op = alpha + simd_float4::Load1(3.f);
+    const SimdFloat4 op2 = op * op;
+    const SimdFloat4 op4 = op2 * op2;
+    const SimdFloat4 ratio = simd_float4::Load1(81.f) * RcpEst(op4);
+
+    // Recomputes start_target_ss vector and length.
+    const SimdFloat4 start_target_ss_len = da + ds - ds * ratio;
+    *_start_target_ss_len2 =
+        Select(soften, start_target_ss_len * start_target_ss_len,
+               start_target_original_ss_len2);
+    *_start_target_ss = internal::Select(
+        soften,
+        start_target_original_ss *
+            (start_target_ss_len * RcpEst(start_target_original_ss_len)),
+        start_target_original_ss);
+  } else {
+    *_start_target_ss = start_target_original_ss;
+    *_start_target_ss_len2 = start_target_original_ss_len2;
+  }
+
+  // The maximum distance we can reach is the soften bone chain length: da.
+  // The minimum distance we can reach is the absolute value of the difference
+  // of the 2 bone lengths, |d1−d2|.
+  return AndNot(CmpGt(start_target_original_ss_len, bone_len_diff_abs),
+                further);
+}
+
+SoaQuaternion ComputeSoaMidJoint(const IKTwoBoneSoaJob& _job,
+                                 const IKSoaConstantSetup& _setup,
+                                 _SimdFloat4 _start_target_ss_len2) {
+  const SimdFloat4 one = simd_float4::one();
+  const SimdFloat4 m_one = -one;
+
+  // Computes expected angle at mid_ss joint, using law of cosine (generalized
+  // Pythagorean), for both corrected and initial mid joint angles.
+  const SimdFloat4 start_mid_end_sum_ss_len2 =
+      _setup.start_mid_ss_len2 + _setup.mid_end_ss_len2;
+  const SimdFloat4 start_mid_end_ss_half_rlen =
+      simd_float4::Load1(.5f) *
+      RSqrtEstNR(_setup.start_mid_ss_len2 * _setup.mid_end_ss_len2);
+  const SimdFloat4 mid_corrected_cos_angle =
+      Clamp(m_one,
+            (start_mid_end_sum_ss_len2 - _start_target_ss_len2) *
+                start_mid_end_ss_half_rlen,
+            one);
+  const SimdFloat4 mid_initial_cos_angle =
+      Clamp(m_one,
+            (start_mid_end_sum_ss_len2 - _setup.start_end_ss_len2) *
+                start_mid_end_ss_half_rlen,
+            one);
+
+  // Computes corrected angle
+  const SimdFloat4 mid_corrected_angle = ACos(mid_corrected_cos_angle);
+
+  // Computes initial angle, negative if mid-to-end joint is bent backward.
+  const SoaFloat3 bent_side_ref = Cross(_setup.start_mid_ms, _job.mid_axis);
+  const SimdInt4 bent_side_flip =
+      CmpLt(Dot(bent_side_ref, _setup.mid_end_ms), simd_float4::zero());
+  const SimdFloat4 mid_initial_angle =
+      Xor(ACos(mid_initial_cos_angle),
+          And(bent_side_flip, simd_int4::mask_sign()));
+
+  // Finally deduces initial to corrected angle difference.
+  const SimdFloat4 mid_angles_diff = mid_corrected_angle - mid_initial_angle;
+
+  // Builds quaternion.
+  return internal::QuaternionFromAxisAngle(_job.mid_axis, mid_angles_diff);
+}
+
+SoaQuaternion ComputeSoaStartJoint(const IKTwoBoneSoaJob& _job,
+                                   const IKSoaConstantSetup& _setup,
+                                   const SoaQuaternion& _mid_rot_ms,
+                                   const SoaFloat3& _start_target_ss,
+                                   _SimdFloat4 _start_target_ss_len2) {
+  const SimdFloat4 one = simd_float4::one();
+
+  // Pole vector in start joint space (_ss)
+  const SoaFloat3 pole_ss =
+      internal::TransformVector(_setup.inv_start_joint, _job.pole_vector);
+
+  // start_mid_ss with quaternion mid_rot_ms applied.
+  const SoaFloat3 mid_end_ss_final = internal::TransformVector(
+      _setup.inv_start_joint,
+      internal::TransformVector(
+          *_job.mid_joint,
+          internal::TransformVector(_mid_rot_ms, _setup.mid_end_ms)));
+  const SoaFloat3 start_end_ss_final = _setup.start_mid_ss + mid_end_ss_final;
+
+  // Quaternion for rotating the effector onto the target
+  const SoaQuaternion end_to_target_rot_ss =
+      internal::QuaternionFromVectors(start_end_ss_final, _start_target_ss);
+
+  // Calculates rotate_plane_ss quaternion which aligns joint chain plane to
+  // the reference plane (pole vector). This can only be computed if start
+  // target axis is valid (not 0 length).
+  const SimdInt4 valid = CmpGt(_start_target_ss_len2, simd_float4::zero());
+  if (AreAllFalse(valid)) {
+    return end_to_target_rot_ss;
+  }
+
+  // Computes each plane normal.
+  const SoaFloat3 ref_plane_normal_ss = Cross(_start_target_ss, pole_ss);
+  const SimdFloat4 ref_plane_normal_ss_len2 = LengthSqr(ref_plane_normal_ss);
+  // Computes joint chain plane normal, which is the same as mid joint axis
+  // (same triangle).
+  const SoaFloat3 mid_axis_ss = internal::TransformVector(
+      _setup.inv_start_joint,
+      internal::TransformVector(*_job.mid_joint, _job.mid_axis));
+  const SoaFloat3 joint_plane_normal_ss =
+      internal::TransformVector(end_to_target_rot_ss, mid_axis_ss);
+  const SimdFloat4 joint_plane_normal_ss_len2 =
+      LengthSqr(joint_plane_normal_ss);
+
+  // Computes angle cosine between the 2 normalized normals.
+  const SimdFloat4 rotate_plane_cos_angle =
+      Dot(ref_plane_normal_ss * RSqrtEstNR(ref_plane_normal_ss_len2),
+          joint_plane_normal_ss * RSqrtEstNR(joint_plane_normal_ss_len2));
+
+  // Computes rotation axis, which is either start_target_ss or
+  // -start_target_ss depending on rotation direction.
+  const SoaFloat3 rotate_plane_axis_ss =
+      _start_target_ss * RSqrtEstNR(_start_target_ss_len2);
+  const SoaFloat3 rotate_plane_axis_flipped_ss = internal::XorSign(
+      rotate_plane_axis_ss, Dot(joint_plane_normal_ss, pole_ss));
+
+  // Builds quaternion along rotation axis.
+  const SoaQuaternion rotate_plane_ss = internal::QuaternionFromAxisCosAngle(
+      rotate_plane_axis_flipped_ss, Clamp(-one, rotate_plane_cos_angle, one));
+
+  SoaQuaternion start_rot_ss;
+  if (!AreAllTrue(CmpEq(_job.twist_angle, simd_float4::zero()))) {
+    // If a twist angle is provided, rotation angle is rotated along
+    // rotation plane axis.
+    const SoaQuaternion twist_ss = internal::QuaternionFromAxisAngle(
+        rotate_plane_axis_ss, _job.twist_angle);
+    start_rot_ss = twist_ss * rotate_plane_ss * end_to_target_rot_ss;
+  } else {
+    start_rot_ss = rotate_plane_ss * end_to_target_rot_ss;
+  }
+  return internal::Select(valid, start_rot_ss, end_to_target_rot_ss);
+}
+
+void WeightSoaOutput(const IKTwoBoneSoaJob& _job,
+                     const SoaQuaternion& _start_rot,
+                     const SoaQuaternion& _mid_rot) {
+  const SimdFloat4 zero = simd_float4::zero();
+  const SimdFloat4 one = simd_float4::one();
+
+  // Fix up quaternions so w is always positive, which is required for NLerp
+  // (with identity quaternion) to lerp the shortest path.
+  const SoaQuaternion start_rot_fu = internal::PositiveW(_start_rot);
+  const SoaQuaternion mid_rot_fu = internal::PositiveW(_mid_rot);
+
+  const SimdInt4 partial = CmpLt(_job.weight, one);
+  if (!AreAllFalse(partial)) {
+    // NLerp start and mid joint rotations.
+    const SoaQuaternion identity = SoaQuaternion::identity();
+    const SimdFloat4 simd_weight = Max(zero, _job.weight);
+    *_job.start_joint_correction = internal::Select(
+        partial, NLerpEst(identity, start_rot_fu, simd_weight), start_rot_fu);
+    *_job.mid_joint_correction = internal::Select(
+        partial, NLerpEst(identity, mid_rot_fu, simd_weight), mid_rot_fu);
+  } else {
+    // Quaternions don't need interpolation
+    *_job.start_joint_correction = start_rot_fu;
+    *_job.mid_joint_correction = mid_rot_fu;
+  }
+
+  // No correction for 0 weights.
+  const SimdInt4 disabled = CmpLe(_job.weight, zero);
+  *_job.start_joint_correction = internal::Select(
+      disabled, SoaQuaternion::identity(), *_job.start_joint_correction);
+  *_job.mid_joint_correction = internal::Select(
+      disabled, SoaQuaternion::identity(), *_job.mid_joint_correction);
+}
+}  // namespace
+
+bool IKTwoBoneSoaJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Early out if all weights are 0.
+  if (AreAllTrue(CmpLe(weight, simd_float4::zero()))) {
+    // No correction.
+    *start_joint_correction = *mid_joint_correction =
+        SoaQuaternion::identity();
+    // Targets aren't reached.
+    if (reached) {
+      *reached = simd_int4::all_false();
+    }
+    return true;
+  }
+
+  // Prepares constant ik data.
+  const IKSoaConstantSetup setup(*this);
+
+  // Finds soften target position.
+  SoaFloat3 start_target_ss;
+  SimdFloat4 start_target_ss_len2;
+  const SimdInt4 lreached =
+      SoftenSoaTarget(*this, setup, &start_target_ss, &start_target_ss_len2);
+  if (reached) {
+    *reached = And(lreached, CmpGe(weight, simd_float4::one()));
+  }
+
+  // Calculate mid_rot_local quaternion which solves for the mid_ss joint
+  // rotation.
+  const SoaQuaternion mid_rot_ms =
+      ComputeSoaMidJoint(*this, setup, start_target_ss_len2);
+
+  // Calculates end_to_target_rot_ss quaternion which solves for effector
+  // rotating onto the target.
+  const SoaQuaternion start_rot_ss = ComputeSoaStartJoint(
+      *this, setup, mid_rot_ms, start_target_ss, start_target_ss_len2);
+
+  // Finally apply weight and output quaternions.
+  WeightSoaOutput(*this, start_rot_ss, mid_rot_ms);
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
@@ -28,6 +28,7 @@
 #include "ozz/animation/runtime/local_to_model_job.h"
 
 #include <cassert>
+#include <cstring>
 
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/simd_math.h"
@@ -67,12 +68,69 @@ bool LocalToModelJob::Validate() const {
   return valid;
 }
 
+namespace {
+// Defines the maximum number of joints whose mask closure is computed at once.
+// Closure is computed by chunks, so that stack usage doesn't depend on the
+// number of joints.
+const int kMaxChunkJoints = 1024;
+
+// Tests bit _i of _bits, bits beyond _bits range are 0.
+bool TestBit(const span<const uint8_t>& _bits, int _i) {
+  const size_t byte = static_cast<size_t>(_i) / 8;
+  return byte < _bits.size() && (_bits[byte] & (1 << (_i & 7))) != 0;
+}
+
+// Closes _mask over ancestors for joints of the [_begin,_end[ chunk, where
+// joints up to _last (excluded) can be selected. Bit i of _closure is set if
+// joint _begin + i is selected.
+void CloseMask(const span<const uint8_t>& _mask,
+               const span<const int32_t>& _parents, int _begin, int _end,
+               int _last, uint8_t* _closure) {
+  std::memset(_closure, 0, kMaxChunkJoints / 8);
+
+  // Joints are sorted depth-first, so the chunk joints whose subtree extends
+  // beyond the chunk are _end ancestors. A joint k after the chunk belongs to
+  // the subtree of ancestor j as long as parents of joints [_end,k] are all
+  // >= j. So the first selected joint after the chunk selects the ancestors
+  // up to the lowest of these parents.
+  int lowest = _end;
+  for (int k = _end; k < _last; ++k) {
+    lowest = math::Min(lowest, _parents[k]);
+    if (lowest < _begin) {
+      break;
+    }
+    if (TestBit(_mask, k)) {
+      for (int j = _parents[_end]; j >= _begin; j = _parents[j]) {
+        if (j <= lowest) {
+          _closure[(j - _begin) / 8] |= 1 << ((j - _begin) & 7);
+        }
+      }
+      break;
+    }
+  }
+
+  // A reverse traversal of the chunk propagates selection up to the chunk
+  // roots.
+  for (int i = _end - 1; i >= _begin; --i) {
+    const int local = i - _begin;
+    if (!TestBit(_mask, i) && !(_closure[local / 8] & (1 << (local & 7)))) {
+      continue;
+    }
+    _closure[local / 8] |= 1 << (local & 7);
+    const int parent = _parents[i];
+    if (parent >= _begin) {
+      _closure[(parent - _begin) / 8] |= 1 << ((parent - _begin) & 7);
+    }
+  }
+}
+}  // namespace
+
 bool LocalToModelJob::Run() const {
   if (!Validate()) {
     return false;
   }
 
-  const span<const int16_t>& parents = skeleton->joint_parents();
+  const span<const int32_t>& parents = skeleton->joint_parents();
 
   // Initializes an identity matrix that will be used to compute roots model
   // matrices without requiring a branch.
@@ -82,26 +140,94 @@ bool LocalToModelJob::Run() const {
   // Applies hierarchical transformation.
   // Loop ends after "to".
   const int end = math::Min(to + 1, skeleton->num_joints());
+
+  // Mask closure over selected joints ancestors, computed for the
+  // [chunk_begin,chunk_end[ chunk of joints being processed.
+  const bool masked = !mask.empty();
+  uint8_t closure[kMaxChunkJoints / 8];
+  int chunk_begin = 0;
+  int chunk_end = 0;
+
+  // Dirty flags are propagated to descendants while iterating. Joints are
+  // sorted depth-first, so the subtree of the outermost updated joint is left
+  // as soon as a joint parent is lower than it. No per-joint state is needed.
+  const bool tracked = !dirty.empty();
+  int dirty_root = Skeleton::kNoParent;
+
   // Begins iteration from "from", or the next joint if "from" is excluded.
+  int begin = math::Max(from + from_excluded, 0);
+
+  // When the whole hierarchy is processed, iteration can begin with the first
+  // dirty joint, as all the joints before it and their ancestors are unchanged.
+  if (tracked && from < 0) {
+    const size_t num_bytes =
+        math::Min(static_cast<size_t>(math::Max(end, 0) + 7) / 8, dirty.size());
+    size_t first = 0;
+    while (first < num_bytes && !dirty[first]) {
+      ++first;
+    }
+    begin = first < num_bytes ? static_cast<int>(first * 8) : end;
+  }
+
   // Process next joint if end is not reach. parents[begin] >= from is true as
   // long as "begin" is a child of "from".
-  for (int i = math::Max(from + from_excluded, 0),
+  for (int i = begin,
            process = i < end && (!from_excluded || parents[i] >= from);
        process;) {
-    // Builds soa matrices from soa transforms.
-    const math::SoaTransform& transform = input[i / 4];
-    const math::SoaFloat4x4 local_soa_matrices = math::SoaFloat4x4::FromAffine(
-        transform.translation, transform.rotation, transform.scale);
-
-    // Converts to aos matrices.
+    // Soa matrices are converted once the first joint of these 4 needs it, so
+    // conversion is skipped if none is updated.
     math::Float4x4 local_aos_matrices[4];
-    math::Transpose16x16(&local_soa_matrices.cols[0].x,
-                         local_aos_matrices->cols);
+    bool converted = false;
 
     // parents[i] >= from is true as long as "i" is a child of "from".
     for (const int soa_end = (i + 4) & ~3; i < soa_end && process;
          ++i, process = i < end && parents[i] >= from) {
       const int parent = parents[i];
+
+      // Leaving dirty subtree must be detected for every joint, including the
+      // ones that are masked out.
+      if (parent < dirty_root) {
+        dirty_root = Skeleton::kNoParent;
+      }
+
+      if (masked) {
+        if (i >= chunk_end) {
+          chunk_begin = i;
+          chunk_end = math::Min(i + kMaxChunkJoints, end);
+          CloseMask(mask, parents, chunk_begin, chunk_end, end, closure);
+        }
+        const int local = i - chunk_begin;
+        if (!(closure[local / 8] & (1 << (local & 7)))) {
+          continue;
+        }
+      }
+
+      // Joints before "begin" aren't processed, so their dirty flag is tested
+      // directly.
+      if (tracked && dirty_root == Skeleton::kNoParent) {
+        if (TestBit(dirty, i) ||
+            (parent != Skeleton::kNoParent && parent < begin &&
+             TestBit(dirty, parent))) {
+          dirty_root = i;
+        } else {
+          continue;
+        }
+      }
+
+      if (!converted) {
+        converted = true;
+
+        // Builds soa matrices from soa transforms.
+        const math::SoaTransform& transform = input[i / 4];
+        const math::SoaFloat4x4 local_soa_matrices =
+            math::SoaFloat4x4::FromAffine(transform.translation,
+                                          transform.rotation, transform.scale);
+
+        // Converts to aos matrices.
+        math::Transpose16x16(&local_soa_matrices.cols[0].x,
+                             local_aos_matrices->cols);
+      }
+
       const math::Float4x4* parent_matrix =
           parent == Skeleton::kNoParent ? root_matrix : &output[parent];
       output[i] = *parent_matrix * local_aos_matrices[i & 3];
@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/model_space_query_job.h"
+
+#include <cstring>
+
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_transform.h"
+
+namespace ozz {
+namespace animation {
+
+ModelSpaceQueryJob::ModelSpaceQueryJob()
+    : ratio(0.f),
+      animation(nullptr),
+      cache(nullptr),
+      skeleton(nullptr),
+      joint(0),
+      root(nullptr),
+      output(nullptr) {}
+
+bool ModelSpaceQueryJob::Validate() const {
+  // Don't need any early out, as jobs are valid in most of the performance
+  // critical cases.
+  // Tests are written in multiple lines in order to avoid branches.
+  bool valid = true;
+
+  // Test for nullptr pointers.
+  if (!animation || !cache || !skeleton || !output) {
+    return false;
+  }
+
+  // Joint must be a skeleton joint, sampled by the animation.
+  valid &= joint >= 0;
+  valid &= joint < skeleton->num_joints();
+  valid &= joint < animation->num_tracks();
+
+  // Tests locals and cache sizes.
+  const int num_soa_tracks = animation->num_soa_tracks();
+  valid &= locals.size() >= static_cast<size_t>(num_soa_tracks);
+  valid &= cache->max_soa_tracks() >= num_soa_tracks;
+
+  return valid;
+}
+
+bool ModelSpaceQueryJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Flags joint and its ancestors in a joints mask. Joints are sorted
+  // depth-first, so ancestors always have a lower index than joint.
+  uint8_t mask[(Skeleton::kMaxJoints + 7) / 8];
+  const size_t mask_size = joint / 8 + 1;
+  std::memset(mask, 0, mask_size);
+  const span<const int32_t>& parents = skeleton->joint_parents();
+  for (int i = joint; i != Skeleton::kNoParent; i = parents[i]) {
+    mask[i / 8] |= 1 << (i & 7);
+  }
+
+  // Samples ancestors chain soa tracks only.
+  SamplingJob sampling;
+  sampling.ratio = ratio;
+  sampling.animation = animation;
+  sampling.cache = cache;
+  sampling.output = locals;
+  sampling.mask = span<const uint8_t>(mask, mask_size);
+  if (!sampling.Run()) {
+    return false;
+  }
+
+  // Concatenates local matrices from the root to joint, in the same order as
+  // LocalToModelJob. Each joint of the chain is its successor's parent.
+  math::Float4x4 model = root ? *root : math::Float4x4::identity();
+  math::Float4x4 local_aos_matrices[4];
+  int soa_converted = -1;
+  for (int i = 0; i <= joint; ++i) {
+    if (!(mask[i / 8] & (1 << (i & 7)))) {
+      continue;
+    }
+
+    // Converts soa transforms to aos matrices, unless it was already done for
+    // the previous joint of the chain.
+    if (i / 4 != soa_converted) {
+      soa_converted = i / 4;
+      const math::SoaTransform& transform = locals[soa_converted];
+      const math::SoaFloat4x4 local_soa_matrices =
+          math::SoaFloat4x4::FromAffine(transform.translation,
+                                        transform.rotation, transform.scale);
+      math::Transpose16x16(&local_soa_matrices.cols[0].x,
+                           local_aos_matrices->cols);
+    }
+    model = model * local_aos_matrices[i & 3];
+  }
+  *output = model;
+
+  return true;
+}
+}  // namespace animation
+}  // namespace ozz
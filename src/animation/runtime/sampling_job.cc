@@ -34,6 +34,7 @@
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
 
 // Internal include file
 #define OZZ_INCLUDE_PRIVATE_HEADER  // Allows to include private headers.
@@ -76,8 +77,9 @@ bool SamplingJob::Validate() const {
 
 namespace {
 // Loops through the sorted key frames and update cache structure.
+// Returns the number of keys consumed by the cursor.
 template <typename _Key>
-void UpdateCacheCursor(float _ratio, int _num_soa_tracks,
+int UpdateCacheCursor(float _ratio, int _num_soa_tracks,
                        const ozz::span<const _Key>& _keys, int* _cursor,
                        int* _cache, unsigned char* _outdated) {
   assert(_num_soa_tracks >= 1);
@@ -116,6 +118,7 @@ void UpdateCacheCursor(float _ratio, int _num_soa_tracks,
     cursor = _keys.begin() + *_cursor;  // Might be == end()
     assert(cursor >= _keys.begin() + num_tracks * 2 && cursor <= _keys.end());
   }
+  const int previous_cursor = *_cursor;
 
   // Search for the keys that matches _ratio.
   // Iterates while the cache is not updated with left and right keys required
@@ -138,18 +141,42 @@ void UpdateCacheCursor(float _ratio, int _num_soa_tracks,
 
   // Updates cursor output.
   *_cursor = static_cast<int>(cursor - _keys.begin());
+  return *_cursor - previous_cursor;
 }
 
+// Computes the soa tracks mask of _byte outdated flags (8 soa tracks), from
+// _mask joints mask (1 bit per track). Every soa track is selected if _mask is
+// empty.
+uint8_t SoaMask(const span<const uint8_t>& _mask, int _byte) {
+  if (_mask.empty()) {
+    return 0xff;
+  }
+  uint8_t soa_mask = 0;
+  for (size_t i = _byte * 4, end = math::Min(i + 4, _mask.size()); i < end;
+       ++i) {
+    const int shift = static_cast<int>(i & 3) * 2;
+    soa_mask |= ((_mask[i] & 0x0f) != 0) << shift;
+    soa_mask |= ((_mask[i] & 0xf0) != 0) << (shift + 1);
+  }
+  return soa_mask;
+}
+
+// Returns the number of soa keyframes decompressed.
 template <typename _Key, typename _InterpKey, typename _Decompress>
-void UpdateInterpKeyframes(int _num_soa_tracks,
+int UpdateInterpKeyframes(int _num_soa_tracks,
                            const ozz::span<const _Key>& _keys,
-                           const int* _interp, uint8_t* _outdated,
-                           _InterpKey* _interp_keys,
+                           const int* _interp,
+                           const span<const uint8_t>& _mask,
+                           uint8_t* _outdated, _InterpKey* _interp_keys,
                            const _Decompress& _decompress) {
+  int decompressed = 0;
   const int num_outdated_flags = (_num_soa_tracks + 7) / 8;
   for (int j = 0; j < num_outdated_flags; ++j) {
-    uint8_t outdated = _outdated[j];
-    _outdated[j] = 0;  // Reset outdated entries as all will be processed.
+    // Masked out entries remain outdated, so they're decompressed as soon as
+    // they're sampled.
+    const uint8_t soa_mask = SoaMask(_mask, j);
+    uint8_t outdated = _outdated[j] & soa_mask;
+    _outdated[j] &= ~soa_mask;  // Reset entries that will be processed.
     for (int i = j * 8; outdated; ++i, outdated >>= 1) {
       if (!(outdated & 1)) {
         continue;
@@ -173,8 +200,11 @@ void UpdateInterpKeyframes(int _num_soa_tracks,
       _interp_keys[i].ratio[1] =
           math::simd_float4::Load(k01.ratio, k11.ratio, k21.ratio, k31.ratio);
       _decompress(k01, k11, k21, k31, &_interp_keys[i].value[1]);
+
+      ++decompressed;
     }
   }
+  return decompressed;
 }
 
 inline void DecompressFloat3(const Float3Key& _k0, const Float3Key& _k1,
@@ -197,10 +227,10 @@ void DecompressQuaternion(const QuaternionKey& _k0, const QuaternionKey& _k1,
                           const QuaternionKey& _k2, const QuaternionKey& _k3,
                           math::SoaQuaternion* _quaternion) {
   // Selects proper mapping for each key.
-  const int* m0 = kCpntMapping[_k0.largest];
-  const int* m1 = kCpntMapping[_k1.largest];
-  const int* m2 = kCpntMapping[_k2.largest];
-  const int* m3 = kCpntMapping[_k3.largest];
+  const int* m0 = kCpntMapping[_k0.largest()];
+  const int* m1 = kCpntMapping[_k1.largest()];
+  const int* m2 = kCpntMapping[_k2.largest()];
+  const int* m3 = kCpntMapping[_k3.largest()];
 
   // Prepares an array of input values, according to the mapping required to
   // restore quaternion largest component.
@@ -213,23 +243,24 @@ void DecompressQuaternion(const QuaternionKey& _k0, const QuaternionKey& _k1,
 
   // Resets largest component to 0. Overwritting here avoids 16 branchings
   // above.
-  cmp_keys[_k0.largest][0] = 0;
-  cmp_keys[_k1.largest][1] = 0;
-  cmp_keys[_k2.largest][2] = 0;
-  cmp_keys[_k3.largest][3] = 0;
+  cmp_keys[_k0.largest()][0] = 0;
+  cmp_keys[_k1.largest()][1] = 0;
+  cmp_keys[_k2.largest()][2] = 0;
+  cmp_keys[_k3.largest()][3] = 0;
 
-  // Rebuilds quaternion from quantized values.
+  // Rebuilds quaternion from quantized values, masking out flag bits.
   const math::SimdFloat4 kInt2Float =
       math::simd_float4::Load1(1.f / (32767.f * math::kSqrt2));
+  const math::SimdInt4 kValueMask = math::simd_int4::Load1(~1);
   math::SimdFloat4 cpnt[4] = {
-      kInt2Float *
-          math::simd_float4::FromInt(math::simd_int4::LoadPtr(cmp_keys[0])),
-      kInt2Float *
-          math::simd_float4::FromInt(math::simd_int4::LoadPtr(cmp_keys[1])),
-      kInt2Float *
-          math::simd_float4::FromInt(math::simd_int4::LoadPtr(cmp_keys[2])),
-      kInt2Float *
-          math::simd_float4::FromInt(math::simd_int4::LoadPtr(cmp_keys[3])),
+      kInt2Float * math::simd_float4::FromInt(math::And(
+                       math::simd_int4::LoadPtr(cmp_keys[0]), kValueMask)),
+      kInt2Float * math::simd_float4::FromInt(math::And(
+                       math::simd_int4::LoadPtr(cmp_keys[1]), kValueMask)),
+      kInt2Float * math::simd_float4::FromInt(math::And(
+                       math::simd_int4::LoadPtr(cmp_keys[2]), kValueMask)),
+      kInt2Float * math::simd_float4::FromInt(math::And(
+                       math::simd_int4::LoadPtr(cmp_keys[3]), kValueMask)),
   };
 
   // Get back length of 4th component. Favors performance over accuracy by using
@@ -242,18 +273,19 @@ void DecompressQuaternion(const QuaternionKey& _k0, const QuaternionKey& _k1,
   const math::SimdFloat4 w0 = ww0 * math::RSqrtEst(ww0);
   // Re-applies 4th component' s sign.
   const math::SimdInt4 sign = math::ShiftL(
-      math::simd_int4::Load(_k0.sign, _k1.sign, _k2.sign, _k3.sign), 31);
+      math::simd_int4::Load(_k0.sign(), _k1.sign(), _k2.sign(), _k3.sign()),
+      31);
   const math::SimdFloat4 restored = math::Or(w0, sign);
 
   // Re-injects the largest component inside the SoA structure.
-  cpnt[_k0.largest] = math::Or(
-      cpnt[_k0.largest], math::And(restored, math::simd_int4::mask_f000()));
-  cpnt[_k1.largest] = math::Or(
-      cpnt[_k1.largest], math::And(restored, math::simd_int4::mask_0f00()));
-  cpnt[_k2.largest] = math::Or(
-      cpnt[_k2.largest], math::And(restored, math::simd_int4::mask_00f0()));
-  cpnt[_k3.largest] = math::Or(
-      cpnt[_k3.largest], math::And(restored, math::simd_int4::mask_000f()));
+  cpnt[_k0.largest()] = math::Or(
+      cpnt[_k0.largest()], math::And(restored, math::simd_int4::mask_f000()));
+  cpnt[_k1.largest()] = math::Or(
+      cpnt[_k1.largest()], math::And(restored, math::simd_int4::mask_0f00()));
+  cpnt[_k2.largest()] = math::Or(
+      cpnt[_k2.largest()], math::And(restored, math::simd_int4::mask_00f0()));
+  cpnt[_k3.largest()] = math::Or(
+      cpnt[_k3.largest()], math::And(restored, math::simd_int4::mask_000f()));
 
   // Stores result.
   _quaternion->x = cpnt[0];
@@ -263,12 +295,20 @@ void DecompressQuaternion(const QuaternionKey& _k0, const QuaternionKey& _k1,
 }
 
 void Interpolates(float _anim_ratio, int _num_soa_tracks,
+                  const span<const uint8_t>& _mask,
                   const internal::InterpSoaFloat3* _translations,
                   const internal::InterpSoaQuaternion* _rotations,
                   const internal::InterpSoaFloat3* _scales,
                   math::SoaTransform* _output) {
   const math::SimdFloat4 anim_ratio = math::simd_float4::Load1(_anim_ratio);
   for (int i = 0; i < _num_soa_tracks; ++i) {
+    // Skips soa tracks that have no joint selected by the mask.
+    if (!_mask.empty() &&
+        (static_cast<size_t>(i / 2) >= _mask.size() ||
+         !(_mask[i / 2] & (0x0f << ((i & 1) * 4))))) {
+      continue;
+    }
+
     // Prepares interpolation coefficients.
     const math::SimdFloat4 interp_t_ratio =
         (anim_ratio - _translations[i].ratio[0]) *
@@ -314,29 +354,40 @@ bool SamplingJob::Run() const {
 
   // Fetch key frames from the animation to the cache a r = anim_ratio.
   // Then updates outdated soa hot values.
-  UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->translations(),
-                    &cache->translation_cursor_, cache->translation_keys_,
-                    cache->outdated_translations_);
-  UpdateInterpKeyframes(num_soa_tracks, animation->translations(),
-                        cache->translation_keys_, cache->outdated_translations_,
-                        cache->soa_translations_, &DecompressFloat3);
-
-  UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->rotations(),
-                    &cache->rotation_cursor_, cache->rotation_keys_,
-                    cache->outdated_rotations_);
-  UpdateInterpKeyframes(num_soa_tracks, animation->rotations(),
-                        cache->rotation_keys_, cache->outdated_rotations_,
-                        cache->soa_rotations_, &DecompressQuaternion);
-
-  UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->scales(),
-                    &cache->scale_cursor_, cache->scale_keys_,
-                    cache->outdated_scales_);
-  UpdateInterpKeyframes(num_soa_tracks, animation->scales(), cache->scale_keys_,
-                        cache->outdated_scales_, cache->soa_scales_,
-                        &DecompressFloat3);
+  int keys = 0;
+  int decompressions = 0;
+  keys += UpdateCacheCursor(anim_ratio, num_soa_tracks,
+                            animation->translations(),
+                            &cache->translation_cursor_,
+                            cache->translation_keys_,
+                            cache->outdated_translations_);
+  decompressions += UpdateInterpKeyframes(
+      num_soa_tracks, animation->translations(), cache->translation_keys_,
+      mask, cache->outdated_translations_, cache->soa_translations_,
+      &DecompressFloat3);
+
+  keys += UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->rotations(),
+                            &cache->rotation_cursor_, cache->rotation_keys_,
+                            cache->outdated_rotations_);
+  decompressions += UpdateInterpKeyframes(
+      num_soa_tracks, animation->rotations(), cache->rotation_keys_, mask,
+      cache->outdated_rotations_, cache->soa_rotations_, &DecompressQuaternion);
+
+  keys += UpdateCacheCursor(anim_ratio, num_soa_tracks, animation->scales(),
+                            &cache->scale_cursor_, cache->scale_keys_,
+                            cache->outdated_scales_);
+  decompressions += UpdateInterpKeyframes(
+      num_soa_tracks, animation->scales(), cache->scale_keys_, mask,
+      cache->outdated_scales_, cache->soa_scales_, &DecompressFloat3);
+
+  // Accumulates statistics.
+  SamplingCache::Statistics& statistics = cache->statistics_;
+  ++statistics.samplings;
+  statistics.keys += keys;
+  statistics.decompressions += decompressions;
 
   // Interpolates soa hot data.
-  Interpolates(anim_ratio, num_soa_tracks, cache->soa_translations_,
+  Interpolates(anim_ratio, num_soa_tracks, mask, cache->soa_translations_,
                cache->soa_rotations_, cache->soa_scales_, output.begin());
 
   return true;
@@ -346,13 +397,16 @@ SamplingCache::SamplingCache()
     : max_soa_tracks_(0),
       soa_translations_(
           nullptr) {  // soa_translations_ is the allocation pointer.
-  Invalidate();
+  Reset();
+  ResetStatistics();
 }
 
 SamplingCache::SamplingCache(int _max_tracks)
     : max_soa_tracks_(0),
       soa_translations_(
           nullptr) {  // soa_translations_ is the allocation pointer.
+  Reset();
+  ResetStatistics();
   Resize(_max_tracks);
 }
 
@@ -361,12 +415,33 @@ SamplingCache::~SamplingCache() {
   memory::default_allocator()->Deallocate(soa_translations_);
 }
 
+namespace {
+// Computes the size of the buffer allocated by a SamplingCache of
+// _max_soa_tracks.
+size_t AllocationSize(int _max_soa_tracks) {
+  const size_t max_tracks = _max_soa_tracks * 4;
+  const size_t num_outdated = (_max_soa_tracks + 7) / 8;
+  return sizeof(internal::InterpSoaFloat3) * _max_soa_tracks +
+         sizeof(internal::InterpSoaQuaternion) * _max_soa_tracks +
+         sizeof(internal::InterpSoaFloat3) * _max_soa_tracks +
+         sizeof(int) * max_tracks * 2 * 3 +  // 2 keys * (trans + rot + scale).
+         sizeof(uint8_t) * 3 * num_outdated;
+}
+}  // namespace
+
+size_t SamplingCache::size() const {
+  return sizeof(*this) + AllocationSize(max_soa_tracks_);
+}
+
 void SamplingCache::Resize(int _max_tracks) {
   using internal::InterpSoaFloat3;
   using internal::InterpSoaQuaternion;
 
   // Reset existing data.
-  Invalidate();
+  if (animation_) {
+    ++statistics_.resize_invalidations;
+  }
+  Reset();
   memory::default_allocator()->Deallocate(soa_translations_);
 
   // Updates maximum supported soa tracks.
@@ -380,14 +455,10 @@ void SamplingCache::Resize(int _max_tracks) {
   // Computes allocation size.
   const size_t max_tracks = max_soa_tracks_ * 4;
   const size_t num_outdated = (max_soa_tracks_ + 7) / 8;
-  const size_t size =
-      sizeof(InterpSoaFloat3) * max_soa_tracks_ +
-      sizeof(InterpSoaQuaternion) * max_soa_tracks_ +
-      sizeof(InterpSoaFloat3) * max_soa_tracks_ +
-      sizeof(int) * max_tracks * 2 * 3 +  // 2 keys * (trans + rot + scale).
-      sizeof(uint8_t) * 3 * num_outdated;
+  const size_t size = AllocationSize(max_soa_tracks_);
 
   // Allocates all at once.
+  const memory::ScopedTag tag(memory::kCache);
   memory::Allocator* allocator = memory::default_allocator();
   char* alloc_begin = reinterpret_cast<char*>(
       allocator->Allocate(size, alignof(InterpSoaFloat3)));
@@ -433,6 +504,11 @@ void SamplingCache::Resize(int _max_tracks) {
 void SamplingCache::Step(const Animation& _animation, float _ratio) {
   // The cache is invalidated if animation has changed or if it is being rewind.
   if (animation_ != &_animation || _ratio < ratio_) {
+    if (animation_ != &_animation) {
+      statistics_.animation_invalidations += animation_ != nullptr;
+    } else {
+      ++statistics_.backward_invalidations;
+    }
     animation_ = &_animation;
     translation_cursor_ = 0;
     rotation_cursor_ = 0;
@@ -442,6 +518,23 @@ void SamplingCache::Step(const Animation& _animation, float _ratio) {
 }
 
 void SamplingCache::Invalidate() {
+  if (animation_) {
+    ++statistics_.explicit_invalidations;
+  }
+  Reset();
+}
+
+void SamplingCache::ResetStatistics() {
+  statistics_.samplings = 0;
+  statistics_.keys = 0;
+  statistics_.decompressions = 0;
+  statistics_.animation_invalidations = 0;
+  statistics_.backward_invalidations = 0;
+  statistics_.resize_invalidations = 0;
+  statistics_.explicit_invalidations = 0;
+}
+
+void SamplingCache::Reset() {
   animation_ = nullptr;
   ratio_ = 0.f;
   translation_cursor_ = 0;
@@ -35,6 +35,7 @@
 #include "ozz/base/maths/soa_math_archive.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
 
 namespace ozz {
 namespace animation {
@@ -47,8 +48,8 @@ char* Skeleton::Allocate(size_t _chars_size, size_t _num_joints) {
   // Distributes buffer memory while ensuring proper alignment (serves larger
   // alignment values first).
   static_assert(alignof(math::SoaTransform) >= alignof(char*) &&
-                    alignof(char*) >= alignof(int16_t) &&
-                    alignof(int16_t) >= alignof(char),
+                    alignof(char*) >= alignof(int32_t) &&
+                    alignof(int32_t) >= alignof(char),
                 "Must serve larger alignment values first)");
 
   assert(joint_bind_poses_.size() == 0 && joint_names_.size() == 0 &&
@@ -64,11 +65,12 @@ char* Skeleton::Allocate(size_t _chars_size, size_t _num_joints) {
   const size_t joint_bind_poses_size =
       num_soa_joints * sizeof(math::SoaTransform);
   const size_t names_size = _num_joints * sizeof(char*);
-  const size_t joint_parents_size = _num_joints * sizeof(int16_t);
+  const size_t joint_parents_size = _num_joints * sizeof(int32_t);
   const size_t buffer_size =
       names_size + _chars_size + joint_parents_size + joint_bind_poses_size;
 
   // Allocates whole buffer.
+  const memory::ScopedTag tag(memory::kSkeleton);
   span<char> buffer = {static_cast<char*>(memory::default_allocator()->Allocate(
                            buffer_size, alignof(math::SoaTransform))),
                        buffer_size};
@@ -81,7 +83,7 @@ char* Skeleton::Allocate(size_t _chars_size, size_t _num_joints) {
   joint_names_ = fill_span<char*>(buffer, _num_joints);
 
   // Parents, third biggest alignment.
-  joint_parents_ = fill_span<int16_t>(buffer, _num_joints);
+  joint_parents_ = fill_span<int32_t>(buffer, _num_joints);
 
   // Remaning buffer will be used to store joint names.
   assert(buffer.size_bytes() == _chars_size &&
@@ -96,6 +98,15 @@ void Skeleton::Deallocate() {
   joint_parents_ = {};
 }
 
+size_t Skeleton::size() const {
+  size_t size = sizeof(*this) + joint_bind_poses_.size_bytes() +
+                joint_parents_.size_bytes() + joint_names_.size_bytes();
+  for (size_t i = 0; i < joint_names_.size(); ++i) {
+    size += (std::strlen(joint_names_[i]) + 1) * sizeof(char);
+  }
+  return size;
+}
+
 void Skeleton::Save(ozz::io::OArchive& _archive) const {
   const int32_t num_joints = this->num_joints();
 
@@ -121,7 +132,7 @@ void Skeleton::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   // Deallocate skeleton in case it was already used before.
   Deallocate();
 
-  if (_version != 2) {
+  if (_version != 2 && _version != 3) {
     log::Err() << "Unsupported Skeleton version " << _version << "."
                << std::endl;
     return;
@@ -154,7 +165,16 @@ void Skeleton::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   // num_joints is > 0, as this was tested at the beginning of the function.
   joint_names_[num_joints - 1] = cursor;
 
-  _archive >> ozz::io::MakeArray(joint_parents_);
+  if (_version == 2) {
+    // Version 2 stored parents as 16 bits indices.
+    for (int32_t& parent : joint_parents_) {
+      int16_t parent16;
+      _archive >> parent16;
+      parent = parent16;
+    }
+  } else {
+    _archive >> ozz::io::MakeArray(joint_parents_);
+  }
   _archive >> ozz::io::MakeArray(joint_bind_poses_);
 }
 }  // namespace animation
@@ -34,6 +34,7 @@
 #include "ozz/base/maths/math_archive.h"
 #include "ozz/base/maths/math_ex.h"
 #include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
 
 namespace ozz {
 namespace animation {
@@ -49,7 +50,8 @@ Track<_ValueType>::~Track() {
 }
 
 template <typename _ValueType>
-void Track<_ValueType>::Allocate(size_t _keys_count, size_t _name_len) {
+void Track<_ValueType>::Allocate(size_t _keys_count, size_t _name_len,
+                                 bool _cubic) {
   assert(ratios_.size() == 0 && values_.size() == 0);
 
   // Distributes buffer memory while ensuring proper alignment (serves larger
@@ -58,10 +60,17 @@ void Track<_ValueType>::Allocate(size_t _keys_count, size_t _name_len) {
                     alignof(float) >= alignof(uint8_t),
                 "Must serve larger alignment values first)");
 
+  // Cubic buffers are only allocated if needed.
+  const size_t tangents_count = _cubic ? _keys_count * 2 : 0;
+  const size_t cubics_count = _cubic ? (_keys_count + 7) / 8 : 0;
+
   // Compute overall size and allocate a single buffer for all the data.
+  const memory::ScopedTag tag(memory::kTrack);
   const size_t buffer_size = _keys_count * sizeof(_ValueType) +  // values
-                             _keys_count * sizeof(float) +       // ratios
+                             tangents_count * sizeof(_ValueType) +  // tangents
+                             _keys_count * sizeof(float) +          // ratios
                              (_keys_count + 7) * sizeof(uint8_t) / 8 +  // steps
+                             cubics_count * sizeof(uint8_t) +  // cubics
                              (_name_len > 0 ? _name_len + 1 : 0);
   span<char> buffer = {static_cast<char*>(memory::default_allocator()->Allocate(
                            buffer_size, alignof(_ValueType))),
@@ -69,8 +78,10 @@ void Track<_ValueType>::Allocate(size_t _keys_count, size_t _name_len) {
 
   // Fix up pointers. Serves larger alignment values first.
   values_ = fill_span<_ValueType>(buffer, _keys_count);
+  tangents_ = fill_span<_ValueType>(buffer, tangents_count);
   ratios_ = fill_span<float>(buffer, _keys_count);
   steps_ = fill_span<uint8_t>(buffer, (_keys_count + 7) / 8);
+  cubics_ = fill_span<uint8_t>(buffer, cubics_count);
 
   // Let name be nullptr if track has no name. Allows to avoid allocating this
   // buffer in the constructor of empty animations.
@@ -86,15 +97,18 @@ void Track<_ValueType>::Deallocate() {
   memory::default_allocator()->Deallocate(as_writable_bytes(values_).data());
 
   values_ = {};
+  tangents_ = {};
   ratios_ = {};
   steps_ = {};
+  cubics_ = {};
   name_ = nullptr;
 }
 
 template <typename _ValueType>
 size_t Track<_ValueType>::size() const {
   const size_t size = sizeof(*this) + values_.size_bytes() +
-                      ratios_.size_bytes() + steps_.size_bytes();
+                      tangents_.size_bytes() + ratios_.size_bytes() +
+                      steps_.size_bytes() + cubics_.size_bytes();
   return size;
 }
 
@@ -106,9 +120,14 @@ void Track<_ValueType>::Save(ozz::io::OArchive& _archive) const {
   const size_t name_len = name_ ? std::strlen(name_) : 0;
   _archive << static_cast<int32_t>(name_len);
 
+  const bool cubic = !cubics_.empty();
+  _archive << cubic;
+
   _archive << ozz::io::MakeArray(ratios_);
   _archive << ozz::io::MakeArray(values_);
   _archive << ozz::io::MakeArray(steps_);
+  _archive << ozz::io::MakeArray(cubics_);
+  _archive << ozz::io::MakeArray(tangents_);
 
   _archive << ozz::io::MakeArray(name_, name_len);
 }
@@ -118,7 +137,7 @@ void Track<_ValueType>::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   // Destroy animation in case it was already used before.
   Deallocate();
 
-  if (_version > 1) {
+  if (_version < 1 || _version > 2) {
     log::Err() << "Unsupported Track version " << _version << "." << std::endl;
     return;
   }
@@ -129,11 +148,19 @@ void Track<_ValueType>::Load(ozz::io::IArchive& _archive, uint32_t _version) {
   int32_t name_len;
   _archive >> name_len;
 
-  Allocate(num_keys, name_len);
+  // Cubic keys were introduced with version 2.
+  bool cubic = false;
+  if (_version >= 2) {
+    _archive >> cubic;
+  }
+
+  Allocate(num_keys, name_len, cubic);
 
   _archive >> ozz::io::MakeArray(ratios_);
   _archive >> ozz::io::MakeArray(values_);
   _archive >> ozz::io::MakeArray(steps_);
+  _archive >> ozz::io::MakeArray(cubics_);
+  _archive >> ozz::io::MakeArray(tangents_);
 
   if (name_) {  // nullptr name_ is supported.
     _archive >> ozz::io::MakeArray(name_, name_len);
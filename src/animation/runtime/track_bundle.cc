@@ -0,0 +1,116 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/track_bundle.h"
+
+#include <cassert>
+
+#include "ozz/base/io/archive.h"
+#include "ozz/base/log.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
+
+namespace ozz {
+namespace animation {
+
+FloatTrackBundle::FloatTrackBundle() : num_tracks_(0) {}
+
+FloatTrackBundle::~FloatTrackBundle() { Deallocate(); }
+
+void FloatTrackBundle::Allocate(size_t _keys_count, int _num_tracks) {
+  assert(ratios_.size() == 0 && values_.size() == 0);
+
+  // Values are stored in SoA, 4 tracks per SIMD vector.
+  const size_t num_values = _keys_count * ((_num_tracks + 3) / 4) * 4;
+
+  // Compute overall size and allocate a single buffer for all the data.
+  // Values are served first, as they require SIMD alignment.
+  const memory::ScopedTag tag(memory::kTrack);
+  const size_t buffer_size = num_values * sizeof(float) +  // values
+                             _keys_count * sizeof(float);  // ratios
+  span<char> buffer = {static_cast<char*>(memory::default_allocator()->Allocate(
+                           buffer_size, alignof(math::SimdFloat4))),
+                       buffer_size};
+
+  // Fix up pointers. Serves larger alignment values first.
+  values_ = fill_span<float>(buffer, num_values);
+  ratios_ = fill_span<float>(buffer, _keys_count);
+
+  assert(buffer.empty() && "Whole buffer should be consumned");
+
+  num_tracks_ = _num_tracks;
+}
+
+void FloatTrackBundle::Deallocate() {
+  // Deallocate everything at once.
+  memory::default_allocator()->Deallocate(as_writable_bytes(values_).data());
+
+  num_tracks_ = 0;
+  values_ = {};
+  ratios_ = {};
+}
+
+size_t FloatTrackBundle::size() const {
+  const size_t size =
+      sizeof(*this) + values_.size_bytes() + ratios_.size_bytes();
+  return size;
+}
+
+void FloatTrackBundle::Save(ozz::io::OArchive& _archive) const {
+  _archive << static_cast<int32_t>(num_tracks_);
+
+  const uint32_t num_keys = static_cast<uint32_t>(ratios_.size());
+  _archive << num_keys;
+
+  _archive << ozz::io::MakeArray(ratios_);
+  _archive << ozz::io::MakeArray(values_);
+}
+
+void FloatTrackBundle::Load(ozz::io::IArchive& _archive, uint32_t _version) {
+  // Destroy bundle in case it was already used before.
+  Deallocate();
+
+  if (_version > 1) {
+    log::Err() << "Unsupported FloatTrackBundle version " << _version << "."
+               << std::endl;
+    return;
+  }
+
+  int32_t num_tracks;
+  _archive >> num_tracks;
+
+  uint32_t num_keys;
+  _archive >> num_keys;
+
+  Allocate(num_keys, num_tracks);
+
+  _archive >> ozz::io::MakeArray(ratios_);
+  _archive >> ozz::io::MakeArray(values_);
+}
+}  // namespace animation
+}  // namespace ozz
@@ -0,0 +1,111 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/track_edges.h"
+
+#include <cassert>
+
+#include "ozz/base/io/archive.h"
+#include "ozz/base/log.h"
+#include "ozz/base/memory/allocator.h"
+#include "ozz/base/memory/tracking_allocator.h"
+
+namespace ozz {
+namespace animation {
+
+TrackEdges::TrackEdges() : threshold_(0.f) {}
+
+TrackEdges::~TrackEdges() { Deallocate(); }
+
+void TrackEdges::Allocate(size_t _edges_count) {
+  assert(ratios_.size() == 0 && risings_.size() == 0);
+
+  // Compute overall size and allocate a single buffer for all the data.
+  const memory::ScopedTag tag(memory::kTrack);
+  const size_t risings_count = (_edges_count + 7) / 8;
+  const size_t buffer_size = _edges_count * sizeof(float) +  // ratios
+                             risings_count * sizeof(uint8_t);  // risings
+  span<char> buffer = {static_cast<char*>(memory::default_allocator()->Allocate(
+                           buffer_size, alignof(float))),
+                       buffer_size};
+
+  // Fix up pointers. Serves larger alignment values first.
+  ratios_ = fill_span<float>(buffer, _edges_count);
+  risings_ = fill_span<uint8_t>(buffer, risings_count);
+
+  assert(buffer.empty() && "Whole buffer should be consumned");
+}
+
+void TrackEdges::Deallocate() {
+  // Deallocate everything at once.
+  memory::default_allocator()->Deallocate(as_writable_bytes(ratios_).data());
+
+  threshold_ = 0.f;
+  ratios_ = {};
+  risings_ = {};
+}
+
+size_t TrackEdges::size() const {
+  const size_t size =
+      sizeof(*this) + ratios_.size_bytes() + risings_.size_bytes();
+  return size;
+}
+
+void TrackEdges::Save(ozz::io::OArchive& _archive) const {
+  _archive << threshold_;
+
+  const uint32_t num_edges = static_cast<uint32_t>(ratios_.size());
+  _archive << num_edges;
+
+  _archive << ozz::io::MakeArray(ratios_);
+  _archive << ozz::io::MakeArray(risings_);
+}
+
+void TrackEdges::Load(ozz::io::IArchive& _archive, uint32_t _version) {
+  // Destroy table in case it was already used before.
+  Deallocate();
+
+  if (_version > 1) {
+    log::Err() << "Unsupported TrackEdges version " << _version << "."
+               << std::endl;
+    return;
+  }
+
+  float threshold;
+  _archive >> threshold;
+
+  uint32_t num_edges;
+  _archive >> num_edges;
+
+  Allocate(num_edges);
+  threshold_ = threshold;
+
+  _archive >> ozz::io::MakeArray(ratios_);
+  _archive >> ozz::io::MakeArray(risings_);
+}
+}  // namespace animation
+}  // namespace ozz
@@ -27,18 +27,101 @@
 
 #include "ozz/animation/runtime/track_sampling_job.h"
 #include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_bundle.h"
 #include "ozz/base/maths/math_ex.h"
+#include "ozz/base/maths/simd_math.h"
 
 #include <algorithm>
 #include <cassert>
 
 namespace ozz {
 namespace animation {
+namespace {
+// Searches for the first key frame with a ratio greater than _ratio, starting
+// from _cursor, the result of the previous search. Playback is usually
+// coherent, so the cursor first moves forward linearly by a few keys, before
+// falling back to a binary search on the remaining ones.
+template <typename _Ratio>
+const _Ratio* SearchFromCursor(const span<const _Ratio>& _ratios,
+                               const _Ratio* _cursor, float _ratio) {
+  // Sampling backward, key is before the cursor.
+  if (_ratio < _cursor[-1]) {
+    return std::upper_bound(_ratios.begin(), _cursor - 1, _ratio);
+  }
+  const int kMaxLinearSteps = 4;
+  for (int i = 0; _cursor != _ratios.end() && *_cursor <= _ratio;
+       ++i, ++_cursor) {
+    if (i == kMaxLinearSteps) {
+      return std::upper_bound(_cursor, _ratios.end(), _ratio);
+    }
+  }
+  return _cursor;
+}
+
+// Keyframes accessors, for uncompressed and compressed tracks. Compressed track
+// ratios are quantized, so the sampling ratio is scaled to the same range
+// before being compared. Only uncompressed tracks support cubic keys.
+template <typename _ValueType>
+inline float RatioScale(const internal::Track<_ValueType>&) {
+  return 1.f;
+}
+template <typename _ValueType>
+inline const _ValueType& KeyValue(const internal::Track<_ValueType>& _track,
+                                  size_t _key) {
+  return _track.values()[_key];
+}
+template <typename _ValueType>
+inline _ValueType Interpolate(const internal::Track<_ValueType>& _track,
+                              size_t _id0, float _alpha) {
+  const span<const _ValueType> values = _track.values();
+  const span<const uint8_t> cubics = _track.cubics();
+  if (!cubics.empty() && (cubics[_id0 / 8] & (1 << (_id0 & 7))) != 0) {
+    const span<const _ValueType> tangents = _track.tangents();
+    return internal::TrackPolicy<_ValueType>::Hermite(
+        values[_id0], tangents[_id0 * 2], values[_id0 + 1],
+        tangents[_id0 * 2 + 1], _alpha);
+  }
+  return internal::TrackPolicy<_ValueType>::Lerp(values[_id0],
+                                                 values[_id0 + 1], _alpha);
+}
+template <typename _ValueType>
+inline float RatioScale(const internal::CompressedTrack<_ValueType>&) {
+  return internal::CompressedTrack<_ValueType>::kMaxRatio;
+}
+template <typename _ValueType>
+inline _ValueType KeyValue(const internal::CompressedTrack<_ValueType>& _track,
+                           size_t _key) {
+  return _track.value(_key);
+}
+template <typename _ValueType>
+inline _ValueType Interpolate(
+    const internal::CompressedTrack<_ValueType>& _track, size_t _id0,
+    float _alpha) {
+  return internal::TrackPolicy<_ValueType>::Lerp(
+      _track.value(_id0), _track.value(_id0 + 1), _alpha);
+}
+}  // namespace
+
+template <typename _Ratio>
+const _Ratio* TrackSamplingCache::Search(const void* _track,
+                                         const span<const _Ratio>& _ratios,
+                                         float _ratio) {
+  const _Ratio* found;
+  if (track_ == _track && cursor_ > 0 && cursor_ <= _ratios.size()) {
+    found = SearchFromCursor(_ratios, _ratios.begin() + cursor_, _ratio);
+  } else {
+    found = std::upper_bound(_ratios.begin(), _ratios.end(), _ratio);
+  }
+  track_ = _track;
+  cursor_ = found - _ratios.begin();
+  return found;
+}
+
 namespace internal {
 
 template <typename _Track>
 TrackSamplingJob<_Track>::TrackSamplingJob()
-    : ratio(0.f), track(nullptr), result(nullptr) {}
+    : ratio(0.f), track(nullptr), cache(nullptr), result(nullptr) {}
 
 template <typename _Track>
 bool TrackSamplingJob<_Track>::Validate() const {
@@ -54,14 +137,13 @@ bool TrackSamplingJob<_Track>::Run() const {
     return false;
   }
 
-  // Clamps ratio in range [0,1].
-  const float clamped_ratio = math::Clamp(0.f, ratio, 1.f);
+  // Clamps ratio in range [0,1], then scales it to the range of track ratios.
+  const float clamped_ratio =
+      math::Clamp(0.f, ratio, 1.f) * RatioScale(*track);
 
   // Search keyframes to interpolate.
-  const span<const float> ratios = track->ratios();
-  const span<const ValueType> values = track->values();
-  assert(ratios.size() == values.size() &&
-         track->steps().size() * 8 >= values.size());
+  const span<const RatioType> ratios = track->ratios();
+  assert(track->steps().size() * 8 >= ratios.size());
 
   // Default track returns identity.
   if (ratios.size() == 0) {
@@ -71,7 +153,9 @@ bool TrackSamplingJob<_Track>::Run() const {
 
   // Search for the first key frame with a ratio value greater than input ratio.
   // Our ratio is between this one and the previous one.
-  const float* ptk1 = std::upper_bound(ratios.begin(), ratios.end(), clamped_ratio);
+  const RatioType* ptk1 =
+      cache ? cache->Search(track, ratios, clamped_ratio)
+            : std::upper_bound(ratios.begin(), ratios.end(), clamped_ratio);
 
   // Deduce keys indices.
   const size_t id1 = ptk1 - ratios.begin();
@@ -79,16 +163,14 @@ bool TrackSamplingJob<_Track>::Run() const {
 
   const bool id0step = (track->steps()[id0 / 8] & (1 << (id0 & 7))) != 0;
   if (id0step || ptk1 == ratios.end()) {
-    *result = values[id0];
+    *result = KeyValue(*track, id0);
   } else {
-    // Lerp relevant keys.
+    // Interpolates relevant keys, linearly or along a cubic curve.
     const float tk0 = ratios[id0];
     const float tk1 = ratios[id1];
     assert(clamped_ratio >= tk0 && clamped_ratio < tk1 && tk0 != tk1);
     const float alpha = (clamped_ratio - tk0) / (tk1 - tk0);
-    const ValueType& vk0 = values[id0];
-    const ValueType& vk1 = values[id1];
-    *result = internal::TrackPolicy<ValueType>::Lerp(vk0, vk1, alpha);
+    *result = Interpolate(*track, id0, alpha);
   }
   return true;
 }
@@ -99,6 +181,92 @@ template struct TrackSamplingJob<Float2Track>;
 template struct TrackSamplingJob<Float3Track>;
 template struct TrackSamplingJob<Float4Track>;
 template struct TrackSamplingJob<QuaternionTrack>;
+template struct TrackSamplingJob<CompressedFloatTrack>;
+template struct TrackSamplingJob<CompressedFloat2Track>;
+template struct TrackSamplingJob<CompressedFloat3Track>;
+template struct TrackSamplingJob<CompressedFloat4Track>;
+template struct TrackSamplingJob<CompressedQuaternionTrack>;
 }  // namespace internal
+
+FloatTrackBundleSamplingJob::FloatTrackBundleSamplingJob()
+    : ratio(0.f), bundle(nullptr), cache(nullptr) {}
+
+bool FloatTrackBundleSamplingJob::Validate() const {
+  bool success = true;
+  success &= bundle != nullptr;
+  success &=
+      bundle && output.size() >= static_cast<size_t>(bundle->num_tracks());
+  return success;
+}
+
+bool FloatTrackBundleSamplingJob::Run() const {
+  if (!Validate()) {
+    return false;
+  }
+
+  // Clamps ratio in range [0,1].
+  const float clamped_ratio = math::Clamp(0.f, ratio, 1.f);
+
+  const span<const float> ratios = bundle->ratios();
+  const int num_tracks = bundle->num_tracks();
+  const int num_soa_tracks = bundle->num_soa_tracks();
+  assert(bundle->values().size() == ratios.size() * num_soa_tracks * 4);
+
+  // Default bundle returns identity.
+  if (ratios.size() == 0) {
+    for (int i = 0; i < num_tracks; ++i) {
+      output[i] = 0.f;
+    }
+    return true;
+  }
+
+  // Search for the first key frame with a ratio value greater than input ratio.
+  // Our ratio is between this one and the previous one. Ratios are shared by
+  // all tracks, so this is done once for all of them.
+  const float* ptk1 =
+      cache ? cache->Search(bundle, ratios, clamped_ratio)
+            : std::upper_bound(ratios.begin(), ratios.end(), clamped_ratio);
+
+  // Deduce keys indices.
+  const size_t id1 = ptk1 - ratios.begin();
+  const size_t id0 = id1 - 1;
+  const float* vk0 = bundle->values().begin() + id0 * num_soa_tracks * 4;
+
+  // Interpolates 4 tracks at a time, last ones being stored one by one.
+  const int num_full_soa_tracks = num_tracks / 4;
+  float* out = output.begin();
+  if (ptk1 == ratios.end()) {
+    for (int i = 0; i < num_full_soa_tracks; ++i, vk0 += 4, out += 4) {
+      math::StorePtrU(math::simd_float4::LoadPtr(vk0), out);
+    }
+    for (int i = num_full_soa_tracks * 4; i < num_tracks; ++i) {
+      *(out++) = *(vk0++);
+    }
+  } else {
+    // Lerp relevant keys.
+    const float tk0 = ratios[id0];
+    const float tk1 = ratios[id1];
+    assert(clamped_ratio >= tk0 && clamped_ratio < tk1 && tk0 != tk1);
+    const float alpha = (clamped_ratio - tk0) / (tk1 - tk0);
+    const math::SimdFloat4 simd_alpha = math::simd_float4::Load1(alpha);
+    const float* vk1 = vk0 + num_soa_tracks * 4;
+    for (int i = 0; i < num_full_soa_tracks;
+         ++i, vk0 += 4, vk1 += 4, out += 4) {
+      math::StorePtrU(math::Lerp(math::simd_float4::LoadPtr(vk0),
+                                 math::simd_float4::LoadPtr(vk1), simd_alpha),
+                      out);
+    }
+    if (num_full_soa_tracks != num_soa_tracks) {
+      float remaining[4];
+      math::StorePtrU(math::Lerp(math::simd_float4::LoadPtr(vk0),
+                                 math::simd_float4::LoadPtr(vk1), simd_alpha),
+                      remaining);
+      for (int i = num_full_soa_tracks * 4; i < num_tracks; ++i) {
+        *(out++) = remaining[i & 3];
+      }
+    }
+  }
+  return true;
+}
 }  // namespace animation
 }  // namespace ozz
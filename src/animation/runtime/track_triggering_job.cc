@@ -27,6 +27,7 @@
 
 #include "ozz/animation/runtime/track_triggering_job.h"
 #include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_edges.h"
 
 #include <algorithm>
 #include <cassert>
@@ -35,11 +36,16 @@ namespace ozz {
 namespace animation {
 
 TrackTriggeringJob::TrackTriggeringJob()
-    : from(0.f), to(0.f), threshold(0.f), track(nullptr), iterator(nullptr) {}
+    : from(0.f),
+      to(0.f),
+      threshold(0.f),
+      track(nullptr),
+      edges(nullptr),
+      iterator(nullptr) {}
 
 bool TrackTriggeringJob::Validate() const {
   bool valid = true;
-  valid &= track != nullptr;
+  valid &= track != nullptr || edges != nullptr;
   valid &= iterator != nullptr;
   return valid;
 }
@@ -107,6 +113,29 @@ inline bool DetectEdge(ptrdiff_t _i0, ptrdiff_t _i1, bool _forward,
   }
   return detected;
 }
+
+// Finds the index of the first precomputed edge whose ratio isn't before
+// _ratio, in _outer loop space.
+inline ptrdiff_t LowerBoundEdge(const TrackEdges& _edges, float _outer,
+                                float _ratio) {
+  const span<const float>& ratios = _edges.ratios();
+  ptrdiff_t first = 0;
+  ptrdiff_t count = ratios.size();
+  while (count > 0) {
+    const ptrdiff_t step = count / 2;
+    if (ratios[first + step] + _outer < _ratio) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
+inline bool IsRisingEdge(const TrackEdges& _edges, ptrdiff_t _i) {
+  return (_edges.risings()[_i / 8] & (1 << (_i & 7))) != 0;
+}
 }  // namespace
 
 TrackTriggeringJob::Iterator::Iterator(const TrackTriggeringJob* _job)
@@ -114,6 +143,17 @@ TrackTriggeringJob::Iterator::Iterator(const TrackTriggeringJob* _job)
   // Outer loop initialization.
   outer_ = floorf(job_->from);
 
+  if (job_->edges) {
+    // Edges are sorted, so the first edge can be searched directly. Backward,
+    // it's the last edge before "from".
+    const ptrdiff_t first = LowerBoundEdge(*job_->edges, outer_, job_->from);
+    inner_ = job_->from < job_->to ? first : first - 1;
+
+    // Evaluates first edge.
+    ++*this;
+    return;
+  }
+
   // Search could start more closely to the "from" ratio, but it's not possible
   // to ensure that floating point precision will not lead to missing a key
   // (when from/to range is far from 0). This is less good in algorithmic
@@ -129,6 +169,10 @@ TrackTriggeringJob::Iterator::Iterator(const TrackTriggeringJob* _job)
 const TrackTriggeringJob::Iterator& TrackTriggeringJob::Iterator::operator++() {
   assert(*this != job_->end() && "Can't increment end iterator.");
 
+  if (job_->edges) {
+    return IncrementEdges();
+  }
+
   const span<const float>& ratios = job_->track->ratios();
   const ptrdiff_t num_keys = ratios.size();
 
@@ -177,5 +221,51 @@ const TrackTriggeringJob::Iterator& TrackTriggeringJob::Iterator::operator++() {
 
   return *this;
 }
+
+const TrackTriggeringJob::Iterator&
+TrackTriggeringJob::Iterator::IncrementEdges() {
+  const TrackEdges& edges = *job_->edges;
+  const span<const float>& ratios = edges.ratios();
+  const ptrdiff_t num_edges = ratios.size();
+
+  if (job_->to > job_->from) {
+    for (; outer_ < job_->to; outer_ += 1.f) {
+      for (; inner_ < num_edges; ++inner_) {
+        const float ratio = ratios[inner_] + outer_;
+        if (ratio >= job_->to && job_->to < 1.f + outer_) {
+          break;  // Won't find any further edge.
+        }
+        if (ratio >= job_->from) {
+          edge_.ratio = ratio;
+          edge_.rising = IsRisingEdge(edges, inner_);
+          ++inner_;
+          return *this;  // Yield found edge.
+        }
+      }
+      inner_ = 0;  // Ready for next loop.
+    }
+  } else {
+    for (; outer_ + 1.f > job_->to; outer_ -= 1.f) {
+      for (; inner_ >= 0; --inner_) {
+        const float ratio = ratios[inner_] + outer_;
+        if (ratio < job_->to) {
+          break;  // Won't find any further edge.
+        }
+        if (ratio < job_->from || job_->from >= 1.f + outer_) {
+          edge_.ratio = ratio;
+          edge_.rising = !IsRisingEdge(edges, inner_);
+          --inner_;
+          return *this;  // Yield found edge.
+        }
+      }
+      inner_ = num_edges - 1;  // Ready for next loop.
+    }
+  }
+
+  // Set iterator to end position.
+  *this = job_->end();
+
+  return *this;
+}
 }  // namespace animation
 }  // namespace ozz
@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/base/memory/tracking_allocator.h"
+
+#include <cassert>
+
+#include "ozz/base/maths/math_ex.h"
+
+namespace ozz {
+namespace memory {
+
+namespace {
+// Tag of the current thread.
+thread_local Tag g_current_tag = kUntagged;
+
+// Header stored before every tracked block, to retrieve its size and tag on
+// deallocation.
+struct TrackingHeader {
+  void* block;  // Block allocated by the forwarded allocator.
+  size_t size;
+  Tag tag;
+};
+}  // namespace
+
+const char* TagName(Tag _tag) {
+  static const char* const kNames[] = {"untagged", "animation", "skeleton",
+                                       "track",    "cache",     "builder"};
+  static_assert(OZZ_ARRAY_SIZE(kNames) == kTagCount,
+                "Tag names count mismatch.");
+  if (_tag < 0 || _tag >= kTagCount) {
+    return nullptr;
+  }
+  return kNames[_tag];
+}
+
+Tag current_tag() { return g_current_tag; }
+
+ScopedTag::ScopedTag(Tag _tag) : previous_(g_current_tag) {
+  assert(_tag >= 0 && _tag < kTagCount);
+  g_current_tag = _tag;
+}
+
+ScopedTag::~ScopedTag() { g_current_tag = previous_; }
+
+TrackingAllocator::TrackingAllocator(Allocator* _allocator)
+    : allocator_(_allocator) {
+  assert(_allocator && _allocator != this);
+  for (int i = 0; i < kTagCount; ++i) {
+    tags_[i].bytes.store(0);
+    tags_[i].peak_bytes.store(0);
+    tags_[i].blocks.store(0);
+    tags_[i].allocations.store(0);
+  }
+  total_.bytes.store(0);
+  total_.peak_bytes.store(0);
+  total_.blocks.store(0);
+  total_.allocations.store(0);
+}
+
+TrackingAllocator::~TrackingAllocator() {
+  assert(total_.blocks.load() == 0 && "Memory leak detected");
+}
+
+void* TrackingAllocator::Allocate(size_t _size, size_t _alignment) {
+  // Header is stored right before the returned block, offset keeps block
+  // alignment.
+  const size_t alignment = math::Max(_alignment, alignof(TrackingHeader));
+  const size_t offset = Align(sizeof(TrackingHeader), alignment);
+  char* block =
+      reinterpret_cast<char*>(allocator_->Allocate(_size + offset, alignment));
+  if (!block) {
+    return nullptr;
+  }
+  char* aligned = block + offset;
+  assert(IsAligned(aligned, _alignment));
+
+  const Tag tag = g_current_tag;
+  TrackingHeader* header =
+      reinterpret_cast<TrackingHeader*>(aligned - sizeof(TrackingHeader));
+  header->block = block;
+  header->size = _size;
+  header->tag = tag;
+
+  Track(&tags_[tag], _size);
+  Track(&total_, _size);
+
+  return aligned;
+}
+
+void TrackingAllocator::Deallocate(void* _block) {
+  if (!_block) {
+    return;
+  }
+  const TrackingHeader* header = reinterpret_cast<const TrackingHeader*>(
+      reinterpret_cast<char*>(_block) - sizeof(TrackingHeader));
+  Untrack(&tags_[header->tag], header->size);
+  Untrack(&total_, header->size);
+  allocator_->Deallocate(header->block);
+}
+
+TrackingAllocator::Statistics TrackingAllocator::statistics(Tag _tag) const {
+  assert(_tag >= 0 && _tag < kTagCount);
+  return Read(tags_[_tag]);
+}
+
+TrackingAllocator::Statistics TrackingAllocator::total() const {
+  return Read(total_);
+}
+
+void TrackingAllocator::ResetPeaks() {
+  for (int i = 0; i < kTagCount; ++i) {
+    tags_[i].peak_bytes.store(tags_[i].bytes.load());
+  }
+  total_.peak_bytes.store(total_.bytes.load());
+}
+
+void TrackingAllocator::Track(Counters* _counters, size_t _size) {
+  const size_t bytes = _counters->bytes.fetch_add(_size) + _size;
+  ++_counters->blocks;
+  ++_counters->allocations;
+
+  // Updates high-water mark, which might have been concurrently updated.
+  size_t peak = _counters->peak_bytes.load();
+  while (bytes > peak &&
+         !_counters->peak_bytes.compare_exchange_weak(peak, bytes)) {
+  }
+}
+
+void TrackingAllocator::Untrack(Counters* _counters, size_t _size) {
+  assert(_counters->bytes.load() >= _size && _counters->blocks.load() > 0);
+  _counters->bytes.fetch_sub(_size);
+  --_counters->blocks;
+}
+
+TrackingAllocator::Statistics TrackingAllocator::Read(
+    const Counters& _counters) {
+  Statistics statistics;
+  statistics.bytes = _counters.bytes.load();
+  statistics.peak_bytes = _counters.peak_bytes.load();
+  statistics.blocks = _counters.blocks.load();
+  statistics.allocations = _counters.allocations.load();
+  return statistics;
+}
+}  // namespace memory
+}  // namespace ozz
@@ -30,21 +30,31 @@
 #include "gtest/gtest.h"
 
 #include "ozz/base/maths/math_constant.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/transform.h"
 
+#include "ozz/base/memory/tracking_allocator.h"
 #include "ozz/base/memory/unique_ptr.h"
 
 #include "ozz/animation/offline/animation_builder.h"
 #include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_animation_utils.h"
 
 #include "ozz/animation/offline/raw_skeleton.h"
 #include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/offline/task_runner.h"
 #include "ozz/animation/runtime/skeleton.h"
 
+#include <cmath>
+
 using ozz::animation::Skeleton;
 using ozz::animation::offline::AnimationOptimizer;
 using ozz::animation::offline::RawAnimation;
 using ozz::animation::offline::RawSkeleton;
 using ozz::animation::offline::SkeletonBuilder;
+using ozz::animation::offline::Task;
+using ozz::animation::offline::TaskRunner;
+using ozz::animation::offline::ThreadedTaskRunner;
 
 TEST(Error, AnimationOptimizer) {
   AnimationOptimizer optimizer;
@@ -670,3 +680,318 @@ TEST(OptimizeOverride, AnimationOptimizer) {
     input.tracks[4].scales.clear();
   }
 }
+
+namespace {
+// Executes tasks sequentially, in reverse order, to check output doesn't depend
+// on execution order.
+class ReverseTaskRunner : public TaskRunner {
+ public:
+  ReverseTaskRunner() : runs(0) {}
+  virtual void Run(int _count, const Task& _task) {
+    ++runs;
+    for (int i = _count - 1; i >= 0; --i) {
+      _task.Execute(i);
+    }
+  }
+  int runs;
+};
+
+void ExpectEqual(const RawAnimation& _a, const RawAnimation& _b) {
+  ASSERT_EQ(_a.num_tracks(), _b.num_tracks());
+  for (int i = 0; i < _a.num_tracks(); ++i) {
+    const RawAnimation::JointTrack& a = _a.tracks[i];
+    const RawAnimation::JointTrack& b = _b.tracks[i];
+    ASSERT_EQ(a.translations.size(), b.translations.size());
+    for (size_t j = 0; j < a.translations.size(); ++j) {
+      EXPECT_EQ(a.translations[j].time, b.translations[j].time);
+      EXPECT_EQ(a.translations[j].value.x, b.translations[j].value.x);
+    }
+    ASSERT_EQ(a.rotations.size(), b.rotations.size());
+    for (size_t j = 0; j < a.rotations.size(); ++j) {
+      EXPECT_EQ(a.rotations[j].time, b.rotations[j].time);
+      EXPECT_EQ(a.rotations[j].value.w, b.rotations[j].value.w);
+    }
+    ASSERT_EQ(a.scales.size(), b.scales.size());
+    for (size_t j = 0; j < a.scales.size(); ++j) {
+      EXPECT_EQ(a.scales[j].time, b.scales[j].time);
+      EXPECT_EQ(a.scales[j].value.y, b.scales[j].value.y);
+    }
+  }
+}
+
+// Builds a chain skeleton.
+ozz::unique_ptr<Skeleton> BuildChainSkeleton(int _num_joints) {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint* joint = &raw_skeleton.roots[0];
+  for (int i = 1; i < _num_joints; ++i) {
+    joint->children.resize(1);
+    joint = &joint->children[0];
+  }
+  SkeletonBuilder skeleton_builder;
+  return skeleton_builder(raw_skeleton);
+}
+
+// Builds an animation with noisy keys, so that only a part of them are
+// optimized.
+void BuildNoisyAnimation(int _num_tracks, int _num_keys,
+                         RawAnimation* _animation) {
+  _animation->duration = 1.f;
+  _animation->tracks.resize(_num_tracks);
+  for (int i = 0; i < _num_tracks; ++i) {
+    RawAnimation::JointTrack& track = _animation->tracks[i];
+    for (int k = 0; k < _num_keys; ++k) {
+      const float time = static_cast<float>(k) / (_num_keys - 1);
+      const float phase = time * (i + 1) * 3.f;
+      const RawAnimation::TranslationKey tkey = {
+          time, ozz::math::Float3(1.f + std::sin(phase) * .1f,
+                                  std::cos(phase * 7.f) * .01f, 0.f)};
+      track.translations.push_back(tkey);
+      const RawAnimation::RotationKey rkey = {
+          time, ozz::math::Quaternion::FromAxisAngle(
+                    ozz::math::Float3::y_axis(), std::sin(phase * 2.f))};
+      track.rotations.push_back(rkey);
+      const RawAnimation::ScaleKey skey = {
+          time, ozz::math::Float3(1.f, 1.f + std::sin(phase * 5.f) * .1f, 1.f)};
+      track.scales.push_back(skey);
+    }
+  }
+}
+}  // namespace
+
+TEST(TaskRunner, AnimationOptimizer) {
+  ozz::unique_ptr<Skeleton> skeleton(BuildChainSkeleton(16));
+  ASSERT_TRUE(skeleton);
+
+  RawAnimation input;
+  BuildNoisyAnimation(skeleton->num_joints(), 101, &input);
+  ASSERT_TRUE(input.Validate());
+
+  AnimationOptimizer optimizer;
+  EXPECT_TRUE(optimizer.task_runner == nullptr);
+
+  RawAnimation reference;
+  ASSERT_TRUE(optimizer(input, *skeleton, &reference));
+  EXPECT_LT(reference.tracks[0].translations.size(),
+            input.tracks[0].translations.size());
+
+  // Custom runner.
+  {
+    ReverseTaskRunner runner;
+    optimizer.task_runner = &runner;
+    RawAnimation output;
+    ASSERT_TRUE(optimizer(input, *skeleton, &output));
+    EXPECT_EQ(runner.runs, 1);
+    ExpectEqual(reference, output);
+  }
+
+  // Threaded runners, output must not depend on the number of threads.
+  const int num_threads[] = {0, 1, 2, 7, 64};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(num_threads); ++i) {
+    ThreadedTaskRunner runner(num_threads[i]);
+    EXPECT_GE(runner.num_threads(), 1);
+    optimizer.task_runner = &runner;
+    RawAnimation output;
+    ASSERT_TRUE(optimizer(input, *skeleton, &output));
+    ExpectEqual(reference, output);
+  }
+}
+
+TEST(MemoryTag, AnimationOptimizer) {
+  ozz::unique_ptr<Skeleton> skeleton(BuildChainSkeleton(16));
+  ASSERT_TRUE(skeleton);
+
+  RawAnimation input;
+  BuildNoisyAnimation(skeleton->num_joints(), 101, &input);
+  ASSERT_TRUE(input.Validate());
+
+  // Allocations done by optimizer tasks on worker threads are accounted as
+  // builder allocations.
+  ozz::memory::TrackingAllocator tracking(ozz::memory::default_allocator());
+  ozz::memory::Allocator* previous =
+      ozz::memory::SetDefaulAllocator(&tracking);
+  {
+    ThreadedTaskRunner runner(4);
+    AnimationOptimizer optimizer;
+    optimizer.task_runner = &runner;
+    RawAnimation output;
+    ASSERT_TRUE(optimizer(input, *skeleton, &output));
+
+    EXPECT_GT(tracking.statistics(ozz::memory::kBuilder).allocations, 0u);
+    EXPECT_EQ(tracking.statistics(ozz::memory::kUntagged).allocations, 0u);
+  }
+  EXPECT_EQ(tracking.total().blocks, 0u);
+  EXPECT_EQ(ozz::memory::SetDefaulAllocator(previous), &tracking);
+}
+
+TEST(Algorithms, AnimationOptimizer) {
+  ozz::unique_ptr<Skeleton> skeleton(BuildChainSkeleton(16));
+  ASSERT_TRUE(skeleton);
+
+  RawAnimation input;
+  BuildNoisyAnimation(skeleton->num_joints(), 1001, &input);
+  ASSERT_TRUE(input.Validate());
+
+  AnimationOptimizer optimizer;
+  EXPECT_EQ(optimizer.algorithm,
+            ozz::animation::offline::kRamerDouglasPeucker);
+  RawAnimation reference;
+  ASSERT_TRUE(optimizer(input, *skeleton, &reference));
+  EXPECT_LT(reference.tracks[0].rotations.size(),
+            input.tracks[0].rotations.size());
+
+  // Simd implementation selects the same keys.
+  optimizer.algorithm = ozz::animation::offline::kRamerDouglasPeuckerSimd;
+  RawAnimation output;
+  ASSERT_TRUE(optimizer(input, *skeleton, &output));
+  ExpectEqual(reference, output);
+}
+
+namespace {
+// Computes the maximum model-space error between _a and _b animations, at all
+// _reference keyframe times. Error is measured at _distance from each joint.
+float ModelSpaceError(const RawAnimation& _reference, const RawAnimation& _a,
+                      const RawAnimation& _b, const Skeleton& _skeleton,
+                      float _distance) {
+  const int num_joints = _skeleton.num_joints();
+  ozz::vector<ozz::math::Transform> locals_a(num_joints);
+  ozz::vector<ozz::math::Transform> locals_b(num_joints);
+  ozz::vector<ozz::math::Float4x4> models_a(num_joints);
+  ozz::vector<ozz::math::Float4x4> models_b(num_joints);
+  const ozz::math::SimdFloat4 points[] = {
+      ozz::math::simd_float4::zero(),
+      ozz::math::simd_float4::Load(_distance, 0.f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, _distance, 0.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, 0.f, _distance, 0.f)};
+
+  float error = 0.f;
+  for (const RawAnimation::JointTrack& track : _reference.tracks) {
+    for (const RawAnimation::TranslationKey& key : track.translations) {
+      EXPECT_TRUE(ozz::animation::offline::SampleAnimation(
+          _a, key.time, ozz::make_span(locals_a)));
+      EXPECT_TRUE(ozz::animation::offline::SampleAnimation(
+          _b, key.time, ozz::make_span(locals_b)));
+      for (int i = 0; i < num_joints; ++i) {
+        const ozz::math::Transform& a = locals_a[i];
+        const ozz::math::Transform& b = locals_b[i];
+        models_a[i] = ozz::math::Float4x4::FromAffine(
+            ozz::math::simd_float4::Load3PtrU(&a.translation.x),
+            ozz::math::simd_float4::LoadPtrU(&a.rotation.x),
+            ozz::math::simd_float4::Load3PtrU(&a.scale.x));
+        models_b[i] = ozz::math::Float4x4::FromAffine(
+            ozz::math::simd_float4::Load3PtrU(&b.translation.x),
+            ozz::math::simd_float4::LoadPtrU(&b.rotation.x),
+            ozz::math::simd_float4::Load3PtrU(&b.scale.x));
+        const int parent = _skeleton.joint_parents()[i];
+        if (parent != Skeleton::kNoParent) {
+          models_a[i] = models_a[parent] * models_a[i];
+          models_b[i] = models_b[parent] * models_b[i];
+        }
+        for (size_t p = 0; p < OZZ_ARRAY_SIZE(points); ++p) {
+          const ozz::math::SimdFloat4 diff =
+              TransformPoint(models_a[i], points[p]) -
+              TransformPoint(models_b[i], points[p]);
+          error = ozz::math::Max(error,
+                                 ozz::math::GetX(ozz::math::Length3(diff)));
+        }
+      }
+    }
+  }
+  return error;
+}
+
+size_t CountKeys(const RawAnimation& _animation) {
+  size_t count = 0;
+  for (const RawAnimation::JointTrack& track : _animation.tracks) {
+    count += track.translations.size() + track.rotations.size() +
+             track.scales.size();
+  }
+  return count;
+}
+}  // namespace
+
+TEST(ModelSpace, AnimationOptimizer) {
+  ozz::unique_ptr<Skeleton> skeleton(BuildChainSkeleton(8));
+  ASSERT_TRUE(skeleton);
+
+  RawAnimation input;
+  BuildNoisyAnimation(skeleton->num_joints(), 51, &input);
+  input.name = "model space";
+  ASSERT_TRUE(input.Validate());
+
+  AnimationOptimizer optimizer;
+  EXPECT_EQ(optimizer.mode, AnimationOptimizer::kHierarchical);
+  optimizer.setting.tolerance = .01f;
+  optimizer.setting.distance = .1f;
+
+  RawAnimation hierarchical;
+  ASSERT_TRUE(optimizer(input, *skeleton, &hierarchical));
+
+  optimizer.mode = AnimationOptimizer::kModelSpace;
+  RawAnimation model_space;
+  ASSERT_TRUE(optimizer(input, *skeleton, &model_space));
+  EXPECT_STREQ(model_space.name.c_str(), input.name.c_str());
+  EXPECT_EQ(model_space.duration, input.duration);
+  ASSERT_EQ(model_space.num_tracks(), input.num_tracks());
+
+  // Removes more keys than the conservative hierarchical mode.
+  EXPECT_LT(CountKeys(model_space), CountKeys(hierarchical));
+
+  // Tolerance is respected at every original keyframe time.
+  EXPECT_LE(ModelSpaceError(input, input, model_space, *skeleton,
+                            optimizer.setting.distance),
+            optimizer.setting.tolerance * 1.0001f);
+
+  // Every channel keeps at least a key.
+  for (const RawAnimation::JointTrack& track : model_space.tracks) {
+    EXPECT_GE(track.translations.size(), 1u);
+    EXPECT_GE(track.rotations.size(), 1u);
+    EXPECT_GE(track.scales.size(), 1u);
+  }
+
+  // Output doesn't depend on the task runner.
+  {
+    ThreadedTaskRunner runner(3);
+    optimizer.task_runner = &runner;
+    RawAnimation output;
+    ASSERT_TRUE(optimizer(input, *skeleton, &output));
+    ExpectEqual(model_space, output);
+    optimizer.task_runner = nullptr;
+  }
+
+  // Zero tolerance only removes keys that generate no error.
+  {
+    optimizer.setting.tolerance = 0.f;
+    RawAnimation output;
+    ASSERT_TRUE(optimizer(input, *skeleton, &output));
+    EXPECT_EQ(ModelSpaceError(input, input, output, *skeleton,
+                              optimizer.setting.distance),
+              0.f);
+  }
+}
+
+TEST(ModelSpaceOverride, AnimationOptimizer) {
+  ozz::unique_ptr<Skeleton> skeleton(BuildChainSkeleton(4));
+  ASSERT_TRUE(skeleton);
+
+  RawAnimation input;
+  BuildNoisyAnimation(skeleton->num_joints(), 51, &input);
+  ASSERT_TRUE(input.Validate());
+
+  AnimationOptimizer optimizer;
+  optimizer.mode = AnimationOptimizer::kModelSpace;
+  optimizer.setting.tolerance = .1f;
+
+  RawAnimation loose;
+  ASSERT_TRUE(optimizer(input, *skeleton, &loose));
+
+  // Overriding last joint tolerance constrains all its ancestors.
+  optimizer.joints_setting_override[3] = AnimationOptimizer::Setting(0.f, .1f);
+  RawAnimation strict;
+  ASSERT_TRUE(optimizer(input, *skeleton, &strict));
+  EXPECT_GT(CountKeys(strict), CountKeys(loose));
+  for (int i = 0; i < skeleton->num_joints(); ++i) {
+    EXPECT_EQ(strict.tracks[i].rotations.size(),
+              input.tracks[i].rotations.size());
+  }
+}
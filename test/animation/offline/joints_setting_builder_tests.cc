@@ -0,0 +1,183 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/offline/joints_setting_builder.h"
+
+#include "gtest/gtest.h"
+
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::Skeleton;
+using ozz::animation::offline::AnimationOptimizer;
+using ozz::animation::offline::JointsSettingBuilder;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+
+namespace {
+// Builds root -> a -> b skinned chain, plus root -> c unskinned joint. Every
+// joint is 1m above its parent.
+ozz::unique_ptr<Skeleton> BuildSkeleton() {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.name = "root";
+  root.transform = ozz::math::Transform::identity();
+  root.children.resize(2);
+  RawSkeleton::Joint& a = root.children[0];
+  a.name = "joint_a";
+  a.transform = ozz::math::Transform::identity();
+  a.transform.translation = ozz::math::Float3(0.f, 1.f, 0.f);
+  a.children.resize(1);
+  RawSkeleton::Joint& b = a.children[0];
+  b.name = "joint_b";
+  b.transform = a.transform;
+  RawSkeleton::Joint& c = root.children[1];
+  c.name = "joint_c";
+  c.transform = a.transform;
+
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+}  // namespace
+
+TEST(Error, JointsSettingBuilder) {
+  ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 4);
+
+  const ozz::math::Float3 positions[] = {ozz::math::Float3(0.f, 1.5f, 0.f)};
+  const uint16_t joints[] = {1, 2};
+  const float weights[] = {.5f, .5f};
+  const uint16_t invalid_joints[] = {1, 4};
+
+  JointsSettingBuilder builder;
+  AnimationOptimizer::JointsSetting settings;
+
+  {  // No output.
+    JointsSettingBuilder::Mesh mesh;
+    EXPECT_FALSE(builder(
+        *skeleton, ozz::span<const JointsSettingBuilder::Mesh>(&mesh, 1),
+        nullptr));
+  }
+
+  {  // Mismatching buffer sizes.
+    settings[0] = AnimationOptimizer::Setting();
+    JointsSettingBuilder::Mesh mesh;
+    mesh.positions = ozz::make_span(positions);
+    mesh.influences = 1;
+    mesh.joint_indices = ozz::make_span(joints);
+    mesh.joint_weights = ozz::make_span(weights);
+    EXPECT_FALSE(builder(
+        *skeleton, ozz::span<const JointsSettingBuilder::Mesh>(&mesh, 1),
+        &settings));
+    EXPECT_TRUE(settings.empty());
+
+    mesh.influences = 0;
+    EXPECT_FALSE(builder(
+        *skeleton, ozz::span<const JointsSettingBuilder::Mesh>(&mesh, 1),
+        &settings));
+  }
+
+  {  // Invalid joint index.
+    JointsSettingBuilder::Mesh mesh;
+    mesh.positions = ozz::make_span(positions);
+    mesh.influences = 2;
+    mesh.joint_indices = ozz::make_span(invalid_joints);
+    mesh.joint_weights = ozz::make_span(weights);
+    EXPECT_FALSE(builder(
+        *skeleton, ozz::span<const JointsSettingBuilder::Mesh>(&mesh, 1),
+        &settings));
+  }
+
+  {  // No mesh, every joint is unskinned.
+    EXPECT_TRUE(builder(
+        *skeleton, ozz::span<const JointsSettingBuilder::Mesh>(), &settings));
+    ASSERT_EQ(settings.size(), 4u);
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_FLOAT_EQ(settings[i].tolerance, builder.unskinned.tolerance);
+      EXPECT_FLOAT_EQ(settings[i].distance, builder.unskinned.distance);
+    }
+  }
+}
+
+TEST(Build, JointsSettingBuilder) {
+  ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+  ASSERT_TRUE(skeleton);
+
+  // Joints are root (0), a (1), b (2) and c (3). a is at 1m, b at 2m.
+  const ozz::math::Float3 positions0[] = {ozz::math::Float3(0.f, 1.5f, 0.f),
+                                          ozz::math::Float3(0.f, 4.f, 0.f)};
+  const uint16_t joints0[] = {1, 0, 2, 1};
+  const float weights0[] = {1.f, 0.f, .25f, .75f};
+
+  const ozz::math::Float3 positions1[] = {ozz::math::Float3(3.f, 1.f, 0.f)};
+  const uint16_t joints1[] = {1};
+  const float weights1[] = {.5f};
+
+  JointsSettingBuilder::Mesh meshes[2];
+  meshes[0].positions = ozz::make_span(positions0);
+  meshes[0].influences = 2;
+  meshes[0].joint_indices = ozz::make_span(joints0);
+  meshes[0].joint_weights = ozz::make_span(weights0);
+  meshes[1].positions = ozz::make_span(positions1);
+  meshes[1].influences = 1;
+  meshes[1].joint_indices = ozz::make_span(joints1);
+  meshes[1].joint_weights = ozz::make_span(weights1);
+
+  JointsSettingBuilder builder;
+  builder.tolerance = 2e-3f;
+  builder.unskinned = AnimationOptimizer::Setting(1e-1f, 0.f);
+
+  AnimationOptimizer::JointsSetting settings;
+  ASSERT_TRUE(builder(*skeleton, ozz::make_span(meshes), &settings));
+  ASSERT_EQ(settings.size(), 4u);
+
+  // Root doesn't influence any vertex (null weight is ignored), but its
+  // descendants do.
+  EXPECT_FLOAT_EQ(settings[0].tolerance, 2e-3f);
+  EXPECT_FLOAT_EQ(settings[0].distance, 0.f);
+
+  // a farthest weighted vertex is 3m * .75, from first mesh.
+  EXPECT_FLOAT_EQ(settings[1].tolerance, 2e-3f);
+  EXPECT_FLOAT_EQ(settings[1].distance, 2.25f);
+
+  // b farthest weighted vertex is 2m * .25.
+  EXPECT_FLOAT_EQ(settings[2].tolerance, 2e-3f);
+  EXPECT_FLOAT_EQ(settings[2].distance, .5f);
+
+  // c is unskinned.
+  EXPECT_FLOAT_EQ(settings[3].tolerance, 1e-1f);
+  EXPECT_FLOAT_EQ(settings[3].distance, 0.f);
+
+  // Settings can be used as optimizer overrides.
+  AnimationOptimizer optimizer;
+  optimizer.joints_setting_override = settings;
+  EXPECT_EQ(optimizer.joints_setting_override.size(), 4u);
+}
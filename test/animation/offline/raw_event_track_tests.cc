@@ -0,0 +1,139 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/offline/raw_event_track.h"
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/event_track.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::EventTrack;
+using ozz::animation::offline::RawEventTrack;
+using ozz::animation::offline::TrackBuilder;
+
+TEST(Validate, RawEventTrack) {
+  RawEventTrack raw_track;
+  EXPECT_TRUE(raw_track.Validate());
+
+  {  // Out of range.
+    RawEventTrack invalid;
+    const RawEventTrack::Event event = {1.5f, 0};
+    invalid.events.push_back(event);
+    EXPECT_FALSE(invalid.Validate());
+  }
+
+  {  // Unsorted.
+    RawEventTrack invalid;
+    const RawEventTrack::Event event0 = {.5f, 0};
+    invalid.events.push_back(event0);
+    const RawEventTrack::Event event1 = {.2f, 1};
+    invalid.events.push_back(event1);
+    EXPECT_FALSE(invalid.Validate());
+  }
+
+  {  // Events sharing the same ratio.
+    RawEventTrack valid;
+    const RawEventTrack::Event event0 = {0.f, 0};
+    valid.events.push_back(event0);
+    const RawEventTrack::Event event1 = {0.f, 1};
+    valid.events.push_back(event1);
+    const RawEventTrack::Event event2 = {1.f, 2};
+    valid.events.push_back(event2);
+    EXPECT_TRUE(valid.Validate());
+  }
+}
+
+TEST(Build, RawEventTrack) {
+  TrackBuilder builder;
+
+  {  // Invalid.
+    RawEventTrack invalid;
+    const RawEventTrack::Event event = {-.5f, 0};
+    invalid.events.push_back(event);
+    EXPECT_FALSE(builder(invalid));
+  }
+
+  {  // Empty.
+    RawEventTrack raw_track;
+    ozz::unique_ptr<EventTrack> track(builder(raw_track));
+    ASSERT_TRUE(track);
+    EXPECT_EQ(track->num_events(), 0u);
+    EXPECT_STREQ(track->name(), "");
+  }
+
+  RawEventTrack raw_track;
+  raw_track.name = "footsteps";
+  const RawEventTrack::Event event0 = {.2f, 46};
+  raw_track.events.push_back(event0);
+  const RawEventTrack::Event event1 = {.7f, 93};
+  raw_track.events.push_back(event1);
+
+  ozz::unique_ptr<EventTrack> track(builder(raw_track));
+  ASSERT_TRUE(track);
+  EXPECT_STREQ(track->name(), "footsteps");
+  ASSERT_EQ(track->num_events(), 2u);
+  EXPECT_FLOAT_EQ(track->ratios()[0], .2f);
+  EXPECT_EQ(track->ids()[0], 46);
+  EXPECT_FLOAT_EQ(track->ratios()[1], .7f);
+  EXPECT_EQ(track->ids()[1], 93);
+}
+
+TEST(Serialize, RawEventTrack) {
+  RawEventTrack o_track;
+  o_track.name = "test track";
+  const RawEventTrack::Event event0 = {.5f, 46};
+  o_track.events.push_back(event0);
+  const RawEventTrack::Event event1 = {.7f, 65535};
+  o_track.events.push_back(event1);
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << o_track;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive ia(&stream);
+
+    RawEventTrack i_track;
+    ia >> i_track;
+
+    EXPECT_TRUE(i_track.Validate());
+    EXPECT_STREQ(o_track.name.c_str(), i_track.name.c_str());
+    ASSERT_EQ(o_track.events.size(), i_track.events.size());
+    for (size_t i = 0; i < o_track.events.size(); ++i) {
+      EXPECT_FLOAT_EQ(o_track.events[i].ratio, i_track.events[i].ratio);
+      EXPECT_EQ(o_track.events[i].id, i_track.events[i].id);
+    }
+  }
+}
@@ -105,6 +105,45 @@ TEST(Filled, RawAnimationSerialize) {
   }
 }
 
+TEST(Cubic, RawAnimationSerialize) {
+  RawFloatTrack o_track;
+
+  const RawFloatTrack::Keyframe first_key = {RawTrackInterpolation::kCubic,
+                                             .5f, 46.f, 1.f, 2.f};
+  o_track.keyframes.push_back(first_key);
+  const RawFloatTrack::Keyframe second_key = {RawTrackInterpolation::kLinear,
+                                              .7f, 0.f, 3.f, 4.f};
+  o_track.keyframes.push_back(second_key);
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << o_track;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive ia(&stream);
+
+    RawFloatTrack i_track;
+    ia >> i_track;
+
+    ASSERT_EQ(i_track.keyframes.size(), 2u);
+    EXPECT_EQ(i_track.keyframes[0].interpolation,
+              RawTrackInterpolation::kCubic);
+    EXPECT_FLOAT_EQ(i_track.keyframes[0].in_tangent, 1.f);
+    EXPECT_FLOAT_EQ(i_track.keyframes[0].out_tangent, 2.f);
+
+    // Only cubic keys tangents are serialized.
+    EXPECT_EQ(i_track.keyframes[1].interpolation,
+              RawTrackInterpolation::kLinear);
+    EXPECT_FLOAT_EQ(i_track.keyframes[1].in_tangent, 0.f);
+    EXPECT_FLOAT_EQ(i_track.keyframes[1].out_tangent, 0.f);
+  }
+}
+
 TEST(AlreadyInitialized, RawAnimationSerialize) {
   RawFloatTrack o_track;
 
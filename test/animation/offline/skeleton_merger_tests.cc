@@ -0,0 +1,340 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/offline/skeleton_merger.h"
+
+#include "gtest/gtest.h"
+
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::Animation;
+using ozz::animation::LocalToModelJob;
+using ozz::animation::SamplingCache;
+using ozz::animation::SamplingJob;
+using ozz::animation::Skeleton;
+using ozz::animation::offline::AnimationBuilder;
+using ozz::animation::offline::RawAnimation;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+using ozz::animation::offline::SkeletonMerger;
+
+namespace {
+// Builds a skeleton made of a chain of joints, each one translated by
+// _translation from its parent.
+ozz::unique_ptr<Skeleton> BuildChain(const char* const* _names, int _count,
+                                     const ozz::math::Float3& _translation) {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint* joint = &raw_skeleton.roots[0];
+  for (int i = 0; i < _count; ++i) {
+    joint->name = _names[i];
+    joint->transform = ozz::math::Transform::identity();
+    joint->transform.translation = _translation;
+    if (i != _count - 1) {
+      joint->children.resize(1);
+      joint = &joint->children[0];
+    }
+  }
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+
+// Builds root -> spine -> hand, and spine -> neck body skeleton.
+ozz::unique_ptr<Skeleton> BuildBody() {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.name = "root";
+  root.transform = ozz::math::Transform::identity();
+  root.children.resize(1);
+  RawSkeleton::Joint& spine = root.children[0];
+  spine.name = "spine";
+  spine.transform = ozz::math::Transform::identity();
+  spine.transform.translation = ozz::math::Float3(0.f, 1.f, 0.f);
+  spine.children.resize(2);
+  RawSkeleton::Joint& hand = spine.children[0];
+  hand.name = "hand";
+  hand.transform = ozz::math::Transform::identity();
+  hand.transform.translation = ozz::math::Float3(1.f, 0.f, 0.f);
+  RawSkeleton::Joint& neck = spine.children[1];
+  neck.name = "neck";
+  neck.transform = spine.transform;
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+}  // namespace
+
+TEST(Validity, SkeletonMerger) {
+  ozz::unique_ptr<Skeleton> body = BuildBody();
+  ASSERT_TRUE(body);
+  SkeletonMerger merger;
+  ozz::vector<SkeletonMerger::JointRemap> remaps;
+
+  {  // No part.
+    EXPECT_FALSE(merger({}, &remaps));
+    EXPECT_TRUE(remaps.empty());
+  }
+
+  SkeletonMerger::Part parts[2];
+  parts[0].skeleton = body.get();
+  parts[1].skeleton = body.get();
+  parts[1].parent = 0;
+  parts[1].joint = 3;
+
+  {  // No remap output.
+    EXPECT_FALSE(merger(parts, nullptr));
+  }
+
+  {  // Valid.
+    EXPECT_TRUE(merger(parts, &remaps));
+    EXPECT_EQ(remaps.size(), 2u);
+  }
+
+  {  // nullptr skeleton.
+    parts[1].skeleton = nullptr;
+    EXPECT_FALSE(merger(parts, &remaps));
+    EXPECT_TRUE(remaps.empty());
+    parts[1].skeleton = body.get();
+  }
+
+  {  // Attached to itself.
+    parts[1].parent = 1;
+    EXPECT_FALSE(merger(parts, &remaps));
+    parts[1].parent = 0;
+  }
+
+  {  // Attached to a following part.
+    parts[0].parent = 1;
+    EXPECT_FALSE(merger(parts, &remaps));
+    parts[0].parent = Skeleton::kNoParent;
+  }
+
+  {  // Invalid attachment joint.
+    parts[1].joint = 4;
+    EXPECT_FALSE(merger(parts, &remaps));
+    parts[1].joint = -1;
+    EXPECT_FALSE(merger(parts, &remaps));
+    parts[1].joint = 3;
+  }
+
+  {  // Too many joints.
+    RawSkeleton raw_skeleton;
+    raw_skeleton.roots.resize(Skeleton::kMaxJoints - 3);
+    SkeletonBuilder builder;
+    ozz::unique_ptr<Skeleton> big = builder(raw_skeleton);
+    ASSERT_TRUE(big);
+
+    parts[1].skeleton = big.get();
+    parts[1].parent = Skeleton::kNoParent;
+    EXPECT_FALSE(merger(parts, &remaps));
+    EXPECT_TRUE(remaps.empty());
+    EXPECT_TRUE(merger({parts + 1, 1}, &remaps));
+  }
+}
+
+TEST(Merge, SkeletonMerger) {
+  ozz::unique_ptr<Skeleton> body = BuildBody();
+  ASSERT_TRUE(body);
+  const char* head_names[] = {"head", "jaw"};
+  ozz::unique_ptr<Skeleton> head =
+      BuildChain(head_names, 2, ozz::math::Float3(0.f, .2f, 0.f));
+  ASSERT_TRUE(head);
+  const char* sword_names[] = {"blade"};
+  ozz::unique_ptr<Skeleton> sword =
+      BuildChain(sword_names, 1, ozz::math::Float3(.1f, 0.f, 0.f));
+  ASSERT_TRUE(sword);
+  const char* prop_names[] = {"prop"};
+  ozz::unique_ptr<Skeleton> prop =
+      BuildChain(prop_names, 1, ozz::math::Float3(0.f, 0.f, 5.f));
+  ASSERT_TRUE(prop);
+
+  // Head is attached to body neck, sword to body hand, and prop is a separate
+  // root.
+  SkeletonMerger::Part parts[4];
+  parts[0].skeleton = body.get();
+  parts[1].skeleton = head.get();
+  parts[1].parent = 0;
+  parts[1].joint = 3;
+  parts[2].skeleton = sword.get();
+  parts[2].parent = 0;
+  parts[2].joint = 2;
+  parts[3].skeleton = prop.get();
+
+  SkeletonMerger merger;
+  ozz::vector<SkeletonMerger::JointRemap> remaps;
+  ozz::unique_ptr<Skeleton> merged = merger(parts, &remaps);
+  ASSERT_TRUE(merged);
+  ASSERT_EQ(merged->num_joints(), 8);
+
+  const char* names[] = {"root", "spine", "hand", "blade",
+                         "neck", "head",  "jaw",  "prop"};
+  const int parents[] = {Skeleton::kNoParent, 0, 1, 2, 1, 4, 5,
+                         Skeleton::kNoParent};
+  for (int i = 0; i < merged->num_joints(); ++i) {
+    EXPECT_STREQ(merged->joint_names()[i], names[i]);
+    EXPECT_EQ(merged->joint_parents()[i], parents[i]);
+  }
+
+  ASSERT_EQ(remaps.size(), 4u);
+  const int body_remap[] = {0, 1, 2, 4};
+  ASSERT_EQ(remaps[0].size(), 4u);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(remaps[0][i], body_remap[i]);
+  }
+  ASSERT_EQ(remaps[1].size(), 2u);
+  EXPECT_EQ(remaps[1][0], 5);
+  EXPECT_EQ(remaps[1][1], 6);
+  ASSERT_EQ(remaps[2].size(), 1u);
+  EXPECT_EQ(remaps[2][0], 3);
+  ASSERT_EQ(remaps[3].size(), 1u);
+  EXPECT_EQ(remaps[3][0], 7);
+
+  // Bind poses are preserved, attached parts roots being relative to their
+  // attachment joint.
+  EXPECT_SOAFLOAT3_EQ(merged->joint_bind_poses()[0].translation, 0.f, 0.f, 1.f,
+                      .1f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+  EXPECT_SOAFLOAT3_EQ(merged->joint_bind_poses()[1].translation, 0.f, 0.f, 0.f,
+                      0.f, 1.f, .2f, .2f, 0.f, 0.f, 0.f, 0.f, 5.f);
+}
+
+TEST(MergeAnimation, SkeletonMerger) {
+  ozz::unique_ptr<Skeleton> body = BuildBody();
+  ASSERT_TRUE(body);
+  const char* head_names[] = {"head", "jaw"};
+  ozz::unique_ptr<Skeleton> head =
+      BuildChain(head_names, 2, ozz::math::Float3(0.f, .2f, 0.f));
+  ASSERT_TRUE(head);
+  const char* sword_names[] = {"blade"};
+  ozz::unique_ptr<Skeleton> sword =
+      BuildChain(sword_names, 1, ozz::math::Float3(.1f, 0.f, 0.f));
+  ASSERT_TRUE(sword);
+
+  SkeletonMerger::Part parts[3];
+  parts[0].skeleton = body.get();
+  parts[1].skeleton = head.get();
+  parts[1].parent = 0;
+  parts[1].joint = 3;
+  parts[2].skeleton = sword.get();
+  parts[2].parent = 0;
+  parts[2].joint = 2;
+
+  SkeletonMerger merger;
+  ozz::vector<SkeletonMerger::JointRemap> remaps;
+  ozz::unique_ptr<Skeleton> merged = merger(parts, &remaps);
+  ASSERT_TRUE(merged);
+  ASSERT_EQ(merged->num_joints(), 7);
+
+  // Body animation moves spine up, and sword animation moves blade along x.
+  // Head has no animation.
+  RawAnimation body_animation;
+  body_animation.name = "body";
+  body_animation.duration = 2.f;
+  body_animation.tracks.resize(4);
+  const RawAnimation::TranslationKey spine_key = {
+      0.f, ozz::math::Float3(0.f, 2.f, 0.f)};
+  body_animation.tracks[1].translations.push_back(spine_key);
+  const RawAnimation::TranslationKey hand_key = {
+      0.f, ozz::math::Float3(1.f, 0.f, 0.f)};
+  body_animation.tracks[2].translations.push_back(hand_key);
+  const RawAnimation::TranslationKey neck_key = {
+      0.f, ozz::math::Float3(0.f, 1.f, 0.f)};
+  body_animation.tracks[3].translations.push_back(neck_key);
+
+  RawAnimation sword_animation;
+  sword_animation.duration = 2.f;
+  sword_animation.tracks.resize(1);
+  const RawAnimation::TranslationKey blade_keys[] = {
+      {0.f, ozz::math::Float3(0.f, 0.f, 0.f)},
+      {2.f, ozz::math::Float3(1.f, 0.f, 0.f)}};
+  sword_animation.tracks[0].translations.assign(
+      blade_keys, blade_keys + OZZ_ARRAY_SIZE(blade_keys));
+
+  const RawAnimation* animations[] = {&body_animation, nullptr,
+                                      &sword_animation};
+
+  {  // Invalid inputs.
+    RawAnimation output;
+    EXPECT_FALSE(merger(parts, make_span(remaps), animations, nullptr));
+    EXPECT_FALSE(merger(parts, {remaps.data(), 2}, animations, &output));
+    EXPECT_FALSE(merger(parts, make_span(remaps), {animations, 2}, &output));
+
+    // Tracks count doesn't match part skeleton.
+    const RawAnimation* mismatching[] = {&body_animation, &sword_animation,
+                                         &sword_animation};
+    EXPECT_FALSE(merger(parts, make_span(remaps), mismatching, &output));
+
+    // Durations don't match.
+    sword_animation.duration = 1.f;
+    EXPECT_FALSE(merger(parts, make_span(remaps), animations, &output));
+    EXPECT_EQ(output.num_tracks(), 0);
+    sword_animation.duration = 2.f;
+  }
+
+  RawAnimation raw_animation;
+  ASSERT_TRUE(merger(parts, make_span(remaps), animations, &raw_animation));
+  EXPECT_STREQ(raw_animation.name.c_str(), "body");
+  EXPECT_FLOAT_EQ(raw_animation.duration, 2.f);
+  ASSERT_EQ(raw_animation.num_tracks(), merged->num_joints());
+  EXPECT_TRUE(raw_animation.Validate());
+
+  // The whole character is sampled and converted to model space at once.
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation = builder(raw_animation);
+  ASSERT_TRUE(animation);
+
+  SamplingCache cache(merged->num_joints());
+  ozz::math::SoaTransform locals[2];
+  SamplingJob sampling_job;
+  sampling_job.animation = animation.get();
+  sampling_job.cache = &cache;
+  sampling_job.ratio = .5f;
+  sampling_job.output = locals;
+  ASSERT_TRUE(sampling_job.Run());
+
+  ozz::math::Float4x4 models[7];
+  LocalToModelJob ltm_job;
+  ltm_job.skeleton = merged.get();
+  ltm_job.input = locals;
+  ltm_job.output = models;
+  ASSERT_TRUE(ltm_job.Run());
+
+  // Blade, attached to hand. Translations precision is limited by animation
+  // compression.
+  EXPECT_SIMDFLOAT_EQ_EST(models[3].cols[3], 1.5f, 2.f, 0.f, 1.f);
+  // Jaw, attached to neck through head, uses bind pose.
+  EXPECT_SIMDFLOAT_EQ_EST(models[6].cols[3], 0.f, 3.4f, 0.f, 1.f);
+}
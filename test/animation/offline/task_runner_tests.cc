@@ -0,0 +1,104 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/offline/task_runner.h"
+
+#include <atomic>
+
+#include "gtest/gtest.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/memory/tracking_allocator.h"
+
+using ozz::animation::offline::Task;
+using ozz::animation::offline::ThreadedTaskRunner;
+
+namespace {
+// Counts the number of times each index is executed.
+class CountTask : public Task {
+ public:
+  explicit CountTask(int _count) : counts_(_count) {
+    for (size_t i = 0; i < counts_.size(); ++i) {
+      counts_[i] = 0;
+    }
+  }
+  virtual void Execute(int _index) const { ++counts_[_index]; }
+  int count(int _index) const { return counts_[_index]; }
+
+ private:
+  mutable ozz::vector<std::atomic<int>> counts_;
+};
+
+// Records the memory tag active while executing each index.
+class TagTask : public Task {
+ public:
+  explicit TagTask(ozz::memory::Tag* _tags) : tags_(_tags) {}
+  virtual void Execute(int _index) const {
+    tags_[_index] = ozz::memory::current_tag();
+  }
+
+ private:
+  ozz::memory::Tag* tags_;
+};
+}  // namespace
+
+TEST(Default, ThreadedTaskRunner) {
+  ThreadedTaskRunner runner;
+  EXPECT_GE(runner.num_threads(), 1);
+
+  ThreadedTaskRunner negative(-3);
+  EXPECT_GE(negative.num_threads(), 1);
+
+  ThreadedTaskRunner four(4);
+  EXPECT_EQ(four.num_threads(), 4);
+}
+
+TEST(Run, ThreadedTaskRunner) {
+  const int num_threads[] = {1, 2, 3, 16};
+  const int counts[] = {0, 1, 2, 5, 1000};
+  for (size_t t = 0; t < OZZ_ARRAY_SIZE(num_threads); ++t) {
+    ThreadedTaskRunner runner(num_threads[t]);
+    for (size_t c = 0; c < OZZ_ARRAY_SIZE(counts); ++c) {
+      CountTask task(counts[c]);
+      runner.Run(counts[c], task);
+      for (int i = 0; i < counts[c]; ++i) {
+        EXPECT_EQ(task.count(i), 1);
+      }
+    }
+  }
+}
+
+TEST(Tag, ThreadedTaskRunner) {
+  // Memory tag of the calling thread is propagated to worker threads.
+  ozz::memory::Tag tags[64];
+  const ozz::memory::ScopedTag tag(ozz::memory::kTrack);
+  ThreadedTaskRunner runner(8);
+  runner.Run(static_cast<int>(OZZ_ARRAY_SIZE(tags)), TagTask(tags));
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(tags); ++i) {
+    EXPECT_EQ(tags[i], ozz::memory::kTrack);
+  }
+  EXPECT_EQ(ozz::memory::current_tag(), ozz::memory::kTrack);
+}
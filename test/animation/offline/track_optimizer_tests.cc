@@ -32,6 +32,10 @@
 
 #include "ozz/animation/offline/raw_track.h"
 #include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_sampling_job.h"
+
+#include <cmath>
 
 using ozz::animation::offline::RawFloat2Track;
 using ozz::animation::offline::RawFloat3Track;
@@ -400,3 +404,172 @@ TEST(Quaternion, TrackOptimizer) {
   EXPECT_QUATERNION_EQ(output.keyframes[1].value, key2.value.x, key2.value.y,
                        key2.value.z, key2.value.w);
 }
+
+namespace {
+// Builds a long dense track with _components noisy values per key. Some keys
+// are steps.
+template <typename _Track>
+void BuildNoisyTrack(int _num_keys, int _components, _Track* _track) {
+  uint32_t seed = 46;
+  for (int i = 0; i < _num_keys; ++i) {
+    typename _Track::Keyframe key;
+    key.interpolation = i % 1000 == 500 ? RawTrackInterpolation::kStep
+                                        : RawTrackInterpolation::kLinear;
+    key.ratio = static_cast<float>(i) / (_num_keys - 1);
+    float* values = reinterpret_cast<float*>(&key.value);
+    for (int c = 0; c < _components; ++c) {
+      seed = seed * 1664525u + 1013904223u;
+      const float noise = ((seed >> 8) * (1.f / 16777216.f) - .5f) * 1e-2f;
+      values[c] = std::sin(key.ratio * (20.f + c * 7.f)) + noise;
+    }
+    _track->keyframes.push_back(key);
+  }
+}
+
+// Optimizes _input with both algorithms and expects the same output.
+template <typename _Track>
+void ExpectSameDecimation(const _Track& _input, float _tolerance,
+                          int _components) {
+  ASSERT_TRUE(_input.Validate());
+
+  TrackOptimizer optimizer;
+  EXPECT_EQ(optimizer.algorithm, ozz::animation::offline::kRamerDouglasPeucker);
+  optimizer.tolerance = _tolerance;
+  _Track reference;
+  ASSERT_TRUE(optimizer(_input, &reference));
+
+  optimizer.algorithm = ozz::animation::offline::kRamerDouglasPeuckerSimd;
+  _Track output;
+  ASSERT_TRUE(optimizer(_input, &output));
+
+  EXPECT_LT(reference.keyframes.size(), _input.keyframes.size());
+  ASSERT_EQ(reference.keyframes.size(), output.keyframes.size());
+  for (size_t i = 0; i < output.keyframes.size(); ++i) {
+    EXPECT_EQ(reference.keyframes[i].interpolation,
+              output.keyframes[i].interpolation);
+    EXPECT_EQ(reference.keyframes[i].ratio, output.keyframes[i].ratio);
+    const float* expected =
+        reinterpret_cast<const float*>(&reference.keyframes[i].value);
+    const float* values =
+        reinterpret_cast<const float*>(&output.keyframes[i].value);
+    for (int c = 0; c < _components; ++c) {
+      EXPECT_EQ(expected[c], values[c]);
+    }
+  }
+}
+}  // namespace
+
+TEST(Algorithms, TrackOptimizer) {
+  {
+    RawFloatTrack input;
+    BuildNoisyTrack(10000, 1, &input);
+    ExpectSameDecimation(input, 1e-2f, 1);
+  }
+  {
+    RawFloat2Track input;
+    BuildNoisyTrack(10000, 2, &input);
+    ExpectSameDecimation(input, 1e-2f, 2);
+  }
+  {
+    RawFloat3Track input;
+    BuildNoisyTrack(10000, 3, &input);
+    ExpectSameDecimation(input, 1e-2f, 3);
+  }
+  {
+    RawFloat4Track input;
+    BuildNoisyTrack(10000, 4, &input);
+    ExpectSameDecimation(input, 1e-2f, 4);
+  }
+  {
+    RawQuaternionTrack input;
+    BuildNoisyTrack(10000, 4, &input);
+    for (size_t i = 0; i < input.keyframes.size(); ++i) {
+      ozz::math::Quaternion& value = input.keyframes[i].value;
+      value = Normalize(value);
+    }
+    ExpectSameDecimation(input, 1e-1f, 4);
+  }
+}
+
+TEST(AlgorithmsSteps, TrackOptimizer) {
+  // Step keys aren't optimized.
+  TrackOptimizer optimizer;
+  optimizer.algorithm = ozz::animation::offline::kRamerDouglasPeuckerSimd;
+
+  RawFloatTrack input;
+  for (int i = 0; i < 10; ++i) {
+    const RawFloatTrack::Keyframe key = {
+        i == 7 ? RawTrackInterpolation::kStep : RawTrackInterpolation::kLinear,
+        i * .1f, 0.f};
+    input.keyframes.push_back(key);
+  }
+
+  RawFloatTrack output;
+  ASSERT_TRUE(optimizer(input, &output));
+  ASSERT_EQ(output.keyframes.size(), 2u);
+  EXPECT_FLOAT_EQ(output.keyframes[0].ratio, 0.f);
+  EXPECT_FLOAT_EQ(output.keyframes[1].ratio, .7f);
+}
+
+TEST(FitCurves, TrackOptimizer) {
+  // Densely sampled sine wave, with a step in the middle.
+  RawFloatTrack input;
+  const int kKeys = 201;
+  for (int i = 0; i < kKeys; ++i) {
+    const float ratio = i / (kKeys - 1.f);
+    const RawFloatTrack::Keyframe key = {
+        i == 100 ? RawTrackInterpolation::kStep
+                 : RawTrackInterpolation::kLinear,
+        ratio, std::sin(ratio * 6.2831853f) + (i > 100 ? 2.f : 0.f)};
+    input.keyframes.push_back(key);
+  }
+
+  TrackOptimizer optimizer;
+  optimizer.tolerance = 1e-3f;
+
+  RawFloatTrack linear;
+  ASSERT_TRUE(optimizer(input, &linear));
+
+  optimizer.fit_curves = true;
+  RawFloatTrack fitted;
+  ASSERT_TRUE(optimizer(input, &fitted));
+  EXPECT_TRUE(fitted.Validate());
+
+  // Curves need far less keys than linear segments.
+  EXPECT_LT(fitted.keyframes.size() * 2, linear.keyframes.size());
+
+  // Step key is preserved.
+  bool step = false;
+  for (size_t i = 0; i < fitted.keyframes.size(); ++i) {
+    if (fitted.keyframes[i].interpolation == RawTrackInterpolation::kStep) {
+      EXPECT_FLOAT_EQ(fitted.keyframes[i].ratio, .5f);
+      step = true;
+    }
+  }
+  EXPECT_TRUE(step);
+
+  // Compares with reference track, within tolerance.
+  ozz::animation::offline::TrackBuilder builder;
+  ozz::unique_ptr<ozz::animation::FloatTrack> reference(builder(input));
+  ozz::unique_ptr<ozz::animation::FloatTrack> optimized(builder(fitted));
+  ASSERT_TRUE(reference && optimized);
+
+  ozz::animation::FloatTrackSamplingJob job;
+  float expected, result;
+  for (int i = 0; i < kKeys; ++i) {
+    job.ratio = i / (kKeys - 1.f);
+    job.track = reference.get();
+    job.result = &expected;
+    ASSERT_TRUE(job.Run());
+    job.track = optimized.get();
+    job.result = &result;
+    ASSERT_TRUE(job.Run());
+    EXPECT_NEAR(result, expected, 2e-3f) << "ratio " << job.ratio;
+  }
+
+  // Cubic keys aren't decimated when not fitting curves.
+  optimizer.fit_curves = false;
+  RawFloatTrack decimated;
+  ASSERT_TRUE(optimizer(fitted, &decimated));
+  EXPECT_EQ(decimated.keyframes.size(), fitted.keyframes.size());
+}
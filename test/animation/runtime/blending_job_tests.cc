@@ -27,10 +27,13 @@
 
 #include "gtest/gtest.h"
 #include "ozz/animation/runtime/blending_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/gtest_math_helper.h"
 #include "ozz/base/maths/soa_transform.h"
 
 using ozz::animation::BlendingJob;
+using ozz::animation::Skeleton;
 
 TEST(JobValidity, BlendingJob) {
   const ozz::math::SoaTransform identity = ozz::math::SoaTransform::identity();
@@ -869,3 +872,54 @@ TEST(AdditiveJointWeight, BlendingJob) {
                             1.f / 20.f, 1.f / 11.f, 1.f, 1.f);
   }
 }
+
+TEST(MaxJoints, BlendingJob) {
+  const ozz::math::SoaTransform identity = ozz::math::SoaTransform::identity();
+  const size_t num_soa_joints = Skeleton::kMaxSoAJoints;
+
+  // Initialize inputs, all soa joints share the same values so that they're
+  // expected to blend identically, whichever chunk they belong to.
+  ozz::math::SoaTransform input = identity;
+  input.translation = ozz::math::SoaFloat3::Load(
+      ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 3.f),
+      ozz::math::simd_float4::Load(4.f, 5.f, 6.f, 7.f),
+      ozz::math::simd_float4::Load(8.f, 9.f, 10.f, 11.f));
+  ozz::vector<ozz::math::SoaTransform> input_transforms[2] = {
+      ozz::vector<ozz::math::SoaTransform>(num_soa_joints, input),
+      ozz::vector<ozz::math::SoaTransform>(num_soa_joints, input)};
+  for (ozz::math::SoaTransform& transform : input_transforms[1]) {
+    transform.translation = -transform.translation;
+  }
+  ozz::vector<ozz::math::SimdFloat4> joint_weights(
+      num_soa_joints, ozz::math::simd_float4::Load(1.f, 1.f, 0.f, 0.f));
+
+  // Initialize bind pose.
+  ozz::math::SoaTransform bind_pose = identity;
+  bind_pose.translation = ozz::math::SoaFloat3::Load(
+      ozz::math::simd_float4::Load(10.f, 11.f, 12.f, 13.f),
+      ozz::math::simd_float4::Load(14.f, 15.f, 16.f, 17.f),
+      ozz::math::simd_float4::Load(18.f, 19.f, 20.f, 21.f));
+  const ozz::vector<ozz::math::SoaTransform> bind_poses(num_soa_joints,
+                                                        bind_pose);
+
+  BlendingJob::Layer layers[2];
+  layers[0].transform = make_span(input_transforms[0]);
+  layers[0].joint_weights = make_span(joint_weights);
+  layers[0].weight = .5f;
+  layers[1].transform = make_span(input_transforms[1]);
+  layers[1].weight = .25f;
+
+  ozz::vector<ozz::math::SoaTransform> output_transforms(num_soa_joints);
+
+  BlendingJob job;
+  job.layers = layers;
+  job.bind_pose = make_span(bind_poses);
+  job.output = make_span(output_transforms);
+  EXPECT_TRUE(job.Run());
+
+  for (size_t i = 0; i < num_soa_joints; ++i) {
+    EXPECT_SOAFLOAT3_EQ(output_transforms[i].translation, 0.f, 1.f / 3.f,
+                        -2.f, -3.f, 4.f / 3.f, 5.f / 3.f, -6.f, -7.f,
+                        8.f / 3.f, 3.f, -10.f, -11.f);
+  }
+}
@@ -0,0 +1,346 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/compressed_track.h"
+
+#include "gtest/gtest.h"
+
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/math_constant.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_sampling_job.h"
+
+using ozz::animation::CompressedFloat2Track;
+using ozz::animation::CompressedFloat3Track;
+using ozz::animation::CompressedFloat4Track;
+using ozz::animation::CompressedFloatTrack;
+using ozz::animation::CompressedQuaternionTrack;
+using ozz::animation::TrackSamplingCache;
+using ozz::animation::offline::RawFloat2Track;
+using ozz::animation::offline::RawFloat3Track;
+using ozz::animation::offline::RawFloat4Track;
+using ozz::animation::offline::RawFloatTrack;
+using ozz::animation::offline::RawQuaternionTrack;
+using ozz::animation::offline::RawTrackInterpolation;
+using ozz::animation::offline::TrackBuilder;
+
+namespace {
+// Samples _track and _compressed at many ratios, and returns the maximum
+// distance between the two.
+template <typename _Track, typename _CompressedTrack>
+float SamplingError(const _Track& _track, const _CompressedTrack& _compressed,
+                    TrackSamplingCache* _cache = nullptr) {
+  typedef typename _Track::ValueType ValueType;
+  ozz::animation::internal::TrackSamplingJob<_Track> job;
+  ozz::animation::internal::TrackSamplingJob<_CompressedTrack> compressed_job;
+  ValueType result;
+  ValueType compressed_result;
+  job.track = &_track;
+  job.result = &result;
+  compressed_job.track = &_compressed;
+  compressed_job.cache = _cache;
+  compressed_job.result = &compressed_result;
+
+  float error = 0.f;
+  for (float ratio = -.1f; ratio <= 1.1f; ratio += .001f) {
+    job.ratio = ratio;
+    compressed_job.ratio = ratio;
+    EXPECT_TRUE(job.Run());
+    EXPECT_TRUE(compressed_job.Run());
+    error = ozz::math::Max(
+        error, ozz::animation::internal::TrackPolicy<ValueType>::Distance(
+                   result, compressed_result));
+  }
+  return error;
+}
+
+// Builds a float track with smooth and step keys.
+void BuildRawFloatTrack(RawFloatTrack* _track) {
+  for (int i = 0; i <= 20; ++i) {
+    const RawFloatTrack::Keyframe key = {
+        i == 7 ? RawTrackInterpolation::kStep : RawTrackInterpolation::kLinear,
+        i / 20.f, 10.f * std::sin(i * .6f) - 3.f};
+    _track->keyframes.push_back(key);
+  }
+}
+}  // namespace
+
+TEST(Build, CompressedTrack) {
+  TrackBuilder builder;
+
+  {  // Invalid track.
+    RawFloatTrack raw_track;
+    const RawFloatTrack::Keyframe key = {RawTrackInterpolation::kLinear, 2.f,
+                                         0.f};
+    raw_track.keyframes.push_back(key);
+    EXPECT_FALSE(builder(raw_track, 1e-3f));
+  }
+
+  {  // Default track.
+    RawFloatTrack raw_track;
+    raw_track.name = "test name";
+    ozz::unique_ptr<CompressedFloatTrack> track(builder(raw_track, 0.f));
+    ASSERT_TRUE(track);
+    EXPECT_STREQ(track->name(), "test name");
+    ASSERT_EQ(track->ratios().size(), 2u);
+    EXPECT_EQ(track->ratios()[0], 0);
+    EXPECT_EQ(track->ratios()[1], CompressedFloatTrack::kMaxRatio);
+    EXPECT_FLOAT_EQ(track->value(0), 0.f);
+    EXPECT_FLOAT_EQ(track->value(1), 0.f);
+  }
+
+  {  // Tolerance selects the number of bits.
+    RawFloatTrack raw_track;
+    BuildRawFloatTrack(&raw_track);
+
+    ozz::unique_ptr<CompressedFloatTrack> loose(builder(raw_track, .1f));
+    ASSERT_TRUE(loose);
+    EXPECT_EQ(loose->value_bits(), 8);
+    EXPECT_EQ(loose->values().size(), 21u);
+
+    ozz::unique_ptr<CompressedFloatTrack> tight(builder(raw_track, 1e-3f));
+    ASSERT_TRUE(tight);
+    EXPECT_EQ(tight->value_bits(), 16);
+    EXPECT_EQ(tight->values().size(), 42u);
+    EXPECT_LT(loose->size(), tight->size());
+
+    // Key values are within tolerance.
+    for (size_t i = 0; i < raw_track.keyframes.size(); ++i) {
+      EXPECT_NEAR(loose->value(i), raw_track.keyframes[i].value, .1f);
+      EXPECT_NEAR(tight->value(i), raw_track.keyframes[i].value, 1e-3f);
+    }
+
+    // Smaller than uncompressed track.
+    ozz::unique_ptr<ozz::animation::FloatTrack> uncompressed(
+        builder(raw_track));
+    ASSERT_TRUE(uncompressed);
+    EXPECT_LT(tight->size(), uncompressed->size());
+  }
+}
+
+TEST(RatioQuantization, CompressedTrack) {
+  TrackBuilder builder;
+  ozz::animation::CompressedFloatTrackSamplingJob job;
+  float result;
+  job.result = &result;
+
+  {  // Sampling at a step key ratio returns its value, whatever the ratio.
+    RawFloatTrack raw_track;
+    const RawFloatTrack::Keyframe keys[] = {
+        {RawTrackInterpolation::kStep, 0.f, 0.f},
+        {RawTrackInterpolation::kStep, 1.f / 3.f, 10.f},
+        {RawTrackInterpolation::kStep, 2.f / 3.f, 20.f}};
+    raw_track.keyframes.assign(keys, keys + OZZ_ARRAY_SIZE(keys));
+    ozz::unique_ptr<CompressedFloatTrack> track(builder(raw_track, .1f));
+    ASSERT_TRUE(track);
+    EXPECT_EQ(track->value_bits(), 8);
+    job.track = track.get();
+    for (size_t i = 0; i < OZZ_ARRAY_SIZE(keys); ++i) {
+      job.ratio = keys[i].ratio;
+      ASSERT_TRUE(job.Run());
+      EXPECT_NEAR(result, keys[i].value, .1f);
+    }
+  }
+
+  {  // Keys closer than quantized ratio precision are merged to the last one.
+    RawFloatTrack raw_track;
+    const RawFloatTrack::Keyframe keys[] = {
+        {RawTrackInterpolation::kLinear, 0.f, 0.f},
+        {RawTrackInterpolation::kStep, .5f, 5.f},
+        {RawTrackInterpolation::kLinear, .5f + 1e-6f, 20.f},
+        {RawTrackInterpolation::kLinear, 1.f, 20.f}};
+    raw_track.keyframes.assign(keys, keys + OZZ_ARRAY_SIZE(keys));
+    ozz::unique_ptr<CompressedFloatTrack> track(builder(raw_track, 1.f));
+    ASSERT_TRUE(track);
+    ASSERT_EQ(track->ratios().size(), 3u);
+    EXPECT_EQ(track->steps()[0], 0);
+    EXPECT_LT(track->ratios()[0], track->ratios()[1]);
+    EXPECT_LT(track->ratios()[1], track->ratios()[2]);
+
+    // Merged step key error is accounted, so 8 bits precision isn't selected.
+    EXPECT_EQ(track->value_bits(), 16);
+    job.track = track.get();
+    job.ratio = .5f + 1e-6f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_NEAR(result, 20.f, 1e-2f);
+  }
+}
+
+TEST(Sampling, CompressedFloatTrack) {
+  TrackBuilder builder;
+  RawFloatTrack raw_track;
+  BuildRawFloatTrack(&raw_track);
+
+  ozz::unique_ptr<ozz::animation::FloatTrack> track(builder(raw_track));
+  ASSERT_TRUE(track);
+  ozz::unique_ptr<CompressedFloatTrack> compressed(builder(raw_track, 1e-3f));
+  ASSERT_TRUE(compressed);
+  ASSERT_EQ(compressed->value_bits(), 16);
+
+  // Ratio quantization introduces a small error, mainly on steep slopes.
+  EXPECT_LT(SamplingError(*track, *compressed), 2e-3f);
+
+  // Step is preserved.
+  ozz::animation::CompressedFloatTrackSamplingJob job;
+  float result;
+  job.track = compressed.get();
+  job.result = &result;
+  job.ratio = 7.5f / 20.f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_NEAR(result, raw_track.keyframes[7].value, 1e-3f);
+
+  // Cache doesn't change the result.
+  TrackSamplingCache cache;
+  EXPECT_LT(SamplingError(*track, *compressed, &cache), 2e-3f);
+}
+
+TEST(Sampling, CompressedFloatNTrack) {
+  TrackBuilder builder;
+
+  RawFloat2Track raw_track2;
+  RawFloat3Track raw_track3;
+  RawFloat4Track raw_track4;
+  for (int i = 0; i <= 10; ++i) {
+    const float ratio = i / 10.f;
+    const float v = static_cast<float>(i);
+    const RawFloat2Track::Keyframe key2 = {
+        RawTrackInterpolation::kLinear, ratio, ozz::math::Float2(v, -v * 2.f)};
+    raw_track2.keyframes.push_back(key2);
+    const RawFloat3Track::Keyframe key3 = {
+        RawTrackInterpolation::kLinear, ratio,
+        ozz::math::Float3(v, 46.f, -v * v)};
+    raw_track3.keyframes.push_back(key3);
+    const RawFloat4Track::Keyframe key4 = {
+        RawTrackInterpolation::kLinear, ratio,
+        ozz::math::Float4(v, 0.f, -v, v * .01f)};
+    raw_track4.keyframes.push_back(key4);
+  }
+
+  ozz::unique_ptr<ozz::animation::Float2Track> track2(builder(raw_track2));
+  ozz::unique_ptr<CompressedFloat2Track> compressed2(
+      builder(raw_track2, 1e-2f));
+  ASSERT_TRUE(track2 && compressed2);
+  EXPECT_LT(SamplingError(*track2, *compressed2), 1e-2f);
+
+  ozz::unique_ptr<ozz::animation::Float3Track> track3(builder(raw_track3));
+  ozz::unique_ptr<CompressedFloat3Track> compressed3(
+      builder(raw_track3, 1e-2f));
+  ASSERT_TRUE(track3 && compressed3);
+  EXPECT_LT(SamplingError(*track3, *compressed3), 1e-2f);
+
+  ozz::unique_ptr<ozz::animation::Float4Track> track4(builder(raw_track4));
+  ozz::unique_ptr<CompressedFloat4Track> compressed4(
+      builder(raw_track4, 1e-2f));
+  ASSERT_TRUE(track4 && compressed4);
+  EXPECT_LT(SamplingError(*track4, *compressed4), 1e-2f);
+}
+
+TEST(Sampling, CompressedQuaternionTrack) {
+  TrackBuilder builder;
+
+  // Rotates around all axes, so that every component is the largest one at
+  // some point. Also includes opposite successive quaternions.
+  RawQuaternionTrack raw_track;
+  for (int i = 0; i <= 16; ++i) {
+    const ozz::math::Float3 axis = Normalize(
+        ozz::math::Float3(std::cos(i * .7f), std::sin(i * 1.3f), .3f));
+    ozz::math::Quaternion value =
+        ozz::math::Quaternion::FromAxisAngle(axis, i * .8f);
+    if (i & 1) {
+      value = -value;
+    }
+    const RawQuaternionTrack::Keyframe key = {RawTrackInterpolation::kLinear,
+                                              i / 16.f, value};
+    raw_track.keyframes.push_back(key);
+  }
+
+  ozz::unique_ptr<ozz::animation::QuaternionTrack> track(builder(raw_track));
+  ASSERT_TRUE(track);
+
+  ozz::unique_ptr<CompressedQuaternionTrack> tight(builder(raw_track, 0.f));
+  ASSERT_TRUE(tight);
+  EXPECT_EQ(tight->value_bits(), 16);
+  EXPECT_LT(SamplingError(*track, *tight), 1e-6f);
+
+  ozz::unique_ptr<CompressedQuaternionTrack> loose(builder(raw_track, 1e-3f));
+  ASSERT_TRUE(loose);
+  EXPECT_EQ(loose->value_bits(), 8);
+  EXPECT_LT(SamplingError(*track, *loose), 1e-3f);
+
+  // Compressed quaternions are normalized.
+  for (size_t i = 0; i < raw_track.keyframes.size(); ++i) {
+    EXPECT_TRUE(IsNormalized(tight->value(i)));
+  }
+}
+
+TEST(Serialize, CompressedTrack) {
+  TrackBuilder builder;
+  RawFloatTrack raw_track;
+  raw_track.name = "test name";
+  BuildRawFloatTrack(&raw_track);
+
+  for (int i = 0; i < 2; ++i) {
+    const float tolerance = i == 0 ? .1f : 0.f;
+    ozz::unique_ptr<CompressedFloatTrack> o_track(
+        builder(raw_track, tolerance));
+    ASSERT_TRUE(o_track);
+
+    for (int e = 0; e < 2; ++e) {
+      ozz::io::MemoryStream stream;
+      {
+        ozz::io::OArchive o(&stream, e == 0 ? ozz::kLittleEndian
+                                            : ozz::kBigEndian);
+        o << *o_track;
+      }
+
+      stream.Seek(0, ozz::io::Stream::kSet);
+      ozz::io::IArchive ia(&stream);
+      ASSERT_TRUE(ia.TestTag<CompressedFloatTrack>());
+
+      CompressedFloatTrack i_track;
+      ia >> i_track;
+
+      EXPECT_STREQ(o_track->name(), i_track.name());
+      EXPECT_EQ(o_track->value_bits(), i_track.value_bits());
+      EXPECT_EQ(o_track->size(), i_track.size());
+      ASSERT_EQ(o_track->ratios().size(), i_track.ratios().size());
+      for (size_t k = 0; k < i_track.ratios().size(); ++k) {
+        EXPECT_EQ(o_track->ratios()[k], i_track.ratios()[k]);
+        EXPECT_EQ(o_track->value(k), i_track.value(k));
+      }
+      for (size_t k = 0; k < i_track.steps().size(); ++k) {
+        EXPECT_EQ(o_track->steps()[k], i_track.steps()[k]);
+      }
+    }
+  }
+}
@@ -0,0 +1,239 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/event_track_query_job.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/raw_event_track.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/event_track.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::EventTrack;
+using ozz::animation::EventTrackQueryJob;
+using ozz::animation::offline::RawEventTrack;
+using ozz::animation::offline::TrackBuilder;
+
+namespace {
+ozz::unique_ptr<EventTrack> BuildTestTrack() {
+  RawEventTrack raw_track;
+  const float ratios[] = {0.f, .1f, .25f, .25f, .5f, .9f, 1.f};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(ratios); ++i) {
+    const RawEventTrack::Event event = {ratios[i], static_cast<uint16_t>(i)};
+    raw_track.events.push_back(event);
+  }
+  TrackBuilder builder;
+  return builder(raw_track);
+}
+
+ozz::vector<EventTrackQueryJob::Event> Query(const EventTrack& _track,
+                                             float _from, float _to) {
+  ozz::vector<EventTrackQueryJob::Event> events;
+  EventTrackQueryJob job;
+  job.track = &_track;
+  job.from = _from;
+  job.to = _to;
+  EventTrackQueryJob::Iterator iterator;
+  job.iterator = &iterator;
+  EXPECT_TRUE(job.Run());
+  for (; iterator != job.end(); ++iterator) {
+    events.push_back(*iterator);
+  }
+  return events;
+}
+
+// Brute force implementation, used as a reference.
+ozz::vector<EventTrackQueryJob::Event> Reference(const EventTrack& _track,
+                                                 float _from, float _to) {
+  ozz::vector<EventTrackQueryJob::Event> events;
+  const float lower = std::floor(_from < _to ? _from : _to) - 1.f;
+  const float upper = std::floor(_from < _to ? _to : _from) + 1.f;
+  for (float outer = lower; outer <= upper; outer += 1.f) {
+    for (size_t i = 0; i < _track.num_events(); ++i) {
+      const float ratio = _track.ratios()[i] + outer;
+      if ((_from < _to && ratio > _from && ratio <= _to) ||
+          (_from > _to && ratio >= _to && ratio < _from)) {
+        const EventTrackQueryJob::Event event = {ratio, _track.ids()[i]};
+        events.push_back(event);
+      }
+    }
+  }
+  if (_from > _to) {  // Backward events are reversed.
+    for (size_t i = 0; i < events.size() / 2; ++i) {
+      std::swap(events[i], events[events.size() - i - 1]);
+    }
+  }
+  return events;
+}
+}  // namespace
+
+TEST(JobValidity, EventTrackQueryJob) {
+  ozz::unique_ptr<EventTrack> track(BuildTestTrack());
+  ASSERT_TRUE(track);
+
+  {  // Default is invalid
+    EventTrackQueryJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // No output
+    EventTrackQueryJob job;
+    job.track = track.get();
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid
+    EventTrackQueryJob job;
+    job.track = track.get();
+    EventTrackQueryJob::Iterator iterator;
+    job.iterator = &iterator;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+    EXPECT_FALSE(iterator != job.end());  // Empty range.
+  }
+}
+
+TEST(Empty, EventTrackQueryJob) {
+  EventTrack track;
+  EXPECT_TRUE(Query(track, -2.f, 3.f).empty());
+  EXPECT_TRUE(Query(track, 3.f, -2.f).empty());
+}
+
+TEST(Range, EventTrackQueryJob) {
+  ozz::unique_ptr<EventTrack> track(BuildTestTrack());
+  ASSERT_TRUE(track);
+
+  {  // From is excluded, to is included.
+    const ozz::vector<EventTrackQueryJob::Event> events =
+        Query(*track, .1f, .25f);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_FLOAT_EQ(events[0].ratio, .25f);
+    EXPECT_EQ(events[0].id, 2);
+    EXPECT_FLOAT_EQ(events[1].ratio, .25f);
+    EXPECT_EQ(events[1].id, 3);
+  }
+
+  {  // Backward, from is excluded, to is included.
+    const ozz::vector<EventTrackQueryJob::Event> events =
+        Query(*track, .25f, .1f);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_FLOAT_EQ(events[0].ratio, .1f);
+    EXPECT_EQ(events[0].id, 1);
+  }
+
+  {  // Loops, events at the end and the beginning of the track.
+    const ozz::vector<EventTrackQueryJob::Event> events =
+        Query(*track, .95f, 1.05f);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_FLOAT_EQ(events[0].ratio, 1.f);
+    EXPECT_EQ(events[0].id, 6);
+    EXPECT_FLOAT_EQ(events[1].ratio, 1.f);
+    EXPECT_EQ(events[1].id, 0);
+  }
+
+  {  // Backward loops.
+    const ozz::vector<EventTrackQueryJob::Event> events =
+        Query(*track, .05f, -.05f);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_FLOAT_EQ(events[0].ratio, 0.f);
+    EXPECT_EQ(events[0].id, 0);
+    EXPECT_FLOAT_EQ(events[1].ratio, 0.f);
+    EXPECT_EQ(events[1].id, 6);
+  }
+}
+
+TEST(Reference, EventTrackQueryJob) {
+  ozz::unique_ptr<EventTrack> track(BuildTestTrack());
+  ASSERT_TRUE(track);
+
+  const float bounds[] = {-2.3f, -1.f, -.5f, 0.f, .1f,  .25f,
+                          .3f,   .9f,  1.f,  1.1f, 2.f, 2.7f};
+  for (size_t f = 0; f < OZZ_ARRAY_SIZE(bounds); ++f) {
+    for (size_t t = 0; t < OZZ_ARRAY_SIZE(bounds); ++t) {
+      const ozz::vector<EventTrackQueryJob::Event> events =
+          Query(*track, bounds[f], bounds[t]);
+      const ozz::vector<EventTrackQueryJob::Event> expected =
+          Reference(*track, bounds[f], bounds[t]);
+      ASSERT_EQ(events.size(), expected.size())
+          << "from " << bounds[f] << " to " << bounds[t];
+      for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(events[i].ratio, expected[i].ratio);
+        EXPECT_EQ(events[i].id, expected[i].id);
+      }
+    }
+  }
+}
+
+TEST(Contiguous, EventTrackQueryJob) {
+  ozz::unique_ptr<EventTrack> track(BuildTestTrack());
+  ASSERT_TRUE(track);
+
+  // Contiguous ranges yield every event once per loop, forward and backward.
+  for (int backward = 0; backward < 2; ++backward) {
+    size_t count = 0;
+    const float step = backward ? -1.f / 32.f : 1.f / 32.f;
+    for (int i = 0; i < 32 * 3; ++i) {
+      count += Query(*track, i * step, (i + 1) * step).size();
+    }
+    EXPECT_EQ(count, track->num_events() * 3);
+  }
+}
+
+TEST(Serialize, EventTrack) {
+  ozz::unique_ptr<EventTrack> o_track(BuildTestTrack());
+  ASSERT_TRUE(o_track);
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << *o_track;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+
+    EventTrack i_track;
+    i >> i_track;
+
+    EXPECT_EQ(o_track->size(), i_track.size());
+    ASSERT_EQ(o_track->num_events(), i_track.num_events());
+    for (size_t j = 0; j < i_track.num_events(); ++j) {
+      EXPECT_FLOAT_EQ(o_track->ratios()[j], i_track.ratios()[j]);
+      EXPECT_EQ(o_track->ids()[j], i_track.ids()[j]);
+    }
+  }
+}
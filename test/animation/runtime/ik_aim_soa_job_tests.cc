@@ -0,0 +1,243 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/ik_aim_soa_job.h"
+
+#include "ozz/animation/runtime/ik_aim_job.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+
+namespace {
+// Builds a SoaFloat4x4 from 4 Float4x4.
+ozz::math::SoaFloat4x4 ToSoa(const ozz::math::Float4x4 _m[4]) {
+  ozz::math::SoaFloat4x4 soa;
+  for (int c = 0; c < 4; ++c) {
+    const ozz::math::SimdFloat4 cols[4] = {_m[0].cols[c], _m[1].cols[c],
+                                           _m[2].cols[c], _m[3].cols[c]};
+    ozz::math::Transpose4x4(cols, &soa.cols[c].x);
+  }
+  return soa;
+}
+
+// Builds a SoaFloat3 from 4 SimdFloat4.
+ozz::math::SoaFloat3 ToSoa(const ozz::math::SimdFloat4 _v[4]) {
+  ozz::math::SimdFloat4 soa[4];
+  ozz::math::Transpose4x4(_v, soa);
+  return ozz::math::SoaFloat3::Load(soa[0], soa[1], soa[2]);
+}
+
+// Runs IKAimSoaJob with 4 IKAimJob setups and compares outputs of every lane.
+void ExpectSoaMatches(const ozz::animation::IKAimJob _jobs[4]) {
+  ozz::math::Float4x4 joints[4];
+  ozz::math::SimdFloat4 targets[4], forwards[4], offsets[4], ups[4], poles[4];
+  for (int i = 0; i < 4; ++i) {
+    joints[i] = *_jobs[i].joint;
+    targets[i] = _jobs[i].target;
+    forwards[i] = _jobs[i].forward;
+    offsets[i] = _jobs[i].offset;
+    ups[i] = _jobs[i].up;
+    poles[i] = _jobs[i].pole_vector;
+  }
+  const ozz::math::SoaFloat4x4 joint = ToSoa(joints);
+
+  ozz::animation::IKAimSoaJob job;
+  job.target = ToSoa(targets);
+  job.forward = ToSoa(forwards);
+  job.offset = ToSoa(offsets);
+  job.up = ToSoa(ups);
+  job.pole_vector = ToSoa(poles);
+  job.twist_angle =
+      ozz::math::simd_float4::Load(_jobs[0].twist_angle, _jobs[1].twist_angle,
+                                   _jobs[2].twist_angle, _jobs[3].twist_angle);
+  job.weight = ozz::math::simd_float4::Load(
+      _jobs[0].weight, _jobs[1].weight, _jobs[2].weight, _jobs[3].weight);
+  job.joint = &joint;
+  ozz::math::SoaQuaternion correction;
+  job.joint_correction = &correction;
+  ozz::math::SimdInt4 reached;
+  job.reached = &reached;
+  ASSERT_TRUE(job.Validate());
+  ASSERT_TRUE(job.Run());
+
+  ozz::math::SimdFloat4 corrections[4];
+  ozz::math::Transpose4x4(&correction.x, corrections);
+  const int reached_mask = ozz::math::MoveMask(reached);
+
+  // IKAimJob normalizes weighted corrections with a lower precision
+  // estimation than IKAimSoaJob does.
+  const float kTolerance = 5e-4f;
+  for (int i = 0; i < 4; ++i) {
+    ozz::animation::IKAimJob scalar = _jobs[i];
+    ozz::math::SimdQuaternion expected;
+    scalar.joint_correction = &expected;
+    bool reached_expected;
+    scalar.reached = &reached_expected;
+    ASSERT_TRUE(scalar.Run());
+
+    EXPECT_SIMDQUATERNION_EQ_TOL(expected, ozz::math::GetX(corrections[i]),
+                                 ozz::math::GetY(corrections[i]),
+                                 ozz::math::GetZ(corrections[i]),
+                                 ozz::math::GetW(corrections[i]), kTolerance);
+    EXPECT_EQ((reached_mask & (1 << i)) != 0, reached_expected);
+  }
+}
+}  // namespace
+
+TEST(JobValidity, IKAimSoaJob) {
+  const ozz::math::SoaFloat4x4 joint = ozz::math::SoaFloat4x4::identity();
+  ozz::math::SoaQuaternion quat;
+
+  {  // Default is invalid
+    ozz::animation::IKAimSoaJob job;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Invalid joint matrix
+    ozz::animation::IKAimSoaJob job;
+    job.joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Invalid output
+    ozz::animation::IKAimSoaJob job;
+    job.joint = &joint;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Invalid non normalized forward vector.
+    ozz::animation::IKAimSoaJob job;
+    job.forward = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(1.f, 1.f, .5f, 1.f),
+        ozz::math::simd_float4::zero(), ozz::math::simd_float4::zero());
+    job.joint = &joint;
+    job.joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Valid
+    ozz::animation::IKAimSoaJob job;
+    job.joint = &joint;
+    job.joint_correction = &quat;
+    EXPECT_TRUE(job.Validate());
+  }
+}
+
+TEST(Lanes, IKAimSoaJob) {
+  using ozz::math::simd_float4::Load;
+  using ozz::math::simd_float4::Load1;
+
+  // 4 different joints.
+  const ozz::math::Float4x4 joints[4] = {
+      ozz::math::Float4x4::identity(),
+      ozz::math::Float4x4::FromAffine(
+          Load(1.f, 2.f, 3.f, 1.f),
+          ozz::math::SimdQuaternion::FromAxisAngle(
+              ozz::math::simd_float4::y_axis(), Load1(.7f))
+              .xyzw,
+          ozz::math::simd_float4::one()),
+      ozz::math::Float4x4::FromAffine(
+          Load(-1.f, 0.f, 2.f, 1.f),
+          ozz::math::SimdQuaternion::FromAxisAngle(
+              ozz::math::Normalize3(Load(1.f, 1.f, 0.f, 0.f)), Load1(-1.2f))
+              .xyzw,
+          Load(2.f, 2.f, 2.f, 0.f)),
+      ozz::math::Float4x4::FromAffine(
+          Load(0.f, -3.f, 1.f, 1.f),
+          ozz::math::SimdQuaternion::FromAxisAngle(
+              ozz::math::simd_float4::z_axis(), Load1(2.5f))
+              .xyzw,
+          ozz::math::simd_float4::one())};
+
+  // Targets are offsets from joints. Degenerated cases (target aligned with
+  // up or pole vector) are unstable, see IKAimJob, so they're avoided.
+  const ozz::math::SimdFloat4 targets[] = {
+      Load(1.f, .2f, .3f, 0.f),   Load(.3f, 1.5f, .5f, 0.f),
+      Load(-.2f, .1f, .3f, 0.f),  Load(3.f, -1.f, 2.f, 0.f),
+      Load(.5f, -1.f, -.3f, 0.f), Load(-.1f, 2.f, -1.f, 0.f),
+      Load(.7f, .2f, -.9f, 0.f)};
+  const int num_targets = static_cast<int>(OZZ_ARRAY_SIZE(targets));
+  const ozz::math::SimdFloat4 forwards[] = {
+      ozz::math::simd_float4::x_axis(), ozz::math::simd_float4::z_axis(),
+      ozz::math::Normalize3(Load(1.f, 0.f, 1.f, 0.f)),
+      -ozz::math::simd_float4::x_axis()};
+  const ozz::math::SimdFloat4 offsets[] = {
+      ozz::math::simd_float4::zero(), Load(0.f, .2f, 0.f, 0.f),
+      Load(.1f, -.3f, .2f, 0.f),
+      // Further than most targets, so they aren't reachable.
+      Load(0.f, 3.f, 0.f, 0.f)};
+  const int num_offsets = static_cast<int>(OZZ_ARRAY_SIZE(offsets));
+  const ozz::math::SimdFloat4 ups[] = {
+      ozz::math::simd_float4::y_axis(), ozz::math::simd_float4::x_axis(),
+      ozz::math::simd_float4::y_axis(), -ozz::math::simd_float4::z_axis()};
+  const ozz::math::SimdFloat4 poles[] = {
+      ozz::math::simd_float4::y_axis(),
+      ozz::math::Normalize3(Load(1.f, 1.f, 1.f, 0.f)),
+      ozz::math::simd_float4::x_axis(), -ozz::math::simd_float4::z_axis()};
+  const float twists[] = {0.f, .5f, 0.f, -1.f};
+  const float weights[] = {1.f, .5f, 0.f, 1.2f, -.1f, .9f};
+  const int num_weights = static_cast<int>(OZZ_ARRAY_SIZE(weights));
+
+  for (int t = 0; t < num_targets; ++t) {
+    for (int o = 0; o < num_offsets; ++o) {
+      for (int w = 0; w < num_weights; ++w) {
+        for (int uniform_twist = 0; uniform_twist < 2; ++uniform_twist) {
+          ozz::animation::IKAimJob jobs[4];
+          for (int i = 0; i < 4; ++i) {
+            jobs[i].joint = &joints[i];
+            jobs[i].target = joints[i].cols[3] + targets[(t + i) % num_targets];
+            jobs[i].forward = forwards[i];
+            jobs[i].offset = offsets[(o + i) % num_offsets];
+            jobs[i].up = ups[i];
+            jobs[i].pole_vector = poles[i];
+            jobs[i].twist_angle = uniform_twist ? 0.f : twists[i];
+            jobs[i].weight = weights[(w + i) % num_weights];
+          }
+          ExpectSoaMatches(jobs);
+        }
+      }
+    }
+  }
+}
+
+TEST(TargetTooClose, IKAimSoaJob) {
+  const ozz::math::SoaFloat4x4 joint = ozz::math::SoaFloat4x4::identity();
+  ozz::math::SoaQuaternion correction;
+
+  ozz::animation::IKAimSoaJob job;
+  job.target = ozz::math::SoaFloat3::zero();
+  job.joint = &joint;
+  job.joint_correction = &correction;
+  ASSERT_TRUE(job.Run());
+
+  EXPECT_SOAQUATERNION_EQ(correction, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                          0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f);
+}
@@ -0,0 +1,439 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/ik_chain_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/ik_correction_job.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::IKChainJob;
+using ozz::animation::IKCorrectionJob;
+using ozz::animation::LocalToModelJob;
+using ozz::animation::Skeleton;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+
+namespace {
+// Builds a chain of _count joints, each one with a branch child. Joints are
+// indexed 0 (root), 1 (branch), 2, 3 (branch), 4... so chain joints have even
+// indices. Chain joints are slightly rotated with a uniform scale.
+ozz::unique_ptr<Skeleton> BuildSkeleton(int _count) {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint* joint = &raw_skeleton.roots[0];
+  for (int i = 0; i < _count; ++i) {
+    const float seed = i * .3f;
+    joint->name = "joint";
+    joint->transform.translation =
+        ozz::math::Float3(0.f, i == 0 ? 0.f : 1.f, 0.f);
+    joint->transform.rotation = ozz::math::Quaternion::FromAxisAngle(
+        Normalize(ozz::math::Float3(std::cos(seed), .2f, std::sin(seed))),
+        .2f);
+    joint->transform.scale = ozz::math::Float3(i == 2 ? 1.5f : 1.f);
+    joint->children.resize(i == _count - 1 ? 1 : 2);
+    RawSkeleton::Joint& branch = joint->children[0];
+    branch.name = "branch";
+    branch.transform.translation = ozz::math::Float3(1.f, 0.f, 0.f);
+    if (i != _count - 1) {
+      joint = &joint->children[1];
+    }
+  }
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+
+ozz::math::SimdFloat4 Position(const ozz::math::Float4x4& _m) {
+  return _m.cols[3];
+}
+
+// Test fixture running IKChainJob on the chain skeleton, and applying its
+// corrections.
+class IKChainJobTest : public testing::Test {
+ protected:
+  void SetUp() override { Init(10); }
+
+  void Init(int _count) {
+    skeleton_ = BuildSkeleton(_count);
+    ASSERT_TRUE(skeleton_);
+    const ozz::span<const ozz::math::SoaTransform> bind_pose =
+        skeleton_->joint_bind_poses();
+    locals_.assign(bind_pose.begin(), bind_pose.end());
+    models_.resize(skeleton_->num_joints());
+    ASSERT_TRUE(UpdateModels());
+  }
+
+  bool UpdateModels() {
+    LocalToModelJob ltm_job;
+    ltm_job.skeleton = skeleton_.get();
+    ltm_job.input = make_span(locals_);
+    ltm_job.output = make_span(models_);
+    return ltm_job.Run();
+  }
+
+  // Applies corrections to models and locals, then checks that they match.
+  void ApplyCorrections(
+      ozz::span<const IKCorrectionJob::Correction> _corrections) {
+    IKCorrectionJob correction_job;
+    correction_job.skeleton = skeleton_.get();
+    correction_job.corrections = _corrections;
+    correction_job.models = make_span(models_);
+    correction_job.locals = make_span(locals_);
+    ASSERT_TRUE(correction_job.Run());
+
+    const ozz::vector<ozz::math::Float4x4> corrected = models_;
+    ASSERT_TRUE(UpdateModels());
+    for (size_t i = 0; i < models_.size(); ++i) {
+      const ozz::math::SimdFloat4 expected = Position(models_[i]);
+      EXPECT_SIMDFLOAT3_EQ_TOL(Position(corrected[i]),
+                               ozz::math::GetX(expected),
+                               ozz::math::GetY(expected),
+                               ozz::math::GetZ(expected), 1e-4f);
+    }
+  }
+
+  ozz::unique_ptr<Skeleton> skeleton_;
+  ozz::vector<ozz::math::SoaTransform> locals_;
+  ozz::vector<ozz::math::Float4x4> models_;
+};
+
+#define EXPECT_POSITION_NEAR(_joint, _position, _tol)                       \
+  do {                                                                      \
+    const ozz::math::SimdFloat4 _p = _position;                             \
+    EXPECT_SIMDFLOAT3_EQ_TOL(Position(models_[_joint]), ozz::math::GetX(_p), \
+                             ozz::math::GetY(_p), ozz::math::GetZ(_p), _tol); \
+  } while (void(0), 0)
+}  // namespace
+
+TEST_F(IKChainJobTest, JobValidity) {
+  const int joints[] = {0, 2, 4};
+  IKCorrectionJob::Correction corrections[2];
+
+  {  // Default is invalid
+    IKChainJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid
+    IKChainJob job;
+    job.joints = joints;
+    job.models = make_span(models_);
+    job.corrections = corrections;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Not enough joints
+    IKChainJob job;
+    job.joints = {joints, 1};
+    job.models = make_span(models_);
+    job.corrections = corrections;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Too many joints
+    int many[IKChainJob::kMaxJoints + 1];
+    for (int i = 0; i < IKChainJob::kMaxJoints + 1; ++i) {
+      many[i] = i;
+    }
+    IKCorrectionJob::Correction many_corrections[IKChainJob::kMaxJoints];
+    ozz::vector<ozz::math::Float4x4> many_models(IKChainJob::kMaxJoints + 1);
+    IKChainJob job;
+    job.joints = many;
+    job.models = make_span(many_models);
+    job.corrections = many_corrections;
+    EXPECT_FALSE(job.Validate());
+    job.joints = {many, IKChainJob::kMaxJoints};
+    EXPECT_TRUE(job.Validate());
+  }
+
+  {  // Not enough corrections
+    IKChainJob job;
+    job.joints = joints;
+    job.models = make_span(models_);
+    job.corrections = {corrections, 1};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Unsorted joints
+    const int unsorted[] = {0, 4, 2};
+    IKChainJob job;
+    job.joints = unsorted;
+    job.models = make_span(models_);
+    job.corrections = corrections;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid joint index
+    const int invalid[] = {0, 2, 42};
+    IKChainJob job;
+    job.joints = invalid;
+    job.models = make_span(models_);
+    job.corrections = corrections;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Negative iterations
+    IKChainJob job;
+    job.joints = joints;
+    job.models = make_span(models_);
+    job.corrections = corrections;
+    job.max_iterations = -1;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Negative tolerance
+    IKChainJob job;
+    job.joints = joints;
+    job.models = make_span(models_);
+    job.corrections = corrections;
+    job.tolerance = -1.f;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+}
+
+TEST_F(IKChainJobTest, Reachable) {
+  // Chain of 10 joints, which spans 3 SoA groups.
+  const int joints[] = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18};
+  IKCorrectionJob::Correction corrections[9];
+
+  const ozz::math::SimdFloat4 targets[] = {
+      ozz::math::simd_float4::Load(2.f, 3.f, 1.f, 0.f),
+      ozz::math::simd_float4::Load(-4.f, 1.f, 3.f, 0.f),
+      ozz::math::simd_float4::Load(0.f, -2.f, 0.f, 0.f),
+      ozz::math::simd_float4::Load(1.f, 7.f, -2.f, 0.f)};
+
+  for (const ozz::math::SimdFloat4& target : targets) {
+    IKChainJob job;
+    job.target = target;
+    job.joints = joints;
+    job.models = make_span(models_);
+    job.corrections = corrections;
+    job.max_iterations = 64;
+    bool reached = false;
+    job.reached = &reached;
+    int iterations = -1;
+    job.iterations = &iterations;
+    ASSERT_TRUE(job.Run());
+    EXPECT_TRUE(reached);
+    EXPECT_GT(iterations, 0);
+    EXPECT_LE(iterations, 64);
+
+    for (int i = 0; i < 9; ++i) {
+      EXPECT_EQ(corrections[i].joint, joints[i]);
+    }
+
+    ApplyCorrections(corrections);
+    EXPECT_POSITION_NEAR(18, target, 2e-3f);
+  }
+}
+
+TEST_F(IKChainJobTest, SparseChain) {
+  // Joints 6 and 12 aren't part of the chain, they remain fixed.
+  const int joints[] = {0, 2, 4, 8, 10, 14, 16};
+  IKCorrectionJob::Correction corrections[6];
+
+  const ozz::math::SimdFloat4 target =
+      ozz::math::simd_float4::Load(3.f, 4.f, -1.f, 0.f);
+
+  IKChainJob job;
+  job.target = target;
+  job.joints = joints;
+  job.models = make_span(models_);
+  job.corrections = corrections;
+  job.max_iterations = 64;
+  bool reached = false;
+  job.reached = &reached;
+  ASSERT_TRUE(job.Run());
+  EXPECT_TRUE(reached);
+
+  ApplyCorrections(corrections);
+  EXPECT_POSITION_NEAR(16, target, 2e-3f);
+}
+
+TEST_F(IKChainJobTest, Unreachable) {
+  const int joints[] = {0, 2, 4, 6};
+  IKCorrectionJob::Correction corrections[3];
+
+  const ozz::math::SimdFloat4 target =
+      ozz::math::simd_float4::Load(10.f, 10.f, 10.f, 0.f);
+
+  IKChainJob job;
+  job.target = target;
+  job.joints = joints;
+  job.models = make_span(models_);
+  job.corrections = corrections;
+  job.max_iterations = 1000;
+  bool reached = true;
+  job.reached = &reached;
+  int iterations = -1;
+  job.iterations = &iterations;
+  ASSERT_TRUE(job.Run());
+  EXPECT_FALSE(reached);
+
+  // Stops iterating once the chain is stretched.
+  EXPECT_LT(iterations, 1000);
+
+  // Chain is stretched toward the target.
+  ApplyCorrections(corrections);
+  const ozz::math::SimdFloat4 start = Position(models_[0]);
+  const ozz::math::SimdFloat4 to_target = ozz::math::Normalize3(target - start);
+  for (int i = 1; i < 4; ++i) {
+    const ozz::math::SimdFloat4 to_joint =
+        ozz::math::Normalize3(Position(models_[joints[i]]) - start);
+    EXPECT_NEAR(ozz::math::GetX(ozz::math::Dot3(to_target, to_joint)), 1.f,
+                1e-3f);
+  }
+}
+
+TEST_F(IKChainJobTest, AlreadyReached) {
+  const int joints[] = {0, 2, 4, 6};
+  IKCorrectionJob::Correction corrections[3];
+
+  IKChainJob job;
+  job.target = Position(models_[6]);
+  job.joints = joints;
+  job.models = make_span(models_);
+  job.corrections = corrections;
+  bool reached = false;
+  job.reached = &reached;
+  int iterations = -1;
+  job.iterations = &iterations;
+  ASSERT_TRUE(job.Run());
+  EXPECT_TRUE(reached);
+  EXPECT_EQ(iterations, 0);
+  for (const IKCorrectionJob::Correction& correction : corrections) {
+    EXPECT_SIMDQUATERNION_EQ_TOL(correction.rotation, 0.f, 0.f, 0.f, 1.f,
+                                 1e-6f);
+  }
+}
+
+TEST_F(IKChainJobTest, Iterations) {
+  const int joints[] = {0, 2, 4, 6, 8, 10};
+  IKCorrectionJob::Correction corrections[5];
+
+  const ozz::math::SimdFloat4 target =
+      ozz::math::simd_float4::Load(-2.f, 1.f, 2.f, 0.f);
+
+  IKChainJob job;
+  job.target = target;
+  job.joints = joints;
+  job.models = make_span(models_);
+  job.corrections = corrections;
+  int iterations = -1;
+  job.iterations = &iterations;
+
+  {  // No iteration means no correction.
+    job.max_iterations = 0;
+    bool reached = true;
+    job.reached = &reached;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FALSE(reached);
+    EXPECT_EQ(iterations, 0);
+    for (const IKCorrectionJob::Correction& correction : corrections) {
+      EXPECT_SIMDQUATERNION_EQ_TOL(correction.rotation, 0.f, 0.f, 0.f, 1.f,
+                                   1e-6f);
+    }
+  }
+
+  {  // Limited iterations.
+    job.max_iterations = 1;
+    ASSERT_TRUE(job.Run());
+    EXPECT_EQ(iterations, 1);
+  }
+
+  {  // A looser tolerance stops iterating earlier.
+    job.max_iterations = 64;
+    job.tolerance = 1e-4f;
+    ASSERT_TRUE(job.Run());
+    const int tight_iterations = iterations;
+    job.tolerance = 1e-1f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_LE(iterations, tight_iterations);
+    EXPECT_GT(iterations, 0);
+  }
+}
+
+TEST_F(IKChainJobTest, Weight) {
+  const int joints[] = {0, 2, 4, 6};
+  IKCorrectionJob::Correction corrections[3];
+
+  const ozz::math::SimdFloat4 target =
+      ozz::math::simd_float4::Load(1.f, 2.f, 1.f, 0.f);
+  IKChainJob job;
+  job.target = target;
+  job.joints = joints;
+  job.models = make_span(models_);
+  job.corrections = corrections;
+  bool reached = true;
+  job.reached = &reached;
+
+  {  // Null weight.
+    job.weight = 0.f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FALSE(reached);
+    for (const IKCorrectionJob::Correction& correction : corrections) {
+      EXPECT_SIMDQUATERNION_EQ_TOL(correction.rotation, 0.f, 0.f, 0.f, 1.f,
+                                   1e-6f);
+    }
+  }
+
+  {  // Negative weight.
+    job.weight = -1.f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FALSE(reached);
+    for (const IKCorrectionJob::Correction& correction : corrections) {
+      EXPECT_SIMDQUATERNION_EQ_TOL(correction.rotation, 0.f, 0.f, 0.f, 1.f,
+                                   1e-6f);
+    }
+  }
+
+  {  // Half weight.
+    job.weight = .5f;
+    ASSERT_TRUE(job.Run());
+    EXPECT_FALSE(reached);
+    ApplyCorrections(corrections);
+    const float distance = ozz::math::GetX(
+        ozz::math::Length3(target - Position(models_[6])));
+    EXPECT_GT(distance, 1e-3f);
+  }
+}
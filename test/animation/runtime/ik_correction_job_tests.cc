@@ -0,0 +1,368 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/ik_correction_job.h"
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::IKCorrectionJob;
+using ozz::animation::LocalToModelJob;
+using ozz::animation::Skeleton;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+
+namespace {
+// Sets joint _joint transform to arbitrary values derived from _seed.
+void SetupJoint(RawSkeleton::Joint* _joint, const char* _name, float _seed) {
+  _joint->name = _name;
+  _joint->transform.translation =
+      ozz::math::Float3(std::sin(_seed), 1.f + std::cos(_seed * 2.f), _seed);
+  _joint->transform.rotation = ozz::math::Quaternion::FromAxisAngle(
+      Normalize(ozz::math::Float3(std::cos(_seed), 1.f, std::sin(_seed * 3.f))),
+      _seed);
+  // Scale is uniform, see IKCorrectionJob.
+  _joint->transform.scale = ozz::math::Float3(.5f + _seed * .2f);
+}
+
+// Builds the following hierarchy:
+// 0 root
+// 1  - a
+// 2    - b
+// 3      - c
+// 4      - d
+// 5    - e
+// 6      - f
+// 7  - g
+// 8    - h
+ozz::unique_ptr<Skeleton> BuildSkeleton() {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  SetupJoint(&root, "root", .1f);
+  root.children.resize(2);
+  RawSkeleton::Joint& a = root.children[0];
+  SetupJoint(&a, "a", .2f);
+  a.children.resize(2);
+  RawSkeleton::Joint& b = a.children[0];
+  SetupJoint(&b, "b", .3f);
+  b.children.resize(2);
+  SetupJoint(&b.children[0], "c", .4f);
+  SetupJoint(&b.children[1], "d", .5f);
+  RawSkeleton::Joint& e = a.children[1];
+  SetupJoint(&e, "e", .6f);
+  e.children.resize(1);
+  SetupJoint(&e.children[0], "f", .7f);
+  RawSkeleton::Joint& g = root.children[1];
+  SetupJoint(&g, "g", .8f);
+  g.children.resize(1);
+  SetupJoint(&g.children[0], "h", .9f);
+
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+
+// Multiplies the local-space rotation of joint _index with _quat.
+void MultiplyLocalRotation(int _index, const ozz::math::SimdQuaternion& _quat,
+                           ozz::math::SoaTransform* _locals) {
+  ozz::math::SoaTransform& soa_transform = _locals[_index / 4];
+  ozz::math::SimdQuaternion aos_quats[4];
+  ozz::math::Transpose4x4(&soa_transform.rotation.x, &aos_quats->xyzw);
+  aos_quats[_index & 3] = aos_quats[_index & 3] * _quat;
+  ozz::math::Transpose4x4(&aos_quats->xyzw, &soa_transform.rotation.x);
+}
+
+void ExpectFloat4x4Near(const ozz::math::Float4x4& _a,
+                        const ozz::math::Float4x4& _b) {
+  for (int c = 0; c < 4; ++c) {
+    float a[4], b[4];
+    ozz::math::StorePtrU(_a.cols[c], a);
+    ozz::math::StorePtrU(_b.cols[c], b);
+    for (int r = 0; r < 4; ++r) {
+      EXPECT_NEAR(a[r], b[r], 1e-4f);
+    }
+  }
+}
+
+// Applies _corrections with IKCorrectionJob, and compares the result with
+// corrections applied to local-space transforms followed by LocalToModelJob.
+void ExpectCorrectionsMatch(
+    const Skeleton& _skeleton,
+    ozz::span<const IKCorrectionJob::Correction> _corrections) {
+  const ozz::span<const ozz::math::SoaTransform> bind_pose =
+      _skeleton.joint_bind_poses();
+  ozz::vector<ozz::math::SoaTransform> locals(bind_pose.begin(),
+                                              bind_pose.end());
+  ozz::vector<ozz::math::Float4x4> models(_skeleton.num_joints());
+
+  LocalToModelJob ltm_job;
+  ltm_job.skeleton = &_skeleton;
+  ltm_job.input = make_span(locals);
+  ltm_job.output = make_span(models);
+  ASSERT_TRUE(ltm_job.Run());
+
+  // Expected results.
+  ozz::vector<ozz::math::SoaTransform> expected_locals = locals;
+  for (const IKCorrectionJob::Correction& correction : _corrections) {
+    MultiplyLocalRotation(correction.joint, correction.rotation,
+                          expected_locals.data());
+  }
+  ozz::vector<ozz::math::Float4x4> expected_models(_skeleton.num_joints());
+  ltm_job.input = make_span(expected_locals);
+  ltm_job.output = make_span(expected_models);
+  ASSERT_TRUE(ltm_job.Run());
+
+  IKCorrectionJob job;
+  job.skeleton = &_skeleton;
+  job.corrections = _corrections;
+  job.models = make_span(models);
+  job.locals = make_span(locals);
+  ASSERT_TRUE(job.Validate());
+  ASSERT_TRUE(job.Run());
+
+  for (int i = 0; i < _skeleton.num_joints(); ++i) {
+    SCOPED_TRACE(i);
+    ExpectFloat4x4Near(models[i], expected_models[i]);
+  }
+  for (size_t i = 0; i < locals.size(); ++i) {
+    EXPECT_SOAQUATERNION_EQ_EST(
+        locals[i].rotation, ozz::math::GetX(expected_locals[i].rotation.x),
+        ozz::math::GetY(expected_locals[i].rotation.x),
+        ozz::math::GetZ(expected_locals[i].rotation.x),
+        ozz::math::GetW(expected_locals[i].rotation.x),
+        ozz::math::GetX(expected_locals[i].rotation.y),
+        ozz::math::GetY(expected_locals[i].rotation.y),
+        ozz::math::GetZ(expected_locals[i].rotation.y),
+        ozz::math::GetW(expected_locals[i].rotation.y),
+        ozz::math::GetX(expected_locals[i].rotation.z),
+        ozz::math::GetY(expected_locals[i].rotation.z),
+        ozz::math::GetZ(expected_locals[i].rotation.z),
+        ozz::math::GetW(expected_locals[i].rotation.z),
+        ozz::math::GetX(expected_locals[i].rotation.w),
+        ozz::math::GetY(expected_locals[i].rotation.w),
+        ozz::math::GetZ(expected_locals[i].rotation.w),
+        ozz::math::GetW(expected_locals[i].rotation.w));
+  }
+}
+
+IKCorrectionJob::Correction MakeCorrection(int _joint, float _angle) {
+  const IKCorrectionJob::Correction correction = {
+      _joint, ozz::math::SimdQuaternion::FromAxisAngle(
+                  ozz::math::Normalize3(ozz::math::simd_float4::Load(
+                      1.f, _angle, -.5f, 0.f)),
+                  ozz::math::simd_float4::Load1(_angle))};
+  return correction;
+}
+}  // namespace
+
+TEST(JobValidity, IKCorrectionJob) {
+  const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 9);
+
+  ozz::math::Float4x4 models[9];
+  ozz::math::SoaTransform locals[3];
+  const IKCorrectionJob::Correction corrections[] = {
+      MakeCorrection(1, .1f), MakeCorrection(3, .2f), MakeCorrection(8, .3f)};
+
+  {  // Default is invalid
+    IKCorrectionJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // No correction is valid.
+    IKCorrectionJob job;
+    job.skeleton = skeleton.get();
+    job.models = models;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Too small models.
+    IKCorrectionJob job;
+    job.skeleton = skeleton.get();
+    job.corrections = corrections;
+    job.models = {models, 8};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Too small locals.
+    IKCorrectionJob job;
+    job.skeleton = skeleton.get();
+    job.corrections = corrections;
+    job.models = models;
+    job.locals = {locals, 2};
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Unsorted corrections.
+    const IKCorrectionJob::Correction unsorted[] = {MakeCorrection(3, .1f),
+                                                    MakeCorrection(1, .2f)};
+    IKCorrectionJob job;
+    job.skeleton = skeleton.get();
+    job.corrections = unsorted;
+    job.models = models;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Duplicated corrections.
+    const IKCorrectionJob::Correction duplicated[] = {MakeCorrection(3, .1f),
+                                                      MakeCorrection(3, .2f)};
+    IKCorrectionJob job;
+    job.skeleton = skeleton.get();
+    job.corrections = duplicated;
+    job.models = models;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Invalid joint index.
+    const IKCorrectionJob::Correction invalid[] = {MakeCorrection(9, .1f)};
+    IKCorrectionJob job;
+    job.skeleton = skeleton.get();
+    job.corrections = invalid;
+    job.models = models;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Too many corrections.
+    IKCorrectionJob::Correction many[IKCorrectionJob::kMaxCorrections + 1];
+    for (int i = 0; i < IKCorrectionJob::kMaxCorrections + 1; ++i) {
+      many[i] = MakeCorrection(i, .1f);
+    }
+    IKCorrectionJob job;
+    job.skeleton = skeleton.get();
+    job.corrections = many;
+    job.models = models;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid
+    IKCorrectionJob job;
+    job.skeleton = skeleton.get();
+    job.corrections = corrections;
+    job.models = models;
+    job.locals = locals;
+    EXPECT_TRUE(job.Validate());
+  }
+}
+
+TEST(Corrections, IKCorrectionJob) {
+  const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+  ASSERT_TRUE(skeleton);
+
+  {  // Root.
+    const IKCorrectionJob::Correction corrections[] = {MakeCorrection(0, .5f)};
+    ExpectCorrectionsMatch(*skeleton, corrections);
+  }
+
+  {  // Leaf.
+    const IKCorrectionJob::Correction corrections[] = {MakeCorrection(4, .5f)};
+    ExpectCorrectionsMatch(*skeleton, corrections);
+  }
+
+  {  // Chain, like a look-at.
+    const IKCorrectionJob::Correction corrections[] = {
+        MakeCorrection(0, .2f), MakeCorrection(1, -.4f), MakeCorrection(2, .6f),
+        MakeCorrection(3, 1.f)};
+    ExpectCorrectionsMatch(*skeleton, corrections);
+  }
+
+  {  // Disjoint hierarchies, like legs.
+    const IKCorrectionJob::Correction corrections[] = {
+        MakeCorrection(2, .2f), MakeCorrection(3, -.4f), MakeCorrection(7, .6f),
+        MakeCorrection(8, 1.f)};
+    ExpectCorrectionsMatch(*skeleton, corrections);
+  }
+
+  {  // Nested and sibling hierarchies.
+    const IKCorrectionJob::Correction corrections[] = {
+        MakeCorrection(1, .3f), MakeCorrection(3, -.7f), MakeCorrection(4, .2f),
+        MakeCorrection(6, 2.f), MakeCorrection(7, -1.f)};
+    ExpectCorrectionsMatch(*skeleton, corrections);
+  }
+
+  {  // Identity.
+    const IKCorrectionJob::Correction corrections[] = {MakeCorrection(1, 0.f)};
+    ExpectCorrectionsMatch(*skeleton, corrections);
+  }
+}
+
+TEST(Sequence, IKCorrectionJob) {
+  // Successive jobs, as IK jobs would, are equivalent to a single one.
+  const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+  ASSERT_TRUE(skeleton);
+
+  const ozz::span<const ozz::math::SoaTransform> bind_pose =
+      skeleton->joint_bind_poses();
+  ozz::vector<ozz::math::SoaTransform> locals(bind_pose.begin(),
+                                              bind_pose.end());
+  ozz::vector<ozz::math::Float4x4> models(skeleton->num_joints());
+  LocalToModelJob ltm_job;
+  ltm_job.skeleton = skeleton.get();
+  ltm_job.input = make_span(locals);
+  ltm_job.output = make_span(models);
+  ASSERT_TRUE(ltm_job.Run());
+  ozz::vector<ozz::math::Float4x4> expected_models = models;
+
+  const IKCorrectionJob::Correction first[] = {MakeCorrection(2, .2f),
+                                               MakeCorrection(3, -.4f)};
+  const IKCorrectionJob::Correction second[] = {MakeCorrection(3, .6f)};
+
+  IKCorrectionJob job;
+  job.skeleton = skeleton.get();
+  job.models = make_span(models);
+  job.corrections = first;
+  ASSERT_TRUE(job.Run());
+  job.corrections = second;
+  ASSERT_TRUE(job.Run());
+
+  MultiplyLocalRotation(2, first[0].rotation, locals.data());
+  MultiplyLocalRotation(3, first[1].rotation, locals.data());
+  MultiplyLocalRotation(3, second[0].rotation, locals.data());
+  ltm_job.output = make_span(expected_models);
+  ASSERT_TRUE(ltm_job.Run());
+
+  for (int i = 0; i < skeleton->num_joints(); ++i) {
+    SCOPED_TRACE(i);
+    ExpectFloat4x4Near(models[i], expected_models[i]);
+  }
+}
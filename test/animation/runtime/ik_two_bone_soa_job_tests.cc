@@ -0,0 +1,311 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/ik_two_bone_soa_job.h"
+
+#include "ozz/animation/runtime/ik_two_bone_job.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/simd_quaternion.h"
+#include "ozz/base/maths/soa_float4x4.h"
+#include "ozz/base/maths/soa_quaternion.h"
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/gtest_math_helper.h"
+
+namespace {
+// Builds a SoaFloat4x4 from 4 Float4x4.
+ozz::math::SoaFloat4x4 ToSoa(const ozz::math::Float4x4 _m[4]) {
+  ozz::math::SoaFloat4x4 soa;
+  for (int c = 0; c < 4; ++c) {
+    const ozz::math::SimdFloat4 cols[4] = {_m[0].cols[c], _m[1].cols[c],
+                                           _m[2].cols[c], _m[3].cols[c]};
+    ozz::math::Transpose4x4(cols, &soa.cols[c].x);
+  }
+  return soa;
+}
+
+// Builds a SoaFloat3 from 4 SimdFloat4.
+ozz::math::SoaFloat3 ToSoa(const ozz::math::SimdFloat4 _v[4]) {
+  ozz::math::SimdFloat4 soa[4];
+  ozz::math::Transpose4x4(_v, soa);
+  return ozz::math::SoaFloat3::Load(soa[0], soa[1], soa[2]);
+}
+
+// Builds a chain of 3 joints from a start transform and 2 local transforms.
+void BuildChain(const ozz::math::SimdFloat4& _position, float _angle,
+                float _mid_angle, float _mid_length, float _end_length,
+                ozz::math::Float4x4 _chain[3]) {
+  using ozz::math::simd_float4::Load;
+  using ozz::math::simd_float4::Load1;
+  const ozz::math::SimdFloat4 axis =
+      ozz::math::Normalize3(Load(.2f, .3f, 1.f, 0.f));
+  _chain[0] = ozz::math::Float4x4::FromAffine(
+      _position,
+      ozz::math::SimdQuaternion::FromAxisAngle(axis, Load1(_angle)).xyzw,
+      ozz::math::simd_float4::one());
+  _chain[1] =
+      _chain[0] *
+      ozz::math::Float4x4::FromAffine(
+          Load(0.f, _mid_length, 0.f, 0.f),
+          ozz::math::SimdQuaternion::FromAxisAngle(
+              ozz::math::simd_float4::z_axis(), Load1(_mid_angle))
+              .xyzw,
+          ozz::math::simd_float4::one());
+  _chain[2] = _chain[1] * ozz::math::Float4x4::Translation(
+                              Load(_end_length, 0.f, 0.f, 0.f));
+}
+
+// Runs IKTwoBoneSoaJob with 4 IKTwoBoneJob setups and compares outputs of
+// every lane.
+void ExpectSoaMatches(const ozz::animation::IKTwoBoneJob _jobs[4]) {
+  ozz::math::Float4x4 starts[4], mids[4], ends[4];
+  ozz::math::SimdFloat4 targets[4], mid_axes[4], poles[4];
+  for (int i = 0; i < 4; ++i) {
+    starts[i] = *_jobs[i].start_joint;
+    mids[i] = *_jobs[i].mid_joint;
+    ends[i] = *_jobs[i].end_joint;
+    targets[i] = _jobs[i].target;
+    mid_axes[i] = _jobs[i].mid_axis;
+    poles[i] = _jobs[i].pole_vector;
+  }
+  const ozz::math::SoaFloat4x4 start = ToSoa(starts);
+  const ozz::math::SoaFloat4x4 mid = ToSoa(mids);
+  const ozz::math::SoaFloat4x4 end = ToSoa(ends);
+
+  ozz::animation::IKTwoBoneSoaJob job;
+  job.target = ToSoa(targets);
+  job.mid_axis = ToSoa(mid_axes);
+  job.pole_vector = ToSoa(poles);
+  job.twist_angle =
+      ozz::math::simd_float4::Load(_jobs[0].twist_angle, _jobs[1].twist_angle,
+                                   _jobs[2].twist_angle, _jobs[3].twist_angle);
+  job.soften = ozz::math::simd_float4::Load(
+      _jobs[0].soften, _jobs[1].soften, _jobs[2].soften, _jobs[3].soften);
+  job.weight = ozz::math::simd_float4::Load(
+      _jobs[0].weight, _jobs[1].weight, _jobs[2].weight, _jobs[3].weight);
+  job.start_joint = &start;
+  job.mid_joint = &mid;
+  job.end_joint = &end;
+  ozz::math::SoaQuaternion start_correction, mid_correction;
+  job.start_joint_correction = &start_correction;
+  job.mid_joint_correction = &mid_correction;
+  ozz::math::SimdInt4 reached;
+  job.reached = &reached;
+  ASSERT_TRUE(job.Validate());
+  ASSERT_TRUE(job.Run());
+
+  ozz::math::SimdFloat4 start_corrections[4], mid_corrections[4];
+  ozz::math::Transpose4x4(&start_correction.x, start_corrections);
+  ozz::math::Transpose4x4(&mid_correction.x, mid_corrections);
+  const int reached_mask = ozz::math::MoveMask(reached);
+
+  // Operations order differs from IKTwoBoneJob, which leads to small
+  // differences that are amplified by acos when chains are almost straight.
+  const float kTolerance = 1e-3f;
+  for (int i = 0; i < 4; ++i) {
+    ozz::animation::IKTwoBoneJob scalar = _jobs[i];
+    ozz::math::SimdQuaternion start_expected, mid_expected;
+    scalar.start_joint_correction = &start_expected;
+    scalar.mid_joint_correction = &mid_expected;
+    bool reached_expected;
+    scalar.reached = &reached_expected;
+    ASSERT_TRUE(scalar.Run());
+
+    EXPECT_SIMDQUATERNION_EQ_TOL(
+        start_expected, ozz::math::GetX(start_corrections[i]),
+        ozz::math::GetY(start_corrections[i]),
+        ozz::math::GetZ(start_corrections[i]),
+        ozz::math::GetW(start_corrections[i]), kTolerance);
+    EXPECT_SIMDQUATERNION_EQ_TOL(
+        mid_expected, ozz::math::GetX(mid_corrections[i]),
+        ozz::math::GetY(mid_corrections[i]),
+        ozz::math::GetZ(mid_corrections[i]),
+        ozz::math::GetW(mid_corrections[i]), kTolerance);
+    EXPECT_EQ((reached_mask & (1 << i)) != 0, reached_expected);
+  }
+}
+}  // namespace
+
+TEST(JobValidity, IKTwoBoneSoaJob) {
+  const ozz::math::SoaFloat4x4 matrix = ozz::math::SoaFloat4x4::identity();
+  ozz::math::SoaQuaternion quat;
+
+  {  // Default is invalid
+    ozz::animation::IKTwoBoneSoaJob job;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Missing start joint matrix
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.mid_joint = &matrix;
+    job.end_joint = &matrix;
+    job.start_joint_correction = &quat;
+    job.mid_joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Missing mid joint matrix
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.start_joint = &matrix;
+    job.end_joint = &matrix;
+    job.start_joint_correction = &quat;
+    job.mid_joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Missing end joint matrix
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.start_joint = &matrix;
+    job.mid_joint = &matrix;
+    job.start_joint_correction = &quat;
+    job.mid_joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Missing start joint output quaternion
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.start_joint = &matrix;
+    job.mid_joint = &matrix;
+    job.end_joint = &matrix;
+    job.mid_joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Missing mid joint output quaternion
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.start_joint = &matrix;
+    job.mid_joint = &matrix;
+    job.end_joint = &matrix;
+    job.start_joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Unnormalized mid axis
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.mid_axis = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::zero(), ozz::math::simd_float4::zero(),
+        ozz::math::simd_float4::Load(1.f, 1.f, 1.1f, 1.f));
+    job.start_joint = &matrix;
+    job.mid_joint = &matrix;
+    job.end_joint = &matrix;
+    job.start_joint_correction = &quat;
+    job.mid_joint_correction = &quat;
+    EXPECT_FALSE(job.Validate());
+  }
+
+  {  // Valid
+    ozz::animation::IKTwoBoneSoaJob job;
+    job.start_joint = &matrix;
+    job.mid_joint = &matrix;
+    job.end_joint = &matrix;
+    job.start_joint_correction = &quat;
+    job.mid_joint_correction = &quat;
+    EXPECT_TRUE(job.Validate());
+  }
+}
+
+TEST(Lanes, IKTwoBoneSoaJob) {
+  using ozz::math::simd_float4::Load;
+
+  // 4 different chains. Chain 2 length isn't a power of 2, as soften RcpEst
+  // would then differ by 2e-4 from one ulp to the next, which acos amplifies
+  // when the chain is almost folded.
+  ozz::math::Float4x4 chains[4][3];
+  BuildChain(Load(0.f, 0.f, 0.f, 1.f), 0.f, ozz::math::kPi_2, 1.f, 1.f,
+             chains[0]);
+  BuildChain(Load(1.f, 2.f, 3.f, 1.f), .7f, .3f, 2.f, 1.f, chains[1]);
+  BuildChain(Load(-1.f, 0.f, 2.f, 1.f), -1.2f, 2.f, .5f, 1.4f, chains[2]);
+  BuildChain(Load(0.f, -3.f, 1.f, 1.f), 2.5f, -.5f, 1.f, .25f, chains[3]);
+
+  // Targets are offsets from start joints, some reachable, some too close or
+  // too far. Degenerated cases (target on start joint or aligned with pole
+  // vector) are unstable, see IKTwoBoneJob, so they're avoided.
+  const ozz::math::SimdFloat4 offsets[] = {
+      Load(1.f, 1.f, 0.f, 0.f),   Load(0.f, 1.5f, .5f, 0.f),
+      Load(-.2f, .1f, .3f, 0.f),  Load(3.f, -1.f, 2.f, 0.f),
+      Load(.5f, -1.f, -.3f, 0.f), Load(.1f, 0.f, -.2f, 0.f),
+      Load(-.1f, 2.f, -1.f, 0.f), Load(.7f, .2f, -.9f, 0.f)};
+  const int num_offsets = static_cast<int>(OZZ_ARRAY_SIZE(offsets));
+  const ozz::math::SimdFloat4 poles[] = {
+      ozz::math::simd_float4::y_axis(),
+      ozz::math::Normalize3(Load(1.f, 1.f, 1.f, 0.f)),
+      ozz::math::simd_float4::x_axis(), -ozz::math::simd_float4::z_axis()};
+  const ozz::math::SimdFloat4 mid_axes[] = {
+      ozz::math::simd_float4::z_axis(), -ozz::math::simd_float4::z_axis(),
+      ozz::math::simd_float4::z_axis(), ozz::math::simd_float4::z_axis()};
+  const float twists[] = {0.f, .5f, 0.f, -1.f};
+  const float softens[] = {1.f, .9f, .5f, 1.f, 0.f};
+  const float weights[] = {1.f, .5f, 0.f, 1.2f, -.1f, .9f};
+  const int num_softens = static_cast<int>(OZZ_ARRAY_SIZE(softens));
+  const int num_weights = static_cast<int>(OZZ_ARRAY_SIZE(weights));
+
+  for (int t = 0; t < num_offsets; ++t) {
+    for (int s = 0; s < num_softens; ++s) {
+      for (int w = 0; w < num_weights; ++w) {
+        for (int uniform_twist = 0; uniform_twist < 2; ++uniform_twist) {
+          ozz::animation::IKTwoBoneJob jobs[4];
+          for (int i = 0; i < 4; ++i) {
+            jobs[i].start_joint = &chains[i][0];
+            jobs[i].mid_joint = &chains[i][1];
+            jobs[i].end_joint = &chains[i][2];
+            jobs[i].target =
+                chains[i][0].cols[3] + offsets[(t + i) % num_offsets];
+            jobs[i].pole_vector = poles[i];
+            jobs[i].mid_axis = mid_axes[i];
+            jobs[i].twist_angle = uniform_twist ? 0.f : twists[i];
+            jobs[i].soften = softens[(s + i) % num_softens];
+            jobs[i].weight = weights[(w + i) % num_weights];
+          }
+          ExpectSoaMatches(jobs);
+        }
+      }
+    }
+  }
+}
+
+TEST(ZeroWeight, IKTwoBoneSoaJob) {
+  const ozz::math::SoaFloat4x4 matrix = ozz::math::SoaFloat4x4::identity();
+  ozz::math::SoaQuaternion start_correction, mid_correction;
+  ozz::math::SimdInt4 reached = ozz::math::simd_int4::all_true();
+
+  ozz::animation::IKTwoBoneSoaJob job;
+  job.target = ozz::math::SoaFloat3::x_axis();
+  job.weight = ozz::math::simd_float4::zero();
+  job.start_joint = &matrix;
+  job.mid_joint = &matrix;
+  job.end_joint = &matrix;
+  job.start_joint_correction = &start_correction;
+  job.mid_joint_correction = &mid_correction;
+  job.reached = &reached;
+  ASSERT_TRUE(job.Run());
+
+  EXPECT_SOAQUATERNION_EQ(start_correction, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                          0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f);
+  EXPECT_SOAQUATERNION_EQ(mid_correction, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+                          0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f);
+  EXPECT_SIMDINT_EQ(reached, 0, 0, 0, 0);
+}
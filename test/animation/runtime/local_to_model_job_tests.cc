@@ -30,6 +30,7 @@
 #include "ozz/animation/offline/skeleton_builder.h"
 #include "ozz/animation/runtime/local_to_model_job.h"
 #include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/gtest_math_helper.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/unique_ptr.h"
@@ -1008,6 +1009,456 @@ TEST(TransformationFromToExclude, LocalToModel) {
   }
 }
 
+namespace {
+// Builds the skeleton
+/*
+ 8 joints
+       *
+     /   \
+   j0    j7
+  /  \
+ j1  j3
+  |  / \
+ j2 j4 j6
+     |
+    j5
+*/
+ozz::unique_ptr<Skeleton> BuildSkeleton8() {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(2);
+  RawSkeleton::Joint& j0 = raw_skeleton.roots[0];
+  j0.name = "j0";
+  RawSkeleton::Joint& j7 = raw_skeleton.roots[1];
+  j7.name = "j7";
+
+  j0.children.resize(2);
+  j0.children[0].name = "j1";
+  j0.children[1].name = "j3";
+
+  j0.children[0].children.resize(1);
+  j0.children[0].children[0].name = "j2";
+
+  j0.children[1].children.resize(2);
+  j0.children[1].children[0].name = "j4";
+  j0.children[1].children[1].name = "j6";
+
+  j0.children[1].children[0].children.resize(1);
+  j0.children[1].children[0].children[0].name = "j5";
+
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+
+// Fills 2 soa transforms with different translations, rotations and scales
+// for every joint.
+void FillInput8(ozz::math::SoaTransform _input[2]) {
+  for (int i = 0; i < 2; ++i) {
+    const float f = i * 4.f;
+    _input[i].translation = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(f, f + 1.f, f + 2.f, f + 3.f),
+        ozz::math::simd_float4::Load(1.f, -1.f, 2.f, -2.f),
+        ozz::math::simd_float4::Load(3.f, 0.f, -3.f, 1.f));
+    _input[i].rotation = ozz::math::SoaQuaternion::Load(
+        ozz::math::simd_float4::Load(0.f, .70710677f, 0.f, 0.f),
+        ozz::math::simd_float4::Load(0.f, 0.f, .70710677f, 0.f),
+        ozz::math::simd_float4::Load(.70710677f, 0.f, 0.f, 0.f),
+        ozz::math::simd_float4::Load(.70710677f, .70710677f, .70710677f, 1.f));
+    _input[i].scale = ozz::math::SoaFloat3::Load(
+        ozz::math::simd_float4::Load(1.f, 2.f, 1.f, .5f),
+        ozz::math::simd_float4::Load(1.f, 2.f, 1.f, .5f),
+        ozz::math::simd_float4::Load(1.f, 2.f, 1.f, .5f));
+  }
+}
+}  // namespace
+
+TEST(TransformationMask, LocalToModel) {
+  ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton8();
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 8);
+
+  ozz::math::SoaTransform input[2];
+  FillInput8(input);
+
+  // Computes expected outputs for the whole hierarchy.
+  ozz::math::Float4x4 expected[8];
+  LocalToModelJob job_full;
+  job_full.skeleton = skeleton.get();
+  job_full.input = input;
+  job_full.output = expected;
+  ASSERT_TRUE(job_full.Run());
+
+  struct {
+    uint8_t mask;
+    int from;
+    int to;
+    bool from_excluded;
+    uint8_t valid;  // Expected valid joints.
+  } cases[] = {
+      {0x00, Skeleton::kNoParent, Skeleton::kMaxJoints, false, 0x00},
+      {0xff, Skeleton::kNoParent, Skeleton::kMaxJoints, false, 0xff},
+      {0x04, Skeleton::kNoParent, Skeleton::kMaxJoints, false, 0x07},
+      {0x20, Skeleton::kNoParent, Skeleton::kMaxJoints, false, 0x39},
+      {0x84, Skeleton::kNoParent, Skeleton::kMaxJoints, false, 0x87},
+      {0x44, Skeleton::kNoParent, Skeleton::kMaxJoints, false, 0x4f},
+      {0x28, Skeleton::kNoParent, Skeleton::kMaxJoints, false, 0x39},
+      {0x20, 3, Skeleton::kMaxJoints, false, 0x38},
+      // j3 is excluded, its valid output is used.
+      {0x20, 3, Skeleton::kMaxJoints, true, 0x38},
+      // j7 is selected, but after "to".
+      {0xa4, Skeleton::kNoParent, 5, false, 0x3f},
+  };
+
+  for (size_t c = 0; c < OZZ_ARRAY_SIZE(cases); ++c) {
+    ozz::math::Float4x4 output[8];
+    for (int i = 0; i < 8; ++i) {
+      output[i] = ozz::math::Float4x4::identity();
+    }
+    // "from" parent, and "from" itself when excluded, are expected to be
+    // valid.
+    output[0] = expected[0];
+    if (cases[c].from_excluded) {
+      output[cases[c].from] = expected[cases[c].from];
+    }
+
+    LocalToModelJob job;
+    job.skeleton = skeleton.get();
+    job.from = cases[c].from;
+    job.to = cases[c].to;
+    job.from_excluded = cases[c].from_excluded;
+    job.mask = ozz::span<const uint8_t>(&cases[c].mask, 1);
+    job.input = input;
+    job.output = output;
+    ASSERT_TRUE(job.Validate());
+    ASSERT_TRUE(job.Run());
+
+    for (int i = 1; i < 8; ++i) {
+      const ozz::math::Float4x4& ref = cases[c].valid & (1 << i)
+                                           ? expected[i]
+                                           : ozz::math::Float4x4::identity();
+      EXPECT_EQ(memcmp(&output[i], &ref, sizeof(ref)), 0)
+          << "case " << c << ", joint " << i;
+    }
+  }
+}
+
+TEST(TransformationDirty, LocalToModel) {
+  ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton8();
+  ASSERT_TRUE(skeleton);
+
+  ozz::math::SoaTransform input[2];
+  FillInput8(input);
+
+  // Initializes previous outputs.
+  ozz::math::Float4x4 output[8];
+  LocalToModelJob job;
+  job.skeleton = skeleton.get();
+  job.input = input;
+  job.output = output;
+  ASSERT_TRUE(job.Run());
+
+  // Changes local transforms of j3 and j4.
+  ozz::math::SoaTransform changed[2] = {input[0], input[1]};
+  changed[0].translation.x = ozz::math::simd_float4::Load(0.f, 1.f, 2.f, 5.f);
+  changed[1].rotation.x =
+      ozz::math::simd_float4::Load(.70710677f, .70710677f, 0.f, 0.f);
+  changed[1].rotation.z = ozz::math::simd_float4::zero();
+  ozz::math::Float4x4 expected[8];
+  LocalToModelJob job_full;
+  job_full.skeleton = skeleton.get();
+  job_full.input = changed;
+  job_full.output = expected;
+  ASSERT_TRUE(job_full.Run());
+
+  const ozz::math::Float4x4 root = ozz::math::Float4x4::Translation(
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f));
+  ozz::math::Float4x4 expected_root[8];
+  job_full.root = &root;
+  job_full.output = expected_root;
+  ASSERT_TRUE(job_full.Run());
+
+  struct {
+    uint8_t dirty;
+    bool root;
+    int from;
+    uint8_t updated;  // Expected updated joints.
+  } cases[] = {{0x00, false, Skeleton::kNoParent, 0x00},
+               {0x08, false, Skeleton::kNoParent, 0x78},
+               {0x18, false, Skeleton::kNoParent, 0x78},
+               {0x18, false, 3, 0x78},
+               {0x81, true, Skeleton::kNoParent, 0xff},
+               {0xff, false, Skeleton::kNoParent, 0xff}};
+
+  for (size_t c = 0; c < OZZ_ARRAY_SIZE(cases); ++c) {
+    ozz::math::Float4x4 incremental[8];
+    memcpy(incremental, output, sizeof(output));
+
+    LocalToModelJob job_dirty;
+    job_dirty.skeleton = skeleton.get();
+    job_dirty.root = cases[c].root ? &root : nullptr;
+    job_dirty.from = cases[c].from;
+    job_dirty.dirty = ozz::span<const uint8_t>(&cases[c].dirty, 1);
+    job_dirty.input = changed;
+    job_dirty.output = incremental;
+    ASSERT_TRUE(job_dirty.Validate());
+    ASSERT_TRUE(job_dirty.Run());
+
+    const ozz::math::Float4x4* updated = cases[c].root ? expected_root
+                                                       : expected;
+    for (int i = 0; i < 8; ++i) {
+      const ozz::math::Float4x4& ref =
+          cases[c].updated & (1 << i) ? updated[i] : output[i];
+      EXPECT_EQ(memcmp(&incremental[i], &ref, sizeof(ref)), 0)
+          << "case " << c << ", joint " << i;
+    }
+  }
+
+  {  // Combined with mask, j6 isn't updated.
+    ozz::math::Float4x4 incremental[8];
+    memcpy(incremental, output, sizeof(output));
+
+    const uint8_t dirty = 0x08;
+    const uint8_t mask = 0x20;
+    LocalToModelJob job_dirty;
+    job_dirty.skeleton = skeleton.get();
+    job_dirty.dirty = ozz::span<const uint8_t>(&dirty, 1);
+    job_dirty.mask = ozz::span<const uint8_t>(&mask, 1);
+    job_dirty.input = changed;
+    job_dirty.output = incremental;
+    ASSERT_TRUE(job_dirty.Run());
+    for (int i = 0; i < 8; ++i) {
+      const ozz::math::Float4x4& ref =
+          0x38 & (1 << i) ? expected[i] : output[i];
+      EXPECT_EQ(memcmp(&incremental[i], &ref, sizeof(ref)), 0)
+          << "joint " << i;
+    }
+  }
+}
+
+TEST(TransformationDirtySkip, LocalToModel) {
+  // Builds a chain of 20 joints, so dirty flags span multiple bytes.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint* joint = &raw_skeleton.roots[0];
+  for (int i = 0; i < 20; ++i) {
+    joint->name = "joint";
+    joint->transform = ozz::math::Transform::identity();
+    joint->transform.translation = ozz::math::Float3(1.f, 0.f, 0.f);
+    if (i != 19) {
+      joint->children.resize(1);
+      joint = &joint->children[0];
+    }
+  }
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), 20);
+
+  ozz::math::SoaTransform input[5];
+  for (int i = 0; i < 5; ++i) {
+    input[i] = skeleton->joint_bind_poses()[i];
+  }
+  ozz::math::Float4x4 output[20];
+  LocalToModelJob job;
+  job.skeleton = skeleton.get();
+  job.input = input;
+  job.output = output;
+  ASSERT_TRUE(job.Run());
+  EXPECT_FLOAT4x4_EQ(output[19], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 20.f, 0.f, 0.f, 1.f);
+
+  // Changes joint 17 translation, and flags it dirty.
+  input[4].translation.y = ozz::math::simd_float4::Load(0.f, 2.f, 0.f, 0.f);
+  const uint8_t dirty[] = {0x00, 0x00, 0x02};
+  job.dirty = dirty;
+  ASSERT_TRUE(job.Run());
+  EXPECT_FLOAT4x4_EQ(output[16], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 17.f, 0.f, 0.f, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[17], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 18.f, 2.f, 0.f, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[19], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 20.f, 2.f, 0.f, 1.f);
+
+  // Nothing is updated if no joint is dirty.
+  const uint8_t clean[] = {0x00, 0x00, 0x00};
+  job.dirty = clean;
+  input[0].translation.y = ozz::math::simd_float4::Load(5.f, 0.f, 0.f, 0.f);
+  ASSERT_TRUE(job.Run());
+  EXPECT_FLOAT4x4_EQ(output[19], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 20.f, 2.f, 0.f, 1.f);
+}
+
+TEST(TransformationMaskChunks, LocalToModel) {
+  // Builds a root with two chains of 1500 joints, so that chains span multiple
+  // mask closure chunks.
+  const int kChainLength = 1500;
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.name = "root";
+  root.transform = ozz::math::Transform::identity();
+  root.children.resize(2);
+  for (RawSkeleton::Joint& chain : root.children) {
+    RawSkeleton::Joint* joint = &chain;
+    for (int i = 0; i < kChainLength; ++i) {
+      joint->name = "joint";
+      joint->transform = ozz::math::Transform::identity();
+      joint->transform.translation = ozz::math::Float3(1.f, 0.f, 0.f);
+      if (i != kChainLength - 1) {
+        joint->children.resize(1);
+        joint = &joint->children[0];
+      }
+    }
+  }
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  const int num_joints = skeleton->num_joints();
+  ASSERT_EQ(num_joints, 1 + 2 * kChainLength);
+
+  ozz::vector<ozz::math::SoaTransform> input(
+      skeleton->joint_bind_poses().begin(), skeleton->joint_bind_poses().end());
+  ozz::vector<ozz::math::Float4x4> output(num_joints,
+                                          ozz::math::Float4x4::identity());
+
+  // Selects the last joint of the second chain only.
+  const int last = num_joints - 1;
+  ozz::vector<uint8_t> mask((num_joints + 7) / 8, 0);
+  mask[last / 8] = static_cast<uint8_t>(1 << (last & 7));
+
+  LocalToModelJob job;
+  job.skeleton = skeleton.get();
+  job.mask = make_span(mask);
+  job.input = make_span(input);
+  job.output = make_span(output);
+  ASSERT_TRUE(job.Run());
+
+  // Root and second chain are updated, first chain isn't.
+  const ozz::math::Float4x4 identity = ozz::math::Float4x4::identity();
+  for (int i = 0; i < num_joints; ++i) {
+    if (i == 0 || i > kChainLength) {
+      const float x = i == 0 ? 0.f : static_cast<float>(i - kChainLength);
+      EXPECT_FLOAT4x4_EQ(output[i], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+                         0.f, 0.f, 1.f, 0.f, x, 0.f, 0.f, 1.f);
+    } else {
+      EXPECT_EQ(memcmp(&output[i], &identity, sizeof(identity)), 0)
+          << "joint " << i;
+    }
+  }
+
+  // Updates all joints.
+  job.mask = {};
+  ASSERT_TRUE(job.Run());
+
+  // Changes the first joint of both chains, but flags only the first chain
+  // dirty.
+  const int second = kChainLength + 1;
+  alignas(16) float offset[4] = {0.f, 0.f, 0.f, 0.f};
+  offset[1 & 3] = 2.f;
+  input[1 / 4].translation.y =
+      input[1 / 4].translation.y + ozz::math::simd_float4::LoadPtr(offset);
+  offset[1 & 3] = 0.f;
+  offset[second & 3] = 2.f;
+  input[second / 4].translation.y =
+      input[second / 4].translation.y + ozz::math::simd_float4::LoadPtr(offset);
+
+  ozz::vector<uint8_t> dirty((num_joints + 7) / 8, 0);
+  dirty[0] = 1 << 1;
+  job.dirty = make_span(dirty);
+  ASSERT_TRUE(job.Run());
+
+  EXPECT_FLOAT4x4_EQ(output[kChainLength], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f,
+                     0.f, 0.f, 0.f, 1.f, 0.f, static_cast<float>(kChainLength),
+                     2.f, 0.f, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[last], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+                     0.f, 0.f, 1.f, 0.f, static_cast<float>(kChainLength), 0.f,
+                     0.f, 1.f);
+}
+
+TEST(TransformationMaxJoints, LocalToModel) {
+  // Builds a "mega" skeleton of the maximum number of joints, made of a root
+  // with many children, which all have a single child.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  RawSkeleton::Joint& root = raw_skeleton.roots[0];
+  root.name = "root";
+  root.transform = ozz::math::Transform::identity();
+  root.children.resize((Skeleton::kMaxJoints - 1) / 2);
+  int index = 0;
+  for (RawSkeleton::Joint& child : root.children) {
+    child.name = "child";
+    child.transform = ozz::math::Transform::identity();
+    child.transform.translation = ozz::math::Float3(
+        static_cast<float>(index % 7), static_cast<float>(index % 5), 1.f);
+    child.children.resize(1);
+    RawSkeleton::Joint& leaf = child.children[0];
+    leaf.name = "leaf";
+    leaf.transform = ozz::math::Transform::identity();
+    leaf.transform.translation = ozz::math::Float3(
+        static_cast<float>(index % 3), 1.f, static_cast<float>(index % 11));
+    ++index;
+  }
+  SkeletonBuilder builder;
+  ozz::unique_ptr<Skeleton> skeleton(builder(raw_skeleton));
+  ASSERT_TRUE(skeleton);
+  ASSERT_EQ(skeleton->num_joints(), Skeleton::kMaxJoints);
+
+  ozz::vector<ozz::math::SoaTransform> input(
+      skeleton->joint_bind_poses().begin(), skeleton->joint_bind_poses().end());
+  ozz::vector<ozz::math::Float4x4> output(skeleton->num_joints());
+
+  LocalToModelJob job;
+  job.skeleton = skeleton.get();
+  job.input = make_span(input);
+  job.output = make_span(output);
+  ASSERT_TRUE(job.Run());
+
+  // Model space translations are the sum of the ancestors' ones.
+  const ozz::span<const int32_t> parents = skeleton->joint_parents();
+  ozz::vector<ozz::math::Float3> sums(skeleton->num_joints());
+  for (int i = 0; i < skeleton->num_joints(); ++i) {
+    alignas(16) float translation[3][4];
+    ozz::math::StorePtr(input[i / 4].translation.x, translation[0]);
+    ozz::math::StorePtr(input[i / 4].translation.y, translation[1]);
+    ozz::math::StorePtr(input[i / 4].translation.z, translation[2]);
+    const ozz::math::Float3 local(
+        translation[0][i & 3], translation[1][i & 3], translation[2][i & 3]);
+    sums[i] = parents[i] == Skeleton::kNoParent
+                      ? local
+                      : sums[parents[i]] + local;
+    EXPECT_FLOAT4x4_EQ(output[i], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                       0.f, 1.f, 0.f, sums[i].x, sums[i].y,
+                       sums[i].z, 1.f);
+  }
+
+  // Changes the last child joint, and updates it through dirty flags. Root
+  // joint is also changed, but isn't flagged so it's not updated.
+  const int last = Skeleton::kMaxJoints - 2;
+  ASSERT_EQ(parents[last], 0);
+  alignas(16) float offset[4] = {0.f, 0.f, 0.f, 0.f};
+  offset[last & 3] = 10.f;
+  input[last / 4].translation.y =
+      input[last / 4].translation.y + ozz::math::simd_float4::LoadPtr(offset);
+  input[0].translation.x = ozz::math::simd_float4::Load(5.f, 0.f, 0.f, 0.f);
+
+  ozz::vector<uint8_t> dirty((Skeleton::kMaxJoints + 7) / 8, 0);
+  dirty[last / 8] = static_cast<uint8_t>(1 << (last & 7));
+  job.dirty = make_span(dirty);
+  ASSERT_TRUE(job.Run());
+
+  EXPECT_FLOAT4x4_EQ(output[0], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, sums[0].x, sums[0].y,
+                     sums[0].z, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[last - 1], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+                     0.f, 0.f, 1.f, 0.f, sums[last - 1].x,
+                     sums[last - 1].y, sums[last - 1].z, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[last], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+                     0.f, 0.f, 1.f, 0.f, sums[last].x,
+                     sums[last].y + 10.f, sums[last].z, 1.f);
+  EXPECT_FLOAT4x4_EQ(output[last + 1], 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+                     0.f, 0.f, 1.f, 0.f, sums[last + 1].x,
+                     sums[last + 1].y + 10.f, sums[last + 1].z, 1.f);
+}
+
 TEST(Empty, LocalToModel) {
   Skeleton skeleton;
 
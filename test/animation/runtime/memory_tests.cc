@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/tracking_allocator.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::Animation;
+using ozz::animation::FloatTrack;
+using ozz::animation::SamplingCache;
+using ozz::animation::Skeleton;
+using ozz::animation::offline::AnimationBuilder;
+using ozz::animation::offline::RawAnimation;
+using ozz::animation::offline::RawFloatTrack;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+using ozz::animation::offline::TrackBuilder;
+using ozz::memory::TrackingAllocator;
+
+TEST(Size, Runtime) {
+  // Empty objects.
+  EXPECT_EQ(Skeleton().size(), sizeof(Skeleton));
+  EXPECT_EQ(Animation().size(), sizeof(Animation));
+  EXPECT_EQ(FloatTrack().size(), sizeof(FloatTrack));
+  EXPECT_EQ(SamplingCache().size(), sizeof(SamplingCache));
+
+  // Size grows with content.
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(1);
+  raw_skeleton.roots[0].name = "root";
+  raw_skeleton.roots[0].children.resize(6);
+  SkeletonBuilder skeleton_builder;
+  ozz::unique_ptr<Skeleton> skeleton = skeleton_builder(raw_skeleton);
+  ASSERT_TRUE(skeleton);
+  EXPECT_EQ(skeleton->num_joints(), 7);
+  EXPECT_GE(skeleton->size(),
+            sizeof(Skeleton) +
+                skeleton->num_soa_joints() * sizeof(ozz::math::SoaTransform) +
+                7 * (sizeof(int32_t) + sizeof(char*)) + 5);
+
+  const SamplingCache cache4(4);
+  const SamplingCache cache5(5);
+  EXPECT_GT(cache4.size(), sizeof(SamplingCache));
+  EXPECT_GT(cache5.size(), cache4.size());
+}
+
+TEST(Tracking, Runtime) {
+  TrackingAllocator tracking(ozz::memory::default_allocator());
+  ozz::memory::Allocator* previous =
+      ozz::memory::SetDefaulAllocator(&tracking);
+
+  {
+    RawSkeleton raw_skeleton;
+    raw_skeleton.roots.resize(1);
+    raw_skeleton.roots[0].name = "root";
+    raw_skeleton.roots[0].children.resize(6);
+    SkeletonBuilder skeleton_builder;
+    ozz::unique_ptr<Skeleton> skeleton = skeleton_builder(raw_skeleton);
+    ASSERT_TRUE(skeleton);
+
+    RawAnimation raw_animation;
+    raw_animation.duration = 1.f;
+    raw_animation.tracks.resize(skeleton->num_joints());
+    raw_animation.name = "animation";
+    AnimationBuilder animation_builder;
+    ozz::unique_ptr<Animation> animation = animation_builder(raw_animation);
+    ASSERT_TRUE(animation);
+
+    RawFloatTrack raw_track;
+    const RawFloatTrack::Keyframe key = {
+        ozz::animation::offline::RawTrackInterpolation::kLinear, .5f, 46.f};
+    raw_track.keyframes.push_back(key);
+    TrackBuilder track_builder;
+    ozz::unique_ptr<FloatTrack> track = track_builder(raw_track);
+    ASSERT_TRUE(track);
+
+    SamplingCache cache(skeleton->num_joints());
+
+    // Runtime objects data are tagged, objects themselves are allocated by
+    // builders.
+    EXPECT_EQ(tracking.statistics(ozz::memory::kSkeleton).bytes,
+              skeleton->size() - sizeof(Skeleton));
+    EXPECT_EQ(tracking.statistics(ozz::memory::kSkeleton).blocks, 1u);
+    EXPECT_GE(tracking.statistics(ozz::memory::kAnimation).bytes,
+              animation->size() - sizeof(Animation));
+    EXPECT_EQ(tracking.statistics(ozz::memory::kAnimation).blocks, 1u);
+    EXPECT_GE(tracking.statistics(ozz::memory::kTrack).bytes,
+              track->size() - sizeof(FloatTrack));
+    EXPECT_EQ(tracking.statistics(ozz::memory::kTrack).blocks, 1u);
+    EXPECT_EQ(tracking.statistics(ozz::memory::kCache).bytes,
+              cache.size() - sizeof(SamplingCache));
+    EXPECT_EQ(tracking.statistics(ozz::memory::kCache).blocks, 1u);
+
+    // Builders temporary allocations are released, only runtime objects
+    // remain.
+    EXPECT_EQ(tracking.statistics(ozz::memory::kBuilder).blocks, 3u);
+    EXPECT_GT(tracking.statistics(ozz::memory::kBuilder).peak_bytes,
+              tracking.statistics(ozz::memory::kBuilder).bytes);
+  }
+
+  // Everything is released.
+  EXPECT_EQ(tracking.total().bytes, 0u);
+  EXPECT_EQ(tracking.total().blocks, 0u);
+
+  EXPECT_EQ(ozz::memory::SetDefaulAllocator(previous), &tracking);
+}
@@ -0,0 +1,244 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/model_space_query_job.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/runtime/local_to_model_job.h"
+#include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/maths/soa_transform.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::Animation;
+using ozz::animation::LocalToModelJob;
+using ozz::animation::ModelSpaceQueryJob;
+using ozz::animation::SamplingCache;
+using ozz::animation::SamplingJob;
+using ozz::animation::Skeleton;
+using ozz::animation::offline::AnimationBuilder;
+using ozz::animation::offline::RawAnimation;
+using ozz::animation::offline::RawSkeleton;
+using ozz::animation::offline::SkeletonBuilder;
+
+namespace {
+// Recursively adds _depth levels of 2 children to _joint.
+void AddChildren(RawSkeleton::Joint* _joint, int _depth) {
+  if (_depth == 0) {
+    return;
+  }
+  _joint->children.resize(2);
+  for (size_t i = 0; i < _joint->children.size(); ++i) {
+    _joint->children[i].name = "joint";
+    AddChildren(&_joint->children[i], _depth - 1);
+  }
+}
+
+// Builds a skeleton with 2 roots, both being binary trees of depth 3, so 30
+// joints.
+ozz::unique_ptr<Skeleton> BuildSkeleton() {
+  RawSkeleton raw_skeleton;
+  raw_skeleton.roots.resize(2);
+  for (size_t i = 0; i < raw_skeleton.roots.size(); ++i) {
+    raw_skeleton.roots[i].name = "root";
+    AddChildren(&raw_skeleton.roots[i], 3);
+  }
+  SkeletonBuilder builder;
+  return builder(raw_skeleton);
+}
+
+// Builds an animation of _num_tracks, with different translation, rotation
+// and scale keys for every track.
+ozz::unique_ptr<Animation> BuildAnimation(int _num_tracks) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(_num_tracks);
+  for (int i = 0; i < _num_tracks; ++i) {
+    RawAnimation::JointTrack& track = raw_animation.tracks[i];
+    const float f = i * .1f;
+    for (int k = 0; k < 3; ++k) {
+      const float time = k * .5f;
+      const RawAnimation::TranslationKey tkey = {
+          time, ozz::math::Float3(1.f + f, f * k, -f)};
+      track.translations.push_back(tkey);
+      const RawAnimation::RotationKey rkey = {
+          time, ozz::math::Quaternion::FromEuler(f * k, .2f - f, .1f * k)};
+      track.rotations.push_back(rkey);
+      const RawAnimation::ScaleKey skey = {
+          time, ozz::math::Float3(1.f + .1f * k, 1.f, 1.f - f * .1f)};
+      track.scales.push_back(skey);
+    }
+  }
+  AnimationBuilder builder;
+  return builder(raw_animation);
+}
+}  // namespace
+
+TEST(JobValidity, ModelSpaceQueryJob) {
+  const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+  ASSERT_TRUE(skeleton);
+  const ozz::unique_ptr<Animation> animation =
+      BuildAnimation(skeleton->num_joints());
+  ASSERT_TRUE(animation);
+
+  SamplingCache cache(animation->num_tracks());
+  ozz::vector<ozz::math::SoaTransform> locals(animation->num_soa_tracks());
+  ozz::math::Float4x4 output;
+
+  {  // Default is invalid.
+    ModelSpaceQueryJob job;
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  ModelSpaceQueryJob valid;
+  valid.animation = animation.get();
+  valid.cache = &cache;
+  valid.skeleton = skeleton.get();
+  valid.joint = 7;
+  valid.locals = make_span(locals);
+  valid.output = &output;
+  EXPECT_TRUE(valid.Validate());
+  EXPECT_TRUE(valid.Run());
+
+  {  // Missing animation.
+    ModelSpaceQueryJob job = valid;
+    job.animation = nullptr;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Missing cache.
+    ModelSpaceQueryJob job = valid;
+    job.cache = nullptr;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Missing skeleton.
+    ModelSpaceQueryJob job = valid;
+    job.skeleton = nullptr;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Missing output.
+    ModelSpaceQueryJob job = valid;
+    job.output = nullptr;
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Invalid joints.
+    ModelSpaceQueryJob job = valid;
+    job.joint = -1;
+    EXPECT_FALSE(job.Validate());
+    job.joint = skeleton->num_joints();
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Joint not in the animation.
+    const ozz::unique_ptr<Animation> small_animation = BuildAnimation(4);
+    ASSERT_TRUE(small_animation);
+    ModelSpaceQueryJob job = valid;
+    job.animation = small_animation.get();
+    EXPECT_FALSE(job.Validate());
+    job.joint = 3;
+    EXPECT_TRUE(job.Validate());
+  }
+  {  // Locals too small.
+    ModelSpaceQueryJob job = valid;
+    job.locals = ozz::span<ozz::math::SoaTransform>(locals.data(),
+                                                    locals.size() - 1);
+    EXPECT_FALSE(job.Validate());
+  }
+  {  // Cache too small.
+    SamplingCache small_cache(4);
+    ModelSpaceQueryJob job = valid;
+    job.cache = &small_cache;
+    EXPECT_FALSE(job.Validate());
+  }
+}
+
+TEST(Query, ModelSpaceQueryJob) {
+  const ozz::unique_ptr<Skeleton> skeleton = BuildSkeleton();
+  ASSERT_TRUE(skeleton);
+  const int num_joints = skeleton->num_joints();
+  const ozz::unique_ptr<Animation> animation = BuildAnimation(num_joints);
+  ASSERT_TRUE(animation);
+
+  // Expected model-space matrices, computed from the whole pose.
+  SamplingCache expected_cache(num_joints);
+  ozz::vector<ozz::math::SoaTransform> expected_locals(
+      animation->num_soa_tracks());
+  ozz::vector<ozz::math::Float4x4> expected_models(num_joints);
+
+  SamplingCache cache(num_joints);
+  ozz::vector<ozz::math::SoaTransform> locals(animation->num_soa_tracks());
+
+  const ozz::math::Float4x4 root = ozz::math::Float4x4::Translation(
+      ozz::math::simd_float4::Load(1.f, 2.f, 3.f, 0.f));
+  const ozz::math::Float4x4* roots[] = {nullptr, &root};
+
+  const float ratios[] = {0.f, .1f, .3f, .5f, .75f, 1.f, .2f};
+  for (size_t r = 0; r < OZZ_ARRAY_SIZE(ratios); ++r) {
+    for (size_t m = 0; m < OZZ_ARRAY_SIZE(roots); ++m) {
+      SamplingJob sampling;
+      sampling.ratio = ratios[r];
+      sampling.animation = animation.get();
+      sampling.cache = &expected_cache;
+      sampling.output = make_span(expected_locals);
+      ASSERT_TRUE(sampling.Run());
+
+      LocalToModelJob ltm;
+      ltm.skeleton = skeleton.get();
+      ltm.root = roots[m];
+      ltm.input = make_span(expected_locals);
+      ltm.output = make_span(expected_models);
+      ASSERT_TRUE(ltm.Run());
+
+      for (int i = 0; i < num_joints; ++i) {
+        ozz::math::Float4x4 output;
+        ModelSpaceQueryJob job;
+        job.ratio = ratios[r];
+        job.animation = animation.get();
+        job.cache = &cache;
+        job.skeleton = skeleton.get();
+        job.joint = i;
+        job.root = roots[m];
+        job.locals = make_span(locals);
+        job.output = &output;
+        ASSERT_TRUE(job.Run());
+
+        // Operations are the same as LocalToModelJob ones, so results are
+        // bitwise identical.
+        EXPECT_EQ(memcmp(&output, &expected_models[i], sizeof(output)), 0)
+            << "joint " << i << ", ratio " << ratios[r];
+      }
+    }
+  }
+}
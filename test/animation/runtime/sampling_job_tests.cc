@@ -30,6 +30,8 @@
 #include "ozz/animation/offline/raw_animation.h"
 #include "ozz/animation/runtime/animation.h"
 #include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/base/containers/vector.h"
 #include "ozz/base/maths/gtest_math_helper.h"
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/memory/unique_ptr.h"
@@ -37,6 +39,7 @@
 using ozz::animation::Animation;
 using ozz::animation::SamplingCache;
 using ozz::animation::SamplingJob;
+using ozz::animation::Skeleton;
 using ozz::animation::offline::AnimationBuilder;
 using ozz::animation::offline::RawAnimation;
 
@@ -526,6 +529,74 @@ TEST(Sampling4Track2Keys, SamplingJob) {
                           1.f, 1.f, 1.f, -1.f, 1.f);
 }
 
+TEST(Masked, SamplingJob) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(12);  // 3 soa tracks.
+  for (int i = 0; i < 12; ++i) {
+    const float f = static_cast<float>(i);
+    const RawAnimation::TranslationKey tkey0 = {
+        0.f, ozz::math::Float3(f, 0.f, 0.f)};
+    raw_animation.tracks[i].translations.push_back(tkey0);
+    const RawAnimation::TranslationKey tkey1 = {
+        .3f + f * .05f, ozz::math::Float3(0.f, f, 0.f)};
+    raw_animation.tracks[i].translations.push_back(tkey1);
+    const RawAnimation::TranslationKey tkey2 = {
+        1.f, ozz::math::Float3(0.f, 0.f, f)};
+    raw_animation.tracks[i].translations.push_back(tkey2);
+  }
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+
+  SamplingCache cache(12);
+  SamplingCache expected_cache(12);
+  ozz::math::SoaTransform output[3];
+  ozz::math::SoaTransform expected[3];
+
+  SamplingJob job;
+  job.animation = animation.get();
+  job.cache = &cache;
+  job.output = output;
+
+  SamplingJob expected_job;
+  expected_job.animation = animation.get();
+  expected_job.cache = &expected_cache;
+  expected_job.output = expected;
+
+  // Selects joint 5 only, hence second soa track.
+  const uint8_t mask[] = {0x20};
+  job.mask = mask;
+
+  const float ratios[] = {0.f, .2f, .5f, .6f, 1.f};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(ratios); ++i) {
+    memset(output, 0xde, sizeof(output));
+    job.ratio = ratios[i];
+    ASSERT_TRUE(job.Validate());
+    ASSERT_TRUE(job.Run());
+
+    expected_job.ratio = ratios[i];
+    ASSERT_TRUE(expected_job.Run());
+
+    // Only the masked soa track is sampled. Tracks beyond mask range aren't.
+    EXPECT_EQ(memcmp(&output[1], &expected[1], sizeof(output[1])), 0);
+    ozz::math::SoaTransform untouched;
+    memset(&untouched, 0xde, sizeof(untouched));
+    EXPECT_EQ(memcmp(&output[0], &untouched, sizeof(untouched)), 0);
+    EXPECT_EQ(memcmp(&output[2], &untouched, sizeof(untouched)), 0);
+  }
+
+  // Cache remains coherent, so a complete sampling decompresses keys that
+  // were skipped by masked samplings.
+  job.mask = {};
+  job.ratio = .8f;
+  ASSERT_TRUE(job.Run());
+  expected_job.ratio = .8f;
+  ASSERT_TRUE(expected_job.Run());
+  EXPECT_EQ(memcmp(output, expected, sizeof(output)), 0);
+}
+
 TEST(Cache, SamplingJob) {
   RawAnimation raw_animation;
   raw_animation.duration = 46.f;
@@ -638,3 +709,201 @@ TEST(CacheResize, SamplingJob) {
   cache.Resize(1);
   EXPECT_FALSE(job.Validate());
 }
+
+TEST(CacheStatistics, SamplingJob) {
+  RawAnimation raw_animation;
+  raw_animation.duration = 46.f;
+  raw_animation.tracks.resize(1);
+  const RawAnimation::TranslationKey tkeys[] = {
+      {0.f, ozz::math::Float3(0.f, 0.f, 0.f)},
+      {23.f, ozz::math::Float3(1.f, 0.f, 0.f)},
+      {46.f, ozz::math::Float3(0.f, 1.f, 0.f)}};
+  raw_animation.tracks[0].translations.assign(tkeys,
+                                              tkeys + OZZ_ARRAY_SIZE(tkeys));
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation0(builder(raw_animation));
+  ASSERT_TRUE(animation0);
+  ozz::unique_ptr<Animation> animation1(builder(raw_animation));
+  ASSERT_TRUE(animation1);
+
+  // 1 soa track, 2 keys per track, plus the middle translation key.
+  ASSERT_EQ(animation0->translations().size(), 9u);
+  ASSERT_EQ(animation0->rotations().size(), 8u);
+  ASSERT_EQ(animation0->scales().size(), 8u);
+
+  SamplingCache cache(1);
+  const SamplingCache::Statistics& statistics = cache.statistics();
+  EXPECT_EQ(statistics.samplings, 0u);
+  EXPECT_EQ(statistics.keys, 0u);
+  EXPECT_EQ(statistics.decompressions, 0u);
+  EXPECT_EQ(statistics.animation_invalidations, 0u);
+  EXPECT_EQ(statistics.backward_invalidations, 0u);
+  EXPECT_EQ(statistics.resize_invalidations, 0u);
+  EXPECT_EQ(statistics.explicit_invalidations, 0u);
+
+  ozz::math::SoaTransform output[1];
+
+  SamplingJob job;
+  job.animation = animation0.get();
+  job.cache = &cache;
+  job.ratio = 0.f;
+  job.output = output;
+
+  // First sampling fills the cache with the first 2 keys of every track.
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(statistics.samplings, 1u);
+  EXPECT_EQ(statistics.keys, 24u);
+  EXPECT_EQ(statistics.decompressions, 3u);
+  EXPECT_EQ(statistics.animation_invalidations, 0u);
+
+  // Forward sampling consumes middle translation key only.
+  job.ratio = .6f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(statistics.samplings, 2u);
+  EXPECT_EQ(statistics.keys, 25u);
+  EXPECT_EQ(statistics.decompressions, 4u);
+
+  // Same ratio, nothing to update.
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(statistics.samplings, 3u);
+  EXPECT_EQ(statistics.keys, 25u);
+  EXPECT_EQ(statistics.decompressions, 4u);
+
+  // Backward sampling.
+  job.ratio = .2f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(statistics.samplings, 4u);
+  EXPECT_EQ(statistics.keys, 49u);
+  EXPECT_EQ(statistics.decompressions, 7u);
+  EXPECT_EQ(statistics.backward_invalidations, 1u);
+  EXPECT_EQ(statistics.animation_invalidations, 0u);
+
+  // Animation change.
+  job.animation = animation1.get();
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(statistics.keys, 73u);
+  EXPECT_EQ(statistics.decompressions, 10u);
+  EXPECT_EQ(statistics.backward_invalidations, 1u);
+  EXPECT_EQ(statistics.animation_invalidations, 1u);
+
+  // Explicit invalidation, only counted once.
+  cache.Invalidate();
+  cache.Invalidate();
+  EXPECT_EQ(statistics.explicit_invalidations, 1u);
+
+  // Already invalidated cache isn't counted again.
+  job.animation = animation0.get();
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(statistics.keys, 97u);
+  EXPECT_EQ(statistics.animation_invalidations, 1u);
+
+  // Resize, only counted once.
+  cache.Resize(4);
+  cache.Resize(4);
+  EXPECT_EQ(statistics.resize_invalidations, 1u);
+  EXPECT_EQ(statistics.explicit_invalidations, 1u);
+
+  // Reset.
+  cache.ResetStatistics();
+  EXPECT_EQ(statistics.samplings, 0u);
+  EXPECT_EQ(statistics.keys, 0u);
+  EXPECT_EQ(statistics.decompressions, 0u);
+  EXPECT_EQ(statistics.animation_invalidations, 0u);
+  EXPECT_EQ(statistics.backward_invalidations, 0u);
+  EXPECT_EQ(statistics.resize_invalidations, 0u);
+  EXPECT_EQ(statistics.explicit_invalidations, 0u);
+}
+
+TEST(MaxTracks, SamplingJob) {
+  // Every track has its own translation, built from its index, and its own
+  // rotation, with all largest component and sign combinations.
+  RawAnimation raw_animation;
+  raw_animation.duration = 1.f;
+  raw_animation.tracks.resize(Skeleton::kMaxJoints);
+  const ozz::math::Float3 axes[3] = {ozz::math::Float3::x_axis(),
+                                     ozz::math::Float3::y_axis(),
+                                     ozz::math::Float3::z_axis()};
+  for (int i = 0; i < Skeleton::kMaxJoints; ++i) {
+    RawAnimation::JointTrack& track = raw_animation.tracks[i];
+    const ozz::math::Float3 value(static_cast<float>(i % 64),
+                                  static_cast<float>((i / 64) % 64),
+                                  static_cast<float>(i / 4096));
+    const RawAnimation::TranslationKey tkeys[] = {{0.f, value},
+                                                  {1.f, value * 2.f}};
+    track.translations.assign(tkeys, tkeys + OZZ_ARRAY_SIZE(tkeys));
+
+    const ozz::math::Quaternion rotation =
+        ozz::math::Quaternion::FromAxisAngle(axes[i % 3],
+                                             (i % 628) * .01f - 3.14f);
+    const RawAnimation::RotationKey rkey = {0.f, rotation};
+    track.rotations.push_back(rkey);
+  }
+  ASSERT_TRUE(raw_animation.Validate());
+
+  AnimationBuilder builder;
+  ozz::unique_ptr<Animation> animation(builder(raw_animation));
+  ASSERT_TRUE(animation);
+  EXPECT_EQ(animation->num_tracks(), Skeleton::kMaxJoints);
+
+  SamplingCache cache(Skeleton::kMaxJoints);
+  ozz::vector<ozz::math::SoaTransform> output(Skeleton::kMaxSoAJoints);
+
+  SamplingJob job;
+  job.animation = animation.get();
+  job.cache = &cache;
+  job.output = make_span(output);
+
+  // Samples forward, so that the cache is reused.
+  const float ratios[] = {0.f, .5f};
+  for (const float ratio : ratios) {
+    job.ratio = ratio;
+    ASSERT_TRUE(job.Run());
+
+    const float scale = 1.f + ratio;
+    for (int i = 0; i < Skeleton::kMaxSoAJoints * 4; ++i) {
+      alignas(16) float values[10][4];
+      const ozz::math::SoaTransform& soa = output[i / 4];
+      ozz::math::StorePtr(soa.translation.x, values[0]);
+      ozz::math::StorePtr(soa.translation.y, values[1]);
+      ozz::math::StorePtr(soa.translation.z, values[2]);
+      ozz::math::StorePtr(soa.rotation.x, values[3]);
+      ozz::math::StorePtr(soa.rotation.y, values[4]);
+      ozz::math::StorePtr(soa.rotation.z, values[5]);
+      ozz::math::StorePtr(soa.rotation.w, values[6]);
+      ozz::math::StorePtr(soa.scale.x, values[7]);
+      ozz::math::StorePtr(soa.scale.y, values[8]);
+      ozz::math::StorePtr(soa.scale.z, values[9]);
+
+      // Padding track is identity.
+      const int lane = i & 3;
+      if (i >= Skeleton::kMaxJoints) {
+        EXPECT_FLOAT_EQ(values[0][lane], 0.f);
+        EXPECT_FLOAT_EQ(values[6][lane], 1.f);
+        continue;
+      }
+
+      const RawAnimation::JointTrack& track = raw_animation.tracks[i];
+      const ozz::math::Float3& translation = track.translations[0].value;
+      EXPECT_NEAR(values[0][lane], translation.x * scale, 1e-2f);
+      EXPECT_NEAR(values[1][lane], translation.y * scale, 1e-2f);
+      EXPECT_NEAR(values[2][lane], translation.z * scale, 1e-2f);
+
+      // Quaternion sign isn't relevant.
+      const ozz::math::Quaternion& rotation = track.rotations[0].value;
+      const float sign = values[6][lane] * rotation.w < 0.f ? -1.f : 1.f;
+      EXPECT_NEAR(values[3][lane] * sign, rotation.x, 2e-3f);
+      EXPECT_NEAR(values[4][lane] * sign, rotation.y, 2e-3f);
+      EXPECT_NEAR(values[5][lane] * sign, rotation.z, 2e-3f);
+      EXPECT_NEAR(values[6][lane] * sign, rotation.w, 2e-3f);
+
+      EXPECT_FLOAT_EQ(values[7][lane], 1.f);
+      EXPECT_FLOAT_EQ(values[8][lane], 1.f);
+      EXPECT_FLOAT_EQ(values[9][lane], 1.f);
+    }
+  }
+
+  // Forward sampling didn't require to decompress any key again.
+  EXPECT_EQ(cache.statistics().decompressions,
+            3u * Skeleton::kMaxSoAJoints);
+}
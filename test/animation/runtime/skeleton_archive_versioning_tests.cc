@@ -72,4 +72,9 @@ TEST(Versioning, SkeletonSerialize) {
   if (skeleton.num_joints()) {
     EXPECT_STREQ(skeleton.joint_names()[0], OPTIONS_root_name);
   }
+  for (int i = 0; i < skeleton.num_joints(); ++i) {
+    const int parent = skeleton.joint_parents()[i];
+    EXPECT_TRUE(parent == ozz::animation::Skeleton::kNoParent ||
+                (parent >= 0 && parent < i));
+  }
 }
@@ -189,6 +189,59 @@ TEST(FilledFloat, TrackSerialize) {
   }
 }
 
+TEST(CubicFloat, TrackSerialize) {
+  // Builds a valid animation.
+  ozz::unique_ptr<FloatTrack> o_track;
+  {
+    TrackBuilder builder;
+    RawFloatTrack raw_float_track;
+
+    const RawFloatTrack::Keyframe key0 = {RawTrackInterpolation::kCubic, 0.f,
+                                          0.f, 0.f, 0.f};
+    raw_float_track.keyframes.push_back(key0);
+    const RawFloatTrack::Keyframe key1 = {RawTrackInterpolation::kLinear, 1.f,
+                                          1.f, 0.f, 0.f};
+    raw_float_track.keyframes.push_back(key1);
+
+    // Builds track
+    o_track = builder(raw_float_track);
+    ASSERT_TRUE(o_track);
+  }
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << *o_track;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+
+    FloatTrack i_track;
+    i >> i_track;
+
+    EXPECT_EQ(o_track->size(), i_track.size());
+    EXPECT_EQ(i_track.cubics().size(), 1u);
+
+    // Samples a smoothstep curve.
+    FloatTrackSamplingJob sampling;
+    sampling.track = &i_track;
+    float result;
+    sampling.result = &result;
+
+    sampling.ratio = .25f;
+    ASSERT_TRUE(sampling.Run());
+    EXPECT_FLOAT_EQ(result, .15625f);
+
+    sampling.ratio = .5f;
+    ASSERT_TRUE(sampling.Run());
+    EXPECT_FLOAT_EQ(result, .5f);
+  }
+}
+
 TEST(FilledFloat2, TrackSerialize) {
   TrackBuilder builder;
   RawFloat2Track raw_float2_track;
@@ -0,0 +1,276 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/track_bundle.h"
+
+#include "gtest/gtest.h"
+
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_sampling_job.h"
+
+using ozz::animation::FloatTrack;
+using ozz::animation::FloatTrackBundle;
+using ozz::animation::FloatTrackBundleSamplingJob;
+using ozz::animation::FloatTrackSamplingJob;
+using ozz::animation::TrackSamplingCache;
+using ozz::animation::offline::RawFloatTrack;
+using ozz::animation::offline::RawTrackInterpolation;
+using ozz::animation::offline::TrackBuilder;
+
+namespace {
+// Builds _num_tracks raw tracks, with different key counts, ratios and
+// interpolations.
+void BuildRawTracks(int _num_tracks, ozz::vector<RawFloatTrack>* _tracks) {
+  _tracks->resize(_num_tracks);
+  for (int i = 0; i < _num_tracks; ++i) {
+    RawFloatTrack& track = (*_tracks)[i];
+    const int num_keys = i % 5;  // Including empty tracks.
+    for (int k = 0; k < num_keys; ++k) {
+      const RawFloatTrack::Keyframe key = {
+          (i + k) % 3 == 0 ? RawTrackInterpolation::kStep
+                           : RawTrackInterpolation::kLinear,
+          (k + .5f * (i & 1)) / num_keys, static_cast<float>(i * 10 + k * k)};
+      track.keyframes.push_back(key);
+    }
+  }
+}
+
+// Samples _bundle at _ratio, and compares with every track sampled
+// individually.
+void ExpectBundleSample(const FloatTrackBundle& _bundle,
+                        const ozz::vector<ozz::unique_ptr<FloatTrack>>& _tracks,
+                        float _ratio, TrackSamplingCache* _cache) {
+  ozz::vector<float> output(_tracks.size() + 1, 46.f);
+  FloatTrackBundleSamplingJob job;
+  job.bundle = &_bundle;
+  job.ratio = _ratio;
+  job.cache = _cache;
+  job.output = ozz::make_span(output);
+  ASSERT_TRUE(job.Run());
+
+  for (size_t i = 0; i < _tracks.size(); ++i) {
+    float expected;
+    FloatTrackSamplingJob track_job;
+    track_job.track = _tracks[i].get();
+    track_job.ratio = _ratio;
+    track_job.result = &expected;
+    ASSERT_TRUE(track_job.Run());
+    EXPECT_NEAR(output[i], expected, 1e-4f)
+        << "track " << i << " ratio " << _ratio;
+  }
+
+  // Remaining output isn't changed.
+  EXPECT_EQ(output.back(), 46.f);
+}
+}  // namespace
+
+TEST(Build, FloatTrackBundle) {
+  TrackBuilder builder;
+
+  {  // Empty bundle.
+    ozz::unique_ptr<FloatTrackBundle> bundle(
+        builder(ozz::span<const RawFloatTrack>()));
+    ASSERT_TRUE(bundle);
+    EXPECT_EQ(bundle->num_tracks(), 0);
+    EXPECT_EQ(bundle->num_soa_tracks(), 0);
+  }
+
+  {  // Invalid track.
+    ozz::vector<RawFloatTrack> raw_tracks(2);
+    const RawFloatTrack::Keyframe key = {RawTrackInterpolation::kLinear, 2.f,
+                                         0.f};
+    raw_tracks[1].keyframes.push_back(key);
+    EXPECT_FALSE(builder(ozz::make_span(raw_tracks)));
+  }
+
+  {  // Shared time base.
+    ozz::vector<RawFloatTrack> raw_tracks(5);
+    for (int i = 0; i < 5; ++i) {
+      for (int k = 0; k <= 10; ++k) {
+        const RawFloatTrack::Keyframe key = {RawTrackInterpolation::kLinear,
+                                             k / 10.f, static_cast<float>(i)};
+        raw_tracks[i].keyframes.push_back(key);
+      }
+    }
+    ozz::unique_ptr<FloatTrackBundle> bundle(
+        builder(ozz::make_span(raw_tracks)));
+    ASSERT_TRUE(bundle);
+    EXPECT_EQ(bundle->num_tracks(), 5);
+    EXPECT_EQ(bundle->num_soa_tracks(), 2);
+    EXPECT_EQ(bundle->ratios().size(), 11u);
+    EXPECT_EQ(bundle->values().size(), 11u * 8u);
+
+    // Padding is 0.
+    EXPECT_EQ(bundle->values()[4], 4.f);
+    EXPECT_EQ(bundle->values()[5], 0.f);
+    EXPECT_EQ(bundle->values()[7], 0.f);
+  }
+
+  {  // Steps duplicate following key ratio.
+    ozz::vector<RawFloatTrack> raw_tracks(1);
+    const RawFloatTrack::Keyframe key0 = {RawTrackInterpolation::kStep, 0.f,
+                                          1.f};
+    const RawFloatTrack::Keyframe key1 = {RawTrackInterpolation::kLinear, .5f,
+                                          2.f};
+    raw_tracks[0].keyframes.push_back(key0);
+    raw_tracks[0].keyframes.push_back(key1);
+    ozz::unique_ptr<FloatTrackBundle> bundle(
+        builder(ozz::make_span(raw_tracks)));
+    ASSERT_TRUE(bundle);
+    ASSERT_EQ(bundle->ratios().size(), 4u);
+    EXPECT_EQ(bundle->ratios()[1], .5f);
+    EXPECT_EQ(bundle->ratios()[2], .5f);
+    EXPECT_EQ(bundle->values()[4], 1.f);
+    EXPECT_EQ(bundle->values()[8], 2.f);
+  }
+}
+
+TEST(JobValidity, FloatTrackBundleSamplingJob) {
+  TrackBuilder builder;
+  ozz::vector<RawFloatTrack> raw_tracks;
+  BuildRawTracks(6, &raw_tracks);
+  ozz::unique_ptr<FloatTrackBundle> bundle(builder(ozz::make_span(raw_tracks)));
+  ASSERT_TRUE(bundle);
+
+  float output[6];
+  {  // Empty/default job.
+    FloatTrackBundleSamplingJob job;
+    EXPECT_TRUE(job.cache == nullptr);
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // No bundle.
+    FloatTrackBundleSamplingJob job;
+    job.output = ozz::make_span(output);
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Output too small.
+    FloatTrackBundleSamplingJob job;
+    job.bundle = bundle.get();
+    job.output = ozz::span<float>(output, 5);
+    EXPECT_FALSE(job.Validate());
+    EXPECT_FALSE(job.Run());
+  }
+
+  {  // Valid.
+    FloatTrackBundleSamplingJob job;
+    job.bundle = bundle.get();
+    job.output = ozz::make_span(output);
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+
+  {  // Default bundle.
+    FloatTrackBundle default_bundle;
+    FloatTrackBundleSamplingJob job;
+    job.bundle = &default_bundle;
+    EXPECT_TRUE(job.Validate());
+    EXPECT_TRUE(job.Run());
+  }
+}
+
+TEST(Sampling, FloatTrackBundleSamplingJob) {
+  TrackBuilder builder;
+
+  // Tests all padding configurations.
+  for (int num_tracks = 1; num_tracks <= 13; ++num_tracks) {
+    ozz::vector<RawFloatTrack> raw_tracks;
+    BuildRawTracks(num_tracks, &raw_tracks);
+
+    ozz::vector<ozz::unique_ptr<FloatTrack>> tracks;
+    for (const RawFloatTrack& raw_track : raw_tracks) {
+      tracks.push_back(builder(raw_track));
+      ASSERT_TRUE(tracks.back());
+    }
+    ozz::unique_ptr<FloatTrackBundle> bundle(
+        builder(ozz::make_span(raw_tracks)));
+    ASSERT_TRUE(bundle);
+    EXPECT_EQ(bundle->num_tracks(), num_tracks);
+
+    // Samples at all keyframes ratios, as well as in between.
+    for (const RawFloatTrack& raw_track : raw_tracks) {
+      for (const RawFloatTrack::Keyframe& key : raw_track.keyframes) {
+        ExpectBundleSample(*bundle, tracks, key.ratio, nullptr);
+      }
+    }
+    for (float ratio = -.1f; ratio < 1.1f; ratio += .01f) {
+      ExpectBundleSample(*bundle, tracks, ratio, nullptr);
+    }
+
+    // Cache doesn't change the result, forward and backward.
+    TrackSamplingCache cache;
+    for (float ratio = -.1f; ratio < 1.1f; ratio += .003f) {
+      ExpectBundleSample(*bundle, tracks, ratio, &cache);
+    }
+    for (float ratio = 1.1f; ratio > -.1f; ratio -= .007f) {
+      ExpectBundleSample(*bundle, tracks, ratio, &cache);
+    }
+  }
+}
+
+TEST(Serialize, FloatTrackBundle) {
+  TrackBuilder builder;
+  ozz::vector<RawFloatTrack> raw_tracks;
+  BuildRawTracks(7, &raw_tracks);
+  ozz::unique_ptr<FloatTrackBundle> o_bundle(
+      builder(ozz::make_span(raw_tracks)));
+  ASSERT_TRUE(o_bundle);
+
+  ozz::io::MemoryStream stream;
+  {
+    ozz::io::OArchive o(&stream, ozz::GetNativeEndianness());
+    o << *o_bundle;
+  }
+
+  stream.Seek(0, ozz::io::Stream::kSet);
+  ozz::io::IArchive i(&stream);
+  ASSERT_TRUE(i.TestTag<FloatTrackBundle>());
+
+  FloatTrackBundle i_bundle;
+  i >> i_bundle;
+
+  EXPECT_EQ(o_bundle->size(), i_bundle.size());
+  EXPECT_EQ(o_bundle->num_tracks(), i_bundle.num_tracks());
+  ASSERT_EQ(o_bundle->ratios().size(), i_bundle.ratios().size());
+  ASSERT_EQ(o_bundle->values().size(), i_bundle.values().size());
+  for (size_t k = 0; k < i_bundle.ratios().size(); ++k) {
+    EXPECT_EQ(o_bundle->ratios()[k], i_bundle.ratios()[k]);
+  }
+  for (size_t k = 0; k < i_bundle.values().size(); ++k) {
+    EXPECT_EQ(o_bundle->values()[k], i_bundle.values()[k]);
+  }
+}
@@ -0,0 +1,208 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+#include "ozz/animation/runtime/track_edges.h"
+
+#include "gtest/gtest.h"
+#include "ozz/animation/offline/raw_track.h"
+#include "ozz/animation/offline/track_builder.h"
+#include "ozz/animation/offline/track_edges_builder.h"
+#include "ozz/animation/runtime/track.h"
+#include "ozz/animation/runtime/track_triggering_job.h"
+#include "ozz/base/containers/vector.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+#include "ozz/base/memory/unique_ptr.h"
+
+using ozz::animation::FloatTrack;
+using ozz::animation::TrackEdges;
+using ozz::animation::TrackTriggeringJob;
+using ozz::animation::offline::RawFloatTrack;
+using ozz::animation::offline::RawTrackInterpolation;
+using ozz::animation::offline::TrackBuilder;
+using ozz::animation::offline::TrackEdgesBuilder;
+
+namespace {
+// Builds a track mixing step and linear keys, crossing threshold 1 many times.
+ozz::unique_ptr<FloatTrack> BuildTestTrack() {
+  RawFloatTrack raw_track;
+  const float values[] = {0.f, 2.f, 1.f, 1.f, 2.f, 0.f, 0.f, 3.f, -1.f, 2.f};
+  const int num_keys = OZZ_ARRAY_SIZE(values);
+  for (int i = 0; i < num_keys; ++i) {
+    const RawFloatTrack::Keyframe key = {
+        i % 3 == 0 ? RawTrackInterpolation::kStep
+                   : RawTrackInterpolation::kLinear,
+        i / (num_keys - 1.f), values[i]};
+    raw_track.keyframes.push_back(key);
+  }
+  TrackBuilder builder;
+  return builder(raw_track);
+}
+
+ozz::vector<TrackTriggeringJob::Edge> Trigger(TrackTriggeringJob _job) {
+  ozz::vector<TrackTriggeringJob::Edge> edges;
+  TrackTriggeringJob::Iterator iterator;
+  _job.iterator = &iterator;
+  EXPECT_TRUE(_job.Run());
+  for (; iterator != _job.end(); ++iterator) {
+    edges.push_back(*iterator);
+  }
+  return edges;
+}
+}  // namespace
+
+TEST(Empty, TrackEdges) {
+  TrackEdges edges;
+  EXPECT_EQ(edges.num_edges(), 0u);
+  EXPECT_FLOAT_EQ(edges.threshold(), 0.f);
+
+  // Invalid track.
+  FloatTrack track;
+  TrackEdgesBuilder builder;
+  EXPECT_FALSE(builder(track, 0.f));
+
+  // Track without edges.
+  TrackBuilder track_builder;
+  RawFloatTrack raw_track;
+  ozz::unique_ptr<FloatTrack> empty(track_builder(raw_track));
+  ASSERT_TRUE(empty);
+  ozz::unique_ptr<TrackEdges> empty_edges(builder(*empty, 1.f));
+  ASSERT_TRUE(empty_edges);
+  EXPECT_EQ(empty_edges->num_edges(), 0u);
+
+  TrackTriggeringJob job;
+  job.edges = empty_edges.get();
+  job.from = -2.f;
+  job.to = 3.f;
+  EXPECT_TRUE(Trigger(job).empty());
+}
+
+TEST(Build, TrackEdges) {
+  ozz::unique_ptr<FloatTrack> track(BuildTestTrack());
+  ASSERT_TRUE(track);
+
+  TrackEdgesBuilder builder;
+  ozz::unique_ptr<TrackEdges> edges(builder(*track, 1.f));
+  ASSERT_TRUE(edges);
+  EXPECT_FLOAT_EQ(edges->threshold(), 1.f);
+
+  // Edges are the one of a single loop.
+  TrackTriggeringJob job;
+  job.track = track.get();
+  job.threshold = 1.f;
+  job.from = 0.f;
+  job.to = 1.f;
+  const ozz::vector<TrackTriggeringJob::Edge> expected = Trigger(job);
+  ASSERT_EQ(edges->num_edges(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_FLOAT_EQ(edges->ratios()[i], expected[i].ratio);
+    EXPECT_EQ((edges->risings()[i / 8] & (1 << (i & 7))) != 0,
+              expected[i].rising);
+  }
+
+  // Job only requires edges.
+  TrackTriggeringJob edges_job;
+  edges_job.edges = edges.get();
+  TrackTriggeringJob::Iterator iterator;
+  edges_job.iterator = &iterator;
+  EXPECT_TRUE(edges_job.Validate());
+}
+
+TEST(Triggering, TrackEdges) {
+  ozz::unique_ptr<FloatTrack> track(BuildTestTrack());
+  ASSERT_TRUE(track);
+
+  const float thresholds[] = {-2.f, 0.f, .5f, 1.f, 2.f};
+  const float bounds[] = {-2.3f, -1.f, -.5f, 0.f,  .1f,        1.f / 9.f,
+                          .2f,   .5f,  .9f,  1.f, 1.f + 1.f / 9.f, 2.7f};
+  for (size_t t = 0; t < OZZ_ARRAY_SIZE(thresholds); ++t) {
+    TrackEdgesBuilder builder;
+    ozz::unique_ptr<TrackEdges> edges(builder(*track, thresholds[t]));
+    ASSERT_TRUE(edges);
+
+    // Compares processing track and edges, for all ranges in both directions.
+    for (size_t f = 0; f < OZZ_ARRAY_SIZE(bounds); ++f) {
+      for (size_t o = 0; o < OZZ_ARRAY_SIZE(bounds); ++o) {
+        TrackTriggeringJob job;
+        job.track = track.get();
+        job.threshold = thresholds[t];
+        job.from = bounds[f];
+        job.to = bounds[o];
+        const ozz::vector<TrackTriggeringJob::Edge> expected = Trigger(job);
+
+        TrackTriggeringJob edges_job;
+        edges_job.edges = edges.get();
+        edges_job.from = bounds[f];
+        edges_job.to = bounds[o];
+        const ozz::vector<TrackTriggeringJob::Edge> result = Trigger(edges_job);
+
+        ASSERT_EQ(result.size(), expected.size())
+            << "threshold " << thresholds[t] << " from " << bounds[f]
+            << " to " << bounds[o];
+        for (size_t i = 0; i < expected.size(); ++i) {
+          EXPECT_FLOAT_EQ(result[i].ratio, expected[i].ratio);
+          EXPECT_EQ(result[i].rising, expected[i].rising);
+        }
+      }
+    }
+  }
+}
+
+TEST(Serialize, TrackEdges) {
+  ozz::unique_ptr<FloatTrack> track(BuildTestTrack());
+  ASSERT_TRUE(track);
+
+  TrackEdgesBuilder builder;
+  ozz::unique_ptr<TrackEdges> o_edges(builder(*track, .5f));
+  ASSERT_TRUE(o_edges);
+
+  for (int e = 0; e < 2; ++e) {
+    ozz::Endianness endianess = e == 0 ? ozz::kBigEndian : ozz::kLittleEndian;
+    ozz::io::MemoryStream stream;
+
+    // Streams out.
+    ozz::io::OArchive o(&stream, endianess);
+    o << *o_edges;
+
+    // Streams in.
+    stream.Seek(0, ozz::io::Stream::kSet);
+    ozz::io::IArchive i(&stream);
+
+    TrackEdges i_edges;
+    i >> i_edges;
+
+    EXPECT_EQ(o_edges->size(), i_edges.size());
+    EXPECT_FLOAT_EQ(i_edges.threshold(), .5f);
+    ASSERT_EQ(o_edges->num_edges(), i_edges.num_edges());
+    for (size_t j = 0; j < i_edges.num_edges(); ++j) {
+      EXPECT_FLOAT_EQ(o_edges->ratios()[j], i_edges.ratios()[j]);
+    }
+    for (size_t j = 0; j < i_edges.risings().size(); ++j) {
+      EXPECT_EQ(o_edges->risings()[j], i_edges.risings()[j]);
+    }
+  }
+}
@@ -43,6 +43,7 @@ using ozz::animation::Float3Track;
 using ozz::animation::Float4Track;
 using ozz::animation::QuaternionTrack;
 using ozz::animation::FloatTrackSamplingJob;
+using ozz::animation::TrackSamplingCache;
 using ozz::animation::offline::RawFloatTrack;
 using ozz::animation::offline::TrackBuilder;
 using ozz::animation::offline::RawTrackInterpolation;
@@ -465,3 +466,209 @@ TEST(Quaternion, TrackSamplingJob) {
   ASSERT_TRUE(sampling.Run());
   EXPECT_QUATERNION_EQ(result, 0.f, 0.f, 0.f, 1.f);
 }
+
+namespace {
+// Builds a float track with _num_keys keys, alternating step and linear
+// interpolations.
+ozz::unique_ptr<FloatTrack> BuildTrack(int _num_keys) {
+  RawFloatTrack raw_track;
+  for (int i = 0; i < _num_keys; ++i) {
+    const RawFloatTrack::Keyframe key = {
+        i % 3 == 0 ? RawTrackInterpolation::kStep
+                   : RawTrackInterpolation::kLinear,
+        static_cast<float>(i) / (_num_keys - 1), static_cast<float>(i * i)};
+    raw_track.keyframes.push_back(key);
+  }
+  TrackBuilder builder;
+  return builder(raw_track);
+}
+
+// Samples _track at _ratio, with and without _cache, and expects the same
+// result.
+void ExpectCachedSample(const FloatTrack& _track, float _ratio,
+                        TrackSamplingCache* _cache) {
+  float expected;
+  FloatTrackSamplingJob reference;
+  reference.track = &_track;
+  reference.ratio = _ratio;
+  reference.result = &expected;
+  ASSERT_TRUE(reference.Run());
+
+  float result;
+  FloatTrackSamplingJob job;
+  job.track = &_track;
+  job.ratio = _ratio;
+  job.cache = _cache;
+  job.result = &result;
+  ASSERT_TRUE(job.Run());
+  EXPECT_EQ(result, expected) << "ratio " << _ratio;
+}
+}  // namespace
+
+TEST(Cache, TrackSamplingJob) {
+  ozz::unique_ptr<FloatTrack> track = BuildTrack(101);
+  ASSERT_TRUE(track);
+
+  {  // Cache is optional.
+    FloatTrackSamplingJob job;
+    EXPECT_TRUE(job.cache == nullptr);
+  }
+
+  TrackSamplingCache cache;
+
+  // Forward, with small and big steps, including exact key ratios.
+  for (float ratio = -.1f; ratio < 1.1f; ratio += .001f) {
+    ExpectCachedSample(*track, ratio, &cache);
+  }
+  for (int i = 0; i <= 100; ++i) {
+    ExpectCachedSample(*track, i / 100.f, &cache);
+  }
+  for (float ratio = 0.f; ratio <= 1.f; ratio += .13f) {
+    ExpectCachedSample(*track, ratio, &cache);
+  }
+
+  // Backward.
+  for (float ratio = 1.1f; ratio > -.1f; ratio -= .003f) {
+    ExpectCachedSample(*track, ratio, &cache);
+  }
+
+  // Looping.
+  for (float ratio = 0.f; ratio < 10.f; ratio += .07f) {
+    ExpectCachedSample(*track, ratio - static_cast<int>(ratio), &cache);
+  }
+
+  // Explicit invalidation.
+  ExpectCachedSample(*track, .5f, &cache);
+  cache.Invalidate();
+  ExpectCachedSample(*track, .2f, &cache);
+  ExpectCachedSample(*track, .6f, &cache);
+}
+
+TEST(CacheTrackChange, TrackSamplingJob) {
+  ozz::unique_ptr<FloatTrack> track0 = BuildTrack(101);
+  ASSERT_TRUE(track0);
+  ozz::unique_ptr<FloatTrack> track1 = BuildTrack(7);
+  ASSERT_TRUE(track1);
+  FloatTrack empty;
+
+  // Cache is automatically invalidated when sampling another track, even if
+  // cursor would be out of the new track range.
+  TrackSamplingCache cache;
+  ExpectCachedSample(*track0, .9f, &cache);
+  ExpectCachedSample(*track1, .1f, &cache);
+  ExpectCachedSample(*track0, .95f, &cache);
+  ExpectCachedSample(*track1, .95f, &cache);
+  ExpectCachedSample(*track0, .05f, &cache);
+
+  // Empty track.
+  ExpectCachedSample(empty, .5f, &cache);
+  ExpectCachedSample(*track0, .5f, &cache);
+}
+
+TEST(Cubic, TrackSamplingJob) {
+  TrackBuilder builder;
+
+  {  // Linear tracks don't allocate curves.
+    RawFloatTrack raw_track;
+    const RawFloatTrack::Keyframe key0 = {RawTrackInterpolation::kLinear, 0.f,
+                                          0.f};
+    raw_track.keyframes.push_back(key0);
+    const RawFloatTrack::Keyframe key1 = {RawTrackInterpolation::kLinear, 1.f,
+                                          1.f};
+    raw_track.keyframes.push_back(key1);
+    ozz::unique_ptr<FloatTrack> track(builder(raw_track));
+    ASSERT_TRUE(track);
+    EXPECT_EQ(track->cubics().size(), 0u);
+    EXPECT_EQ(track->tangents().size(), 0u);
+  }
+
+  // Curve from 0 to 1 over [.2,.6], with flat tangents (smoothstep), followed
+  // by a linear and then a cubic last key.
+  RawFloatTrack raw_track;
+  const RawFloatTrack::Keyframe key0 = {RawTrackInterpolation::kCubic, .2f,
+                                        0.f, 46.f, 0.f};
+  raw_track.keyframes.push_back(key0);
+  const RawFloatTrack::Keyframe key1 = {RawTrackInterpolation::kLinear, .6f,
+                                        1.f, 0.f, 46.f};
+  raw_track.keyframes.push_back(key1);
+  const RawFloatTrack::Keyframe key2 = {RawTrackInterpolation::kCubic, .8f,
+                                        2.f, 46.f, 46.f};
+  raw_track.keyframes.push_back(key2);
+
+  ozz::unique_ptr<FloatTrack> track(builder(raw_track));
+  ASSERT_TRUE(track);
+  EXPECT_EQ(track->cubics().size(), 1u);
+  EXPECT_EQ(track->tangents().size(), 2u * track->values().size());
+
+  FloatTrackSamplingJob job;
+  float result;
+  job.track = track.get();
+  job.result = &result;
+
+  const float ratios[] = {0.f, .2f, .3f, .4f, .5f, .6f, .7f, .8f, .9f, 1.f};
+  const float expected[] = {0.f, 0.f, .15625f, .5f, .84375f,
+                            1.f, 1.5f, 2.f,   2.f, 2.f};
+  for (size_t i = 0; i < OZZ_ARRAY_SIZE(ratios); ++i) {
+    job.ratio = ratios[i];
+    ASSERT_TRUE(job.Run());
+    EXPECT_NEAR(result, expected[i], 1e-5f) << "ratio " << ratios[i];
+  }
+
+  {  // Tangents are relative to ratios.
+    RawFloatTrack raw_slope;
+    const RawFloatTrack::Keyframe slope0 = {RawTrackInterpolation::kCubic,
+                                            0.f, 0.f, 0.f, 2.f};
+    raw_slope.keyframes.push_back(slope0);
+    const RawFloatTrack::Keyframe slope1 = {RawTrackInterpolation::kLinear,
+                                            .5f, 1.f, 2.f, 0.f};
+    raw_slope.keyframes.push_back(slope1);
+    ozz::unique_ptr<FloatTrack> slope(builder(raw_slope));
+    ASSERT_TRUE(slope);
+
+    // A straight line.
+    job.track = slope.get();
+    for (float ratio = 0.f; ratio <= .5f; ratio += .05f) {
+      job.ratio = ratio;
+      ASSERT_TRUE(job.Run());
+      EXPECT_NEAR(result, ratio * 2.f, 1e-5f);
+    }
+  }
+}
+
+TEST(CubicQuaternion, TrackSamplingJob) {
+  TrackBuilder builder;
+
+  // Curve from identity to a 90 degrees rotation around y.
+  ozz::animation::offline::RawQuaternionTrack raw_track;
+  const ozz::math::Quaternion zero(0.f, 0.f, 0.f, 0.f);
+  const ozz::math::Quaternion rotation(0.f, .70710677f, 0.f, .70710677f);
+  const ozz::animation::offline::RawQuaternionTrack::Keyframe key0 = {
+      RawTrackInterpolation::kCubic, 0.f, ozz::math::Quaternion::identity(),
+      zero, zero};
+  raw_track.keyframes.push_back(key0);
+  // Opposite quaternion, to test tangents are fixed up along with the value.
+  const ozz::animation::offline::RawQuaternionTrack::Keyframe key1 = {
+      RawTrackInterpolation::kLinear, 1.f, -rotation, zero, zero};
+  raw_track.keyframes.push_back(key1);
+
+  ozz::unique_ptr<QuaternionTrack> track(builder(raw_track));
+  ASSERT_TRUE(track);
+
+  ozz::animation::QuaternionTrackSamplingJob job;
+  ozz::math::Quaternion result;
+  job.track = track.get();
+  job.result = &result;
+
+  job.ratio = 0.f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_QUATERNION_EQ(result, 0.f, 0.f, 0.f, 1.f);
+
+  // Symmetric, so half way is the same as a nlerp.
+  job.ratio = .5f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_QUATERNION_EQ(result, 0.f, .38268343f, 0.f, .92387953f);
+
+  job.ratio = 1.f;
+  ASSERT_TRUE(job.Run());
+  EXPECT_QUATERNION_EQ(result, 0.f, .70710677f, 0.f, .70710677f);
+}
@@ -28,6 +28,7 @@
 #include "ozz/base/maths/simd_math.h"
 
 #include <stdint.h>
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -643,6 +644,93 @@ TEST(TrigonometryFloat, ozz_simd_math) {
   EXPECT_SIMDFLOAT_EQ(ozz::math::ATan(tan), 0.f, kPi / 6.f, -kPi / 3.f,
                       kPi / 4.f);
   EXPECT_SIMDFLOAT_EQ(ozz::math::ATanX(tan), 0.f, .57735f, -1.73205f, 1.f);
+
+  const SimdFloat4 y = ozz::math::simd_float4::Load(0.f, 1.f, -2.f, -1.f);
+  const SimdFloat4 x =
+      ozz::math::simd_float4::Load(1.f, 0.f, -2.f, -1.7320508f);
+  EXPECT_SIMDFLOAT_EQ(ozz::math::ATan2(y, x), 0.f, kPi_2, -3.f * kPi / 4.f,
+                      -5.f * kPi / 6.f);
+  EXPECT_SIMDFLOAT_EQ(ozz::math::ATan2X(y, x), 0.f, 1.f, -2.f, -1.f);
+  EXPECT_SIMDFLOAT_EQ(
+      ozz::math::ATan2(ozz::math::simd_float4::Load(0.f, -0.f, 0.f, -0.f),
+                       ozz::math::simd_float4::Load(0.f, 0.f, -0.f, -0.f)),
+      0.f, 0.f, kPi, -kPi);
+  EXPECT_SIMDFLOAT_EQ(
+      ozz::math::ATan2(ozz::math::simd_float4::Load(1e-20f, -3.f, 1e20f, 2.f),
+                       ozz::math::simd_float4::Load(1.f, 1e-20f, -1.f, 2.f)),
+      0.f, -kPi_2, kPi_2, kPi / 4.f);
+
+  SimdFloat4 sin_angle, cos_angle;
+  ozz::math::SinCos(angle, &sin_angle, &cos_angle);
+  EXPECT_SIMDFLOAT_EQ(sin_angle, 0.f, .5f, -1.f, 1.f);
+  EXPECT_SIMDFLOAT_EQ(cos_angle, -1.f, .86602539f, 0.f, 0.f);
+  ozz::math::SinCos(angle - ozz::math::simd_float4::Load1(k2Pi * 24.f),
+                    &sin_angle, &cos_angle);
+  EXPECT_SIMDFLOAT_EQ(sin_angle, 0.f, .5f, -1.f, 1.f);
+  EXPECT_SIMDFLOAT_EQ(cos_angle, -1.f, .86602539f, 0.f, 0.f);
+}
+
+namespace {
+// Updates _max with the absolute difference between _approx and _exact.
+void UpdateMaxError(float _approx, double _exact, double* _max) {
+  *_max = std::max(*_max, std::abs(_approx - _exact));
+}
+}  // namespace
+
+TEST(TrigonometryFloatPrecision, ozz_simd_math) {
+  // Compares with double precision standard functions, over their domain.
+  // Tolerances are maximum absolute errors documented in simd_math.h.
+  const int kSteps = 200000;
+  double acos_err = 0., asin_err = 0., atan_err = 0., atan2_err = 0.,
+         sin_err = 0., cos_err = 0.;
+  for (int i = 0; i <= kSteps; i += 4) {
+    float values[4], angles[4], tans[4], xs[4], ys[4];
+    for (int j = 0; j < 4; ++j) {
+      const float ratio = static_cast<float>(i + j) / kSteps;
+      values[j] = -1.f + 2.f * ratio;
+      angles[j] = -8192.f + 2.f * 8192.f * ratio;
+      tans[j] = std::tan((ratio - .5f) * 3.14f) * (1.f + ratio);
+      const float a = (ratio - .5f) * 6.2831853f * 1.01f;
+      const float len = .01f + ratio * 100.f;
+      xs[j] = std::cos(a) * len;
+      ys[j] = std::sin(a) * len;
+    }
+    float acos[4], asin[4], atan[4], atan2[4], sin[4], cos[4];
+    const SimdFloat4 v = ozz::math::simd_float4::LoadPtrU(values);
+    ozz::math::StorePtrU(ozz::math::ACos(v), acos);
+    ozz::math::StorePtrU(ozz::math::ASin(v), asin);
+    ozz::math::StorePtrU(
+        ozz::math::ATan(ozz::math::simd_float4::LoadPtrU(tans)), atan);
+    ozz::math::StorePtrU(
+        ozz::math::ATan2(ozz::math::simd_float4::LoadPtrU(ys),
+                         ozz::math::simd_float4::LoadPtrU(xs)),
+        atan2);
+    SimdFloat4 simd_sin, simd_cos;
+    ozz::math::SinCos(ozz::math::simd_float4::LoadPtrU(angles), &simd_sin,
+                      &simd_cos);
+    ozz::math::StorePtrU(simd_sin, sin);
+    ozz::math::StorePtrU(simd_cos, cos);
+    for (int j = 0; j < 4; ++j) {
+      const double value = values[j];
+      const double angle = angles[j];
+      UpdateMaxError(acos[j], std::acos(value), &acos_err);
+      UpdateMaxError(asin[j], std::asin(value), &asin_err);
+      UpdateMaxError(atan[j], std::atan(static_cast<double>(tans[j])),
+                     &atan_err);
+      UpdateMaxError(atan2[j],
+                     std::atan2(static_cast<double>(ys[j]),
+                                static_cast<double>(xs[j])),
+                     &atan2_err);
+      UpdateMaxError(sin[j], std::sin(angle), &sin_err);
+      UpdateMaxError(cos[j], std::cos(angle), &cos_err);
+    }
+  }
+  EXPECT_LT(acos_err, 3e-7);
+  EXPECT_LT(asin_err, 2e-7);
+  EXPECT_LT(atan_err, 2e-7);
+  EXPECT_LT(atan2_err, 3e-7);
+  EXPECT_LT(sin_err, 1e-7);
+  EXPECT_LT(cos_err, 1e-7);
 }
 
 TEST(LogicalFloat, ozz_simd_math) {
@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------------//
+//                                                                            //
+// ozz-animation is hosted at http://github.com/guillaumeblanc/ozz-animation  //
+// and distributed under the MIT License (MIT).                               //
+//                                                                            //
+// Copyright (c) Guillaume Blanc                                              //
+//                                                                            //
+// Permission is hereby granted, free of charge, to any person obtaining a    //
+// copy of this software and associated documentation files (the "Software"), //
+// to deal in the Software without restriction, including without limitation  //
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,   //
+// and/or sell copies of the Software, and to permit persons to whom the      //
+// Software is furnished to do so, subject to the following conditions:       //
+//                                                                            //
+// The above copyright notice and this permission notice shall be included in //
+// all copies or substantial portions of the Software.                        //
+//                                                                            //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    //
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING    //
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER        //
+// DEALINGS IN THE SOFTWARE.                                                  //
+//                                                                            //
+//----------------------------------------------------------------------------//
+
+
+#include "ozz/base/memory/tracking_allocator.h"
+
+#include <cstring>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ozz/base/maths/math_ex.h"
+
+using ozz::memory::TrackingAllocator;
+
+TEST(Tags, TrackingAllocator) {
+  EXPECT_STREQ(ozz::memory::TagName(ozz::memory::kUntagged), "untagged");
+  EXPECT_STREQ(ozz::memory::TagName(ozz::memory::kAnimation), "animation");
+  EXPECT_STREQ(ozz::memory::TagName(ozz::memory::kBuilder), "builder");
+  EXPECT_TRUE(ozz::memory::TagName(ozz::memory::kTagCount) == nullptr);
+
+  EXPECT_EQ(ozz::memory::current_tag(), ozz::memory::kUntagged);
+  {
+    const ozz::memory::ScopedTag tag(ozz::memory::kSkeleton);
+    EXPECT_EQ(ozz::memory::current_tag(), ozz::memory::kSkeleton);
+    {
+      const ozz::memory::ScopedTag nested(ozz::memory::kCache);
+      EXPECT_EQ(ozz::memory::current_tag(), ozz::memory::kCache);
+
+      // Tags are per thread.
+      std::thread thread([] {
+        EXPECT_EQ(ozz::memory::current_tag(), ozz::memory::kUntagged);
+      });
+      thread.join();
+    }
+    EXPECT_EQ(ozz::memory::current_tag(), ozz::memory::kSkeleton);
+  }
+  EXPECT_EQ(ozz::memory::current_tag(), ozz::memory::kUntagged);
+}
+
+TEST(Allocate, TrackingAllocator) {
+  TrackingAllocator allocator(ozz::memory::default_allocator());
+
+  {  // Empty by default.
+    const TrackingAllocator::Statistics total = allocator.total();
+    EXPECT_EQ(total.bytes, 0u);
+    EXPECT_EQ(total.peak_bytes, 0u);
+    EXPECT_EQ(total.blocks, 0u);
+    EXPECT_EQ(total.allocations, 0u);
+  }
+
+  // Alignment is respected.
+  void* untagged = allocator.Allocate(12, 1024);
+  ASSERT_TRUE(untagged != nullptr);
+  EXPECT_TRUE(ozz::IsAligned(untagged, 1024));
+  memset(untagged, 0, 12);
+
+  void* animation;
+  {
+    const ozz::memory::ScopedTag tag(ozz::memory::kAnimation);
+    animation = allocator.Allocate(100, 16);
+    ASSERT_TRUE(animation != nullptr);
+    EXPECT_TRUE(ozz::IsAligned(animation, 16));
+    memset(animation, 0, 100);
+  }
+
+  {
+    const TrackingAllocator::Statistics stats =
+        allocator.statistics(ozz::memory::kUntagged);
+    EXPECT_EQ(stats.bytes, 12u);
+    EXPECT_EQ(stats.peak_bytes, 12u);
+    EXPECT_EQ(stats.blocks, 1u);
+    EXPECT_EQ(stats.allocations, 1u);
+  }
+  {
+    const TrackingAllocator::Statistics stats =
+        allocator.statistics(ozz::memory::kAnimation);
+    EXPECT_EQ(stats.bytes, 100u);
+    EXPECT_EQ(stats.peak_bytes, 100u);
+    EXPECT_EQ(stats.blocks, 1u);
+    EXPECT_EQ(stats.allocations, 1u);
+  }
+  {
+    const TrackingAllocator::Statistics stats =
+        allocator.statistics(ozz::memory::kSkeleton);
+    EXPECT_EQ(stats.bytes, 0u);
+    EXPECT_EQ(stats.allocations, 0u);
+  }
+
+  // Deallocation is tracked with allocation tag, whatever current tag.
+  {
+    const ozz::memory::ScopedTag tag(ozz::memory::kSkeleton);
+    allocator.Deallocate(animation);
+  }
+  {
+    const TrackingAllocator::Statistics stats =
+        allocator.statistics(ozz::memory::kAnimation);
+    EXPECT_EQ(stats.bytes, 0u);
+    EXPECT_EQ(stats.peak_bytes, 100u);
+    EXPECT_EQ(stats.blocks, 0u);
+    EXPECT_EQ(stats.allocations, 1u);
+  }
+  {
+    const TrackingAllocator::Statistics total = allocator.total();
+    EXPECT_EQ(total.bytes, 12u);
+    EXPECT_EQ(total.peak_bytes, 112u);
+    EXPECT_EQ(total.blocks, 1u);
+    EXPECT_EQ(total.allocations, 2u);
+  }
+
+  // Resets peaks.
+  allocator.ResetPeaks();
+  EXPECT_EQ(allocator.statistics(ozz::memory::kAnimation).peak_bytes, 0u);
+  EXPECT_EQ(allocator.total().peak_bytes, 12u);
+
+  // nullptr deallocation is valid.
+  allocator.Deallocate(nullptr);
+
+  allocator.Deallocate(untagged);
+  EXPECT_EQ(allocator.total().bytes, 0u);
+  EXPECT_EQ(allocator.total().blocks, 0u);
+}
+
+TEST(Concurrency, TrackingAllocator) {
+  TrackingAllocator allocator(ozz::memory::default_allocator());
+
+  const int kAllocations = 1000;
+  auto run = [&allocator](ozz::memory::Tag _tag) {
+    const ozz::memory::ScopedTag tag(_tag);
+    for (int i = 0; i < kAllocations; ++i) {
+      allocator.Deallocate(allocator.Allocate(8, 8));
+    }
+  };
+  std::thread thread0(run, ozz::memory::kTrack);
+  std::thread thread1(run, ozz::memory::kCache);
+  thread0.join();
+  thread1.join();
+
+  EXPECT_EQ(allocator.statistics(ozz::memory::kTrack).allocations,
+            static_cast<size_t>(kAllocations));
+  EXPECT_EQ(allocator.statistics(ozz::memory::kCache).allocations,
+            static_cast<size_t>(kAllocations));
+  EXPECT_EQ(allocator.statistics(ozz::memory::kTrack).peak_bytes, 8u);
+  EXPECT_EQ(allocator.total().allocations,
+            static_cast<size_t>(kAllocations * 2));
+  EXPECT_EQ(allocator.total().bytes, 0u);
+  EXPECT_LE(allocator.total().peak_bytes, 16u);
+}